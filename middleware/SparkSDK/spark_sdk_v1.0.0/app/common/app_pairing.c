@@ -14,7 +14,7 @@
 #include "swc_api.h"
 
 /* CONSTANTS ******************************************************************/
-#define SWC_MEM_POOL_SIZE 4600
+#define SWC_MEM_POOL_SIZE 5100
 
 #define GENERATE_SERIALIZED_LEN              4
 #define GENERATE_SERIALIZED_CRC_POLY         0x1021
@@ -0,0 +1,3090 @@
+/** @file  audio_core_benchmark.c
+ *  @brief This application benchmarks the SPARK Audio Core on a host computer.
+ *         Pipelines of varying processing stage count, payload size, bit depth
+ *         and channel count are run back to back and the time spent per audio
+ *         packet is reported. The output of every pipeline is also compared
+ *         against golden checksums so optimizations can be validated bit-exactly.
+ *         The processing of zero-copy pipelines is then timed against the same
+ *         pipelines copying their packets, which must output the same samples.
+ *         Stage checks then run processing stages directly, comparing their
+ *         output against reference models written independently of the stages
+ *         and reporting the time spent per call.
+ *
+ *         Build and run with CMake:
+ *             cmake -S app/example/audio_core_benchmark -B build
+ *             cmake --build build
+ *             ./build/audio_core_benchmark [packet_count]
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "adpcm.h"
+#include "audio_compression.h"
+#include "audio_eq_cmsis.h"
+#include "audio_mixer_module.h"
+#include "audio_packing.h"
+#include "audio_plc.h"
+#include "audio_src_rational.h"
+#include "audio_volume.h"
+#include "sac_api.h"
+
+/* CONSTANTS ******************************************************************/
+#define SAC_MEM_POOL_SIZE          32000
+#define BENCH_QUEUE_SIZE           4
+#define BENCH_DEFAULT_PACKET_COUNT 20000
+#define BENCH_GOLDEN_PACKET_COUNT  64  /* Number of packets covered by the golden checksums */
+#define BENCH_MIN_PACKET_COUNT     (BENCH_GOLDEN_PACKET_COUNT + BENCH_QUEUE_SIZE) /* Covers the pipelines latency */
+#define BENCH_VOLUME_LEVEL         70
+#define BENCH_TRIANGLE_PERIOD      200 /* Period in samples of the generated triangle wave */
+#define BENCH_TRIANGLE_GAIN        500
+#define BENCH_NOISE_AMPLITUDE      512
+#define BENCH_SAMPLE_RATE          48000
+#define BENCH_SRC_OUTPUT_RATE      32000
+#define BENCH_CDC_RESAMPLING_LENGTH 5760
+#define BENCH_CDC_QUEUE_AVG_SIZE   1000
+#define BENCH_ZERO_COPY_ROUND_COUNT 16   /* Rounds of the copy vs zero-copy comparison, the fastest is kept */
+#define BENCH_ZERO_COPY_TIMED_COUNT 1024 /* Packets of a round whose time is kept for the median */
+#define BENCH_LINK_PACKET_SIZE     256 /* Largest encapsulated audio packet the link holds */
+#define BENCH_LINK_HEADROOM        7   /* Link header written in front of a packet received in place */
+#define BENCH_PLC_HOLD_MS          20
+#define BENCH_PLC_FADE_MS          20
+#define FNV1A_OFFSET_BASIS         0x811C9DC5
+#define FNV1A_PRIME                0x01000193
+#define NS_PER_S                   1000000000ULL
+#define CHECK_PACKET_COUNT         64  /* Number of packets compared against the reference models */
+#define CHECK_FRAME_COUNT          60  /* Number of frames per packet of the stage checks */
+#define CHECK_CHANNEL_COUNT        2
+#define CHECK_SAMPLE_COUNT         (CHECK_FRAME_COUNT * CHECK_CHANNEL_COUNT)
+#define CHECK_VOLUME_TICK_COUNT    3   /* Volume decrease commands starting the gain ramp */
+#define GAIN_FRAC_BITS             30  /* Q2.30 gain of the volume reference model */
+#define GAIN_Q16_FRAC_BITS         16  /* Q15.16 gain applied on 16-bit samples by the volume reference model */
+#define CHECK_RECORD_SIZE          8192 /* Samples the consumer can record for the stage checks */
+#define CHECK_SETTLED_PACKET_COUNT (CHECK_PACKET_COUNT / 2) /* Last packets measured, once the filters settled */
+#define CHECK_TONE_LEVEL           0.25 /* Tone amplitude relative to the full scale */
+#define CHECK_EQ_FREQUENCY_HZ      1000.0f
+#define CHECK_EQ_Q                 1.0f
+#define CHECK_EQ_GAIN_DB           6.0f
+#define CHECK_EQ_TOLERANCE_Q15_DB  0.1  /* Largest EQ response error with 16-bit samples filtered in Q15 */
+#define CHECK_EQ_TOLERANCE_Q31_DB  0.01 /* Largest EQ response error with 24-bit samples filtered in Q31 */
+#define CHECK_EQ_SWAP_PACKET_COUNT 128  /* Packets filtered, the settings change half way */
+#define CHECK_EQ_SWAP_LEVEL        0.5  /* Tone amplitude relative to the full scale, boosted into the limiter */
+#define CHECK_EQ_SWAP_GAIN_DB      (-6.0f) /* Peaking band gain after the change */
+#define CHECK_EQ_SWAP_LIMITER_DB   (-1.0f) /* Limiter threshold before the change, -6 dB after */
+#define CHECK_EQ_SWAP_RELEASE_MS   10.0f
+#define CHECK_OOM_POOL_STEP        8    /* Memory pool size increment of the out of memory checks */
+#define CHECK_SRC_TONE_HZ          1000
+#define CHECK_SRC_TOLERANCE_DB     0.01 /* Largest SRC passband gain error */
+#define CHECK_SRC_MIN_SNR_DB       70.0 /* Smallest SRC signal to noise and distortion ratio */
+#define CHECK_SWEEP_BIN_HZ         25   /* Tones are whole numbers of periods over a record of 1 / CHECK_SWEEP_BIN_HZ */
+#define CHECK_SWEEP_SETTLE_FRAMES  512  /* Samples out discarded while the filter history fills */
+#define CHECK_SWEEP_PASSBAND_DB    0.01 /* Largest SRC gain error below CHECK_SWEEP_PASSBAND_EDGE */
+#define CHECK_SWEEP_PASSBAND_EDGE  0.6  /* Highest passband tone, relative to the lowest Nyquist frequency */
+#define CHECK_SWEEP_STOPBAND_EDGE  1.2  /* Lowest stopband tone, relative to the lowest Nyquist frequency */
+#define CHECK_SWEEP_ALIAS_DB       (-70.0) /* Largest alias or image left by the SRC, relative to the tone */
+#define CHECK_PLC_TONE_HZ          220  /* Pitch period not a whole number of samples */
+#define CHECK_PLC_CONCEAL_COUNT    4    /* Packets concealed, all within the hold time */
+#define CHECK_PLC_MIN_SNR_DB       35.0 /* Smallest ratio of the true continuation to the concealment error */
+#define CHECK_CRC_CORRUPTION_PERIOD 8
+#define CHECK_RECREATE_COUNT       4    /* Times the pipeline is torn down and rebuilt */
+#define CHECK_TAKEN_NODE_MAX       16   /* Free nodes the check without free node can hold */
+#define CHECK_MIXER_PAYLOAD_SIZE   240  /* Bytes mixed per packet, of every input */
+#define CHECK_MIXER_INPUT_COUNT    3
+#define CHECK_MIXER_RING_PAYLOAD_SIZE 200 /* Bytes mixed per packet, not dividing the input queue size */
+#define CHECK_MIXER_RING_WRAP_COUNT 8   /* Times every input queue wraps */
+
+/* TYPES **********************************************************************/
+/** @brief Benchmark Processing Stages.
+ */
+typedef enum bench_stages {
+    BENCH_STAGES_NONE,        /*!< No processing stage */
+    BENCH_STAGES_VOLUME,      /*!< Digital volume control */
+    BENCH_STAGES_VOLUME_CODEC, /*!< Digital volume control, then packing and unpacking. 16-bit samples go
+                                    through ADPCM compression, 20 and 24-bit samples through the packing stage */
+    BENCH_STAGES_ZERO_COPY,    /*!< Digital volume control on a zero-copy pipeline */
+    BENCH_STAGES_CDC,          /*!< No processing stage, with clock drift compensation */
+    BENCH_STAGES_CDC_POLYPHASE, /*!< No processing stage, with clock drift compensation by the polyphase resampler */
+    BENCH_STAGES_LINK_CRC,     /*!< No processing stage, through an encapsulated link protected by the payload CRC */
+    BENCH_STAGES_LINK_IN_PLACE, /*!< No processing stage, through an encapsulated link receiving in place */
+    BENCH_STAGES_EQ,           /*!< Parametric equalizer and limiter */
+    BENCH_STAGES_SRC,          /*!< Rational ratio sampling rate conversion from BENCH_SAMPLE_RATE to BENCH_SRC_OUTPUT_RATE */
+    BENCH_STAGES_PLC,          /*!< Packet loss concealment, without any packet lost */
+    BENCH_STAGES_MULTI_RATE    /*!< Multi-rate packing and unpacking with the lossless codec, 16-bit samples only */
+} bench_stages_t;
+
+/** @brief Benchmark Case.
+ */
+typedef struct bench_case {
+    bench_stages_t stages;     /*!< Processing stages of the pipeline */
+    uint16_t payload_size;     /*!< Size in bytes of the produced and consumed audio payloads */
+    sac_bit_depth_t bit_depth; /*!< Bit depth of the samples */
+    uint8_t channel_count;     /*!< 1 for mono and 2 for interleaved stereo */
+    uint32_t golden_checksum;  /*!< Checksum of the first BENCH_GOLDEN_PACKET_COUNT consumed payloads */
+} bench_case_t;
+
+/** @brief Benchmark Stage Check.
+ */
+typedef struct bench_check {
+    const char *name; /*!< Name printed with the result */
+    /*! Compare the stage output against its reference model, then time iteration_count calls */
+    bool (*run)(uint32_t iteration_count, uint64_t *elapsed_ns);
+} bench_check_t;
+
+/** @brief Benchmark Producer Endpoint Instance.
+ */
+typedef struct bench_producer_instance {
+    sac_bit_depth_t bit_depth; /*!< Bit depth of the produced samples */
+    uint32_t lcg;              /*!< State of the noise generator */
+    uint16_t phase;            /*!< Position in the triangle wave period */
+    bool white_noise;          /*!< Full scale white noise instead of the triangle wave with noise */
+} bench_producer_instance_t;
+
+/** @brief Benchmark Consumer Endpoint Instance.
+ */
+typedef struct bench_consumer_instance {
+    sac_bit_depth_t bit_depth;    /*!< Bit depth of the consumed samples */
+    uint32_t checksum;            /*!< FNV-1a hash of the consumed payloads */
+    uint32_t packet_count;        /*!< Number of consumed payloads */
+    uint32_t silent_packet_count; /*!< Number of consumed payloads with only null samples */
+    int32_t *record;              /*!< Consumed samples, right-justified and sign extended, NULL to not record */
+    uint32_t record_count;        /*!< Number of samples recorded, up to CHECK_RECORD_SIZE */
+} bench_consumer_instance_t;
+
+/** @brief Benchmark Link Endpoint Instance.
+ *
+ *  Carries encapsulated audio packets from the consumer of a pipeline to the producer of another.
+ */
+typedef struct bench_link_instance {
+    uint8_t packet[BENCH_LINK_PACKET_SIZE]; /*!< Audio packet in flight */
+    uint16_t size;                          /*!< Size in bytes of the audio packet in flight, 0 if none */
+    uint32_t packet_count;                  /*!< Number of audio packets sent */
+    uint32_t corruption_period;             /*!< A payload bit of one audio packet every corruption_period is
+                                                 flipped, 0 to never corrupt the audio packets */
+    sac_endpoint_t *receiver;               /*!< Producer receiving in place, NULL to copy the audio packets */
+    uint8_t *rx_packet;                     /*!< Audio packet lent by the receiver, the next one is received in */
+} bench_link_instance_t;
+
+/* PRIVATE FUNCTION PROTOTYPE *************************************************/
+static void app_audio_core_init(const bench_case_t *bench_case, sac_error_t *audio_err);
+static void app_audio_core_deinit(void);
+static void app_audio_core_volume_interface_init(sac_processing_interface_t *iface);
+static void app_audio_core_compression_interface_init(sac_processing_interface_t *iface);
+static void app_audio_core_packing_interface_init(sac_processing_interface_t *iface);
+static void app_audio_core_eq_interface_init(sac_processing_interface_t *iface);
+static void app_audio_core_src_interface_init(sac_processing_interface_t *iface);
+static void app_audio_core_plc_interface_init(sac_processing_interface_t *iface);
+static void app_audio_core_bench_endpoint_init(sac_endpoint_interface_t *producer_iface,
+                                               sac_endpoint_interface_t *consumer_iface);
+static void app_audio_core_link_endpoint_init(sac_endpoint_interface_t *producer_iface,
+                                              sac_endpoint_interface_t *consumer_iface);
+static void app_audio_core_processing_init(const bench_case_t *bench_case, sac_error_t *audio_err);
+static void app_audio_core_critical_section_init(queue_critical_cfg_t *queue_critical);
+
+static bool run_bench_case(const bench_case_t *bench_case, uint32_t packet_count,
+                           uint64_t *elapsed_ns, sac_error_t *audio_err);
+static bool run_bench_pipeline(const bench_case_t *bench_case, uint32_t packet_count,
+                               uint64_t *elapsed_ns, sac_error_t *audio_err);
+static void run_pipeline_cycle(sac_pipeline_t *pipeline, sac_error_t *audio_err);
+static bool run_zero_copy_comparison(const bench_case_t *zero_copy_case, uint32_t packet_count);
+static uint32_t run_zero_copy_round(const bench_case_t *bench_case, uint32_t packet_count, sac_error_t *audio_err);
+static int compare_uint32(const void *a, const void *b);
+#if (SAC_PROFILING_EN > 0U)
+static void print_profile(sac_pipeline_t *pipeline);
+static void print_cycles_stats(const char *name, const sac_cycles_stats_t *stats);
+#endif
+static uint64_t get_time_ns(void);
+static bool check_volume_16bits(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_volume_20bits(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_volume_24bits(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_volume(sac_bit_depth_t bit_depth, uint32_t iteration_count, uint64_t *elapsed_ns);
+static void reference_volume(sac_bit_depth_t bit_depth, const int32_t *samples_in, int32_t *samples_out,
+                             int32_t gain_start, int32_t gain_end);
+static int32_t saturate(int64_t sample, uint8_t bit_depth);
+static bool check_mixer_soft_clip(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_mixer_gain(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_mixer_ring_buffer(uint32_t iteration_count, uint64_t *elapsed_ns);
+static int32_t get_mixer_stream_sample(uint8_t input, uint32_t index, sac_bit_depth_t bit_depth);
+static double reference_soft_clip(int64_t sample, int32_t full_scale);
+static bool check_cdc_passthrough(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_payload_crc(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_eq_response(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_eq_swap(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_eq_out_of_memory(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_src_tone(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_src_sweep(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_src_out_of_memory(uint32_t iteration_count, uint64_t *elapsed_ns);
+static uint32_t convert_tone(audio_src_rational_instance_t *instance, uint32_t frequency_hz, int32_t amplitude,
+                             uint32_t count);
+static uint32_t fold_frequency(uint32_t frequency_hz, uint32_t sample_rate);
+static bool check_plc_continuation(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_adpcm_per_sample(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_adpcm_block(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_adpcm_packed_3bits(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_adpcm_packed_2bits(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_adpcm(uint8_t code_size, bool per_sample, uint32_t iteration_count, uint64_t *elapsed_ns);
+static void encode_adpcm_packet(uint8_t code_size, bool per_sample, const int16_t *pcm, uint8_t *codes,
+                                adpcm_state_t *state);
+static void decode_adpcm_packet(uint8_t code_size, bool per_sample, const uint8_t *codes, int16_t *pcm,
+                                adpcm_state_t *state);
+static bool check_multi_rate_snr(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_multi_rate_noise(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_pipeline_recreate(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_stage_without_free_node(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_stage_remove(uint32_t iteration_count, uint64_t *elapsed_ns);
+static bool check_stage_chain(sac_pipeline_t *pipeline, sac_processing_t **stages, uint8_t stage_count);
+static double reference_peaking_gain_db(double frequency_hz);
+static void generate_tone(int32_t *samples, uint16_t count, uint32_t start, double frequency_hz,
+                          uint32_t sample_rate, int32_t amplitude);
+static void measure_tone(const int32_t *samples, uint32_t count, double frequency_hz, uint32_t sample_rate,
+                         double *amplitude, double *snr_db);
+static double get_snr_db(const int32_t *reference, const int32_t *samples, uint32_t count);
+static void store_samples(sac_bit_depth_t bit_depth, const int32_t *samples, uint16_t count, uint8_t *buffer);
+static void load_samples(sac_bit_depth_t bit_depth, const uint8_t *buffer, uint16_t count, int32_t *samples);
+static int32_t generate_sample(bench_producer_instance_t *instance);
+
+static uint16_t ep_bench_produce(void *instance, uint8_t *samples, uint16_t size);
+static uint16_t ep_bench_consume(void *instance, uint8_t *samples, uint16_t size);
+static uint16_t ep_link_produce(void *instance, uint8_t *samples, uint16_t size);
+static uint16_t ep_link_consume(void *instance, uint8_t *samples, uint16_t size);
+static void ep_bench_start(void *instance);
+static void ep_bench_stop(void *instance);
+static void critical_section_enter(void);
+static void critical_section_exit(void);
+
+/* PRIVATE GLOBALS ************************************************************/
+/* ** Audio Core ** */
+static uint8_t audio_memory_pool[SAC_MEM_POOL_SIZE];
+static sac_pipeline_t *pipeline;
+
+static bench_producer_instance_t producer_instance;
+static sac_endpoint_t *producer;
+
+static bench_consumer_instance_t consumer_instance;
+static sac_endpoint_t *consumer;
+
+static audio_volume_instance_t volume_instance;
+static sac_processing_t *volume_processing;
+
+static audio_compression_instance_t compression_instance;
+static sac_processing_t *compression_processing;
+
+static audio_compression_instance_t decompression_instance;
+static sac_processing_t *decompression_processing;
+
+static audio_packing_instance_t packing_instance;
+static sac_processing_t *packing_processing;
+
+static audio_packing_instance_t unpacking_instance;
+static sac_processing_t *unpacking_processing;
+
+static audio_eq_cmsis_instance_t eq_instance;
+static sac_processing_t *eq_processing;
+
+static audio_src_rational_instance_t src_instance;
+static sac_processing_t *src_processing;
+
+static audio_plc_instance_t plc_instance;
+static sac_processing_t *plc_processing;
+
+static bench_link_instance_t link_instance;
+static sac_endpoint_t *link_consumer;
+static sac_endpoint_t *link_producer;
+static sac_pipeline_t *link_pipeline;
+
+/* ** Application Specific ** */
+static const bench_case_t bench_cases[] = {
+    {BENCH_STAGES_NONE,         48,  AUDIO_16BITS, 1, 0xE4EE4795},
+    {BENCH_STAGES_NONE,         48,  AUDIO_16BITS, 2, 0xE4EE4795},
+    {BENCH_STAGES_NONE,         48,  AUDIO_20BITS, 1, 0xDC76235E},
+    {BENCH_STAGES_NONE,         48,  AUDIO_20BITS, 2, 0xDC76235E},
+    {BENCH_STAGES_NONE,         48,  AUDIO_24BITS, 1, 0xD7BE1630},
+    {BENCH_STAGES_NONE,         48,  AUDIO_24BITS, 2, 0xD7BE1630},
+    {BENCH_STAGES_NONE,         240, AUDIO_16BITS, 1, 0x7DB3873E},
+    {BENCH_STAGES_NONE,         240, AUDIO_16BITS, 2, 0x7DB3873E},
+    {BENCH_STAGES_NONE,         240, AUDIO_20BITS, 1, 0x424FB970},
+    {BENCH_STAGES_NONE,         240, AUDIO_20BITS, 2, 0x424FB970},
+    {BENCH_STAGES_NONE,         240, AUDIO_24BITS, 1, 0x57DFAB19},
+    {BENCH_STAGES_NONE,         240, AUDIO_24BITS, 2, 0x57DFAB19},
+    {BENCH_STAGES_VOLUME,       48,  AUDIO_16BITS, 1, 0xED9DE65D},
+    {BENCH_STAGES_VOLUME,       48,  AUDIO_16BITS, 2, 0xED9DE65D},
+    {BENCH_STAGES_VOLUME,       48,  AUDIO_20BITS, 1, 0x0EDFD821},
+    {BENCH_STAGES_VOLUME,       48,  AUDIO_20BITS, 2, 0x0EDFD821},
+    {BENCH_STAGES_VOLUME,       48,  AUDIO_24BITS, 1, 0x2B91405B},
+    {BENCH_STAGES_VOLUME,       48,  AUDIO_24BITS, 2, 0x2B91405B},
+    {BENCH_STAGES_VOLUME,       240, AUDIO_16BITS, 1, 0xCD0DE868},
+    {BENCH_STAGES_VOLUME,       240, AUDIO_16BITS, 2, 0xCD0DE868},
+    {BENCH_STAGES_VOLUME,       240, AUDIO_20BITS, 1, 0x72087784},
+    {BENCH_STAGES_VOLUME,       240, AUDIO_20BITS, 2, 0x72087784},
+    {BENCH_STAGES_VOLUME,       240, AUDIO_24BITS, 1, 0x9FA883D6},
+    {BENCH_STAGES_VOLUME,       240, AUDIO_24BITS, 2, 0x9FA883D6},
+    {BENCH_STAGES_VOLUME_CODEC, 48,  AUDIO_16BITS, 1, 0x4F15C0BF},
+    {BENCH_STAGES_VOLUME_CODEC, 48,  AUDIO_16BITS, 2, 0xE6CE783A},
+    {BENCH_STAGES_VOLUME_CODEC, 48,  AUDIO_20BITS, 1, 0x0EDFD821},
+    {BENCH_STAGES_VOLUME_CODEC, 48,  AUDIO_20BITS, 2, 0x0EDFD821},
+    {BENCH_STAGES_VOLUME_CODEC, 48,  AUDIO_24BITS, 1, 0x2B91405B},
+    {BENCH_STAGES_VOLUME_CODEC, 48,  AUDIO_24BITS, 2, 0x2B91405B},
+    {BENCH_STAGES_VOLUME_CODEC, 240, AUDIO_16BITS, 1, 0x9284E2D8},
+    {BENCH_STAGES_VOLUME_CODEC, 240, AUDIO_16BITS, 2, 0x92404F54},
+    {BENCH_STAGES_VOLUME_CODEC, 240, AUDIO_20BITS, 1, 0x72087784},
+    {BENCH_STAGES_VOLUME_CODEC, 240, AUDIO_20BITS, 2, 0x72087784},
+    {BENCH_STAGES_VOLUME_CODEC, 240, AUDIO_24BITS, 1, 0x9FA883D6},
+    {BENCH_STAGES_VOLUME_CODEC, 240, AUDIO_24BITS, 2, 0x9FA883D6},
+    /*
+     * The following pipelines must not change the samples, so their golden checksums are the ones of
+     * the pipelines above instead of being generated by the cases themselves: zero-copy matches the
+     * copying volume pipeline, and the CRC protected link, PLC without packet loss and lossless
+     * multi-rate coding match the pipeline without processing stage.
+     */
+    {BENCH_STAGES_ZERO_COPY,    240, AUDIO_16BITS, 1, 0xCD0DE868},
+    {BENCH_STAGES_ZERO_COPY,    240, AUDIO_16BITS, 2, 0xCD0DE868},
+    {BENCH_STAGES_ZERO_COPY,    240, AUDIO_24BITS, 1, 0x9FA883D6},
+    {BENCH_STAGES_ZERO_COPY,    240, AUDIO_24BITS, 2, 0x9FA883D6},
+    {BENCH_STAGES_LINK_CRC,     240, AUDIO_16BITS, 1, 0x7DB3873E},
+    {BENCH_STAGES_LINK_CRC,     240, AUDIO_16BITS, 2, 0x7DB3873E},
+    {BENCH_STAGES_LINK_CRC,     240, AUDIO_24BITS, 1, 0x57DFAB19},
+    {BENCH_STAGES_LINK_CRC,     240, AUDIO_24BITS, 2, 0x57DFAB19},
+    {BENCH_STAGES_LINK_IN_PLACE, 240, AUDIO_16BITS, 1, 0x7DB3873E},
+    {BENCH_STAGES_LINK_IN_PLACE, 240, AUDIO_16BITS, 2, 0x7DB3873E},
+    {BENCH_STAGES_LINK_IN_PLACE, 240, AUDIO_24BITS, 1, 0x57DFAB19},
+    {BENCH_STAGES_LINK_IN_PLACE, 240, AUDIO_24BITS, 2, 0x57DFAB19},
+    {BENCH_STAGES_PLC,          240, AUDIO_16BITS, 1, 0x7DB3873E},
+    {BENCH_STAGES_PLC,          240, AUDIO_16BITS, 2, 0x7DB3873E},
+    {BENCH_STAGES_PLC,          240, AUDIO_24BITS, 1, 0x57DFAB19},
+    {BENCH_STAGES_PLC,          240, AUDIO_24BITS, 2, 0x57DFAB19},
+    {BENCH_STAGES_MULTI_RATE,   240, AUDIO_16BITS, 1, 0x7DB3873E},
+    {BENCH_STAGES_MULTI_RATE,   240, AUDIO_16BITS, 2, 0x7DB3873E},
+    /* CDC, EQ and SRC outputs are also checked against reference models by the stage checks */
+    {BENCH_STAGES_CDC,          240, AUDIO_16BITS, 1, 0xBEA4D8D0},
+    {BENCH_STAGES_CDC,          240, AUDIO_16BITS, 2, 0x0A060B86},
+    {BENCH_STAGES_CDC,          240, AUDIO_24BITS, 1, 0x40202711},
+    {BENCH_STAGES_CDC,          240, AUDIO_24BITS, 2, 0x25075C51},
+    {BENCH_STAGES_CDC_POLYPHASE, 240, AUDIO_16BITS, 1, 0xF128BEC6},
+    {BENCH_STAGES_CDC_POLYPHASE, 240, AUDIO_16BITS, 2, 0xC164D73F},
+    {BENCH_STAGES_CDC_POLYPHASE, 240, AUDIO_24BITS, 1, 0xB444F2E3},
+    {BENCH_STAGES_CDC_POLYPHASE, 240, AUDIO_24BITS, 2, 0xAE7632BC},
+    {BENCH_STAGES_EQ,           240, AUDIO_16BITS, 1, 0xDA6CF1B5},
+    {BENCH_STAGES_EQ,           240, AUDIO_16BITS, 2, 0x6925FB4A},
+    {BENCH_STAGES_EQ,           240, AUDIO_24BITS, 1, 0xA4F2F8BD},
+    {BENCH_STAGES_EQ,           240, AUDIO_24BITS, 2, 0x74519173},
+    {BENCH_STAGES_SRC,          240, AUDIO_16BITS, 1, 0x8C992418},
+    {BENCH_STAGES_SRC,          240, AUDIO_16BITS, 2, 0xBE0A8EB7},
+    {BENCH_STAGES_SRC,          240, AUDIO_24BITS, 1, 0x6A31AFD8},
+    {BENCH_STAGES_SRC,          240, AUDIO_24BITS, 2, 0x60891BFF},
+};
+
+static const bench_check_t bench_checks[] = {
+    {"volume 16-bit", check_volume_16bits},
+    {"volume 20-bit", check_volume_20bits},
+    {"volume 24-bit", check_volume_24bits},
+    {"mixer soft clip", check_mixer_soft_clip},
+    {"mixer gain", check_mixer_gain},
+    {"mixer ring buffer", check_mixer_ring_buffer},
+    {"cdc passthrough", check_cdc_passthrough},
+    {"payload crc", check_payload_crc},
+    {"eq response", check_eq_response},
+    {"eq swap", check_eq_swap},
+    {"eq out of memory", check_eq_out_of_memory},
+    {"src tone", check_src_tone},
+    {"src sweep", check_src_sweep},
+    {"src out of memory", check_src_out_of_memory},
+    {"plc continuation", check_plc_continuation},
+    {"adpcm per-sample", check_adpcm_per_sample},
+    {"adpcm block", check_adpcm_block},
+    {"adpcm packed 3-bit", check_adpcm_packed_3bits},
+    {"adpcm packed 2-bit", check_adpcm_packed_2bits},
+    {"multi-rate snr", check_multi_rate_snr},
+    {"multi-rate noise", check_multi_rate_noise},
+    {"pipeline recreate", check_pipeline_recreate},
+    {"stage without free node", check_stage_without_free_node},
+    {"stage remove", check_stage_remove},
+};
+
+static uint32_t zero_copy_process_ns[BENCH_ZERO_COPY_TIMED_COUNT];
+
+static mem_pool_t check_mem_pool;
+static uint8_t check_memory_pool[SAC_MEM_POOL_SIZE];
+static int32_t check_record[CHECK_RECORD_SIZE];
+
+static const char *const bench_stages_name[] = {
+    [BENCH_STAGES_NONE]         = "none",
+    [BENCH_STAGES_VOLUME]       = "volume",
+    [BENCH_STAGES_VOLUME_CODEC] = "volume+codec",
+    [BENCH_STAGES_ZERO_COPY]    = "volume zc",
+    [BENCH_STAGES_CDC]          = "cdc",
+    [BENCH_STAGES_CDC_POLYPHASE] = "cdc poly",
+    [BENCH_STAGES_LINK_CRC]     = "link+crc",
+    [BENCH_STAGES_LINK_IN_PLACE] = "link rx zc",
+    [BENCH_STAGES_EQ]           = "eq",
+    [BENCH_STAGES_SRC]          = "src",
+    [BENCH_STAGES_PLC]          = "plc",
+    [BENCH_STAGES_MULTI_RATE]   = "multi-rate",
+};
+
+static const uint8_t bench_stages_count[] = {
+    [BENCH_STAGES_NONE]         = 0,
+    [BENCH_STAGES_VOLUME]       = 1,
+    [BENCH_STAGES_VOLUME_CODEC] = 3,
+    [BENCH_STAGES_ZERO_COPY]    = 1,
+    [BENCH_STAGES_CDC]          = 0,
+    [BENCH_STAGES_CDC_POLYPHASE] = 0,
+    [BENCH_STAGES_LINK_CRC]     = 0,
+    [BENCH_STAGES_LINK_IN_PLACE] = 0,
+    [BENCH_STAGES_EQ]           = 1,
+    [BENCH_STAGES_SRC]          = 1,
+    [BENCH_STAGES_PLC]          = 1,
+    [BENCH_STAGES_MULTI_RATE]   = 2,
+};
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+int main(int argc, char *argv[])
+{
+    sac_error_t audio_err;
+    uint32_t packet_count = BENCH_DEFAULT_PACKET_COUNT;
+    uint32_t mismatch_count = 0;
+    uint64_t elapsed_ns;
+    const bench_case_t *bench_case;
+    bool match;
+
+    if (argc > 1) {
+        packet_count = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (packet_count < BENCH_MIN_PACKET_COUNT) {
+        packet_count = BENCH_MIN_PACKET_COUNT;
+    }
+
+    printf("%-16s %7s %5s %8s %10s %12s  %-10s %s\n",
+           "stages", "payload", "bits", "channels", "ns/packet", "packets/s", "checksum", "golden");
+
+    for (size_t i = 0; i < (sizeof(bench_cases) / sizeof(bench_cases[0])); i++) {
+        bench_case = &bench_cases[i];
+
+        match = run_bench_case(bench_case, packet_count, &elapsed_ns, &audio_err);
+        if (audio_err != SAC_ERR_NONE) {
+            printf("%-16s %7u %5u %8u  Audio Core error %d\n", bench_stages_name[bench_case->stages],
+                   bench_case->payload_size, bench_case->bit_depth, bench_case->channel_count, audio_err);
+            mismatch_count++;
+            continue;
+        }
+        if (!match) {
+            mismatch_count++;
+        }
+
+        printf("%-12s (%u) %7u %5u %8u %10.1f %12.0f  0x%08" PRIX32 " %s\n",
+               bench_stages_name[bench_case->stages], bench_stages_count[bench_case->stages],
+               bench_case->payload_size, bench_case->bit_depth, bench_case->channel_count,
+               (double)elapsed_ns / packet_count, ((double)packet_count * NS_PER_S) / elapsed_ns,
+               consumer_instance.checksum, match ? "ok" : "MISMATCH");
+#if (SAC_PROFILING_EN > 0U)
+        if (link_pipeline != NULL) {
+            print_profile(link_pipeline);
+        }
+        print_profile(pipeline);
+#endif
+    }
+
+    printf("\n%-16s %7s %5s %8s %10s %10s %7s  %s\n",
+           "copy vs zc", "payload", "bits", "channels", "copy ns", "zc ns", "saving", "output");
+
+    for (size_t i = 0; i < (sizeof(bench_cases) / sizeof(bench_cases[0])); i++) {
+        if ((bench_cases[i].stages == BENCH_STAGES_ZERO_COPY) &&
+            !run_zero_copy_comparison(&bench_cases[i], packet_count)) {
+            mismatch_count++;
+        }
+    }
+
+    printf("\n%-29s %10s  %s\n", "check", "ns/call", "reference");
+
+    for (size_t i = 0; i < (sizeof(bench_checks) / sizeof(bench_checks[0])); i++) {
+        match = bench_checks[i].run(packet_count, &elapsed_ns);
+        if (!match) {
+            mismatch_count++;
+        }
+
+        printf("%-29s %10.1f  %s\n", bench_checks[i].name, (double)elapsed_ns / packet_count,
+               match ? "ok" : "MISMATCH");
+    }
+
+    if (mismatch_count > 0) {
+        printf("%" PRIu32 " case(s) do not match their golden checksum or reference\n", mismatch_count);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Run a benchmark case.
+ *
+ *  The Audio Core is reinitialized, so every case starts from the same state.
+ *
+ *  @param[in]  bench_case    Benchmark case to run.
+ *  @param[in]  packet_count  Number of audio packets to produce, process and consume.
+ *  @param[out] elapsed_ns    Time spent running the pipeline, in nanoseconds.
+ *  @param[out] audio_err     Audio Core error code.
+ *  @retval true   Output matches the golden checksum.
+ *  @retval false  Output does not match the golden checksum.
+ */
+static bool run_bench_case(const bench_case_t *bench_case, uint32_t packet_count,
+                           uint64_t *elapsed_ns, sac_error_t *audio_err)
+{
+    queue_critical_cfg_t queue_critical;
+
+    app_audio_core_critical_section_init(&queue_critical);
+    sac_init(queue_critical, audio_memory_pool, SAC_MEM_POOL_SIZE);
+
+    app_audio_core_init(bench_case, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return false;
+    }
+
+    return run_bench_pipeline(bench_case, packet_count, elapsed_ns, audio_err);
+}
+
+/** @brief Run the pipelines of a benchmark case, once initialized.
+ *
+ *  @param[in]  bench_case    Benchmark case to run.
+ *  @param[in]  packet_count  Number of audio packets to produce, process and consume.
+ *  @param[out] elapsed_ns    Time spent running the pipeline, in nanoseconds.
+ *  @param[out] audio_err     Audio Core error code.
+ *  @retval true   Output matches the golden checksum.
+ *  @retval false  Output does not match the golden checksum.
+ */
+static bool run_bench_pipeline(const bench_case_t *bench_case, uint32_t packet_count,
+                               uint64_t *elapsed_ns, sac_error_t *audio_err)
+{
+    uint64_t start_ns;
+
+    if (link_pipeline != NULL) {
+        sac_pipeline_start(link_pipeline);
+        /* Fill the link consumer queue first, so the receiving pipeline gets a packet every cycle */
+        run_pipeline_cycle(link_pipeline, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return false;
+        }
+    }
+    sac_pipeline_start(pipeline);
+
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < packet_count; i++) {
+        if (link_pipeline != NULL) {
+            run_pipeline_cycle(link_pipeline, audio_err);
+            if (*audio_err != SAC_ERR_NONE) {
+                return false;
+            }
+        }
+        run_pipeline_cycle(pipeline, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return false;
+        }
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+
+    sac_pipeline_stop(pipeline);
+    if (link_pipeline != NULL) {
+        sac_pipeline_stop(link_pipeline);
+    }
+
+    return (consumer_instance.checksum == bench_case->golden_checksum);
+}
+
+/** @brief Compare a zero-copy benchmark case with the same pipeline copying its packets.
+ *
+ *  The copies zero-copy removes are all made by sac_pipeline_process(), so only that call
+ *  is timed: the sample generation and checksum of the endpoints would hide them. Both
+ *  pipelines run in alternation for BENCH_ZERO_COPY_ROUND_COUNT rounds on the same samples.
+ *  The median time per packet of the fastest round of each is printed, so packets or
+ *  rounds slowed down by the host do not show as a saving or a loss.
+ *
+ *  @param[in] zero_copy_case  Zero-copy benchmark case.
+ *  @param[in] packet_count    Number of audio packets to produce, process and consume per round.
+ *  @retval true   Both pipelines output the same samples.
+ *  @retval false  The outputs differ or the Audio Core failed.
+ */
+static bool run_zero_copy_comparison(const bench_case_t *zero_copy_case, uint32_t packet_count)
+{
+    bench_case_t copy_case = *zero_copy_case;
+    const bench_case_t *round_cases[] = {&copy_case, zero_copy_case};
+    uint32_t median_ns[] = {UINT32_MAX, UINT32_MAX}; /* Fastest round of each case */
+    uint32_t round_median_ns;
+    uint32_t checksums[2];
+    sac_error_t audio_err;
+
+    copy_case.stages = BENCH_STAGES_VOLUME;
+    for (uint8_t round = 0; round < BENCH_ZERO_COPY_ROUND_COUNT; round++) {
+        for (uint8_t c = 0; c < 2; c++) {
+            round_median_ns = run_zero_copy_round(round_cases[c], packet_count, &audio_err);
+            if (audio_err != SAC_ERR_NONE) {
+                printf("%-16s %7u %5u %8u  Audio Core error %d\n", bench_stages_name[round_cases[c]->stages],
+                       round_cases[c]->payload_size, round_cases[c]->bit_depth, round_cases[c]->channel_count,
+                       audio_err);
+                return false;
+            }
+            median_ns[c] = (round_median_ns < median_ns[c]) ? round_median_ns : median_ns[c];
+            checksums[c] = consumer_instance.checksum;
+        }
+    }
+
+    printf("%-16s %7u %5u %8u %10" PRIu32 " %10" PRIu32 " %6.1f%%  %s\n", bench_stages_name[copy_case.stages],
+           zero_copy_case->payload_size, zero_copy_case->bit_depth, zero_copy_case->channel_count,
+           median_ns[0], median_ns[1], 100.0 * ((double)median_ns[0] - (double)median_ns[1]) / median_ns[0],
+           (checksums[0] == checksums[1]) ? "same" : "MISMATCH");
+
+    return (checksums[0] == checksums[1]);
+}
+
+/** @brief Run one round of the zero-copy comparison.
+ *
+ *  The Audio Core is reinitialized, so every round starts from the same state. The time
+ *  of the last BENCH_ZERO_COPY_TIMED_COUNT packets at most is kept.
+ *
+ *  @param[in]  bench_case    Benchmark case to run.
+ *  @param[in]  packet_count  Number of audio packets to produce, process and consume.
+ *  @param[out] audio_err     Audio Core error code.
+ *  @return Median time spent in sac_pipeline_process() per packet, in nanoseconds.
+ */
+static uint32_t run_zero_copy_round(const bench_case_t *bench_case, uint32_t packet_count, sac_error_t *audio_err)
+{
+    queue_critical_cfg_t queue_critical;
+    uint32_t timed_count = (packet_count < BENCH_ZERO_COPY_TIMED_COUNT) ? packet_count : BENCH_ZERO_COPY_TIMED_COUNT;
+    uint64_t start_ns;
+
+    app_audio_core_critical_section_init(&queue_critical);
+    sac_init(queue_critical, audio_memory_pool, SAC_MEM_POOL_SIZE);
+    app_audio_core_init(bench_case, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return 0;
+    }
+
+    sac_pipeline_start(pipeline);
+    for (uint32_t i = 0; i < packet_count; i++) {
+        sac_pipeline_produce(pipeline, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return 0;
+        }
+        start_ns = get_time_ns();
+        sac_pipeline_process(pipeline, audio_err);
+        zero_copy_process_ns[i % BENCH_ZERO_COPY_TIMED_COUNT] = (uint32_t)(get_time_ns() - start_ns);
+        if (*audio_err != SAC_ERR_NONE) {
+            return 0;
+        }
+        sac_pipeline_consume(pipeline, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return 0;
+        }
+    }
+    sac_pipeline_stop(pipeline);
+
+    qsort(zero_copy_process_ns, timed_count, sizeof(zero_copy_process_ns[0]), compare_uint32);
+
+    return zero_copy_process_ns[timed_count / 2];
+}
+
+/** @brief Compare two unsigned 32-bit integers for qsort().
+ *
+ *  @param[in] a  First integer.
+ *  @param[in] b  Second integer.
+ *  @return Negative, zero or positive if a is below, equal to or above b.
+ */
+static int compare_uint32(const void *a, const void *b)
+{
+    uint32_t value_a = *(const uint32_t *)a;
+    uint32_t value_b = *(const uint32_t *)b;
+
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+/** @brief Produce, process and consume one audio packet on a pipeline.
+ *
+ *  @param[in]  pipeline   Pipeline to run.
+ *  @param[out] audio_err  Audio Core error code.
+ */
+static void run_pipeline_cycle(sac_pipeline_t *pipeline, sac_error_t *audio_err)
+{
+    sac_pipeline_produce(pipeline, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+    sac_pipeline_process(pipeline, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+    sac_pipeline_consume(pipeline, audio_err);
+}
+
+/** @brief Initialize the Audio Core for a benchmark case.
+ *
+ *  @param[in]  bench_case  Benchmark case to initialize the pipeline of.
+ *  @param[out] audio_err   Audio Core error code.
+ */
+static void app_audio_core_init(const bench_case_t *bench_case, sac_error_t *audio_err)
+{
+    sac_endpoint_interface_t producer_iface;
+    sac_endpoint_interface_t consumer_iface;
+    sac_endpoint_interface_t link_producer_iface;
+    sac_endpoint_interface_t link_consumer_iface;
+    uint16_t consumer_payload_size = bench_case->payload_size;
+
+    app_audio_core_bench_endpoint_init(&producer_iface, &consumer_iface);
+    app_audio_core_link_endpoint_init(&link_producer_iface, &link_consumer_iface);
+
+    /*
+     * Benchmark Audio Pipeline
+     * ========================
+     *
+     * Input:      Triangle wave with noise, generated in memory.
+     * Processing: None, digital volume control, digital volume control followed by packing and unpacking,
+     *             equalizer, sampling rate conversion, packet loss concealment or multi-rate coding.
+     * Output:     Checksum of the samples.
+     *
+     * +-----------+    +----------------+    +------+    +--------+    +----------+
+     * | Generator | -> | Digital Volume | -> | Pack | -> | Unpack | -> | Checksum |
+     * +-----------+    +----------------+    +------+    +--------+    +----------+
+     *
+     * The link cases split it in two pipelines exchanging encapsulated audio packets.
+     *
+     * +-----------+    +------+      +------+    +----------+
+     * | Generator | -> | Link | ~~~> | Link | -> | Checksum |
+     * +-----------+    +------+      +------+    +----------+
+     */
+    producer_instance.bit_depth = bench_case->bit_depth;
+    producer_instance.lcg = 0;
+    producer_instance.phase = 0;
+    audio_endpoint_cfg_t producer_cfg = {
+        .use_encapsulation = false,
+        .delayed_action = false,
+        .channel_count = bench_case->channel_count,
+        .bit_depth = bench_case->bit_depth,
+        .audio_payload_size = bench_case->payload_size,
+        .queue_size = BENCH_QUEUE_SIZE};
+    producer = sac_endpoint_init((void *)&producer_instance, "Generator EP (Producer)",
+                                 producer_iface, producer_cfg, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    if (bench_case->stages == BENCH_STAGES_SRC) {
+        consumer_payload_size = ((uint32_t)bench_case->payload_size * BENCH_SRC_OUTPUT_RATE) / BENCH_SAMPLE_RATE;
+    }
+    consumer_instance.bit_depth = bench_case->bit_depth;
+    consumer_instance.checksum = FNV1A_OFFSET_BASIS;
+    consumer_instance.packet_count = 0;
+    consumer_instance.silent_packet_count = 0;
+    consumer_instance.record_count = 0;
+    audio_endpoint_cfg_t consumer_cfg = {
+        .use_encapsulation = false,
+        .delayed_action = false,
+        .channel_count = bench_case->channel_count,
+        .bit_depth = bench_case->bit_depth,
+        .audio_payload_size = consumer_payload_size,
+        .queue_size = BENCH_QUEUE_SIZE};
+    consumer = sac_endpoint_init((void *)&consumer_instance, "Checksum EP (Consumer)",
+                                 consumer_iface, consumer_cfg, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    sac_pipeline_cfg_t pipeline_cfg = {
+        .cdc_enable = (bench_case->stages == BENCH_STAGES_CDC) || (bench_case->stages == BENCH_STAGES_CDC_POLYPHASE),
+        .cdc_resampling_mode = (bench_case->stages == BENCH_STAGES_CDC_POLYPHASE) ? RESAMPLING_MODE_POLYPHASE :
+                                                                                     RESAMPLING_MODE_LINEAR,
+        .cdc_resampling_length = BENCH_CDC_RESAMPLING_LENGTH,
+        .cdc_queue_avg_size = BENCH_CDC_QUEUE_AVG_SIZE,
+        .do_initial_buffering = false,
+        .user_data_enable = false,
+        .zero_copy_enable = (bench_case->stages == BENCH_STAGES_ZERO_COPY),
+        .payload_crc_enable = (bench_case->stages == BENCH_STAGES_LINK_CRC)};
+
+    link_pipeline = NULL;
+    if ((bench_case->stages == BENCH_STAGES_LINK_CRC) || (bench_case->stages == BENCH_STAGES_LINK_IN_PLACE)) {
+        link_instance.size = 0;
+        link_instance.packet_count = 0;
+        link_instance.receiver = NULL;
+        audio_endpoint_cfg_t link_cfg = {
+            .use_encapsulation = true,
+            .delayed_action = false,
+            .channel_count = bench_case->channel_count,
+            .bit_depth = bench_case->bit_depth,
+            .audio_payload_size = bench_case->payload_size,
+            .queue_size = BENCH_QUEUE_SIZE};
+        link_consumer = sac_endpoint_init((void *)&link_instance, "Link EP (Consumer)",
+                                          link_consumer_iface, link_cfg, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        if (bench_case->stages == BENCH_STAGES_LINK_IN_PLACE) {
+            /* The link receives in a single packet at a time */
+            link_cfg.lent_queue_size = 1;
+            link_cfg.packet_headroom = BENCH_LINK_HEADROOM;
+        }
+        link_producer = sac_endpoint_init((void *)&link_instance, "Link EP (Producer)",
+                                          link_producer_iface, link_cfg, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+
+        link_pipeline = sac_pipeline_init("Generator -> Link", producer, pipeline_cfg, link_consumer, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_setup(link_pipeline, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        pipeline = sac_pipeline_init("Link -> Checksum", link_producer, pipeline_cfg, consumer, audio_err);
+    } else {
+        pipeline = sac_pipeline_init("Generator -> Checksum", producer, pipeline_cfg, consumer, audio_err);
+    }
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    app_audio_core_processing_init(bench_case, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    sac_pipeline_setup(pipeline, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    if (bench_case->stages == BENCH_STAGES_LINK_IN_PLACE) {
+        link_instance.rx_packet = sac_endpoint_lend_packet(link_producer);
+        link_instance.receiver = link_producer;
+    }
+}
+
+/** @brief Deinitialize the pipelines of the last benchmark case, their stages and endpoints.
+ *
+ *  Every block they allocated goes back to the Audio Core memory pool.
+ */
+static void app_audio_core_deinit(void)
+{
+    sac_processing_t *process = pipeline->process;
+    sac_processing_t *next_process;
+
+    sac_pipeline_deinit(pipeline);
+    while (process != NULL) {
+        next_process = process->next_process;
+        sac_processing_stage_deinit(process);
+        process = next_process;
+    }
+    sac_endpoint_deinit(producer);
+    sac_endpoint_deinit(consumer);
+    if (link_pipeline != NULL) {
+        sac_pipeline_deinit(link_pipeline);
+        sac_endpoint_deinit(link_producer);
+        sac_endpoint_deinit(link_consumer);
+        link_pipeline = NULL;
+    }
+    pipeline = NULL;
+}
+
+/** @brief Initialize and add the processing stages of a benchmark case.
+ *
+ *  @param[in]  bench_case  Benchmark case to initialize the processing stages of.
+ *  @param[out] audio_err   Audio Core error code.
+ */
+static void app_audio_core_processing_init(const bench_case_t *bench_case, sac_error_t *audio_err)
+{
+    sac_processing_interface_t volume_iface;
+    sac_processing_interface_t compression_iface;
+    sac_processing_interface_t packing_iface;
+    sac_processing_interface_t eq_iface;
+    sac_processing_interface_t src_iface;
+    sac_processing_interface_t plc_iface;
+    bool use_volume = (bench_case->stages == BENCH_STAGES_VOLUME) || (bench_case->stages == BENCH_STAGES_VOLUME_CODEC) ||
+                      (bench_case->stages == BENCH_STAGES_ZERO_COPY);
+
+    app_audio_core_volume_interface_init(&volume_iface);
+    app_audio_core_compression_interface_init(&compression_iface);
+    app_audio_core_packing_interface_init(&packing_iface);
+    app_audio_core_eq_interface_init(&eq_iface);
+    app_audio_core_src_interface_init(&src_iface);
+    app_audio_core_plc_interface_init(&plc_iface);
+
+    *audio_err = SAC_ERR_NONE;
+
+    if (use_volume) {
+        volume_instance.initial_volume_level = BENCH_VOLUME_LEVEL;
+        volume_instance.bit_depth = bench_case->bit_depth;
+        volume_instance.channel_count = bench_case->channel_count;
+        volume_processing = sac_processing_stage_init((void *)&volume_instance, "Digital Volume Control",
+                                                      volume_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, volume_processing);
+    }
+
+    if ((bench_case->stages == BENCH_STAGES_VOLUME_CODEC) && (bench_case->bit_depth == AUDIO_16BITS)) {
+        compression_instance.compression_mode = (bench_case->channel_count == 2) ?
+                                                AUDIO_COMPRESSION_PACK_STEREO : AUDIO_COMPRESSION_PACK_MONO;
+        compression_processing = sac_processing_stage_init((void *)&compression_instance, "Audio Compression",
+                                                           compression_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, compression_processing);
+
+        decompression_instance.compression_mode = (bench_case->channel_count == 2) ?
+                                                  AUDIO_COMPRESSION_UNPACK_STEREO : AUDIO_COMPRESSION_UNPACK_MONO;
+        decompression_processing = sac_processing_stage_init((void *)&decompression_instance, "Audio Decompression",
+                                                             compression_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, decompression_processing);
+    } else if (bench_case->stages == BENCH_STAGES_VOLUME_CODEC) {
+        packing_instance.packing_mode = (bench_case->bit_depth == AUDIO_20BITS) ?
+                                        AUDIO_PACK_20BITS : AUDIO_PACK_24BITS;
+        packing_processing = sac_processing_stage_init((void *)&packing_instance, "Audio Packing",
+                                                       packing_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, packing_processing);
+
+        unpacking_instance.packing_mode = (bench_case->bit_depth == AUDIO_20BITS) ?
+                                          AUDIO_UNPACK_20BITS : AUDIO_UNPACK_24BITS;
+        unpacking_processing = sac_processing_stage_init((void *)&unpacking_instance, "Audio Unpacking",
+                                                         packing_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, unpacking_processing);
+    }
+
+    if (bench_case->stages == BENCH_STAGES_MULTI_RATE) {
+        memset(&compression_instance, 0, sizeof(compression_instance));
+        compression_instance.compression_mode = AUDIO_COMPRESSION_PACK_MULTI_RATE;
+        compression_instance.channel_count = bench_case->channel_count;
+        compression_instance.codec = AUDIO_COMPRESSION_CODEC_LOSSLESS;
+        compression_processing = sac_processing_stage_init((void *)&compression_instance, "Audio Compression",
+                                                           compression_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, compression_processing);
+
+        memset(&decompression_instance, 0, sizeof(decompression_instance));
+        decompression_instance.compression_mode = AUDIO_COMPRESSION_UNPACK_MULTI_RATE;
+        decompression_instance.channel_count = bench_case->channel_count;
+        decompression_instance.max_payload_size = bench_case->payload_size;
+        decompression_processing = sac_processing_stage_init((void *)&decompression_instance, "Audio Decompression",
+                                                             compression_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, decompression_processing);
+    }
+
+    if (bench_case->stages == BENCH_STAGES_EQ) {
+        memset(&eq_instance, 0, sizeof(eq_instance));
+        eq_instance.cfg.bit_depth = bench_case->bit_depth;
+        eq_instance.cfg.channel_count = bench_case->channel_count;
+        eq_instance.cfg.payload_size = bench_case->payload_size;
+        eq_instance.cfg.sample_rate = BENCH_SAMPLE_RATE;
+        eq_instance.cfg.band_count = 3;
+        eq_instance.cfg.band[0] = (audio_eq_band_cfg_t){AUDIO_EQ_HIGH_PASS, 40.0f, 0.707f, 0.0f};
+        eq_instance.cfg.band[1] = (audio_eq_band_cfg_t){AUDIO_EQ_PEAKING, 1000.0f, 1.0f, 6.0f};
+        eq_instance.cfg.band[2] = (audio_eq_band_cfg_t){AUDIO_EQ_HIGH_SHELF, 8000.0f, 0.707f, -3.0f};
+        eq_instance.cfg.limiter_threshold_db = -1.0f;
+        eq_instance.cfg.limiter_release_ms = 50.0f;
+        eq_processing = sac_processing_stage_init((void *)&eq_instance, "Equalizer", eq_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, eq_processing);
+    }
+
+    if (bench_case->stages == BENCH_STAGES_SRC) {
+        memset(&src_instance, 0, sizeof(src_instance));
+        src_instance.cfg.input_sample_rate = BENCH_SAMPLE_RATE;
+        src_instance.cfg.output_sample_rate = BENCH_SRC_OUTPUT_RATE;
+        src_instance.cfg.bit_depth = bench_case->bit_depth;
+        src_instance.cfg.channel_count = bench_case->channel_count;
+        src_instance.cfg.payload_size = bench_case->payload_size;
+        src_processing = sac_processing_stage_init((void *)&src_instance, "Sampling Rate Converter",
+                                                   src_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, src_processing);
+    }
+
+    if (bench_case->stages == BENCH_STAGES_PLC) {
+        memset(&plc_instance, 0, sizeof(plc_instance));
+        plc_instance.cfg.bit_depth = bench_case->bit_depth;
+        plc_instance.cfg.channel_count = bench_case->channel_count;
+        plc_instance.cfg.payload_size = bench_case->payload_size;
+        plc_instance.cfg.sample_rate = BENCH_SAMPLE_RATE;
+        plc_instance.cfg.hold_ms = BENCH_PLC_HOLD_MS;
+        plc_instance.cfg.fade_ms = BENCH_PLC_FADE_MS;
+        plc_processing = sac_processing_stage_init((void *)&plc_instance, "Packet Loss Concealment",
+                                                   plc_iface, audio_err);
+        if (*audio_err != SAC_ERR_NONE) {
+            return;
+        }
+        sac_pipeline_add_processing(pipeline, plc_processing);
+    }
+}
+
+/** @brief Initialize the digital volume control audio processing stage interface.
+ *
+ *  @param[out] iface  Processing interface.
+ */
+static void app_audio_core_volume_interface_init(sac_processing_interface_t *iface)
+{
+    iface->init = audio_volume_init;
+    iface->deinit = audio_volume_deinit;
+    iface->ctrl = audio_volume_ctrl;
+    iface->process = audio_volume_process;
+    iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = true;
+    iface->output_overhead = 0;
+}
+
+/** @brief Initialize the audio compression processing stage interface.
+ *
+ *  @param[out] iface  Processing interface.
+ */
+static void app_audio_core_compression_interface_init(sac_processing_interface_t *iface)
+{
+    iface->init = audio_compression_init;
+    iface->deinit = audio_compression_deinit;
+    iface->ctrl = audio_compression_ctrl;
+    iface->process = audio_compression_process;
+    iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = false;
+    iface->output_overhead = AUDIO_COMPRESSION_MULTI_RATE_OVERHEAD_MAX_SIZE;
+}
+
+/** @brief Initialize the audio packing processing stage interface.
+ *
+ *  @param[out] iface  Processing interface.
+ */
+static void app_audio_core_packing_interface_init(sac_processing_interface_t *iface)
+{
+    iface->init = audio_packing_init;
+    iface->deinit = audio_packing_deinit;
+    iface->ctrl = audio_packing_ctrl;
+    iface->process = audio_packing_process;
+    iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = false;
+    iface->output_overhead = 0;
+}
+
+/** @brief Initialize the equalizer processing stage interface.
+ *
+ *  @param[out] iface  Processing interface.
+ */
+static void app_audio_core_eq_interface_init(sac_processing_interface_t *iface)
+{
+    iface->init = audio_eq_cmsis_init;
+    iface->deinit = audio_eq_cmsis_deinit;
+    iface->ctrl = audio_eq_cmsis_ctrl;
+    iface->process = audio_eq_cmsis_process;
+    iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = true;
+    iface->output_overhead = 0;
+}
+
+/** @brief Initialize the rational ratio sampling rate converter processing stage interface.
+ *
+ *  @param[out] iface  Processing interface.
+ */
+static void app_audio_core_src_interface_init(sac_processing_interface_t *iface)
+{
+    iface->init = audio_src_rational_init;
+    iface->deinit = audio_src_rational_deinit;
+    iface->ctrl = audio_src_rational_ctrl;
+    iface->process = audio_src_rational_process;
+    iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = false;
+    iface->output_overhead = 0;
+}
+
+/** @brief Initialize the packet loss concealment processing stage interface.
+ *
+ *  @param[out] iface  Processing interface.
+ */
+static void app_audio_core_plc_interface_init(sac_processing_interface_t *iface)
+{
+    iface->init = audio_plc_init;
+    iface->deinit = audio_plc_deinit;
+    iface->ctrl = audio_plc_ctrl;
+    iface->process = audio_plc_process;
+    iface->gate = NULL;
+    iface->conceal = audio_plc_conceal;
+    iface->in_place = true;
+    iface->output_overhead = 0;
+}
+
+/** @brief Initialize the benchmark audio endpoint interfaces.
+ *
+ *  @param[out] producer_iface  Generator producer audio endpoint interface.
+ *  @param[out] consumer_iface  Checksum consumer audio endpoint interface.
+ */
+static void app_audio_core_bench_endpoint_init(sac_endpoint_interface_t *producer_iface,
+                                               sac_endpoint_interface_t *consumer_iface)
+{
+    producer_iface->action = ep_bench_produce;
+    producer_iface->start = ep_bench_start;
+    producer_iface->stop = ep_bench_stop;
+
+    consumer_iface->action = ep_bench_consume;
+    consumer_iface->start = ep_bench_start;
+    consumer_iface->stop = ep_bench_stop;
+}
+
+/** @brief Initialize the link audio endpoint interfaces.
+ *
+ *  @param[out] producer_iface  Link producer audio endpoint interface.
+ *  @param[out] consumer_iface  Link consumer audio endpoint interface.
+ */
+static void app_audio_core_link_endpoint_init(sac_endpoint_interface_t *producer_iface,
+                                              sac_endpoint_interface_t *consumer_iface)
+{
+    producer_iface->action = ep_link_produce;
+    producer_iface->start = ep_bench_start;
+    producer_iface->stop = ep_bench_stop;
+
+    consumer_iface->action = ep_link_consume;
+    consumer_iface->start = ep_bench_start;
+    consumer_iface->stop = ep_bench_stop;
+}
+
+/** @brief Initialize the Audio Core critical section.
+ *
+ *  The benchmark runs the Audio Core from a single thread, so nothing needs to be masked.
+ *
+ *  @param[out] queue_critical  Audio Core critical section.
+ */
+static void app_audio_core_critical_section_init(queue_critical_cfg_t *queue_critical)
+{
+    queue_critical->enter_critical = critical_section_enter;
+    queue_critical->exit_critical = critical_section_exit;
+}
+
+#if (SAC_PROFILING_EN > 0U)
+/** @brief Print the time spent by each part of a pipeline.
+ *
+ *  Processing stages and consumer endpoints are listed in the order of the pipeline, the
+ *  ones that never ran are skipped.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ */
+static void print_profile(sac_pipeline_t *pipeline)
+{
+    sac_pipeline_profile_t *profile = sac_pipeline_get_profile(pipeline);
+    char name[16];
+
+    printf("  %s\n  %-14s %10s %10s %10s %10s\n", pipeline->name, "part", "min ns", "avg ns", "max ns", "count");
+    print_cycles_stats("process", &profile->process);
+    print_cycles_stats("dequeue", &profile->dequeue);
+    for (uint8_t i = 0; i < SAC_PROFILING_STAGE_COUNT; i++) {
+        snprintf(name, sizeof(name), "stage %u", i);
+        print_cycles_stats(name, &profile->stage[i]);
+    }
+    print_cycles_stats("cdc", &profile->cdc);
+    print_cycles_stats("enqueue", &profile->enqueue);
+    print_cycles_stats("producer", &profile->producer_action);
+    for (uint8_t i = 0; i < SAC_PROFILING_CONSUMER_COUNT; i++) {
+        snprintf(name, sizeof(name), "consumer %u", i);
+        print_cycles_stats(name, &profile->consumer_action[i]);
+    }
+}
+
+/** @brief Print the cycles statistics of a part of a pipeline, if it ran.
+ *
+ *  @param[in] name   Name of the part.
+ *  @param[in] stats  Cycles statistics, nanoseconds on host.
+ */
+static void print_cycles_stats(const char *name, const sac_cycles_stats_t *stats)
+{
+    if (stats->count > 0) {
+        printf("  %-14s %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+               name, stats->min, stats->avg, stats->max, stats->count);
+    }
+}
+#endif
+
+/** @brief Get the time of a monotonic clock.
+ *
+ *  @return Time in nanoseconds.
+ */
+static uint64_t get_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * NS_PER_S) + (uint64_t)ts.tv_nsec;
+}
+
+/** @brief Check the digital volume control stage on 16-bit samples.
+ *
+ *  @param[in]  iteration_count  Number of timed calls.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the output matches the reference model.
+ */
+static bool check_volume_16bits(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_volume(AUDIO_16BITS, iteration_count, elapsed_ns);
+}
+
+/** @brief Check the digital volume control stage on 20-bit samples.
+ *
+ *  @param[in]  iteration_count  Number of timed calls.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the output matches the reference model.
+ */
+static bool check_volume_20bits(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_volume(AUDIO_20BITS, iteration_count, elapsed_ns);
+}
+
+/** @brief Check the digital volume control stage on 24-bit samples.
+ *
+ *  @param[in]  iteration_count  Number of timed calls.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the output matches the reference model.
+ */
+static bool check_volume_24bits(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_volume(AUDIO_24BITS, iteration_count, elapsed_ns);
+}
+
+/** @brief Check the digital volume control stage against its reference model.
+ *
+ *  The volume is decreased so the gain ramps down over every checked packet. Both
+ *  channels of a frame carry the same sample, so their outputs must stay equal. 20
+ *  and 24-bit samples go up to twice the bit depth range to exercise the saturation.
+ *
+ *  @param[in]  bit_depth        Bit depth of the samples.
+ *  @param[in]  iteration_count  Number of timed calls.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the output matches the reference model.
+ */
+static bool check_volume(sac_bit_depth_t bit_depth, uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    audio_volume_instance_t instance = {
+        .bit_depth = bit_depth,
+        .channel_count = CHECK_CHANNEL_COUNT,
+        .initial_volume_level = 100};
+    uint8_t buffer[CHECK_SAMPLE_COUNT * AUDIO_32BITS_BYTE];
+    uint16_t size = CHECK_SAMPLE_COUNT * ((bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE);
+    int32_t samples[CHECK_SAMPLE_COUNT];
+    int32_t expected[CHECK_SAMPLE_COUNT];
+    int32_t amplitude = (bit_depth == AUDIO_16BITS) ? INT16_MAX : (1 << bit_depth) - 1;
+    float factor = 1.0f;
+    float threshold = 1.0f;
+    int32_t gain_start;
+    uint32_t lcg = 1;
+    uint64_t start_ns;
+    bool match = true;
+
+    audio_volume_init(&instance, NULL);
+    for (uint8_t i = 0; i < CHECK_VOLUME_TICK_COUNT; i++) {
+        audio_volume_ctrl(&instance, AUDIO_VOLUME_DECREASE, 0);
+        threshold -= AUDIO_VOLUME_TICK;
+    }
+
+    for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+        for (uint16_t frame = 0; frame < CHECK_FRAME_COUNT; frame++) {
+            lcg = (lcg * 1664525) + 1013904223;
+            samples[frame * 2] = (int32_t)((int64_t)(lcg >> 1) % (2 * (int64_t)amplitude + 1)) - amplitude;
+            samples[frame * 2 + 1] = samples[frame * 2];
+        }
+        gain_start = (int32_t)(factor * (1 << GAIN_FRAC_BITS));
+        factor = (factor > threshold) ? factor - AUDIO_VOLUME_GRAD : factor;
+        factor = (factor < threshold) ? threshold : factor;
+        reference_volume(bit_depth, samples, expected, gain_start, (int32_t)(factor * (1 << GAIN_FRAC_BITS)));
+
+        store_samples(bit_depth, samples, CHECK_SAMPLE_COUNT, buffer);
+        audio_volume_process(&instance, NULL, buffer, size, buffer);
+        load_samples(bit_depth, buffer, CHECK_SAMPLE_COUNT, samples);
+        for (uint16_t i = 0; i < CHECK_SAMPLE_COUNT; i++) {
+            match = match && (samples[i] == expected[i]);
+        }
+    }
+
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < iteration_count; i++) {
+        audio_volume_process(&instance, NULL, buffer, size, buffer);
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+
+    return match;
+}
+
+/** @brief Reference model of the digital volume control stage on one packet.
+ *
+ *  The gain goes linearly from gain_start to gain_end, one step per frame, and the
+ *  result is truncated then saturated to the bit depth.
+ *
+ *  @param[in]  bit_depth    Bit depth of the samples.
+ *  @param[in]  samples_in   CHECK_SAMPLE_COUNT interleaved samples.
+ *  @param[out] samples_out  CHECK_SAMPLE_COUNT interleaved samples.
+ *  @param[in]  gain_start   Gain before the first frame, in Q2.30 format.
+ *  @param[in]  gain_end     Gain of the last frame, in Q2.30 format.
+ */
+static void reference_volume(sac_bit_depth_t bit_depth, const int32_t *samples_in, int32_t *samples_out,
+                             int32_t gain_start, int32_t gain_end)
+{
+    int32_t gain_step = (gain_end - gain_start) / CHECK_FRAME_COUNT;
+    int32_t gain;
+    int64_t sample;
+
+    for (uint16_t frame = 0; frame < CHECK_FRAME_COUNT; frame++) {
+        gain = gain_start + ((frame + 1) * gain_step);
+        for (uint8_t channel = 0; channel < CHECK_CHANNEL_COUNT; channel++) {
+            sample = samples_in[frame * CHECK_CHANNEL_COUNT + channel];
+            if (bit_depth == AUDIO_16BITS) {
+                /* 16-bit samples are scaled by a Q15.16 gain */
+                sample = (sample * (gain >> (GAIN_FRAC_BITS - GAIN_Q16_FRAC_BITS))) >> GAIN_Q16_FRAC_BITS;
+            } else {
+                sample = (sample * gain) >> GAIN_FRAC_BITS;
+            }
+            samples_out[frame * CHECK_CHANNEL_COUNT + channel] = saturate(sample, bit_depth);
+        }
+    }
+}
+
+/** @brief Check the mixer soft clip curve around and above its knee.
+ *
+ *  Two inputs carry the same ramp, so their sum sweeps twice the full scale in both
+ *  directions. The mix must follow the reference curve, rise monotonically and never
+ *  reach full scale, on 16-bit samples and on 20 and 24-bit samples in 32-bit words.
+ *
+ *  @param[in]  iteration_count  Number of timed mixes, on 24-bit samples.
+ *  @param[out] elapsed_ns       Time spent in the timed mixes, in nanoseconds.
+ *  @return True if the mix matches the reference curve.
+ */
+static bool check_mixer_soft_clip(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const sac_bit_depth_t bit_depths[] = {AUDIO_16BITS, AUDIO_20BITS, AUDIO_24BITS};
+    audio_mixer_module_cfg_t cfg = {.nb_of_inputs = 2, .payload_size = CHECK_MIXER_PAYLOAD_SIZE, .soft_clip = true};
+    audio_mixer_module_t *mixer;
+    sac_error_t audio_err;
+    uint8_t buffer[CHECK_MIXER_PAYLOAD_SIZE] __attribute__((aligned(4)));
+    int32_t samples[CHECK_MIXER_PAYLOAD_SIZE / AUDIO_16BITS_BYTE];
+    int32_t mix[CHECK_MIXER_PAYLOAD_SIZE / AUDIO_16BITS_BYTE];
+    uint16_t sample_count;
+    int64_t ramp_count;
+    int32_t full_scale;
+    int32_t previous;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t depth = 0; depth < (sizeof(bit_depths) / sizeof(bit_depths[0])); depth++) {
+        cfg.bit_depth = bit_depths[depth];
+        sample_count = CHECK_MIXER_PAYLOAD_SIZE / ((bit_depths[depth] == AUDIO_16BITS) ? AUDIO_16BITS_BYTE :
+                                                                                         AUDIO_32BITS_BYTE);
+        ramp_count = (int64_t)CHECK_PACKET_COUNT * sample_count;
+        full_scale = (1 << (bit_depths[depth] - 1)) - 1;
+        mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+        mixer = audio_mixer_module_init(cfg, &check_mem_pool, &audio_err);
+        if (mixer == NULL) {
+            return false;
+        }
+
+        previous = INT32_MIN;
+        for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+            /* From the most negative sample to full scale */
+            for (uint16_t i = 0; i < sample_count; i++) {
+                samples[i] = (int32_t)(-full_scale - 1 + ((2 * (int64_t)full_scale + 1) *
+                                                          (packet * sample_count + i)) / (ramp_count - 1));
+            }
+            store_samples(bit_depths[depth], samples, sample_count, buffer);
+            for (uint8_t input = 0; input < cfg.nb_of_inputs; input++) {
+                audio_mixer_module_append_samples(&mixer->input_samples_queue[input], buffer, cfg.payload_size);
+            }
+            audio_mixer_module_mix_packets(mixer);
+            load_samples(bit_depths[depth], mixer->output_packet_buffer, sample_count, mix);
+
+            for (uint16_t i = 0; i < sample_count; i++) {
+                match = match && (fabs(mix[i] - reference_soft_clip(2 * (int64_t)samples[i], full_scale)) < 1.0);
+                match = match && (mix[i] >= previous) && (mix[i] < full_scale) && (mix[i] > (-full_scale - 1));
+                previous = mix[i];
+            }
+        }
+
+        if (bit_depths[depth] == AUDIO_24BITS) {
+            start_ns = get_time_ns();
+            for (uint32_t i = 0; i < iteration_count; i++) {
+                for (uint8_t input = 0; input < cfg.nb_of_inputs; input++) {
+                    audio_mixer_module_append_samples(&mixer->input_samples_queue[input], buffer, cfg.payload_size);
+                }
+                audio_mixer_module_mix_packets(mixer);
+            }
+            *elapsed_ns = get_time_ns() - start_ns;
+        }
+    }
+
+    return match;
+}
+
+/** @brief Check the mixer Q2.14 input gains and limiting.
+ *
+ *  Three inputs of full scale noise are mixed with unity gains, which 16-bit samples
+ *  sum with saturation only, then with attenuating, amplifying, negative and extreme
+ *  gains, saturated and soft clipped, on 16, 20 and 24-bit samples.
+ *
+ *  @param[in]  iteration_count  Number of timed mixes, on 16-bit samples with gains.
+ *  @param[out] elapsed_ns       Time spent in the timed mixes, in nanoseconds.
+ *  @return True if the mix matches the reference model.
+ */
+static bool check_mixer_gain(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const sac_bit_depth_t bit_depths[] = {AUDIO_16BITS, AUDIO_20BITS, AUDIO_24BITS};
+    static const int16_t gains[][CHECK_MIXER_INPUT_COUNT] = {
+        {AUDIO_MIXER_GAIN_UNITY, AUDIO_MIXER_GAIN_UNITY, AUDIO_MIXER_GAIN_UNITY},
+        {AUDIO_MIXER_GAIN_UNITY / 2, AUDIO_MIXER_GAIN_UNITY + AUDIO_MIXER_GAIN_UNITY / 4, -AUDIO_MIXER_GAIN_UNITY * 3 / 4},
+        {INT16_MAX, INT16_MIN, AUDIO_MIXER_GAIN_UNITY / 3},
+    };
+    audio_mixer_module_cfg_t cfg = {.nb_of_inputs = CHECK_MIXER_INPUT_COUNT, .payload_size = CHECK_MIXER_PAYLOAD_SIZE};
+    audio_mixer_module_t *mixer;
+    sac_error_t audio_err;
+    uint8_t buffer[CHECK_MIXER_PAYLOAD_SIZE] __attribute__((aligned(4)));
+    int32_t samples[CHECK_MIXER_INPUT_COUNT][CHECK_MIXER_PAYLOAD_SIZE / AUDIO_16BITS_BYTE];
+    int32_t mix[CHECK_MIXER_PAYLOAD_SIZE / AUDIO_16BITS_BYTE];
+    uint16_t sample_count;
+    int32_t full_scale;
+    int64_t sum;
+    uint32_t lcg = 1;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t depth = 0; depth < (sizeof(bit_depths) / sizeof(bit_depths[0])); depth++) {
+        sample_count = CHECK_MIXER_PAYLOAD_SIZE / ((bit_depths[depth] == AUDIO_16BITS) ? AUDIO_16BITS_BYTE :
+                                                                                         AUDIO_32BITS_BYTE);
+        full_scale = (1 << (bit_depths[depth] - 1)) - 1;
+        for (size_t set = 0; set < (sizeof(gains) / sizeof(gains[0])); set++) {
+            for (uint8_t soft_clip = 0; soft_clip < 2; soft_clip++) {
+                cfg.bit_depth = bit_depths[depth];
+                cfg.soft_clip = soft_clip;
+                mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+                mixer = audio_mixer_module_init(cfg, &check_mem_pool, &audio_err);
+                if (mixer == NULL) {
+                    return false;
+                }
+                for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                    audio_mixer_module_set_input_gain(mixer, input, gains[set][input]);
+                }
+
+                for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+                    for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                        for (uint16_t i = 0; i < sample_count; i++) {
+                            lcg = (lcg * 1664525) + 1013904223;
+                            samples[input][i] = (int32_t)lcg >> (32 - bit_depths[depth]);
+                        }
+                        store_samples(bit_depths[depth], samples[input], sample_count, buffer);
+                        audio_mixer_module_append_samples(&mixer->input_samples_queue[input], buffer,
+                                                          cfg.payload_size);
+                    }
+                    audio_mixer_module_mix_packets(mixer);
+                    load_samples(bit_depths[depth], mixer->output_packet_buffer, sample_count, mix);
+
+                    for (uint16_t i = 0; i < sample_count; i++) {
+                        /* Every scaled input is rounded toward minus infinity */
+                        sum = 0;
+                        for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                            sum += (int64_t)floor((double)samples[input][i] * gains[set][input] /
+                                                  AUDIO_MIXER_GAIN_UNITY);
+                        }
+                        if (soft_clip) {
+                            match = match && (fabs(mix[i] - reference_soft_clip(sum, full_scale)) < 1.0);
+                        } else {
+                            match = match && (mix[i] == saturate(sum, bit_depths[depth]));
+                        }
+                    }
+                }
+
+                if ((bit_depths[depth] == AUDIO_16BITS) && (set == 1) && !soft_clip) {
+                    start_ns = get_time_ns();
+                    for (uint32_t i = 0; i < iteration_count; i++) {
+                        for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                            audio_mixer_module_append_samples(&mixer->input_samples_queue[input], buffer,
+                                                              cfg.payload_size);
+                        }
+                        audio_mixer_module_mix_packets(mixer);
+                    }
+                    *elapsed_ns = get_time_ns() - start_ns;
+                }
+            }
+        }
+    }
+
+    return match;
+}
+
+/** @brief Check the mixer input queues across their wraps.
+ *
+ *  Every input appends its stream in chunks of its own size, none a multiple of the
+ *  payload or queue size, so the queues wrap at different offsets and payloads are mixed
+ *  across the end of the queues. Once every queue holds a payload, the mix must match
+ *  the saturated sum of the streams read linearly, until every queue wrapped
+ *  CHECK_MIXER_RING_WRAP_COUNT times.
+ *
+ *  @param[in]  iteration_count  Number of timed mixes, on 16-bit samples.
+ *  @param[out] elapsed_ns       Time spent in the timed mixes, in nanoseconds.
+ *  @return True if every mix matches the linear reference.
+ */
+static bool check_mixer_ring_buffer(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const sac_bit_depth_t bit_depths[] = {AUDIO_16BITS, AUDIO_24BITS};
+    static const uint16_t chunk_frames[CHECK_MIXER_INPUT_COUNT] = {37, 61, 101}; /* Samples appended at once */
+    audio_mixer_module_cfg_t cfg = {.nb_of_inputs = CHECK_MIXER_INPUT_COUNT,
+                                    .payload_size = CHECK_MIXER_RING_PAYLOAD_SIZE};
+    audio_mixer_module_t *mixer;
+    sac_error_t audio_err;
+    uint8_t buffer[MAX_NB_OF_BYTES_PER_BUFFER] __attribute__((aligned(4)));
+    int32_t samples[MAX_NB_OF_BYTES_PER_BUFFER / AUDIO_16BITS_BYTE];
+    int32_t mix[CHECK_MIXER_RING_PAYLOAD_SIZE / AUDIO_16BITS_BYTE];
+    uint32_t appended[CHECK_MIXER_INPUT_COUNT]; /* Samples of each stream appended so far */
+    uint32_t mixed; /* Samples of every stream mixed so far */
+    uint8_t sample_size;
+    uint16_t sample_count;
+    uint16_t chunk_size;
+    int64_t sum;
+    bool ready;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t depth = 0; depth < (sizeof(bit_depths) / sizeof(bit_depths[0])); depth++) {
+        cfg.bit_depth = bit_depths[depth];
+        sample_size = (bit_depths[depth] == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE;
+        sample_count = CHECK_MIXER_RING_PAYLOAD_SIZE / sample_size;
+        mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+        mixer = audio_mixer_module_init(cfg, &check_mem_pool, &audio_err);
+        if (mixer == NULL) {
+            return false;
+        }
+        memset(appended, 0, sizeof(appended));
+        mixed = 0;
+
+        while ((mixed * sample_size) < (CHECK_MIXER_RING_WRAP_COUNT * MAX_NB_OF_BYTES_PER_BUFFER)) {
+            /* Fill every queue as far as its next chunk fits */
+            for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                chunk_size = chunk_frames[input] * sample_size;
+                while ((mixer->input_samples_queue[input].current_size + chunk_size) <= MAX_NB_OF_BYTES_PER_BUFFER) {
+                    for (uint16_t i = 0; i < chunk_frames[input]; i++) {
+                        samples[i] = get_mixer_stream_sample(input, appended[input] + i, bit_depths[depth]);
+                    }
+                    store_samples(bit_depths[depth], samples, chunk_frames[input], buffer);
+                    audio_mixer_module_append_samples(&mixer->input_samples_queue[input], buffer, chunk_size);
+                    appended[input] += chunk_frames[input];
+                }
+            }
+
+            /* Mix as long as every queue holds a payload */
+            while (true) {
+                ready = true;
+                for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                    ready = ready && (mixer->input_samples_queue[input].current_size >= cfg.payload_size);
+                }
+                if (!ready) {
+                    break;
+                }
+                audio_mixer_module_mix_packets(mixer);
+                load_samples(bit_depths[depth], mixer->output_packet_buffer, sample_count, mix);
+                for (uint16_t i = 0; i < sample_count; i++) {
+                    sum = 0;
+                    for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                        sum += get_mixer_stream_sample(input, mixed + i, bit_depths[depth]);
+                    }
+                    match = match && (mix[i] == saturate(sum, bit_depths[depth]));
+                }
+                mixed += sample_count;
+            }
+        }
+
+        if (bit_depths[depth] == AUDIO_16BITS) {
+            /* Appends of one payload and a half keep the queues wrapping at every other mix */
+            start_ns = get_time_ns();
+            for (uint32_t i = 0; i < iteration_count; i++) {
+                for (uint8_t input = 0; input < CHECK_MIXER_INPUT_COUNT; input++) {
+                    if (mixer->input_samples_queue[input].current_size < cfg.payload_size) {
+                        audio_mixer_module_append_samples(&mixer->input_samples_queue[input], buffer,
+                                                          cfg.payload_size + (cfg.payload_size / 2));
+                    }
+                }
+                audio_mixer_module_mix_packets(mixer);
+            }
+            *elapsed_ns = get_time_ns() - start_ns;
+        }
+    }
+
+    return match;
+}
+
+/** @brief Get a sample of a mixer input stream.
+ *
+ *  @param[in] input      Input index.
+ *  @param[in] index      Sample index in the stream.
+ *  @param[in] bit_depth  Bit depth of the samples.
+ *  @return Full scale pseudo-random sample, the same for the same input and index.
+ */
+static int32_t get_mixer_stream_sample(uint8_t input, uint32_t index, sac_bit_depth_t bit_depth)
+{
+    uint32_t hash = (index + 1) * 2654435761u;
+
+    hash ^= (hash >> 15) ^ ((uint32_t)input * 0x9E3779B9u);
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+
+    return (int32_t)hash >> (32 - bit_depth);
+}
+
+/** @brief Reference model of the mixer soft clip curve.
+ *
+ *  The curve is linear up to the knee, at 3/4 of full scale, then the excess above the
+ *  knee is compressed into the quarter of full scale left above it.
+ *
+ *  @param[in] sample      Sum of the scaled inputs.
+ *  @param[in] full_scale  Largest sample value of the bit depth.
+ *  @return Soft clipped sample, before rounding.
+ */
+static double reference_soft_clip(int64_t sample, int32_t full_scale)
+{
+    double knee = full_scale - (full_scale / 4);
+    double range = full_scale - knee;
+    double excess = fabs((double)sample) - knee;
+    double clipped;
+
+    if (excess <= 0) {
+        return (double)sample;
+    }
+    clipped = knee + (excess * range) / (excess + range);
+
+    return (sample > 0) ? clipped : -clipped;
+}
+
+/** @brief Check that the clock drift compensation passes the samples through without drift.
+ *
+ *  Without clock drift, the CDC must only delay the samples by the one frame its
+ *  linear interpolation keeps from the previous packet.
+ *
+ *  @param[in]  iteration_count  Number of timed packets.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the output matches the delayed input.
+ */
+static bool check_cdc_passthrough(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    const bench_case_t bench_case = {BENCH_STAGES_CDC, 240, AUDIO_16BITS, 2, 0};
+    bench_producer_instance_t reference = {.bit_depth = AUDIO_16BITS};
+    sac_error_t audio_err;
+    bool match = true;
+
+    consumer_instance.record = check_record;
+    run_bench_case(&bench_case, iteration_count, elapsed_ns, &audio_err);
+    consumer_instance.record = NULL;
+    if ((audio_err != SAC_ERR_NONE) || (consumer_instance.packet_count < BENCH_GOLDEN_PACKET_COUNT)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < consumer_instance.record_count; i++) {
+        if (i < bench_case.channel_count) {
+            match = match && (check_record[i] == 0);
+        } else {
+            match = match && (check_record[i] == (int16_t)generate_sample(&reference));
+        }
+    }
+
+    return match;
+}
+
+/** @brief Check that the payload CRC catches corrupted payloads over an encapsulated link.
+ *
+ *  One payload bit is flipped every CHECK_CRC_CORRUPTION_PERIOD packets. Every one of
+ *  them must be counted as corrupted and muted, and no other packet.
+ *
+ *  @param[in]  iteration_count  Number of timed packets.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if exactly the corrupted packets are detected.
+ */
+static bool check_payload_crc(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    const bench_case_t bench_case = {BENCH_STAGES_LINK_CRC, 240, AUDIO_16BITS, 2, 0};
+    sac_error_t audio_err;
+    bool match;
+
+    link_instance.corruption_period = CHECK_CRC_CORRUPTION_PERIOD;
+    run_bench_case(&bench_case, iteration_count, elapsed_ns, &audio_err);
+    link_instance.corruption_period = 0;
+    if (audio_err != SAC_ERR_NONE) {
+        return false;
+    }
+
+    match = (sac_pipeline_get_producer_payload_corrupted_count(pipeline) ==
+             (link_instance.packet_count / CHECK_CRC_CORRUPTION_PERIOD));
+    match = match && (sac_pipeline_get_producer_packets_corrupted_count(pipeline) == 0);
+    /* The consumer got the packets in the order they were sent */
+    match = match && (consumer_instance.silent_packet_count ==
+                      (consumer_instance.packet_count / CHECK_CRC_CORRUPTION_PERIOD));
+
+    return match;
+}
+
+/** @brief Check the equalizer frequency response against the analog prototype of its band.
+ *
+ *  A single peaking band is measured with tones below, at and above its center frequency,
+ *  on 16-bit samples filtered in Q15 and on 24-bit samples filtered in Q31.
+ *
+ *  @param[in]  iteration_count  Number of timed calls, on 16-bit samples.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if every gain is within tolerance of the reference.
+ */
+static bool check_eq_response(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const sac_bit_depth_t bit_depths[] = {AUDIO_16BITS, AUDIO_24BITS};
+    static const double frequencies_hz[] = {100.0, 1000.0, 10000.0};
+    audio_eq_cmsis_instance_t instance;
+    uint8_t buffer[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE];
+    int32_t samples[CHECK_FRAME_COUNT];
+    int32_t amplitude;
+    uint16_t size;
+    double gain, snr_db, tolerance_db;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t depth = 0; depth < (sizeof(bit_depths) / sizeof(bit_depths[0])); depth++) {
+        amplitude = (int32_t)(CHECK_TONE_LEVEL * (1 << (bit_depths[depth] - 1)));
+        size = CHECK_FRAME_COUNT * ((bit_depths[depth] == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE);
+        tolerance_db = (bit_depths[depth] == AUDIO_16BITS) ? CHECK_EQ_TOLERANCE_Q15_DB : CHECK_EQ_TOLERANCE_Q31_DB;
+
+        for (size_t f = 0; f < (sizeof(frequencies_hz) / sizeof(frequencies_hz[0])); f++) {
+            memset(&instance, 0, sizeof(instance));
+            instance.cfg.bit_depth = bit_depths[depth];
+            instance.cfg.channel_count = 1;
+            instance.cfg.payload_size = size;
+            instance.cfg.sample_rate = BENCH_SAMPLE_RATE;
+            instance.cfg.band_count = 1;
+            instance.cfg.band[0] = (audio_eq_band_cfg_t){AUDIO_EQ_PEAKING, CHECK_EQ_FREQUENCY_HZ, CHECK_EQ_Q,
+                                                         CHECK_EQ_GAIN_DB};
+            mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+            audio_eq_cmsis_init(&instance, &check_mem_pool);
+
+            for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+                generate_tone(samples, CHECK_FRAME_COUNT, packet * CHECK_FRAME_COUNT, frequencies_hz[f],
+                              BENCH_SAMPLE_RATE, amplitude);
+                store_samples(bit_depths[depth], samples, CHECK_FRAME_COUNT, buffer);
+                audio_eq_cmsis_process(&instance, NULL, buffer, size, buffer);
+                if (packet >= (CHECK_PACKET_COUNT - CHECK_SETTLED_PACKET_COUNT)) {
+                    load_samples(bit_depths[depth], buffer, CHECK_FRAME_COUNT,
+                                 &check_record[(packet - (CHECK_PACKET_COUNT - CHECK_SETTLED_PACKET_COUNT)) *
+                                               CHECK_FRAME_COUNT]);
+                }
+            }
+            measure_tone(check_record, CHECK_SETTLED_PACKET_COUNT * CHECK_FRAME_COUNT, frequencies_hz[f],
+                         BENCH_SAMPLE_RATE, &gain, &snr_db);
+            gain = 20.0 * log10(gain / amplitude);
+            match = match && (fabs(gain - reference_peaking_gain_db(frequencies_hz[f])) <= tolerance_db);
+
+            if ((bit_depths[depth] == AUDIO_16BITS) && (frequencies_hz[f] == CHECK_EQ_FREQUENCY_HZ)) {
+                start_ns = get_time_ns();
+                for (uint32_t i = 0; i < iteration_count; i++) {
+                    audio_eq_cmsis_process(&instance, NULL, buffer, size, buffer);
+                }
+                *elapsed_ns = get_time_ns() - start_ns;
+            }
+            audio_eq_cmsis_deinit(&instance);
+        }
+    }
+
+    return match;
+}
+
+/** @brief Check that changing the equalizer and limiter settings mid-stream does not click.
+ *
+ *  A tone is boosted into the limiter, then the band is changed to a cut and the limiter
+ *  threshold lowered while the tone plays. As the output level only goes down, the second
+ *  difference of the samples out may not exceed its largest value before the change. The
+ *  output must then settle to the new band gain.
+ *
+ *  @param[in]  iteration_count  Number of timed calls, with the settings changed on every call.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the output stays continuous and settles to the new gain.
+ */
+static bool check_eq_swap(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const sac_bit_depth_t bit_depths[] = {AUDIO_16BITS, AUDIO_24BITS};
+    const uint32_t swap_start = (CHECK_EQ_SWAP_PACKET_COUNT / 2) * CHECK_FRAME_COUNT;
+    const uint32_t record_count = CHECK_EQ_SWAP_PACKET_COUNT * CHECK_FRAME_COUNT;
+    audio_eq_cmsis_instance_t instance;
+    uint8_t buffer[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE];
+    int32_t samples[CHECK_FRAME_COUNT];
+    int32_t amplitude;
+    uint16_t size;
+    int64_t step, max_step_before, max_step_after; /* Second differences of the samples out */
+    double gain, snr_db;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t depth = 0; depth < (sizeof(bit_depths) / sizeof(bit_depths[0])); depth++) {
+        amplitude = (int32_t)(CHECK_EQ_SWAP_LEVEL * (1 << (bit_depths[depth] - 1)));
+        size = CHECK_FRAME_COUNT * ((bit_depths[depth] == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE);
+
+        memset(&instance, 0, sizeof(instance));
+        instance.cfg.bit_depth = bit_depths[depth];
+        instance.cfg.channel_count = 1;
+        instance.cfg.payload_size = size;
+        instance.cfg.sample_rate = BENCH_SAMPLE_RATE;
+        instance.cfg.band_count = 1;
+        instance.cfg.band[0] = (audio_eq_band_cfg_t){AUDIO_EQ_PEAKING, CHECK_EQ_FREQUENCY_HZ, CHECK_EQ_Q,
+                                                     CHECK_EQ_GAIN_DB};
+        instance.cfg.limiter_threshold_db = CHECK_EQ_SWAP_LIMITER_DB;
+        instance.cfg.limiter_release_ms = CHECK_EQ_SWAP_RELEASE_MS;
+        mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+        audio_eq_cmsis_init(&instance, &check_mem_pool);
+
+        for (uint32_t packet = 0; packet < CHECK_EQ_SWAP_PACKET_COUNT; packet++) {
+            if ((packet * CHECK_FRAME_COUNT) == swap_start) {
+                instance.cfg.band[0].gain_db = CHECK_EQ_SWAP_GAIN_DB;
+                instance.cfg.limiter_threshold_db = CHECK_EQ_SWAP_GAIN_DB;
+                match = match && (audio_eq_cmsis_ctrl(&instance, AUDIO_EQ_APPLY_BANDS, 0) == 1);
+                audio_eq_cmsis_ctrl(&instance, AUDIO_EQ_APPLY_LIMITER, 0);
+            }
+            generate_tone(samples, CHECK_FRAME_COUNT, packet * CHECK_FRAME_COUNT, CHECK_EQ_FREQUENCY_HZ,
+                          BENCH_SAMPLE_RATE, amplitude);
+            store_samples(bit_depths[depth], samples, CHECK_FRAME_COUNT, buffer);
+            audio_eq_cmsis_process(&instance, NULL, buffer, size, buffer);
+            load_samples(bit_depths[depth], buffer, CHECK_FRAME_COUNT, &check_record[packet * CHECK_FRAME_COUNT]);
+        }
+
+        /* Skip the first half of the steady state to let the filter and the limiter settle */
+        max_step_before = 0;
+        max_step_after = 0;
+        for (uint32_t i = swap_start / 2; i < record_count; i++) {
+            /* A click shows as a kink, far larger than the curvature of the tone */
+            step = llabs((int64_t)check_record[i] - 2 * (int64_t)check_record[i - 1] + check_record[i - 2]);
+            if (i < swap_start) {
+                max_step_before = (step > max_step_before) ? step : max_step_before;
+            } else {
+                max_step_after = (step > max_step_after) ? step : max_step_after;
+            }
+        }
+        match = match && (max_step_after <= max_step_before);
+
+        measure_tone(&check_record[record_count - CHECK_SETTLED_PACKET_COUNT * CHECK_FRAME_COUNT],
+                     CHECK_SETTLED_PACKET_COUNT * CHECK_FRAME_COUNT, CHECK_EQ_FREQUENCY_HZ, BENCH_SAMPLE_RATE,
+                     &gain, &snr_db);
+        match = match && (fabs(20.0 * log10(gain / amplitude) - CHECK_EQ_SWAP_GAIN_DB) <= CHECK_EQ_TOLERANCE_Q15_DB);
+
+        if (bit_depths[depth] == AUDIO_16BITS) {
+            start_ns = get_time_ns();
+            for (uint32_t i = 0; i < iteration_count; i++) {
+                instance.cfg.band[0].gain_db = (i & 1) ? CHECK_EQ_SWAP_GAIN_DB : CHECK_EQ_GAIN_DB;
+                audio_eq_cmsis_ctrl(&instance, AUDIO_EQ_APPLY_BANDS, 0);
+                audio_eq_cmsis_process(&instance, NULL, buffer, size, buffer);
+            }
+            *elapsed_ns = get_time_ns() - start_ns;
+        }
+        audio_eq_cmsis_deinit(&instance);
+    }
+
+    return match;
+}
+
+/** @brief Check that the equalizer stays disabled when its memory can not be allocated.
+ *
+ *  The stage is initialized from pools growing by CHECK_OOM_POOL_STEP bytes until its
+ *  allocations succeed. Every failed initialization must give its memory back, report the
+ *  stage disabled and leave the audio untouched.
+ *
+ *  @param[in]  iteration_count  Number of timed initializations, from a pool too small to succeed.
+ *  @param[out] elapsed_ns       Time spent in the timed initializations, in nanoseconds.
+ *  @return True if every failed initialization leaves the stage disabled and the pool empty.
+ */
+static bool check_eq_out_of_memory(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    audio_eq_cmsis_instance_t instance;
+    uint8_t buffer[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE * 2];
+    uint8_t reference[sizeof(buffer)];
+    size_t pool_size = 0;
+    uint64_t start_ns;
+    bool match = true;
+
+    for (size_t i = 0; i < sizeof(reference); i++) {
+        reference[i] = (uint8_t)(i * 7);
+    }
+    memset(&instance, 0, sizeof(instance));
+    instance.cfg.bit_depth = AUDIO_24BITS;
+    instance.cfg.channel_count = 2;
+    instance.cfg.payload_size = sizeof(buffer);
+    instance.cfg.sample_rate = BENCH_SAMPLE_RATE;
+    instance.cfg.band_count = 2;
+    instance.cfg.band[0] = (audio_eq_band_cfg_t){AUDIO_EQ_PEAKING, CHECK_EQ_FREQUENCY_HZ, CHECK_EQ_Q, CHECK_EQ_GAIN_DB};
+    instance.cfg.band[1] = instance.cfg.band[0];
+
+    do {
+        mem_pool_init(&check_mem_pool, check_memory_pool, pool_size);
+        audio_eq_cmsis_init(&instance, &check_mem_pool);
+        if (audio_eq_cmsis_ctrl(&instance, AUDIO_EQ_GET_STATE, 0) == 0) {
+            memcpy(buffer, reference, sizeof(buffer));
+            match = match && (mem_pool_get_owner_bytes(&check_mem_pool, SAC_MEM_POOL_OWNER_PROCESSING) == 0);
+            match = match && (audio_eq_cmsis_ctrl(&instance, AUDIO_EQ_APPLY_BANDS, 0) == 0);
+            match = match && (audio_eq_cmsis_process(&instance, NULL, buffer, sizeof(buffer), buffer) == 0);
+            match = match && (memcmp(buffer, reference, sizeof(buffer)) == 0);
+            pool_size += CHECK_OOM_POOL_STEP;
+        } else {
+            audio_eq_cmsis_deinit(&instance);
+            break;
+        }
+    } while (pool_size <= sizeof(check_memory_pool));
+    /* The stage must fit in the largest pool */
+    match = match && (pool_size > 0) && (pool_size <= sizeof(check_memory_pool));
+
+    mem_pool_init(&check_mem_pool, check_memory_pool, pool_size - CHECK_OOM_POOL_STEP);
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < iteration_count; i++) {
+        audio_eq_cmsis_init(&instance, &check_mem_pool);
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+    match = match && (mem_pool_get_owner_bytes(&check_mem_pool, SAC_MEM_POOL_OWNER_PROCESSING) == 0);
+
+    return match;
+}
+
+/** @brief Check the sampling rate converter on a tone.
+ *
+ *  A tone converted from BENCH_SAMPLE_RATE to BENCH_SRC_OUTPUT_RATE must keep its amplitude
+ *  and come out clean, on 16-bit and 24-bit samples.
+ *
+ *  @param[in]  iteration_count  Number of timed calls, on 16-bit samples.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the gain and the signal to noise ratio are within tolerance.
+ */
+static bool check_src_tone(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const sac_bit_depth_t bit_depths[] = {AUDIO_16BITS, AUDIO_24BITS};
+    audio_src_rational_instance_t instance;
+    uint8_t buffer_in[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE];
+    uint8_t buffer_out[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE];
+    int32_t samples[CHECK_FRAME_COUNT];
+    uint32_t record_count;
+    int32_t amplitude;
+    uint16_t size, size_out;
+    uint8_t word_size;
+    double gain, snr_db;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t depth = 0; depth < (sizeof(bit_depths) / sizeof(bit_depths[0])); depth++) {
+        amplitude = (int32_t)(CHECK_TONE_LEVEL * (1 << (bit_depths[depth] - 1)));
+        word_size = (bit_depths[depth] == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE;
+        size = CHECK_FRAME_COUNT * word_size;
+
+        memset(&instance, 0, sizeof(instance));
+        instance.cfg.input_sample_rate = BENCH_SAMPLE_RATE;
+        instance.cfg.output_sample_rate = BENCH_SRC_OUTPUT_RATE;
+        instance.cfg.bit_depth = bit_depths[depth];
+        instance.cfg.channel_count = 1;
+        instance.cfg.payload_size = size;
+        mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+        audio_src_rational_init(&instance, &check_mem_pool);
+
+        record_count = 0;
+        for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+            generate_tone(samples, CHECK_FRAME_COUNT, packet * CHECK_FRAME_COUNT, CHECK_SRC_TONE_HZ,
+                          BENCH_SAMPLE_RATE, amplitude);
+            store_samples(bit_depths[depth], samples, CHECK_FRAME_COUNT, buffer_in);
+            size_out = audio_src_rational_process(&instance, NULL, buffer_in, size, buffer_out);
+            if (packet >= (CHECK_PACKET_COUNT - CHECK_SETTLED_PACKET_COUNT)) {
+                load_samples(bit_depths[depth], buffer_out, size_out / word_size, &check_record[record_count]);
+                record_count += size_out / word_size;
+            }
+        }
+        measure_tone(check_record, record_count, CHECK_SRC_TONE_HZ, BENCH_SRC_OUTPUT_RATE, &gain, &snr_db);
+        gain = 20.0 * log10(gain / amplitude);
+        match = match && (fabs(gain) <= CHECK_SRC_TOLERANCE_DB) && (snr_db >= CHECK_SRC_MIN_SNR_DB);
+
+        if (bit_depths[depth] == AUDIO_16BITS) {
+            start_ns = get_time_ns();
+            for (uint32_t i = 0; i < iteration_count; i++) {
+                audio_src_rational_process(&instance, NULL, buffer_in, size, buffer_out);
+            }
+            *elapsed_ns = get_time_ns() - start_ns;
+        }
+        audio_src_rational_deinit(&instance);
+    }
+
+    return match;
+}
+
+/** @brief Check the sampling rate converter passband and alias rejection with tone sweeps.
+ *
+ *  For every ratio, tones up to CHECK_SWEEP_PASSBAND_EDGE of the lowest Nyquist frequency
+ *  must keep their gain, and leave no image above that tone when interpolating. Tones above
+ *  CHECK_SWEEP_STOPBAND_EDGE of the output Nyquist frequency must not alias when decimating.
+ *
+ *  @param[in]  iteration_count  Number of timed calls, from 44.1 kHz to 48 kHz.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if every tone is within the passband and alias tolerances.
+ */
+static bool check_src_sweep(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const uint32_t ratios[][2] = {
+        {44100, 48000}, {48000, 44100}, {16000, 48000}, {48000, 16000}, {32000, 48000}, {48000, 32000},
+    };
+    static const double passband_steps[] = {0.05, 0.2, 0.4, CHECK_SWEEP_PASSBAND_EDGE};
+    static const double stopband_steps[] = {CHECK_SWEEP_STOPBAND_EDGE, 1.5, 1.8};
+    audio_src_rational_instance_t instance;
+    uint8_t buffer_in[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE] = {0};
+    uint8_t buffer_out[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE * 3];
+    int32_t amplitude = (int32_t)(CHECK_TONE_LEVEL * (1 << (AUDIO_24BITS - 1)));
+    uint32_t input_rate, output_rate, nyquist_hz, frequency_hz, count;
+    double gain, leak, snr_db;
+    uint64_t start_ns;
+    bool match = true;
+
+    *elapsed_ns = 0;
+    for (size_t r = 0; r < (sizeof(ratios) / sizeof(ratios[0])); r++) {
+        input_rate = ratios[r][0];
+        output_rate = ratios[r][1];
+        nyquist_hz = ((input_rate < output_rate) ? input_rate : output_rate) / 2;
+        count = output_rate / CHECK_SWEEP_BIN_HZ;
+
+        memset(&instance, 0, sizeof(instance));
+        instance.cfg.input_sample_rate = input_rate;
+        instance.cfg.output_sample_rate = output_rate;
+        instance.cfg.bit_depth = AUDIO_24BITS;
+        instance.cfg.channel_count = 1;
+        instance.cfg.payload_size = sizeof(buffer_in);
+        mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+        audio_src_rational_init(&instance, &check_mem_pool);
+
+        for (size_t step = 0; step < (sizeof(passband_steps) / sizeof(passband_steps[0])); step++) {
+            frequency_hz = (uint32_t)lround(passband_steps[step] * nyquist_hz / CHECK_SWEEP_BIN_HZ) *
+                           CHECK_SWEEP_BIN_HZ;
+            count = convert_tone(&instance, frequency_hz, amplitude, count);
+            measure_tone(check_record, count, frequency_hz, output_rate, &gain, &snr_db);
+            match = match && (fabs(20.0 * log10(gain / amplitude)) <= CHECK_SWEEP_PASSBAND_DB);
+            if (input_rate < output_rate) {
+                measure_tone(check_record, count, fold_frequency(input_rate - frequency_hz, output_rate),
+                             output_rate, &leak, &snr_db);
+                match = match && ((20.0 * log10(leak / gain)) <= CHECK_SWEEP_ALIAS_DB);
+            }
+        }
+        for (size_t step = 0; step < (sizeof(stopband_steps) / sizeof(stopband_steps[0])); step++) {
+            frequency_hz = (uint32_t)lround(stopband_steps[step] * nyquist_hz / CHECK_SWEEP_BIN_HZ) *
+                           CHECK_SWEEP_BIN_HZ;
+            if ((input_rate < output_rate) || (frequency_hz >= (input_rate / 2))) {
+                continue;
+            }
+            count = convert_tone(&instance, frequency_hz, amplitude, count);
+            measure_tone(check_record, count, fold_frequency(frequency_hz, output_rate), output_rate, &leak,
+                         &snr_db);
+            match = match && ((20.0 * log10(leak / amplitude)) <= CHECK_SWEEP_ALIAS_DB);
+        }
+
+        if (r == 0) {
+            start_ns = get_time_ns();
+            for (uint32_t i = 0; i < iteration_count; i++) {
+                audio_src_rational_process(&instance, NULL, buffer_in, sizeof(buffer_in), buffer_out);
+            }
+            *elapsed_ns = get_time_ns() - start_ns;
+        }
+        audio_src_rational_deinit(&instance);
+    }
+
+    return match;
+}
+
+/** @brief Check that the sampling rate converter fails cleanly when its memory can not be allocated.
+ *
+ *  The stage is initialized from pools growing by CHECK_OOM_POOL_STEP bytes until its
+ *  allocations succeed. Every failed initialization must give its memory back and report
+ *  the ratio unsupported, so the stage does not convert.
+ *
+ *  @param[in]  iteration_count  Number of timed initializations, from a pool too small to succeed.
+ *  @param[out] elapsed_ns       Time spent in the timed initializations, in nanoseconds.
+ *  @return True if every failed initialization leaves the stage disabled and the pool empty.
+ */
+static bool check_src_out_of_memory(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    audio_src_rational_instance_t instance;
+    uint8_t buffer_in[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE * 2];
+    uint8_t buffer_out[sizeof(buffer_in) * 2];
+    size_t pool_size = 0;
+    uint64_t start_ns;
+    bool match = true;
+
+    memset(buffer_in, 0, sizeof(buffer_in));
+    memset(&instance, 0, sizeof(instance));
+    instance.cfg.input_sample_rate = 44100;
+    instance.cfg.output_sample_rate = 48000;
+    instance.cfg.bit_depth = AUDIO_24BITS;
+    instance.cfg.channel_count = 2;
+    instance.cfg.payload_size = sizeof(buffer_in);
+
+    do {
+        mem_pool_init(&check_mem_pool, check_memory_pool, pool_size);
+        audio_src_rational_init(&instance, &check_mem_pool);
+        if (audio_src_rational_ctrl(&instance, AUDIO_SRC_RATIONAL_GET_INTERPOLATION, 0) == 0) {
+            match = match && (mem_pool_get_owner_bytes(&check_mem_pool, SAC_MEM_POOL_OWNER_PROCESSING) == 0);
+            match = match && (audio_src_rational_ctrl(&instance, AUDIO_SRC_RATIONAL_GET_DECIMATION, 0) == 0);
+            match = match && (audio_src_rational_process(&instance, NULL, buffer_in, sizeof(buffer_in),
+                                                         buffer_out) == 0);
+            pool_size += CHECK_OOM_POOL_STEP;
+        } else {
+            audio_src_rational_deinit(&instance);
+            break;
+        }
+    } while (pool_size <= sizeof(check_memory_pool));
+    /* The stage must fit in the largest pool */
+    match = match && (pool_size > 0) && (pool_size <= sizeof(check_memory_pool));
+
+    mem_pool_init(&check_mem_pool, check_memory_pool, pool_size - CHECK_OOM_POOL_STEP);
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < iteration_count; i++) {
+        audio_src_rational_init(&instance, &check_mem_pool);
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+    match = match && (mem_pool_get_owner_bytes(&check_mem_pool, SAC_MEM_POOL_OWNER_PROCESSING) == 0);
+
+    return match;
+}
+
+/** @brief Convert a tone and record the samples out once the filter settled.
+ *
+ *  @param[in] instance      SRC rational instance, with 24-bit mono samples.
+ *  @param[in] frequency_hz  Frequency of the tone.
+ *  @param[in] amplitude     Amplitude of the tone.
+ *  @param[in] count         Number of samples out to record in check_record.
+ *  @return Number of samples out recorded.
+ */
+static uint32_t convert_tone(audio_src_rational_instance_t *instance, uint32_t frequency_hz, int32_t amplitude,
+                             uint32_t count)
+{
+    uint8_t buffer_in[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE];
+    uint8_t buffer_out[CHECK_FRAME_COUNT * AUDIO_32BITS_BYTE * 3];
+    int32_t samples_in[CHECK_FRAME_COUNT];
+    int32_t samples_out[CHECK_FRAME_COUNT * 3];
+    uint32_t start = 0;
+    uint32_t output_count = 0;
+    uint16_t frame_count;
+
+    audio_src_rational_ctrl(instance, AUDIO_SRC_RATIONAL_RESET, 0);
+    while (output_count < (CHECK_SWEEP_SETTLE_FRAMES + count)) {
+        generate_tone(samples_in, CHECK_FRAME_COUNT, start, frequency_hz, instance->cfg.input_sample_rate,
+                      amplitude);
+        start += CHECK_FRAME_COUNT;
+        store_samples(AUDIO_24BITS, samples_in, CHECK_FRAME_COUNT, buffer_in);
+        frame_count = audio_src_rational_process(instance, NULL, buffer_in, sizeof(buffer_in), buffer_out) /
+                      AUDIO_32BITS_BYTE;
+        load_samples(AUDIO_24BITS, buffer_out, frame_count, samples_out);
+        for (uint16_t i = 0; i < frame_count; i++, output_count++) {
+            if ((output_count >= CHECK_SWEEP_SETTLE_FRAMES) &&
+                (output_count < (CHECK_SWEEP_SETTLE_FRAMES + count))) {
+                check_record[output_count - CHECK_SWEEP_SETTLE_FRAMES] = samples_out[i];
+            }
+        }
+    }
+
+    return count;
+}
+
+/** @brief Get the frequency a tone shows at once sampled.
+ *
+ *  @param[in] frequency_hz  Frequency of the tone.
+ *  @param[in] sample_rate   Sampling rate, in Hz.
+ *  @return Frequency between 0 and the Nyquist frequency.
+ */
+static uint32_t fold_frequency(uint32_t frequency_hz, uint32_t sample_rate)
+{
+    frequency_hz %= sample_rate;
+
+    return (frequency_hz > (sample_rate / 2)) ? (sample_rate - frequency_hz) : frequency_hz;
+}
+
+/** @brief Check the packet loss concealment on a periodic signal.
+ *
+ *  Once the history holds the tone, the packets concealed within the hold time must follow
+ *  the true continuation of the tone.
+ *
+ *  @param[in]  iteration_count  Number of timed calls.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if the concealment is close enough to the true continuation.
+ */
+static bool check_plc_continuation(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    audio_plc_instance_t instance = {0};
+    uint8_t buffer[CHECK_FRAME_COUNT * AUDIO_16BITS_BYTE];
+    int32_t samples[CHECK_FRAME_COUNT];
+    int32_t expected[CHECK_PLC_CONCEAL_COUNT * CHECK_FRAME_COUNT];
+    int32_t amplitude = (int32_t)(CHECK_TONE_LEVEL * (1 << (AUDIO_16BITS - 1)));
+    uint16_t size = sizeof(buffer);
+    uint32_t packet;
+    uint64_t start_ns;
+    bool match = true;
+
+    instance.cfg.bit_depth = AUDIO_16BITS;
+    instance.cfg.channel_count = 1;
+    instance.cfg.payload_size = size;
+    instance.cfg.sample_rate = BENCH_SAMPLE_RATE;
+    instance.cfg.hold_ms = BENCH_PLC_HOLD_MS;
+    instance.cfg.fade_ms = BENCH_PLC_FADE_MS;
+    mem_pool_init(&check_mem_pool, check_memory_pool, sizeof(check_memory_pool));
+    audio_plc_init(&instance, &check_mem_pool);
+
+    for (packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+        generate_tone(samples, CHECK_FRAME_COUNT, packet * CHECK_FRAME_COUNT, CHECK_PLC_TONE_HZ,
+                      BENCH_SAMPLE_RATE, amplitude);
+        store_samples(AUDIO_16BITS, samples, CHECK_FRAME_COUNT, buffer);
+        audio_plc_process(&instance, NULL, buffer, size, buffer);
+    }
+    for (uint32_t i = 0; i < CHECK_PLC_CONCEAL_COUNT; i++) {
+        generate_tone(&expected[i * CHECK_FRAME_COUNT], CHECK_FRAME_COUNT, (packet + i) * CHECK_FRAME_COUNT,
+                      CHECK_PLC_TONE_HZ, BENCH_SAMPLE_RATE, amplitude);
+        match = match && (audio_plc_conceal(&instance, buffer, size) == size);
+        load_samples(AUDIO_16BITS, buffer, CHECK_FRAME_COUNT, &check_record[i * CHECK_FRAME_COUNT]);
+    }
+    match = match && (get_snr_db(expected, check_record, CHECK_PLC_CONCEAL_COUNT * CHECK_FRAME_COUNT) >=
+                      CHECK_PLC_MIN_SNR_DB);
+
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < iteration_count; i++) {
+        audio_plc_process(&instance, NULL, buffer, size, buffer);
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+    audio_plc_deinit(&instance);
+
+    return match;
+}
+
+/** @brief Check the 4-bit ADPCM codec coding one sample per call.
+ *
+ *  @param[in]  iteration_count  Number of timed packets encoded then decoded.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the codec reaches its signal to noise ratio.
+ */
+static bool check_adpcm_per_sample(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_adpcm(ADPCM_CODE_SIZE_MAX, true, iteration_count, elapsed_ns);
+}
+
+/** @brief Check the 4-bit ADPCM block codec.
+ *
+ *  @param[in]  iteration_count  Number of timed packets encoded then decoded.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the codec matches the per-sample codec.
+ */
+static bool check_adpcm_block(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_adpcm(ADPCM_CODE_SIZE_MAX, false, iteration_count, elapsed_ns);
+}
+
+/** @brief Check the 3-bit packed ADPCM block codec.
+ *
+ *  @param[in]  iteration_count  Number of timed packets encoded then decoded.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the codec reaches its signal to noise ratio.
+ */
+static bool check_adpcm_packed_3bits(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_adpcm(3, false, iteration_count, elapsed_ns);
+}
+
+/** @brief Check the 2-bit packed ADPCM block codec.
+ *
+ *  @param[in]  iteration_count  Number of timed packets encoded then decoded.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the codec reaches its signal to noise ratio.
+ */
+static bool check_adpcm_packed_2bits(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    return check_adpcm(ADPCM_CODE_SIZE_MIN, false, iteration_count, elapsed_ns);
+}
+
+/** @brief Check an ADPCM codec against the samples it codes.
+ *
+ *  The codec states are carried from packet to packet. The decoded samples must reach
+ *  the same signal to noise ratio as with the multi-rate codecs. The 4-bit block codec
+ *  must also output the same codes and samples as the per-sample codec, so their
+ *  timings compare the same work.
+ *
+ *  @param[in]  code_size        Code size in bits, ADPCM_CODE_SIZE_MIN up to ADPCM_CODE_SIZE_MAX.
+ *  @param[in]  per_sample       Code with adpcm_encode() and adpcm_decode() instead of the block functions.
+ *  @param[in]  iteration_count  Number of timed packets encoded then decoded.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the codec reaches its signal to noise ratio and matches the per-sample codec.
+ */
+static bool check_adpcm(uint8_t code_size, bool per_sample, uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    static const double min_snr_db[ADPCM_CODE_SIZE_MAX + 1] = {[2] = 16.0, [3] = 17.0, [4] = 20.0};
+    bench_producer_instance_t generator = {.bit_depth = AUDIO_16BITS};
+    adpcm_state_t encoder, decoder;
+    adpcm_state_t reference_encoder, reference_decoder;
+    int16_t pcm[CHECK_FRAME_COUNT];
+    int16_t reference_pcm[CHECK_FRAME_COUNT];
+    uint8_t codes[ADPCM_PACKED_NB_BYTES(CHECK_FRAME_COUNT, ADPCM_CODE_SIZE_MAX)];
+    uint8_t reference_codes[sizeof(codes)];
+    int32_t samples[CHECK_PACKET_COUNT * CHECK_FRAME_COUNT];
+    uint64_t start_ns;
+    bool match = true;
+
+    for (uint32_t i = 0; i < (CHECK_PACKET_COUNT * CHECK_FRAME_COUNT); i++) {
+        samples[i] = (int16_t)generate_sample(&generator);
+    }
+    adpcm_init_state(&encoder);
+    adpcm_init_state(&decoder);
+    adpcm_init_state(&reference_encoder);
+    adpcm_init_state(&reference_decoder);
+
+    for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+        for (uint16_t i = 0; i < CHECK_FRAME_COUNT; i++) {
+            pcm[i] = (int16_t)samples[packet * CHECK_FRAME_COUNT + i];
+        }
+        if ((code_size == ADPCM_CODE_SIZE_MAX) && !per_sample) {
+            encode_adpcm_packet(code_size, true, pcm, reference_codes, &reference_encoder);
+            decode_adpcm_packet(code_size, true, reference_codes, reference_pcm, &reference_decoder);
+        }
+        encode_adpcm_packet(code_size, per_sample, pcm, codes, &encoder);
+        decode_adpcm_packet(code_size, per_sample, codes, pcm, &decoder);
+        if ((code_size == ADPCM_CODE_SIZE_MAX) && !per_sample) {
+            match = match && (memcmp(codes, reference_codes, sizeof(codes)) == 0);
+            match = match && (memcmp(pcm, reference_pcm, sizeof(pcm)) == 0);
+        }
+        for (uint16_t i = 0; i < CHECK_FRAME_COUNT; i++) {
+            check_record[packet * CHECK_FRAME_COUNT + i] = pcm[i];
+        }
+    }
+    match = match && (get_snr_db(samples, check_record, CHECK_PACKET_COUNT * CHECK_FRAME_COUNT) >=
+                      min_snr_db[code_size]);
+
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < iteration_count; i++) {
+        encode_adpcm_packet(code_size, per_sample, pcm, codes, &encoder);
+        decode_adpcm_packet(code_size, per_sample, codes, pcm, &decoder);
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+
+    return match;
+}
+
+/** @brief Encode a packet of CHECK_FRAME_COUNT mono samples with ADPCM.
+ *
+ *  Per-sample codes are packed two per byte, the first in the 4 lsb, like the block codec.
+ *
+ *  @param[in]  code_size   Code size in bits.
+ *  @param[in]  per_sample  Encode one sample per call, with a code size of ADPCM_CODE_SIZE_MAX.
+ *  @param[in]  pcm         16-bit PCM samples.
+ *  @param[out] codes       Packed ADPCM codes.
+ *  @param[out] state       ADPCM encoder state.
+ */
+static void encode_adpcm_packet(uint8_t code_size, bool per_sample, const int16_t *pcm, uint8_t *codes,
+                                adpcm_state_t *state)
+{
+    if (per_sample) {
+        memset(codes, 0, ADPCM_PACKED_NB_BYTES(CHECK_FRAME_COUNT, ADPCM_CODE_SIZE_MAX));
+        for (uint16_t i = 0; i < CHECK_FRAME_COUNT; i++) {
+            codes[i / 2] |= adpcm_encode(pcm[i], state) << (4 * (i & 1));
+        }
+    } else if (code_size == ADPCM_CODE_SIZE_MAX) {
+        adpcm_encode_block(pcm, codes, CHECK_FRAME_COUNT, state);
+    } else {
+        adpcm_encode_block_packed(pcm, codes, CHECK_FRAME_COUNT, 1, code_size, state);
+    }
+}
+
+/** @brief Decode a packet of CHECK_FRAME_COUNT mono samples with ADPCM.
+ *
+ *  @param[in]  code_size   Code size in bits.
+ *  @param[in]  per_sample  Decode one sample per call, with a code size of ADPCM_CODE_SIZE_MAX.
+ *  @param[in]  codes       Packed ADPCM codes, as written by encode_adpcm_packet().
+ *  @param[out] pcm         16-bit PCM samples.
+ *  @param[out] state       ADPCM decoder state.
+ */
+static void decode_adpcm_packet(uint8_t code_size, bool per_sample, const uint8_t *codes, int16_t *pcm,
+                                adpcm_state_t *state)
+{
+    if (per_sample) {
+        for (uint16_t i = 0; i < CHECK_FRAME_COUNT; i++) {
+            pcm[i] = adpcm_decode((codes[i / 2] >> (4 * (i & 1))) & 0x0F, state);
+        }
+    } else if (code_size == ADPCM_CODE_SIZE_MAX) {
+        adpcm_decode_block(codes, pcm, CHECK_FRAME_COUNT, state);
+    } else {
+        adpcm_decode_block_packed(codes, pcm, CHECK_FRAME_COUNT, 1, code_size, state);
+    }
+}
+
+/** @brief Check the multi-rate codecs against the samples they code.
+ *
+ *  The lossless codec must give the samples back bit-exactly. Each ADPCM codec must
+ *  reach its minimum signal to noise ratio within its data rate.
+ *
+ *  @param[in]  iteration_count  Number of timed pack and unpack calls, with the ADPCM 4-bit codec.
+ *  @param[out] elapsed_ns       Time spent in the timed calls, in nanoseconds.
+ *  @return True if every codec is within its data rate and signal to noise ratio.
+ */
+static bool check_multi_rate_snr(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    /* Smallest signal to noise ratio and largest payload size of each codec, in bits per sample */
+    static const struct {
+        audio_compression_codec_t codec;
+        double min_snr_db;
+        uint8_t max_bits_per_sample;
+    } codecs[] = {
+        {AUDIO_COMPRESSION_CODEC_ADPCM_4BITS, 20.0, 4},
+        {AUDIO_COMPRESSION_CODEC_ADPCM_3BITS, 17.0, 3},
+        {AUDIO_COMPRESSION_CODEC_ADPCM_2BITS, 16.0, 2},
+        {AUDIO_COMPRESSION_CODEC_LOSSLESS, INFINITY, 16},
+    };
+    audio_compression_instance_t pack = {0};
+    audio_compression_instance_t unpack = {0};
+    bench_producer_instance_t generator = {.bit_depth = AUDIO_16BITS};
+    uint8_t buffer[CHECK_FRAME_COUNT * AUDIO_16BITS_BYTE];
+    uint8_t payload[CHECK_FRAME_COUNT * AUDIO_16BITS_BYTE + AUDIO_COMPRESSION_MULTI_RATE_OVERHEAD_MAX_SIZE];
+    int32_t samples[CHECK_PACKET_COUNT * CHECK_FRAME_COUNT];
+    uint16_t size = sizeof(buffer);
+    uint16_t payload_size;
+    uint64_t start_ns;
+    bool match = true;
+
+    for (uint32_t i = 0; i < (CHECK_PACKET_COUNT * CHECK_FRAME_COUNT); i++) {
+        samples[i] = (int16_t)generate_sample(&generator);
+    }
+
+    *elapsed_ns = 0;
+    for (size_t c = 0; c < (sizeof(codecs) / sizeof(codecs[0])); c++) {
+        pack.compression_mode = AUDIO_COMPRESSION_PACK_MULTI_RATE;
+        pack.channel_count = 1;
+        pack.codec = codecs[c].codec;
+        unpack.compression_mode = AUDIO_COMPRESSION_UNPACK_MULTI_RATE;
+        unpack.channel_count = 1;
+        unpack.max_payload_size = size;
+        audio_compression_init(&pack, NULL);
+        audio_compression_init(&unpack, NULL);
+
+        for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+            store_samples(AUDIO_16BITS, &samples[packet * CHECK_FRAME_COUNT], CHECK_FRAME_COUNT, buffer);
+            payload_size = audio_compression_process(&pack, NULL, buffer, size, payload);
+            match = match && (payload_size <= ((CHECK_FRAME_COUNT * codecs[c].max_bits_per_sample) / 8 +
+                                               AUDIO_COMPRESSION_MULTI_RATE_OVERHEAD_MAX_SIZE));
+            match = match && (audio_compression_process(&unpack, NULL, payload, payload_size, buffer) == size);
+            load_samples(AUDIO_16BITS, buffer, CHECK_FRAME_COUNT, &check_record[packet * CHECK_FRAME_COUNT]);
+        }
+        match = match && (get_snr_db(samples, check_record, CHECK_PACKET_COUNT * CHECK_FRAME_COUNT) >=
+                          codecs[c].min_snr_db);
+
+        if (codecs[c].codec == AUDIO_COMPRESSION_CODEC_ADPCM_4BITS) {
+            start_ns = get_time_ns();
+            for (uint32_t i = 0; i < iteration_count; i++) {
+                payload_size = audio_compression_process(&pack, NULL, buffer, size, payload);
+                audio_compression_process(&unpack, NULL, payload, payload_size, buffer);
+            }
+            *elapsed_ns = get_time_ns() - start_ns;
+        }
+    }
+
+    return match;
+}
+
+/** @brief Check the multi-rate lossless codec on incompressible audio.
+ *
+ *  Full scale white noise does not compress, so every payload falls back to the raw samples.
+ *  A packed payload must stay within AUDIO_COMPRESSION_MULTI_RATE_OVERHEAD_MAX_SIZE of the
+ *  samples, and the pipeline must fit it in its audio queue nodes and output the noise unchanged.
+ *
+ *  @param[in]  iteration_count  Number of timed packets.
+ *  @param[out] elapsed_ns       Time spent in the timed packets, in nanoseconds.
+ *  @return True if the payloads are within the bound and the output matches the input.
+ */
+static bool check_multi_rate_noise(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    const bench_case_t bench_case = {BENCH_STAGES_MULTI_RATE, 240, AUDIO_16BITS, 2, 0};
+    bench_producer_instance_t reference = {.bit_depth = AUDIO_16BITS, .white_noise = true};
+    audio_compression_instance_t pack = {0};
+    uint8_t buffer[240];
+    uint8_t payload[sizeof(buffer) + AUDIO_COMPRESSION_MULTI_RATE_OVERHEAD_MAX_SIZE];
+    sac_error_t audio_err;
+    bool match = true;
+
+    pack.compression_mode = AUDIO_COMPRESSION_PACK_MULTI_RATE;
+    pack.channel_count = bench_case.channel_count;
+    pack.codec = AUDIO_COMPRESSION_CODEC_LOSSLESS;
+    audio_compression_init(&pack, NULL);
+    for (uint32_t packet = 0; packet < CHECK_PACKET_COUNT; packet++) {
+        ep_bench_produce(&reference, buffer, sizeof(buffer));
+        match = match && (audio_compression_process(&pack, NULL, buffer, sizeof(buffer), payload) <=
+                          sizeof(payload));
+    }
+
+    reference = (bench_producer_instance_t){.bit_depth = AUDIO_16BITS, .white_noise = true};
+    producer_instance.white_noise = true;
+    consumer_instance.record = check_record;
+    run_bench_case(&bench_case, iteration_count, elapsed_ns, &audio_err);
+    consumer_instance.record = NULL;
+    producer_instance.white_noise = false;
+    if ((audio_err != SAC_ERR_NONE) || (consumer_instance.packet_count < BENCH_GOLDEN_PACKET_COUNT)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < consumer_instance.record_count; i++) {
+        match = match && (check_record[i] == (int16_t)generate_sample(&reference));
+    }
+
+    return match;
+}
+
+/** @brief Check that an audio pipeline can be destroyed and recreated in the same memory.
+ *
+ *  The pipeline, stage and endpoints of a digital volume control case are torn down and
+ *  rebuilt CHECK_RECREATE_COUNT times without reinitializing the Audio Core. Every teardown
+ *  must give all their memory back, and every rebuild must use as much and output the same
+ *  samples.
+ *
+ *  @param[in]  iteration_count  Number of packets run by each pipeline.
+ *  @param[out] elapsed_ns       Time spent tearing down and rebuilding, in nanoseconds.
+ *  @return True if the memory is reused and the output matches the golden checksum.
+ */
+static bool check_pipeline_recreate(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    const bench_case_t bench_case = {BENCH_STAGES_VOLUME, 240, AUDIO_16BITS, 2, 0xCD0DE868};
+    sac_error_t audio_err;
+    uint32_t allocated_bytes;
+    uint64_t start_ns;
+    bool match;
+
+    match = run_bench_case(&bench_case, iteration_count, elapsed_ns, &audio_err);
+    if (audio_err != SAC_ERR_NONE) {
+        return false;
+    }
+    allocated_bytes = sac_get_allocated_bytes();
+
+    *elapsed_ns = 0;
+    for (uint32_t i = 0; i < CHECK_RECREATE_COUNT; i++) {
+        start_ns = get_time_ns();
+        app_audio_core_deinit();
+        match = match && (sac_get_allocated_bytes() == 0);
+        app_audio_core_init(&bench_case, &audio_err);
+        *elapsed_ns += get_time_ns() - start_ns;
+        if (audio_err != SAC_ERR_NONE) {
+            return false;
+        }
+        match = match && (sac_get_allocated_bytes() == allocated_bytes);
+        match = match && run_bench_pipeline(&bench_case, iteration_count, &start_ns, &audio_err);
+        if (audio_err != SAC_ERR_NONE) {
+            return false;
+        }
+    }
+    /* Time a single teardown and rebuild */
+    *elapsed_ns = (*elapsed_ns * iteration_count) / CHECK_RECREATE_COUNT;
+
+    return match;
+}
+
+/** @brief Check that a processing stage without a free destination node lets the packet through.
+ *
+ *  Once the consumer started, every free node of the processing queue is taken after a
+ *  packet was produced. The sampling rate converter, which does not process in place, must
+ *  then be skipped and counted in the statistics, and the packet must reach the consumer
+ *  unconverted.
+ *
+ *  @param[in]  iteration_count  Number of packets the time per call is scaled to.
+ *  @param[out] elapsed_ns       Time spent processing the packet, scaled to iteration_count calls.
+ *  @return True if the stage is skipped and the packet consumed unconverted.
+ */
+static bool check_stage_without_free_node(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    const bench_case_t bench_case = {BENCH_STAGES_SRC, 240, AUDIO_16BITS, 1, 0};
+    const uint16_t sample_count = bench_case.payload_size / AUDIO_16BITS_BYTE;
+    bench_producer_instance_t reference = {.bit_depth = AUDIO_16BITS};
+    queue_critical_cfg_t queue_critical;
+    queue_node_t *taken_nodes[CHECK_TAKEN_NODE_MAX];
+    uint8_t taken_count = 0;
+    sac_error_t audio_err;
+    uint64_t start_ns;
+    bool match = true;
+
+    app_audio_core_critical_section_init(&queue_critical);
+    sac_init(queue_critical, audio_memory_pool, SAC_MEM_POOL_SIZE);
+    app_audio_core_init(&bench_case, &audio_err);
+    if (audio_err != SAC_ERR_NONE) {
+        return false;
+    }
+    sac_pipeline_start(pipeline);
+
+    /* The reference generator follows the producer */
+    for (uint32_t packet = 0; (packet < CHECK_PACKET_COUNT) && (consumer_instance.packet_count == 0); packet++) {
+        run_pipeline_cycle(pipeline, &audio_err);
+        for (uint16_t i = 0; i < sample_count; i++) {
+            generate_sample(&reference);
+        }
+    }
+    match = match && (audio_err == SAC_ERR_NONE) && (consumer_instance.packet_count > 0);
+
+    sac_pipeline_produce(pipeline, &audio_err);
+    while (taken_count < CHECK_TAKEN_NODE_MAX) {
+        taken_nodes[taken_count] = queue_get_free_node(producer->_free_queue);
+        if (taken_nodes[taken_count] == NULL) {
+            break;
+        }
+        taken_count++;
+    }
+    start_ns = get_time_ns();
+    sac_pipeline_process(pipeline, &audio_err);
+    *elapsed_ns = (get_time_ns() - start_ns) * iteration_count;
+    match = match && (audio_err == SAC_ERR_NONE);
+    for (uint8_t i = 0; i < taken_count; i++) {
+        queue_free_node(taken_nodes[i]);
+    }
+
+    /* Record only the packet processed without a free node, the last one queued */
+    while (queue_get_length(consumer->_queue) > 1) {
+        sac_pipeline_consume(pipeline, &audio_err);
+    }
+    consumer_instance.record = check_record;
+    sac_pipeline_consume(pipeline, &audio_err);
+    consumer_instance.record = NULL;
+    sac_pipeline_stop(pipeline);
+    match = match && (audio_err == SAC_ERR_NONE);
+
+    match = match && (sac_pipeline_get_stats(pipeline)->processing_stage_skipped_count == 1);
+    match = match && (consumer_instance.record_count == sample_count);
+    for (uint32_t i = 0; i < consumer_instance.record_count; i++) {
+        match = match && (check_record[i] == (int16_t)generate_sample(&reference));
+    }
+
+    return match;
+}
+
+/** @brief Check that removing a processing stage only unlinks stages of the pipeline.
+ *
+ *  Removing a NULL stage or a stage that is not part of the pipeline, including from an
+ *  empty pipeline, must fail and leave the chain unchanged. Removing the middle, first and
+ *  last stages must unlink only them.
+ *
+ *  @param[in]  iteration_count  Number of timed insertions and removals of the middle stage.
+ *  @param[out] elapsed_ns       Time spent inserting and removing, in nanoseconds.
+ *  @return True if every removal gives the expected error and chain.
+ */
+static bool check_stage_remove(uint32_t iteration_count, uint64_t *elapsed_ns)
+{
+    sac_pipeline_t chain_pipeline = {0};
+    sac_processing_t stage[4] = {0};
+    sac_processing_t *stage_a = &stage[0], *stage_b = &stage[1], *stage_c = &stage[2], *stranger = &stage[3];
+    sac_error_t audio_err;
+    uint64_t start_ns;
+    bool match = true;
+
+    for (uint8_t i = 0; i < (sizeof(stage) / sizeof(stage[0])); i++) {
+        stage[i]._initialized = true;
+    }
+    sac_pipeline_add_processing(&chain_pipeline, stage_a);
+    sac_pipeline_add_processing(&chain_pipeline, stage_b);
+    sac_pipeline_add_processing(&chain_pipeline, stage_c);
+
+    sac_pipeline_remove_processing(&chain_pipeline, stranger, &audio_err);
+    match = match && (audio_err == SAC_ERR_PIPELINE_CFG_INVALID);
+    match = match && check_stage_chain(&chain_pipeline, (sac_processing_t *[]){stage_a, stage_b, stage_c}, 3);
+    sac_pipeline_remove_processing(&chain_pipeline, NULL, &audio_err);
+    match = match && (audio_err == SAC_ERR_NULL_PTR);
+    match = match && check_stage_chain(&chain_pipeline, (sac_processing_t *[]){stage_a, stage_b, stage_c}, 3);
+
+    start_ns = get_time_ns();
+    for (uint32_t i = 0; i < iteration_count; i++) {
+        sac_pipeline_remove_processing(&chain_pipeline, stage_b, &audio_err);
+        sac_pipeline_insert_processing(&chain_pipeline, stage_b, stage_a, &audio_err);
+    }
+    *elapsed_ns = get_time_ns() - start_ns;
+    match = match && (audio_err == SAC_ERR_NONE);
+    match = match && check_stage_chain(&chain_pipeline, (sac_processing_t *[]){stage_a, stage_b, stage_c}, 3);
+
+    sac_pipeline_remove_processing(&chain_pipeline, stage_b, &audio_err);
+    match = match && (audio_err == SAC_ERR_NONE);
+    match = match && check_stage_chain(&chain_pipeline, (sac_processing_t *[]){stage_a, stage_c}, 2);
+    sac_pipeline_remove_processing(&chain_pipeline, stage_b, &audio_err);
+    match = match && (audio_err == SAC_ERR_PIPELINE_CFG_INVALID);
+    match = match && check_stage_chain(&chain_pipeline, (sac_processing_t *[]){stage_a, stage_c}, 2);
+    sac_pipeline_remove_processing(&chain_pipeline, stage_a, &audio_err);
+    match = match && (audio_err == SAC_ERR_NONE);
+    match = match && check_stage_chain(&chain_pipeline, (sac_processing_t *[]){stage_c}, 1);
+    sac_pipeline_remove_processing(&chain_pipeline, stage_c, &audio_err);
+    match = match && (audio_err == SAC_ERR_NONE);
+    match = match && check_stage_chain(&chain_pipeline, NULL, 0);
+    sac_pipeline_remove_processing(&chain_pipeline, stage_c, &audio_err);
+    match = match && (audio_err == SAC_ERR_PIPELINE_CFG_INVALID);
+    match = match && check_stage_chain(&chain_pipeline, NULL, 0);
+
+    return match;
+}
+
+/** @brief Check the processing stages chained in a pipeline.
+ *
+ *  @param[in] pipeline     Pipeline instance.
+ *  @param[in] stages       Expected stages, in order.
+ *  @param[in] stage_count  Number of expected stages.
+ *  @return True if the pipeline chains exactly the expected stages.
+ */
+static bool check_stage_chain(sac_pipeline_t *pipeline, sac_processing_t **stages, uint8_t stage_count)
+{
+    sac_processing_t *current_process = pipeline->process;
+
+    for (uint8_t i = 0; i < stage_count; i++) {
+        if (current_process != stages[i]) {
+            return false;
+        }
+        current_process = current_process->next_process;
+    }
+
+    return (current_process == NULL);
+}
+
+/** @brief Reference gain of the peaking band checked by check_eq_response().
+ *
+ *  The analog prototype of the band is mapped with the bilinear transform, as in the Audio EQ
+ *  Cookbook by Robert Bristow-Johnson, and evaluated in double precision.
+ *
+ *  @param[in] frequency_hz  Frequency to evaluate the gain at.
+ *  @return Gain in dB.
+ */
+static double reference_peaking_gain_db(double frequency_hz)
+{
+    double a = pow(10.0, CHECK_EQ_GAIN_DB / 40.0);
+    double w0 = 2.0 * M_PI * CHECK_EQ_FREQUENCY_HZ / BENCH_SAMPLE_RATE;
+    double alpha = sin(w0) / (2.0 * CHECK_EQ_Q);
+    double w = 2.0 * M_PI * frequency_hz / BENCH_SAMPLE_RATE;
+    double b[3] = {1.0 + alpha * a, -2.0 * cos(w0), 1.0 - alpha * a};
+    double den[3] = {1.0 + alpha / a, -2.0 * cos(w0), 1.0 - alpha / a};
+    double num_re = 0.0, num_im = 0.0, den_re = 0.0, den_im = 0.0;
+
+    for (int k = 0; k < 3; k++) {
+        num_re += b[k] * cos(k * w);
+        num_im -= b[k] * sin(k * w);
+        den_re += den[k] * cos(k * w);
+        den_im -= den[k] * sin(k * w);
+    }
+
+    return 10.0 * log10(((num_re * num_re) + (num_im * num_im)) / ((den_re * den_re) + (den_im * den_im)));
+}
+
+/** @brief Generate a tone.
+ *
+ *  @param[out] samples       Samples.
+ *  @param[in]  count         Number of samples.
+ *  @param[in]  start         Index in the tone of the first sample.
+ *  @param[in]  frequency_hz  Frequency of the tone.
+ *  @param[in]  sample_rate   Sampling rate, in Hz.
+ *  @param[in]  amplitude     Amplitude of the tone.
+ */
+static void generate_tone(int32_t *samples, uint16_t count, uint32_t start, double frequency_hz,
+                          uint32_t sample_rate, int32_t amplitude)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        samples[i] = (int32_t)lround(amplitude * sin(2.0 * M_PI * frequency_hz * (start + i) / sample_rate));
+    }
+}
+
+/** @brief Measure the amplitude of a tone and the noise around it.
+ *
+ *  The tone is fitted by least squares, so count should span a whole number of its periods.
+ *
+ *  @param[in]  samples       Samples.
+ *  @param[in]  count         Number of samples.
+ *  @param[in]  frequency_hz  Frequency of the tone.
+ *  @param[in]  sample_rate   Sampling rate, in Hz.
+ *  @param[out] amplitude     Amplitude of the tone.
+ *  @param[out] snr_db        Ratio of the tone to everything else, in dB.
+ */
+static void measure_tone(const int32_t *samples, uint32_t count, double frequency_hz, uint32_t sample_rate,
+                         double *amplitude, double *snr_db)
+{
+    double in_phase = 0.0, quadrature = 0.0;
+    double signal = 0.0, noise = 0.0;
+    double w = 2.0 * M_PI * frequency_hz / sample_rate;
+    double fit;
+
+    for (uint32_t i = 0; i < count; i++) {
+        in_phase += samples[i] * cos(w * i);
+        quadrature += samples[i] * sin(w * i);
+    }
+    in_phase *= 2.0 / count;
+    quadrature *= 2.0 / count;
+    for (uint32_t i = 0; i < count; i++) {
+        fit = (in_phase * cos(w * i)) + (quadrature * sin(w * i));
+        signal += fit * fit;
+        noise += (samples[i] - fit) * (samples[i] - fit);
+    }
+
+    *amplitude = sqrt((in_phase * in_phase) + (quadrature * quadrature));
+    *snr_db = (noise > 0.0) ? 10.0 * log10(signal / noise) : INFINITY;
+}
+
+/** @brief Get the signal to noise ratio of samples compared with their reference.
+ *
+ *  @param[in] reference  Reference samples.
+ *  @param[in] samples    Samples.
+ *  @param[in] count      Number of samples.
+ *  @return Ratio of the reference to the error, in dB, INFINITY if there is no error.
+ */
+static double get_snr_db(const int32_t *reference, const int32_t *samples, uint32_t count)
+{
+    double signal = 0.0, noise = 0.0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        signal += (double)reference[i] * reference[i];
+        noise += ((double)samples[i] - reference[i]) * ((double)samples[i] - reference[i]);
+    }
+
+    return (noise > 0.0) ? 10.0 * log10(signal / noise) : INFINITY;
+}
+
+/** @brief Saturate a sample to a bit depth.
+ *
+ *  @param[in] sample     Sample.
+ *  @param[in] bit_depth  Bit depth.
+ *  @return Saturated sample.
+ */
+static int32_t saturate(int64_t sample, uint8_t bit_depth)
+{
+    int64_t max = ((int64_t)1 << (bit_depth - 1)) - 1;
+
+    if (sample > max) {
+        return (int32_t)max;
+    } else if (sample < (-max - 1)) {
+        return (int32_t)(-max - 1);
+    }
+
+    return (int32_t)sample;
+}
+
+/** @brief Store samples in an audio payload.
+ *
+ *  @param[in]  bit_depth  Bit depth of the payload.
+ *  @param[in]  samples    Samples, right-justified and sign extended.
+ *  @param[in]  count      Number of samples.
+ *  @param[out] buffer     Audio payload.
+ */
+static void store_samples(sac_bit_depth_t bit_depth, const int32_t *samples, uint16_t count, uint8_t *buffer)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        if (bit_depth == AUDIO_16BITS) {
+            ((int16_t *)buffer)[i] = (int16_t)samples[i];
+        } else {
+            ((int32_t *)buffer)[i] = samples[i];
+        }
+    }
+}
+
+/** @brief Load samples from an audio payload.
+ *
+ *  @param[in]  bit_depth  Bit depth of the payload.
+ *  @param[in]  buffer     Audio payload.
+ *  @param[in]  count      Number of samples.
+ *  @param[out] samples    Samples, right-justified and sign extended.
+ */
+static void load_samples(sac_bit_depth_t bit_depth, const uint8_t *buffer, uint16_t count, int32_t *samples)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        if (bit_depth == AUDIO_16BITS) {
+            samples[i] = ((const int16_t *)buffer)[i];
+        } else {
+            samples[i] = ((const int32_t *)buffer)[i];
+        }
+    }
+}
+
+/** @brief Generate the next sample of a triangle wave with noise.
+ *
+ *  The wave is scaled to the instance bit depth, with noise down to the least significant bit.
+ *
+ *  @param[in] instance  Producer instance.
+ *  @return Sample, right-justified and sign extended.
+ */
+static int32_t generate_sample(bench_producer_instance_t *instance)
+{
+    uint8_t extra_bits = instance->bit_depth - AUDIO_16BITS;
+    int32_t triangle;
+    int32_t sample;
+
+    instance->lcg = (instance->lcg * 1664525) + 1013904223;
+    instance->phase = (instance->phase + 1) % BENCH_TRIANGLE_PERIOD;
+
+    if (instance->white_noise) {
+        return (int32_t)instance->lcg >> (32 - instance->bit_depth);
+    }
+
+    triangle = (instance->phase < (BENCH_TRIANGLE_PERIOD / 2)) ? instance->phase : (BENCH_TRIANGLE_PERIOD - instance->phase);
+    triangle -= BENCH_TRIANGLE_PERIOD / 4;
+    sample = (triangle * BENCH_TRIANGLE_GAIN) + (int32_t)(instance->lcg >> 22) - BENCH_NOISE_AMPLITUDE;
+
+    return (sample * (1 << extra_bits)) + (int32_t)((instance->lcg >> 8) & ((1 << extra_bits) - 1));
+}
+
+/** @brief Generator Endpoint's Produce action.
+ *
+ *  @param[in]  instance  Endpoint instance.
+ *  @param[out] samples   Produced samples.
+ *  @param[in]  size      Size of samples to produce in bytes.
+ *  @return Number of bytes produced.
+ */
+static uint16_t ep_bench_produce(void *instance, uint8_t *samples, uint16_t size)
+{
+    bench_producer_instance_t *inst = (bench_producer_instance_t *)instance;
+
+    if (inst->bit_depth == AUDIO_16BITS) {
+        for (uint16_t i = 0; i < (size / AUDIO_16BITS_BYTE); i++) {
+            ((int16_t *)samples)[i] = (int16_t)generate_sample(inst);
+        }
+    } else {
+        for (uint16_t i = 0; i < (size / AUDIO_32BITS_BYTE); i++) {
+            ((int32_t *)samples)[i] = generate_sample(inst);
+        }
+    }
+
+    return size;
+}
+
+/** @brief Checksum Endpoint's Consume action.
+ *
+ *  Only the first BENCH_GOLDEN_PACKET_COUNT payloads are hashed so the checksum does not
+ *  depend on the number of packets the benchmark runs.
+ *
+ *  @param[in]  instance  Endpoint instance.
+ *  @param[in]  samples   Consumed samples.
+ *  @param[in]  size      Size of samples to consume in bytes.
+ *  @return Number of bytes consumed.
+ */
+static uint16_t ep_bench_consume(void *instance, uint8_t *samples, uint16_t size)
+{
+    bench_consumer_instance_t *inst = (bench_consumer_instance_t *)instance;
+
+    uint16_t i;
+
+    if (inst->packet_count < BENCH_GOLDEN_PACKET_COUNT) {
+        for (i = 0; i < size; i++) {
+            inst->checksum = (inst->checksum ^ samples[i]) * FNV1A_PRIME;
+        }
+    }
+    for (i = 0; (i < size) && (samples[i] == 0); i++) {
+    }
+    if (i == size) {
+        inst->silent_packet_count++;
+    }
+    if (inst->record != NULL) {
+        for (i = 0; i < size; i += (inst->bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) {
+            if (inst->record_count < CHECK_RECORD_SIZE) {
+                inst->record[inst->record_count++] = (inst->bit_depth == AUDIO_16BITS) ?
+                                                     *(int16_t *)&samples[i] : *(int32_t *)&samples[i];
+            }
+        }
+    }
+    inst->packet_count++;
+
+    return size;
+}
+
+/** @brief Link Endpoint's Produce action.
+ *
+ *  @param[in]  instance  Endpoint instance.
+ *  @param[out] samples   Produced audio packet.
+ *  @param[in]  size      Largest size of audio packet to produce in bytes.
+ *  @return Number of bytes produced, 0 if no audio packet is in flight.
+ */
+static uint16_t ep_link_produce(void *instance, uint8_t *samples, uint16_t size)
+{
+    bench_link_instance_t *inst = (bench_link_instance_t *)instance;
+    uint16_t packet_size = inst->size;
+
+    if (packet_size > size) {
+        packet_size = size;
+    }
+    if (inst->receiver != NULL) {
+        if (packet_size > 0) {
+            /* Produce the packet received in place, the next one is received in the current one */
+            sac_endpoint_exchange_packet(inst->receiver, inst->rx_packet);
+            inst->rx_packet = samples;
+        }
+    } else {
+        memcpy(samples, inst->packet, packet_size);
+    }
+    inst->size = 0;
+
+    return packet_size;
+}
+
+/** @brief Link Endpoint's Consume action.
+ *
+ *  @param[in]  instance  Endpoint instance.
+ *  @param[in]  samples   Consumed audio packet.
+ *  @param[in]  size      Size of audio packet to consume in bytes.
+ *  @return Number of bytes consumed.
+ */
+static uint16_t ep_link_consume(void *instance, uint8_t *samples, uint16_t size)
+{
+    bench_link_instance_t *inst = (bench_link_instance_t *)instance;
+    uint8_t *packet = inst->packet;
+
+    if (size > BENCH_LINK_PACKET_SIZE) {
+        return 0;
+    }
+    if (inst->receiver != NULL) {
+        /* Receive in the lent packet, behind a link header filling the headroom */
+        packet = inst->rx_packet;
+        memset(packet - BENCH_LINK_HEADROOM, 0xA5, BENCH_LINK_HEADROOM);
+    }
+    memcpy(packet, samples, size);
+    inst->size = size;
+    inst->packet_count++;
+    if ((inst->corruption_period != 0) && ((inst->packet_count % inst->corruption_period) == 0)) {
+        /* Flip the first payload bit, the header stays valid */
+        packet[sizeof(sac_header_t)] ^= 0x01;
+    }
+
+    return size;
+}
+
+/** @brief Start a benchmark endpoint.
+ *
+ *  @param[in] instance  Endpoint instance.
+ */
+static void ep_bench_start(void *instance)
+{
+    (void)instance;
+}
+
+/** @brief Stop a benchmark endpoint.
+ *
+ *  @param[in] instance  Endpoint instance.
+ */
+static void ep_bench_stop(void *instance)
+{
+    (void)instance;
+}
+
+/** @brief Enter the Audio Core critical section.
+ */
+static void critical_section_enter(void)
+{
+}
+
+/** @brief Exit the Audio Core critical section.
+ */
+static void critical_section_exit(void)
+{
+}
@@ -0,0 +1,725 @@
+/** @file  audio_core_simulator.c
+ *  @brief This application simulates a SPARK Audio Core receiving pipeline on a host computer.
+ *         A virtual radio delivers the packets of the sinus endpoint with configurable clock
+ *         drift, jitter and packet loss to a pipeline using clock drift compensation, which is
+ *         consumed by a virtual codec running from its own drifting clock. Everything runs from
+ *         a virtual clock, so hours of audio are simulated in seconds and every run with the
+ *         same options gives the same results.
+ *
+ *         Build and run with CMake:
+ *             cmake -S app/example/audio_core_simulator -B build
+ *             cmake --build build
+ *             ./build/audio_core_simulator -h
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "audio_sinus.h"
+#include "sac_api.h"
+
+/* CONSTANTS ******************************************************************/
+#define SAC_MEM_POOL_SIZE             16000
+#define SAC_SIM_PAYLOAD_SIZE          96   /* One period of the sinus endpoint, 48 mono 16-bit samples */
+#define SAC_SIM_SAMPLING_RATE         48000
+#define SAC_SIM_LATENCY_FIFO_SIZE     64   /* Must be larger than the consumer queue */
+#define SAC_SIM_RADIO_FIFO_SIZE       256  /* Packets in flight over the virtual radio */
+#define NS_PER_S                      1000000000ULL
+#define NS_PER_US                     1000ULL
+#define PPM_PER_UNIT                  1000000.0
+
+/* Default simulation options, matching the audio streaming example forward channel. Without packet loss, the
+ * consumer queue fills up with the clock drift, which the CDC must then compensate without overflowing. */
+#define SAC_SIM_DEFAULT_DURATION_S    3600
+#define SAC_SIM_DEFAULT_REPORT_S      300
+#define SAC_SIM_DEFAULT_TX_DRIFT_PPM  (+20.0)
+#define SAC_SIM_DEFAULT_RX_DRIFT_PPM  (-20.0)
+#define SAC_SIM_DEFAULT_LINK_DELAY_US 500
+#define SAC_SIM_DEFAULT_JITTER_US     1000
+#define SAC_SIM_DEFAULT_LOSS_PERCENT  0.0
+#define SAC_SIM_DEFAULT_QUEUE_SIZE    20
+#define SAC_SIM_DEFAULT_CDC_LENGTH    5760
+#define SAC_SIM_DEFAULT_CDC_AVG_SIZE  1000
+#define SAC_SIM_DEFAULT_SEED          1
+
+/* TYPES **********************************************************************/
+/** @brief Simulation Options.
+ */
+typedef struct sim_cfg {
+    uint32_t duration_s;                   /*!< Simulated audio duration in seconds */
+    uint32_t report_s;                     /*!< Interval in seconds between two reports */
+    double tx_drift_ppm;                   /*!< Transmitter audio clock drift in ppm */
+    double rx_drift_ppm;                   /*!< Receiver audio clock drift in ppm */
+    uint32_t link_delay_us;                /*!< Fixed radio link delay in microseconds */
+    uint32_t jitter_us;                    /*!< Maximum radio link jitter in microseconds, uniformly distributed */
+    double loss_percent;                   /*!< Probability of losing a packet over the radio link */
+    uint8_t queue_size;                    /*!< Consumer queue size, as the SAC_*_LATENCY_QUEUE_SIZE of the applications */
+    uint16_t cdc_resampling_length;        /*!< CDC resampling length */
+    uint16_t cdc_queue_avg_size;           /*!< CDC queue average size */
+    resampling_mode_t cdc_resampling_mode; /*!< CDC resampling mode */
+    bool do_initial_buffering;             /*!< Wait for the consumer queue to be full before starting to consume */
+    uint32_t seed;                         /*!< Seed of the jitter and loss generator */
+} sim_cfg_t;
+
+/** @brief Simulation Statistics.
+ */
+typedef struct sim_stats {
+    uint64_t consume_count;    /*!< Number of codec consume events */
+    uint64_t load_sum;         /*!< Sum of the consumer queue loads sampled at each consume event */
+    uint32_t load_min;         /*!< Minimum consumer queue load */
+    uint32_t load_max;         /*!< Maximum consumer queue load */
+    uint64_t samples_added;    /*!< Samples added by the CDC */
+    uint64_t samples_removed;  /*!< Samples removed by the CDC */
+    uint64_t packets_sent;     /*!< Packets sent over the virtual radio */
+    uint64_t packets_lost;     /*!< Packets lost over the virtual radio */
+    uint64_t latency_count;    /*!< Number of latency measurements */
+    uint64_t latency_sum_ns;   /*!< Sum of the latencies */
+    uint64_t latency_min_ns;   /*!< Minimum latency */
+    uint64_t latency_max_ns;   /*!< Maximum latency */
+} sim_stats_t;
+
+/** @brief Virtual Radio Packet.
+ */
+typedef struct sim_radio_packet {
+    uint64_t generation_ns; /*!< Time the transmitter audio clock produced the packet */
+    uint64_t arrival_ns;    /*!< Time the packet is received */
+} sim_radio_packet_t;
+
+/** @brief Virtual Radio Producer Endpoint Instance.
+ */
+typedef struct sim_radio_instance {
+    sinus_instance_t sinus;                                 /*!< Sinus endpoint generating the audio */
+    sim_radio_packet_t packets[SAC_SIM_RADIO_FIFO_SIZE];    /*!< Packets in flight */
+    uint32_t head;                                          /*!< Index of the next packet to be received */
+    uint32_t count;                                         /*!< Number of packets in flight */
+} sim_radio_instance_t;
+
+/** @brief Virtual Codec Consumer Endpoint Instance.
+ */
+typedef struct sim_codec_instance {
+    bool started;                                   /*!< True once the Audio Core started the codec */
+    uint16_t last_size;                             /*!< Size in bytes of the last consumed payload */
+    uint64_t latency_fifo[SAC_SIM_LATENCY_FIFO_SIZE]; /*!< Generation time of the packets waiting to be played */
+    uint32_t latency_head;                          /*!< Index of the oldest packet */
+    uint32_t latency_count;                         /*!< Number of packets waiting to be played */
+} sim_codec_instance_t;
+
+/* PRIVATE GLOBALS ************************************************************/
+/* ** Audio Core ** */
+static uint8_t audio_memory_pool[SAC_MEM_POOL_SIZE];
+static sac_pipeline_t *pipeline;
+
+static sim_radio_instance_t radio_instance;
+static sac_endpoint_t *radio_producer;
+
+static sim_codec_instance_t codec_instance;
+static sac_endpoint_t *codec_consumer;
+
+/* ** Application Specific ** */
+static sim_cfg_t sim_cfg = {
+    .duration_s = SAC_SIM_DEFAULT_DURATION_S,
+    .report_s = SAC_SIM_DEFAULT_REPORT_S,
+    .tx_drift_ppm = SAC_SIM_DEFAULT_TX_DRIFT_PPM,
+    .rx_drift_ppm = SAC_SIM_DEFAULT_RX_DRIFT_PPM,
+    .link_delay_us = SAC_SIM_DEFAULT_LINK_DELAY_US,
+    .jitter_us = SAC_SIM_DEFAULT_JITTER_US,
+    .loss_percent = SAC_SIM_DEFAULT_LOSS_PERCENT,
+    .queue_size = SAC_SIM_DEFAULT_QUEUE_SIZE,
+    .cdc_resampling_length = SAC_SIM_DEFAULT_CDC_LENGTH,
+    .cdc_queue_avg_size = SAC_SIM_DEFAULT_CDC_AVG_SIZE,
+    .cdc_resampling_mode = RESAMPLING_MODE_LINEAR,
+    .do_initial_buffering = false,
+    .seed = SAC_SIM_DEFAULT_SEED,
+};
+static sim_stats_t sim_stats;
+static uint32_t sim_overflow_count; /* Consumer queue overflows of the whole simulation */
+static uint64_t sim_now_ns;
+static uint32_t random_state;
+
+/* PRIVATE FUNCTION PROTOTYPE *************************************************/
+static void app_audio_core_init(sac_error_t *audio_err);
+static void app_audio_core_sim_endpoint_init(sac_endpoint_interface_t *radio_producer_iface,
+                                             sac_endpoint_interface_t *codec_consumer_iface);
+static void app_audio_core_critical_section_init(queue_critical_cfg_t *queue_critical);
+
+static bool parse_options(int argc, char *argv[]);
+static void print_usage(const char *name);
+static void run_simulation(void);
+static void radio_send(uint64_t generation_ns);
+static void radio_receive(void);
+static void codec_consume(void);
+static void print_stats_header(void);
+static void print_stats(void);
+static void reset_stats(void);
+static uint32_t get_random(void);
+static uint64_t get_wall_time_ns(void);
+
+static uint16_t ep_radio_produce(void *instance, uint8_t *samples, uint16_t size);
+static void ep_radio_start(void *instance);
+static void ep_radio_stop(void *instance);
+static uint16_t ep_codec_consume(void *instance, uint8_t *samples, uint16_t size);
+static void ep_codec_start(void *instance);
+static void ep_codec_stop(void *instance);
+static void critical_section_enter(void);
+static void critical_section_exit(void);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+int main(int argc, char *argv[])
+{
+    sac_error_t audio_err;
+    uint64_t start_ns, elapsed_ns;
+
+    if (!parse_options(argc, argv)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    app_audio_core_init(&audio_err);
+    if (audio_err != SAC_ERR_NONE) {
+        printf("Audio Core initialization error %d\n", audio_err);
+        return EXIT_FAILURE;
+    }
+
+    printf("Simulating %" PRIu32 " s: TX drift %+.1f ppm, RX drift %+.1f ppm, link delay %" PRIu32 " us, "
+           "jitter %" PRIu32 " us, loss %.2f %%, queue size %u, CDC %s length %u average %u\n",
+           sim_cfg.duration_s, sim_cfg.tx_drift_ppm, sim_cfg.rx_drift_ppm, sim_cfg.link_delay_us,
+           sim_cfg.jitter_us, sim_cfg.loss_percent, sim_cfg.queue_size,
+           (sim_cfg.cdc_resampling_mode == RESAMPLING_MODE_POLYPHASE) ? "polyphase" : "linear",
+           sim_cfg.cdc_resampling_length, sim_cfg.cdc_queue_avg_size);
+
+    start_ns = get_wall_time_ns();
+    run_simulation();
+    elapsed_ns = get_wall_time_ns() - start_ns;
+
+    printf("Simulated %" PRIu32 " s of audio in %.2f s\n", sim_cfg.duration_s, (double)elapsed_ns / NS_PER_S);
+
+    if (sim_overflow_count > 0) {
+        /* The CDC did not keep up with the clock drift */
+        printf("%" PRIu32 " consumer queue overflow(s)\n", sim_overflow_count);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Run the simulation.
+ *
+ *  Three event sources share the virtual clock: the transmitter audio clock sending packets
+ *  over the virtual radio, the radio delivering them to the pipeline, and the receiver audio
+ *  clock consuming them. The earliest event is always executed first.
+ */
+static void run_simulation(void)
+{
+    const uint16_t frame_count = SAC_SIM_PAYLOAD_SIZE / AUDIO_16BITS_BYTE;
+    const double tx_rate = SAC_SIM_SAMPLING_RATE * (1.0 + (sim_cfg.tx_drift_ppm / PPM_PER_UNIT));
+    const double rx_rate = SAC_SIM_SAMPLING_RATE * (1.0 + (sim_cfg.rx_drift_ppm / PPM_PER_UNIT));
+    const uint64_t end_ns = (uint64_t)sim_cfg.duration_s * NS_PER_S;
+    uint64_t tx_packet_index = 0;
+    uint64_t next_send_ns = 0;
+    uint64_t next_consume_ns = UINT64_MAX;
+    uint64_t next_report_ns = (uint64_t)sim_cfg.report_s * NS_PER_S;
+    uint64_t rx_frame_count = 0;
+    uint64_t codec_start_ns = 0;
+    uint64_t next_arrival_ns;
+
+    print_stats_header();
+
+    sac_pipeline_start(pipeline);
+
+    while (sim_now_ns < end_ns) {
+        next_arrival_ns = (radio_instance.count > 0) ? radio_instance.packets[radio_instance.head].arrival_ns :
+                                                        UINT64_MAX;
+        if (codec_instance.started && (next_consume_ns == UINT64_MAX)) {
+            /* The codec starts playing as soon as the Audio Core starts it */
+            codec_start_ns = sim_now_ns;
+            next_consume_ns = sim_now_ns;
+        }
+
+        if ((next_send_ns <= next_arrival_ns) && (next_send_ns <= next_consume_ns)) {
+            sim_now_ns = next_send_ns;
+            radio_send(sim_now_ns);
+            tx_packet_index++;
+            next_send_ns = (uint64_t)(((double)tx_packet_index * frame_count * NS_PER_S) / tx_rate);
+        } else if (next_arrival_ns <= next_consume_ns) {
+            sim_now_ns = next_arrival_ns;
+            radio_receive();
+        } else {
+            sim_now_ns = next_consume_ns;
+            codec_consume();
+            /* The codec plays the whole payload it was given, or a packet of silence on underflow */
+            rx_frame_count += (codec_instance.last_size > 0) ? (codec_instance.last_size / AUDIO_16BITS_BYTE) :
+                                                                frame_count;
+            next_consume_ns = codec_start_ns + (uint64_t)(((double)rx_frame_count * NS_PER_S) / rx_rate);
+        }
+
+        if (sim_now_ns >= next_report_ns) {
+            print_stats();
+            reset_stats();
+            next_report_ns += (uint64_t)sim_cfg.report_s * NS_PER_S;
+        }
+    }
+}
+
+/** @brief Send a packet over the virtual radio.
+ *
+ *  @param[in] generation_ns  Time the transmitter produced the packet.
+ */
+static void radio_send(uint64_t generation_ns)
+{
+    sim_radio_packet_t *packet;
+    sim_radio_packet_t *previous_packet;
+    uint64_t jitter_ns = 0;
+
+    sim_stats.packets_sent++;
+
+    if (get_random() < (uint32_t)((sim_cfg.loss_percent / 100.0) * UINT32_MAX)) {
+        sim_stats.packets_lost++;
+        return;
+    }
+    if (radio_instance.count >= SAC_SIM_RADIO_FIFO_SIZE) {
+        sim_stats.packets_lost++;
+        return;
+    }
+
+    if (sim_cfg.jitter_us > 0) {
+        jitter_ns = get_random() % (sim_cfg.jitter_us * NS_PER_US);
+    }
+
+    packet = &radio_instance.packets[(radio_instance.head + radio_instance.count) % SAC_SIM_RADIO_FIFO_SIZE];
+    packet->generation_ns = generation_ns;
+    packet->arrival_ns = generation_ns + (sim_cfg.link_delay_us * NS_PER_US) + jitter_ns;
+    if (radio_instance.count > 0) {
+        /* The radio link delivers packets in order */
+        previous_packet = &radio_instance.packets[(radio_instance.head + radio_instance.count - 1) %
+                                                  SAC_SIM_RADIO_FIFO_SIZE];
+        if (packet->arrival_ns < previous_packet->arrival_ns) {
+            packet->arrival_ns = previous_packet->arrival_ns;
+        }
+    }
+    radio_instance.count++;
+}
+
+/** @brief Receive the next packet from the virtual radio and process it.
+ */
+static void radio_receive(void)
+{
+    sac_error_t audio_err;
+    uint32_t overflow_count = sac_pipeline_get_consumer_buffer_overflow_count(pipeline);
+
+    sac_pipeline_produce(pipeline, &audio_err);
+    radio_instance.head = (radio_instance.head + 1) % SAC_SIM_RADIO_FIFO_SIZE;
+    radio_instance.count--;
+    sac_pipeline_process(pipeline, &audio_err);
+
+    /* On overflow, the oldest audio packets were dropped from the consumer queue */
+    overflow_count = sac_pipeline_get_consumer_buffer_overflow_count(pipeline) - overflow_count;
+    sim_overflow_count += overflow_count;
+    while ((overflow_count-- > 0) && (codec_instance.latency_count > 0)) {
+        codec_instance.latency_head = (codec_instance.latency_head + 1) % SAC_SIM_LATENCY_FIFO_SIZE;
+        codec_instance.latency_count--;
+    }
+}
+
+/** @brief Consume the next packet at the virtual codec.
+ */
+static void codec_consume(void)
+{
+    sac_error_t audio_err;
+    uint32_t load = sac_pipeline_get_consumer_buffer_load(pipeline);
+
+    sim_stats.consume_count++;
+    sim_stats.load_sum += load;
+    if (load < sim_stats.load_min) {
+        sim_stats.load_min = load;
+    }
+    if (load > sim_stats.load_max) {
+        sim_stats.load_max = load;
+    }
+
+    codec_instance.last_size = 0;
+    sac_pipeline_consume(pipeline, &audio_err);
+}
+
+/** @brief Print the statistics column names.
+ */
+static void print_stats_header(void)
+{
+    reset_stats();
+    printf("%8s %16s %15s %9s %9s %13s %26s\n", "time (s)", "load min/avg/max", "CDC added/rm",
+           "underflow", "overflow", "lost/sent", "latency us min/avg/max");
+}
+
+/** @brief Print the statistics of the last report interval.
+ */
+static void print_stats(void)
+{
+    sac_statistics_t *audio_stats = sac_pipeline_get_stats(pipeline);
+    double load_avg = (sim_stats.consume_count > 0) ? ((double)sim_stats.load_sum / sim_stats.consume_count) : 0;
+    double latency_avg = (sim_stats.latency_count > 0) ? ((double)sim_stats.latency_sum_ns / sim_stats.latency_count) : 0;
+
+    if (sim_stats.consume_count == 0) {
+        sim_stats.load_min = 0;
+    }
+    if (sim_stats.latency_count == 0) {
+        sim_stats.latency_min_ns = 0;
+    }
+
+    printf("%8" PRIu64 " %4" PRIu32 "/%5.2f/%4" PRIu32 " %7" PRIu64 "/%-7" PRIu64 " %9" PRIu32 " %9" PRIu32
+           " %6" PRIu64 "/%-6" PRIu64 " %8.0f/%8.0f/%8.0f\n",
+           (uint64_t)(sim_now_ns / NS_PER_S), sim_stats.load_min, load_avg, sim_stats.load_max,
+           sim_stats.samples_added, sim_stats.samples_removed,
+           audio_stats->consumer_buffer_underflow_count, audio_stats->consumer_buffer_overflow_count,
+           sim_stats.packets_lost, sim_stats.packets_sent,
+           (double)sim_stats.latency_min_ns / NS_PER_US, latency_avg / NS_PER_US,
+           (double)sim_stats.latency_max_ns / NS_PER_US);
+}
+
+/** @brief Reset the statistics of the report interval.
+ */
+static void reset_stats(void)
+{
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    sim_stats.load_min = UINT32_MAX;
+    sim_stats.latency_min_ns = UINT64_MAX;
+    sac_pipeline_reset_stats(pipeline);
+}
+
+/** @brief Initialize the Audio Core.
+ *
+ *  @param[out] audio_err  Audio Core error code.
+ */
+static void app_audio_core_init(sac_error_t *audio_err)
+{
+    sac_endpoint_interface_t radio_producer_iface;
+    sac_endpoint_interface_t codec_consumer_iface;
+    queue_critical_cfg_t queue_critical;
+
+    app_audio_core_sim_endpoint_init(&radio_producer_iface, &codec_consumer_iface);
+    app_audio_core_critical_section_init(&queue_critical);
+
+    sac_init(queue_critical, audio_memory_pool, SAC_MEM_POOL_SIZE);
+
+    /*
+     * Simulated Audio Pipeline
+     * ========================
+     *
+     * Input:      Mono stream of 48 samples @ 48 kHz/16 bits is received from the virtual radio.
+     * Processing: Clock drift compensation.
+     * Output:     Mono stream of 48 samples @ 48 kHz/16 bits is played by the virtual codec.
+     *
+     * +---------------+    +-----+    +---------------+
+     * | Virtual Radio | -> | CDC | -> | Virtual Codec |
+     * +---------------+    +-----+    +---------------+
+     */
+    radio_instance.sinus.sine_freq = SINE_FREQ_1K;
+    audio_endpoint_cfg_t radio_producer_cfg = {
+        .use_encapsulation = false,
+        .delayed_action = false,
+        .channel_count = 1,
+        .bit_depth = AUDIO_16BITS,
+        .audio_payload_size = SAC_SIM_PAYLOAD_SIZE,
+        .queue_size = SAC_PRODUCER_QUEUE_SIZE};
+    radio_producer = sac_endpoint_init((void *)&radio_instance, "Virtual Radio EP (Producer)",
+                                       radio_producer_iface, radio_producer_cfg, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    audio_endpoint_cfg_t codec_consumer_cfg = {
+        .use_encapsulation = false,
+        .delayed_action = true,
+        .channel_count = 1,
+        .bit_depth = AUDIO_16BITS,
+        .audio_payload_size = SAC_SIM_PAYLOAD_SIZE,
+        .queue_size = sim_cfg.queue_size};
+    codec_consumer = sac_endpoint_init((void *)&codec_instance, "Virtual Codec EP (Consumer)",
+                                       codec_consumer_iface, codec_consumer_cfg, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    sac_pipeline_cfg_t pipeline_cfg = {
+        .cdc_enable = true,
+        .cdc_resampling_length = sim_cfg.cdc_resampling_length,
+        .cdc_queue_avg_size = sim_cfg.cdc_queue_avg_size,
+        .cdc_resampling_mode = sim_cfg.cdc_resampling_mode,
+        .do_initial_buffering = sim_cfg.do_initial_buffering,
+        .user_data_enable = false};
+    pipeline = sac_pipeline_init("Virtual Radio -> Virtual Codec", radio_producer,
+                                 pipeline_cfg, codec_consumer, audio_err);
+    if (*audio_err != SAC_ERR_NONE) {
+        return;
+    }
+
+    sac_pipeline_setup(pipeline, audio_err);
+}
+
+/** @brief Initialize the simulation audio endpoint interfaces.
+ *
+ *  @param[out] radio_producer_iface  Virtual radio producer audio endpoint interface.
+ *  @param[out] codec_consumer_iface  Virtual codec consumer audio endpoint interface.
+ */
+static void app_audio_core_sim_endpoint_init(sac_endpoint_interface_t *radio_producer_iface,
+                                             sac_endpoint_interface_t *codec_consumer_iface)
+{
+    radio_producer_iface->action = ep_radio_produce;
+    radio_producer_iface->start = ep_radio_start;
+    radio_producer_iface->stop = ep_radio_stop;
+
+    codec_consumer_iface->action = ep_codec_consume;
+    codec_consumer_iface->start = ep_codec_start;
+    codec_consumer_iface->stop = ep_codec_stop;
+}
+
+/** @brief Initialize the Audio Core critical section.
+ *
+ *  The simulation runs the Audio Core from a single thread, so nothing needs to be masked.
+ *
+ *  @param[out] queue_critical  Audio Core critical section.
+ */
+static void app_audio_core_critical_section_init(queue_critical_cfg_t *queue_critical)
+{
+    queue_critical->enter_critical = critical_section_enter;
+    queue_critical->exit_critical = critical_section_exit;
+}
+
+/** @brief Parse the command line options.
+ *
+ *  @param[in] argc  Number of arguments.
+ *  @param[in] argv  Arguments.
+ *  @retval true   Options are valid.
+ *  @retval false  Options are invalid or help was requested.
+ */
+static bool parse_options(int argc, char *argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:i:t:r:l:j:p:q:n:a:mbs:h")) != -1) {
+        switch (opt) {
+        case 'd':
+            sim_cfg.duration_s = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            sim_cfg.report_s = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            sim_cfg.tx_drift_ppm = strtod(optarg, NULL);
+            break;
+        case 'r':
+            sim_cfg.rx_drift_ppm = strtod(optarg, NULL);
+            break;
+        case 'l':
+            sim_cfg.link_delay_us = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'j':
+            sim_cfg.jitter_us = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            sim_cfg.loss_percent = strtod(optarg, NULL);
+            break;
+        case 'q':
+            sim_cfg.queue_size = (uint8_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            sim_cfg.cdc_resampling_length = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'a':
+            sim_cfg.cdc_queue_avg_size = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            sim_cfg.cdc_resampling_mode = RESAMPLING_MODE_POLYPHASE;
+            break;
+        case 'b':
+            sim_cfg.do_initial_buffering = true;
+            break;
+        case 's':
+            sim_cfg.seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return false;
+        }
+    }
+
+    if ((sim_cfg.report_s == 0) || (sim_cfg.queue_size == 0) || (sim_cfg.queue_size >= SAC_SIM_LATENCY_FIFO_SIZE) ||
+        (sim_cfg.cdc_queue_avg_size == 0) || (sim_cfg.seed == 0)) {
+        return false;
+    }
+    random_state = sim_cfg.seed;
+
+    return true;
+}
+
+/** @brief Print the command line options.
+ *
+ *  @param[in] name  Name of the program.
+ */
+static void print_usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -d <s>    Simulated audio duration (default %u)\n", SAC_SIM_DEFAULT_DURATION_S);
+    printf("  -i <s>    Report interval (default %u)\n", SAC_SIM_DEFAULT_REPORT_S);
+    printf("  -t <ppm>  Transmitter audio clock drift (default %+.1f)\n", SAC_SIM_DEFAULT_TX_DRIFT_PPM);
+    printf("  -r <ppm>  Receiver audio clock drift (default %+.1f)\n", SAC_SIM_DEFAULT_RX_DRIFT_PPM);
+    printf("  -l <us>   Radio link delay (default %u)\n", SAC_SIM_DEFAULT_LINK_DELAY_US);
+    printf("  -j <us>   Maximum radio link jitter (default %u)\n", SAC_SIM_DEFAULT_JITTER_US);
+    printf("  -p <%%>    Packet loss probability (default %.2f)\n", SAC_SIM_DEFAULT_LOSS_PERCENT);
+    printf("  -q <n>    Consumer queue size (default %u)\n", SAC_SIM_DEFAULT_QUEUE_SIZE);
+    printf("  -n <n>    CDC resampling length (default %u)\n", SAC_SIM_DEFAULT_CDC_LENGTH);
+    printf("  -a <n>    CDC queue average size (default %u)\n", SAC_SIM_DEFAULT_CDC_AVG_SIZE);
+    printf("  -m        Use the polyphase CDC resampling mode instead of linear\n");
+    printf("  -b        Do initial buffering\n");
+    printf("  -s <n>    Non-zero seed of the jitter and loss generator (default %u)\n", SAC_SIM_DEFAULT_SEED);
+}
+
+/** @brief Get the next pseudo-random number of the jitter and loss generator.
+ *
+ *  @return 32-bit pseudo-random number.
+ */
+static uint32_t get_random(void)
+{
+    /* Xorshift32 */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
+
+/** @brief Get the time of a monotonic clock.
+ *
+ *  @return Time in nanoseconds.
+ */
+static uint64_t get_wall_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * NS_PER_S) + (uint64_t)ts.tv_nsec;
+}
+
+/** @brief Virtual Radio Endpoint's Produce action.
+ *
+ *  The audio is generated by the sinus endpoint and the packet generation time is
+ *  handed to the virtual codec to measure the latency.
+ *
+ *  @param[in]  instance  Endpoint instance.
+ *  @param[out] samples   Produced samples.
+ *  @param[in]  size      Size of samples to produce in bytes.
+ *  @return Number of bytes produced.
+ */
+static uint16_t ep_radio_produce(void *instance, uint8_t *samples, uint16_t size)
+{
+    sim_radio_instance_t *inst = (sim_radio_instance_t *)instance;
+
+    if (codec_instance.latency_count < SAC_SIM_LATENCY_FIFO_SIZE) {
+        codec_instance.latency_fifo[(codec_instance.latency_head + codec_instance.latency_count) %
+                                    SAC_SIM_LATENCY_FIFO_SIZE] = inst->packets[inst->head].generation_ns;
+        codec_instance.latency_count++;
+    }
+
+    return ep_sinus_produce(&inst->sinus, samples, size);
+}
+
+/** @brief Start the Virtual Radio endpoint.
+ *
+ *  @param[in] instance  Endpoint instance.
+ */
+static void ep_radio_start(void *instance)
+{
+    (void)instance;
+}
+
+/** @brief Stop the Virtual Radio endpoint.
+ *
+ *  @param[in] instance  Endpoint instance.
+ */
+static void ep_radio_stop(void *instance)
+{
+    (void)instance;
+}
+
+/** @brief Virtual Codec Endpoint's Consume action.
+ *
+ *  The latency is measured from the packet generation at the transmitter to the start of its playback.
+ *
+ *  @param[in]  instance  Endpoint instance.
+ *  @param[in]  samples   Consumed samples.
+ *  @param[in]  size      Size of samples to consume in bytes.
+ *  @return Number of bytes consumed.
+ */
+static uint16_t ep_codec_consume(void *instance, uint8_t *samples, uint16_t size)
+{
+    (void)samples;
+    sim_codec_instance_t *inst = (sim_codec_instance_t *)instance;
+    uint64_t latency_ns;
+
+    inst->last_size = size;
+
+    if (size > SAC_SIM_PAYLOAD_SIZE) {
+        sim_stats.samples_added += (size - SAC_SIM_PAYLOAD_SIZE) / AUDIO_16BITS_BYTE;
+    } else {
+        sim_stats.samples_removed += (SAC_SIM_PAYLOAD_SIZE - size) / AUDIO_16BITS_BYTE;
+    }
+
+    if (inst->latency_count > 0) {
+        latency_ns = sim_now_ns - inst->latency_fifo[inst->latency_head];
+        inst->latency_head = (inst->latency_head + 1) % SAC_SIM_LATENCY_FIFO_SIZE;
+        inst->latency_count--;
+
+        sim_stats.latency_count++;
+        sim_stats.latency_sum_ns += latency_ns;
+        if (latency_ns < sim_stats.latency_min_ns) {
+            sim_stats.latency_min_ns = latency_ns;
+        }
+        if (latency_ns > sim_stats.latency_max_ns) {
+            sim_stats.latency_max_ns = latency_ns;
+        }
+    }
+
+    return size;
+}
+
+/** @brief Start the Virtual Codec endpoint.
+ *
+ *  @param[in] instance  Endpoint instance.
+ */
+static void ep_codec_start(void *instance)
+{
+    sim_codec_instance_t *inst = (sim_codec_instance_t *)instance;
+
+    inst->started = true;
+}
+
+/** @brief Stop the Virtual Codec endpoint.
+ *
+ *  @param[in] instance  Endpoint instance.
+ */
+static void ep_codec_stop(void *instance)
+{
+    sim_codec_instance_t *inst = (sim_codec_instance_t *)instance;
+
+    inst->started = false;
+}
+
+/** @brief Enter the Audio Core critical section.
+ */
+static void critical_section_enter(void)
+{
+}
+
+/** @brief Exit the Audio Core critical section.
+ */
+static void critical_section_exit(void)
+{
+}
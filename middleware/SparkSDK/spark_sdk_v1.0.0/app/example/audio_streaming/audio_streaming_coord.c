@@ -21,12 +21,12 @@
 #include "evk_usb_device.h"
 
 /* CONSTANTS ******************************************************************/
-#define SAC_MEM_POOL_SIZE 8900
+#define SAC_MEM_POOL_SIZE 9600
 #define SAC_FORWARD_CHANNEL_PAYLOAD_SIZE 84
 #define SAC_FORWARD_CHANNEL_LATENCY_QUEUE_SIZE 20
 #define SAC_BACK_CHANNEL_PAYLOAD_SIZE 60
 #define SAC_BACK_CHANNEL_LATENCY_QUEUE_SIZE 9
-#define SWC_MEM_POOL_SIZE 10000
+#define SWC_MEM_POOL_SIZE 10800
 
 /* PRIVATE GLOBALS ************************************************************/
 /* ** Audio Core ** */
@@ -178,7 +178,7 @@ static void app_swc_core_init(swc_error_t *err)
         .fec = SWC_FEC_LEVEL,
         .timeslot_id = tx_timeslots,
         .timeslot_count = ARRAY_SIZE(tx_timeslots),
-        .allocate_payload_memory = true,
+        .allocate_payload_memory = false, /* Payloads are lent by the Audio Core */
         .ack_enabled = true,
         .arq_enabled = true,
         .arq_settings.retry_count = 0,
@@ -341,13 +341,16 @@ static void app_audio_core_init(sac_error_t *audio_err)
         .channel_count = 2,
         .bit_depth = AUDIO_16BITS,
         .audio_payload_size = SAC_FORWARD_CHANNEL_PAYLOAD_SIZE,
-        .queue_size = SAC_FORWARD_CHANNEL_LATENCY_QUEUE_SIZE};
+        .queue_size = SAC_FORWARD_CHANNEL_LATENCY_QUEUE_SIZE,
+        .lent_queue_size = TX_DATA_QUEUE_SIZE};
     swc_consumer = sac_endpoint_init((void *)&swc_consumer_instance, "SWC EP (Consumer)",
                                      swc_consumer_iface, swc_consumer_cfg, audio_err);
     if (*audio_err != SAC_ERR_NONE)
     {
         return;
     }
+    /* Transmit audio packets from the Audio Core queue without copying them */
+    iface_audio_swc_endpoint_lend_packets(&swc_consumer_instance, swc_consumer);
 
     sac_pipeline_cfg_t primary_pipeline_cfg = {
         .cdc_enable = false,
@@ -384,7 +387,9 @@ static void app_audio_core_init(sac_error_t *audio_err)
         .channel_count = 1,
         .bit_depth = AUDIO_16BITS,
         .audio_payload_size = SAC_BACK_CHANNEL_PAYLOAD_SIZE,
-        .queue_size = SAC_PRODUCER_QUEUE_SIZE};
+        .queue_size = SAC_PRODUCER_QUEUE_SIZE,
+        .lent_queue_size = RX_DATA_QUEUE_SIZE,
+        .packet_headroom = swc_connection_get_rx_headroom(rx_conn)};
     swc_producer = sac_endpoint_init((void *)&swc_producer_instance, "SWC EP (Producer)",
                                      swc_producer_iface, swc_producer_cfg, audio_err);
     if (*audio_err != SAC_ERR_NONE)
@@ -404,6 +409,7 @@ static void app_audio_core_init(sac_error_t *audio_err)
 
     volume_instance.initial_volume_level = 100;
     volume_instance.bit_depth = AUDIO_16BITS;
+    volume_instance.channel_count = swc_producer_cfg.channel_count;
     volume_processing = sac_processing_stage_init((void *)&volume_instance, "Digital Volume Control", volume_iface, audio_err);
     if (*audio_err != SAC_ERR_NONE)
     {
@@ -445,6 +451,8 @@ static void app_audio_core_init(sac_error_t *audio_err)
     {
         return;
     }
+    /* Audio packets are received in place */
+    iface_audio_swc_endpoint_receive_in_place(&swc_producer_instance, swc_producer);
 }
 
 /** @brief Initialize the sampling rate converter audio processing stage interface.
@@ -458,6 +466,9 @@ static void app_audio_core_upsampling_interface_init(sac_processing_interface_t
     iface->ctrl = audio_src_cmsis_ctrl;
     iface->process = audio_src_cmsis_process;
     iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = false;
+    iface->output_overhead = 0;
 }
 
 /** @brief Initialize the digital volume control audio processing stage interface.
@@ -471,6 +482,9 @@ static void app_audio_core_volume_interface_init(sac_processing_interface_t *ifa
     iface->ctrl = audio_volume_ctrl;
     iface->process = audio_volume_process;
     iface->gate = NULL;
+    iface->conceal = NULL;
+    iface->in_place = true;
+    iface->output_overhead = 0;
 }
 
 /** @brief SAI DMA TX complete callback.
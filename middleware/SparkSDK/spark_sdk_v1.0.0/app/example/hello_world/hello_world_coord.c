@@ -15,7 +15,7 @@
 #include "swc_stats.h"
 
 /* CONSTANTS ******************************************************************/
-#define SWC_MEM_POOL_SIZE     4600
+#define SWC_MEM_POOL_SIZE     5100
 #define MAX_PAYLOAD_SIZE_BYTE 16
 
 /* PRIVATE GLOBALS ************************************************************/
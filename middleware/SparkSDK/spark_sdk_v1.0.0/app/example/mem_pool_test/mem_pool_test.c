@@ -0,0 +1,393 @@
+/** @file  mem_pool_test.c
+ *  @brief This application tests the SPARK memory pool on a host computer.
+ *         Releasable blocks are checked for alignment, splitting, merging,
+ *         usage accounting and integrity under a random allocation sequence.
+ *
+ *         Build and run with CMake:
+ *             cmake -S app/example/mem_pool_test -B build
+ *             cmake --build build
+ *             ./build/mem_pool_test
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mem_pool.h"
+
+/* CONSTANTS ******************************************************************/
+#define TEST_POOL_SIZE       8192
+#define TEST_RANDOM_BLOCKS   32   /* Blocks alive at once in the random sequence */
+#define TEST_RANDOM_STEPS    20000
+#define TEST_RANDOM_MAX_SIZE 300
+#define TEST_OWNER_A         1
+#define TEST_OWNER_B         2
+#define TEST_RECREATE_COUNT  3    /* Times the pipeline blocks are created and destroyed */
+
+/* MACROS *********************************************************************/
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            printf("  %s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            return false;                                                     \
+        }                                                                     \
+    } while (0)
+
+/* TYPES **********************************************************************/
+/** @brief Memory Pool Test Case.
+ */
+typedef struct test_case {
+    const char *name;  /*!< Name printed with the result */
+    bool (*run)(void); /*!< Test function, false on failure */
+} test_case_t;
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static bool test_alignment(void);
+static bool test_split(void);
+static bool test_merge(void);
+static bool test_top_release(void);
+static bool test_malloc_boundary(void);
+static bool test_high_water_mark(void);
+static bool test_owner_accounting(void);
+static bool test_random_sequence(void);
+static bool test_recreate(void);
+static bool is_aligned(void *ptr);
+static bool is_filled(uint8_t *block, size_t size, uint8_t pattern);
+
+/* PRIVATE GLOBALS ************************************************************/
+static _Alignas(MEM_POOL_ALIGNMENT) uint8_t pool_memory[TEST_POOL_SIZE];
+static mem_pool_t pool;
+
+static const test_case_t test_cases[] = {
+    {"alignment", test_alignment},
+    {"split", test_split},
+    {"merge", test_merge},
+    {"top release", test_top_release},
+    {"malloc boundary", test_malloc_boundary},
+    {"high-water mark", test_high_water_mark},
+    {"owner accounting", test_owner_accounting},
+    {"random sequence", test_random_sequence},
+    {"recreate", test_recreate},
+};
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+int main(void)
+{
+    uint32_t failure_count = 0;
+    bool passed;
+
+    for (size_t i = 0; i < (sizeof(test_cases) / sizeof(test_cases[0])); i++) {
+        mem_pool_init(&pool, pool_memory, sizeof(pool_memory));
+        passed = test_cases[i].run();
+        if (!passed) {
+            failure_count++;
+        }
+        printf("%-20s %s\n", test_cases[i].name, passed ? "ok" : "FAIL");
+    }
+
+    if (failure_count > 0) {
+        printf("%" PRIu32 " test(s) failed\n", failure_count);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Every block is aligned, whatever the sizes allocated before it.
+ */
+static bool test_alignment(void)
+{
+    void *ptr;
+
+    for (size_t size = 1; size < 40; size++) {
+        ptr = mem_pool_alloc(&pool, size, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+        CHECK(ptr != NULL);
+        CHECK(is_aligned(ptr));
+        ptr = mem_pool_malloc(&pool, size);
+        CHECK(ptr != NULL);
+        CHECK(is_aligned(ptr));
+    }
+
+    return true;
+}
+
+/** @brief A released block serves smaller allocations, split in place.
+ */
+static bool test_split(void)
+{
+    uint8_t *large = mem_pool_alloc(&pool, 512, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *guard = mem_pool_alloc(&pool, 16, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *first, *second, *top;
+
+    CHECK((large != NULL) && (guard != NULL));
+    top = pool.mem_pool_it;
+    mem_pool_release(&pool, large);
+
+    first = mem_pool_alloc(&pool, 64, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    second = mem_pool_alloc(&pool, 64, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    CHECK(first == large);
+    CHECK((second > first) && (second < guard));
+    CHECK(is_aligned(second));
+    /* Neither allocation grew the used pool */
+    CHECK(pool.mem_pool_it == top);
+    CHECK(is_filled(second, 64, 0));
+
+    return true;
+}
+
+/** @brief Released neighbours merge back into a block able to serve the original size.
+ */
+static bool test_merge(void)
+{
+    uint8_t *block[4];
+    uint8_t *merged, *top;
+
+    for (int i = 0; i < 4; i++) {
+        block[i] = mem_pool_alloc(&pool, 100, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+        CHECK(block[i] != NULL);
+    }
+    top = pool.mem_pool_it;
+
+    /* Release out of order so both merge directions are used */
+    mem_pool_release(&pool, block[0]);
+    mem_pool_release(&pool, block[2]);
+    mem_pool_release(&pool, block[1]);
+
+    merged = mem_pool_alloc(&pool, (size_t)(block[3] - block[0]) - 100, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    CHECK(merged == block[0]);
+    CHECK(pool.mem_pool_it == top);
+    CHECK(is_filled(merged, (size_t)(block[3] - block[0]) - 100, 0));
+
+    return true;
+}
+
+/** @brief A released block at the top of the used pool goes back to it, with its released neighbours.
+ */
+static bool test_top_release(void)
+{
+    uint8_t *bottom = mem_pool_alloc(&pool, 40, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *middle = mem_pool_alloc(&pool, 40, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *top = mem_pool_alloc(&pool, 40, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint32_t free_bytes = pool.free_bytes;
+
+    CHECK((bottom != NULL) && (middle != NULL) && (top != NULL));
+    mem_pool_release(&pool, middle);
+    CHECK(pool.free_bytes == free_bytes);
+    mem_pool_release(&pool, top);
+    CHECK(pool.mem_pool_it < middle);
+    mem_pool_release(&pool, bottom);
+    CHECK(pool.mem_pool_it == pool.mem_pool_begin);
+    CHECK(pool.free_bytes == pool.capacity);
+    CHECK(mem_pool_get_allocated_bytes(&pool) == 0);
+
+    /* Stale pointers above the top and double releases are ignored */
+    mem_pool_release(&pool, top);
+    mem_pool_release(&pool, bottom);
+    CHECK(pool.free_bytes == pool.capacity);
+
+    return true;
+}
+
+/** @brief Blocks separated by a mem_pool_malloc() block are never merged.
+ */
+static bool test_malloc_boundary(void)
+{
+    uint8_t *before = mem_pool_alloc(&pool, 64, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *fixed = mem_pool_malloc(&pool, 64);
+    uint8_t *after = mem_pool_alloc(&pool, 64, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *guard = mem_pool_alloc(&pool, 16, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint8_t *block;
+
+    CHECK((before != NULL) && (fixed != NULL) && (after != NULL) && (guard != NULL));
+    memset(fixed, 0xA5, 64);
+    mem_pool_release(&pool, before);
+    mem_pool_release(&pool, after);
+
+    /* The two released blocks can not hold more than 64 bytes each */
+    block = mem_pool_alloc(&pool, 128, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    CHECK(block > guard);
+    CHECK(is_filled(fixed, 64, 0xA5));
+
+    /* A block released below a mem_pool_malloc() block stays in the pool */
+    mem_pool_init(&pool, pool_memory, sizeof(pool_memory));
+    before = mem_pool_alloc(&pool, 64, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    fixed = mem_pool_malloc(&pool, 64);
+    mem_pool_release(&pool, before);
+    CHECK(pool.mem_pool_it == (fixed + 64));
+    CHECK(mem_pool_alloc(&pool, 64, TEST_OWNER_A, MEM_POOL_FLAG_NONE) == before);
+
+    return true;
+}
+
+/** @brief The high-water mark follows the peak usage and survives mem_pool_free().
+ */
+static bool test_high_water_mark(void)
+{
+    void *first = mem_pool_alloc(&pool, 200, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    void *second = mem_pool_alloc(&pool, 300, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    uint32_t peak = mem_pool_get_allocated_bytes(&pool);
+
+    CHECK((first != NULL) && (second != NULL));
+    CHECK(mem_pool_get_high_water_mark(&pool) == peak);
+    mem_pool_release(&pool, first);
+    CHECK(mem_pool_get_allocated_bytes(&pool) < peak);
+    CHECK(mem_pool_get_high_water_mark(&pool) == peak);
+
+    /* Reusing the released block stays under the peak */
+    first = mem_pool_alloc(&pool, 100, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    CHECK(first != NULL);
+    CHECK(mem_pool_get_high_water_mark(&pool) == peak);
+
+    mem_pool_free(&pool);
+    CHECK(mem_pool_get_allocated_bytes(&pool) == 0);
+    CHECK(mem_pool_get_high_water_mark(&pool) == peak);
+    CHECK(mem_pool_malloc(&pool, peak + 8) != NULL);
+    CHECK(mem_pool_get_high_water_mark(&pool) == (peak + 8));
+
+    return true;
+}
+
+/** @brief Each owner is accounted separately, and back to 0 once its blocks are released.
+ */
+static bool test_owner_accounting(void)
+{
+    void *a = mem_pool_alloc(&pool, 48, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+    void *b = mem_pool_alloc(&pool, 96, TEST_OWNER_B, MEM_POOL_FLAG_NONE);
+
+    CHECK((a != NULL) && (b != NULL));
+    CHECK(mem_pool_get_owner_bytes(&pool, TEST_OWNER_A) > 48);
+    CHECK(mem_pool_get_owner_bytes(&pool, TEST_OWNER_B) > 96);
+    CHECK(mem_pool_alloc(&pool, 8, MEM_POOL_OWNER_COUNT, MEM_POOL_FLAG_NONE) == NULL);
+    mem_pool_release(&pool, a);
+    CHECK(mem_pool_get_owner_bytes(&pool, TEST_OWNER_A) == 0);
+    mem_pool_release(&pool, b);
+    CHECK(mem_pool_get_owner_bytes(&pool, TEST_OWNER_B) == 0);
+    CHECK(mem_pool_get_allocated_bytes(&pool) == 0);
+
+    return true;
+}
+
+/** @brief Random allocations and releases never overlap, and releasing everything empties the pool.
+ */
+static bool test_random_sequence(void)
+{
+    uint8_t *block[TEST_RANDOM_BLOCKS] = {0};
+    size_t size[TEST_RANDOM_BLOCKS] = {0};
+    uint32_t lcg = 1;
+    uint32_t slot;
+
+    for (uint32_t step = 0; step < TEST_RANDOM_STEPS; step++) {
+        lcg = lcg * 1664525 + 1013904223;
+        slot = (lcg >> 8) % TEST_RANDOM_BLOCKS;
+        if (block[slot] != NULL) {
+            /* The block kept its pattern, so no other block overlapped it */
+            CHECK(is_filled(block[slot], size[slot], (uint8_t)slot));
+            mem_pool_release(&pool, block[slot]);
+            block[slot] = NULL;
+        } else {
+            size[slot] = 1 + ((lcg >> 16) % TEST_RANDOM_MAX_SIZE);
+            block[slot] = mem_pool_alloc(&pool, size[slot], TEST_OWNER_A, MEM_POOL_FLAG_NO_ZERO);
+            CHECK(block[slot] != NULL);
+            CHECK(is_aligned(block[slot]));
+            memset(block[slot], (uint8_t)slot, size[slot]);
+        }
+    }
+
+    for (slot = 0; slot < TEST_RANDOM_BLOCKS; slot++) {
+        if (block[slot] != NULL) {
+            CHECK(is_filled(block[slot], size[slot], (uint8_t)slot));
+            mem_pool_release(&pool, block[slot]);
+        }
+    }
+    CHECK(mem_pool_get_allocated_bytes(&pool) == 0);
+    CHECK(pool.free_bytes == pool.capacity);
+    CHECK(pool.free_list_map == 0);
+
+    return true;
+}
+
+/** @brief Destroying and recreating a set of blocks reuses the same memory.
+ *
+ *  Models an audio pipeline torn down and rebuilt between a permanent block and a block
+ *  of another owner which both stay allocated: the pipeline, its endpoints, their queues
+ *  and the audio queue nodes, released in the order of their creation.
+ */
+static bool test_recreate(void)
+{
+    static const size_t sizes[] = {120, 96, 40, 96, 40, 1600, 40, 24};
+    uint8_t *block[sizeof(sizes) / sizeof(sizes[0])];
+    uint8_t *first_block[sizeof(sizes) / sizeof(sizes[0])];
+    uint32_t allocated_bytes = 0;
+    uint32_t peak = 0;
+    void *permanent = mem_pool_malloc(&pool, 64);
+    void *stage = mem_pool_alloc(&pool, 200, TEST_OWNER_A, MEM_POOL_FLAG_NONE);
+
+    CHECK((permanent != NULL) && (stage != NULL));
+    for (uint32_t pass = 0; pass < TEST_RECREATE_COUNT; pass++) {
+        for (size_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+            block[i] = mem_pool_alloc(&pool, sizes[i], TEST_OWNER_B, MEM_POOL_FLAG_NONE);
+            CHECK(block[i] != NULL);
+            CHECK(is_filled(block[i], sizes[i], 0));
+            memset(block[i], (uint8_t)(i + 1), sizes[i]);
+            if (pass == 0) {
+                first_block[i] = block[i];
+            } else {
+                CHECK(block[i] == first_block[i]);
+            }
+        }
+        if (pass == 0) {
+            allocated_bytes = mem_pool_get_allocated_bytes(&pool);
+            peak = mem_pool_get_high_water_mark(&pool);
+        }
+        CHECK(mem_pool_get_allocated_bytes(&pool) == allocated_bytes);
+        CHECK(mem_pool_get_high_water_mark(&pool) == peak);
+
+        for (size_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+            CHECK(is_filled(block[i], sizes[i], (uint8_t)(i + 1)));
+            mem_pool_release(&pool, block[i]);
+        }
+        CHECK(mem_pool_get_owner_bytes(&pool, TEST_OWNER_B) == 0);
+        CHECK(mem_pool_get_owner_bytes(&pool, TEST_OWNER_A) > 200);
+    }
+    mem_pool_release(&pool, stage);
+    CHECK(mem_pool_get_allocated_bytes(&pool) == mem_pool_get_owner_bytes(&pool, MEM_POOL_OWNER_DEFAULT));
+    CHECK(pool.free_list_map == 0);
+
+    return true;
+}
+
+/** @brief Check a block alignment.
+ *
+ *  @param[in] ptr  Block.
+ *  @return True if the block is aligned on MEM_POOL_ALIGNMENT.
+ */
+static bool is_aligned(void *ptr)
+{
+    return ((uintptr_t)ptr % MEM_POOL_ALIGNMENT) == 0;
+}
+
+/** @brief Check a block content.
+ *
+ *  @param[in] block    Block.
+ *  @param[in] size     Block size, in bytes.
+ *  @param[in] pattern  Expected value of every byte.
+ *  @return True if every byte matches.
+ */
+static bool is_filled(uint8_t *block, size_t size, uint8_t pattern)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (block[i] != pattern) {
+            return false;
+        }
+    }
+
+    return true;
+}
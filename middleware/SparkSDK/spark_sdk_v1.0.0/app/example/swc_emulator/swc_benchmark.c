@@ -0,0 +1,462 @@
+/** @file  swc_benchmark.c
+ *  @brief This application benchmarks a SPARK Wireless Core link on a host computer.
+ *         A coordinator and a node run the emulator node application, both sending
+ *         as fast as the link allows. Cases of varying payload size, timeslot
+ *         duration, channel count, ACK/ARQ settings and throttling ratio are run back
+ *         to back, and the goodput, the frame latency percentiles, the retries and
+ *         the processing cost per frame are reported, to size a link before
+ *         deploying it.
+ *
+ *         Both sides keep their transmission queue full, so the latency includes the
+ *         queueing delay of a saturated link.
+ *
+ *         The processing cost is the host time spent executing the node code. The
+ *         SPI bytes per frame are also given as they drive most of the cycles spent
+ *         by the microcontroller of the EVK.
+ *
+ *         Build and run with CMake:
+ *             cmake -S app/example/swc_emulator -B build
+ *             cmake --build build
+ *             ./build/swc_benchmark -h
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "emu.h"
+#include "swc_emulator_app.h"
+
+/* CONSTANTS ******************************************************************/
+#define BENCH_PROCESS_PERIOD_US      50     /* Main loop pass period of both nodes */
+#define BENCH_START_OFFSET_US        1234   /* Power up offset of the node after the coordinator */
+#define BENCH_CHIP_ID_BASE           0x1000
+#define BENCH_NODE_COUNT             2      /* Coordinator and node */
+
+/* Default benchmark options */
+#define BENCH_DEFAULT_WARMUP_MS      1000
+#define BENCH_DEFAULT_DURATION_MS    2000
+#define BENCH_DEFAULT_LOSS_PERCENT   2.0
+#define BENCH_DEFAULT_DRIFT_PPM      20.0
+#define BENCH_DEFAULT_SEED           1
+
+/* TYPES **********************************************************************/
+/** @brief Benchmark ACK and ARQ Settings.
+ */
+typedef enum bench_arq {
+    BENCH_ARQ_NONE,    /*!< No acknowledge */
+    BENCH_ARQ_ACK,     /*!< Acknowledge without retransmission */
+    BENCH_ARQ_RETRY_3, /*!< Up to 3 retries */
+    BENCH_ARQ_INFINITE /*!< Retransmit until acknowledged */
+} bench_arq_t;
+
+/** @brief Benchmark Case.
+ */
+typedef struct bench_case {
+    uint8_t payload_size;     /*!< Size of each payload sent */
+    uint32_t timeslot_us;     /*!< Duration of each timeslot */
+    uint8_t channel_count;    /*!< Number of channels hopped through */
+    bench_arq_t arq;          /*!< ACK and ARQ settings */
+    uint8_t throttling_ratio; /*!< Percentage of the TX timeslots used */
+} bench_case_t;
+
+/** @brief Benchmark Options.
+ */
+typedef struct bench_cfg {
+    uint32_t warmup_ms;    /*!< Emulated duration left to synchronize before measuring */
+    uint32_t duration_ms;  /*!< Emulated duration measured for each case */
+    double loss_percent;   /*!< Probability of losing a frame between the two transceivers */
+    double drift_ppm;      /*!< Maximum drift of the transceiver timers, uniformly distributed */
+    uint32_t seed;         /*!< Seed of the medium loss and drift generators */
+} bench_cfg_t;
+
+/** @brief Benchmark Case Results.
+ */
+typedef struct bench_result {
+    uint64_t rx_count;          /*!< Frames received in both directions */
+    uint64_t rx_byte_count;     /*!< Payload bytes received in both directions */
+    uint64_t rx_missed_count;   /*!< Frames never received in both directions */
+    uint32_t latency_p50_us;    /*!< Median latency */
+    uint32_t latency_p90_us;    /*!< 90th percentile latency */
+    uint32_t latency_p99_us;    /*!< 99th percentile latency */
+    uint32_t latency_max_us;    /*!< Maximum latency */
+    uint64_t tx_retry_count;    /*!< Transmissions not acknowledged */
+    uint64_t tx_dropped_count;  /*!< Frames dropped by the ARQ */
+    uint64_t host_time_ns;      /*!< Host time spent in the code of both nodes */
+    uint64_t spi_byte_count;    /*!< Bytes transferred over the radio SPI of both nodes */
+} bench_result_t;
+
+/* PRIVATE GLOBALS ************************************************************/
+static bench_cfg_t bench_cfg = {
+    .warmup_ms = BENCH_DEFAULT_WARMUP_MS,
+    .duration_ms = BENCH_DEFAULT_DURATION_MS,
+    .loss_percent = BENCH_DEFAULT_LOSS_PERCENT,
+    .drift_ppm = BENCH_DEFAULT_DRIFT_PPM,
+    .seed = BENCH_DEFAULT_SEED,
+};
+
+/* Each parameter is swept in turn around the first case */
+static const bench_case_t bench_cases[] = {
+    {32,  500,  5, BENCH_ARQ_INFINITE, 100},
+    {8,   500,  5, BENCH_ARQ_INFINITE, 100},
+    {64,  500,  5, BENCH_ARQ_INFINITE, 100},
+    {100, 500,  5, BENCH_ARQ_INFINITE, 100},
+    {32,  250,  5, BENCH_ARQ_INFINITE, 100},
+    {32,  1000, 5, BENCH_ARQ_INFINITE, 100},
+    {32,  2000, 5, BENCH_ARQ_INFINITE, 100},
+    {32,  500,  1, BENCH_ARQ_INFINITE, 100},
+    {32,  500,  3, BENCH_ARQ_INFINITE, 100},
+    {32,  500,  5, BENCH_ARQ_NONE,     100},
+    {32,  500,  5, BENCH_ARQ_ACK,      100},
+    {32,  500,  5, BENCH_ARQ_RETRY_3,  100},
+    {32,  500,  5, BENCH_ARQ_INFINITE, 75},
+    {32,  500,  5, BENCH_ARQ_INFINITE, 50},
+    {32,  500,  5, BENCH_ARQ_INFINITE, 25},
+};
+
+static const char *const bench_arq_name[] = {
+    [BENCH_ARQ_NONE]     = "none",
+    [BENCH_ARQ_ACK]      = "ack",
+    [BENCH_ARQ_RETRY_3]  = "arq 3",
+    [BENCH_ARQ_INFINITE] = "arq inf",
+};
+
+static emu_node_t *nodes[BENCH_NODE_COUNT];
+static swc_emu_app_cfg_t app_cfg[BENCH_NODE_COUNT];
+static uint32_t latency_histogram[SWC_EMU_APP_LATENCY_BIN_COUNT];
+static uint32_t random_state;
+
+/* PRIVATE FUNCTION PROTOTYPE *************************************************/
+static bool parse_options(int argc, char *argv[]);
+static void print_usage(const char *name);
+static bool run_bench_case(const bench_case_t *bench_case, bench_result_t *result);
+static bool create_link(const bench_case_t *bench_case);
+static void destroy_link(void);
+static const swc_emu_app_stats_t *get_node_stats(emu_node_t *node);
+static bool reset_node_stats(emu_node_t *node);
+static uint32_t get_latency_percentile(uint64_t count, uint32_t percent, uint32_t latency_max_us);
+static uint32_t get_random(void);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+int main(int argc, char *argv[])
+{
+    const bench_case_t *bench_case;
+    bench_result_t result;
+    uint32_t fail_count = 0;
+    double rx_per_ms;
+
+    if (!parse_options(argc, argv)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("Benchmarking %" PRIu32 " ms per case after %" PRIu32 " ms of warmup: loss %.2f %%, drift %.1f ppm\n",
+           bench_cfg.duration_ms, bench_cfg.warmup_ms, bench_cfg.loss_percent, bench_cfg.drift_ppm);
+    printf("%7s %8s %4s %-7s %5s %9s %8s %8s %8s %8s %8s %7s %7s %7s %9s %7s\n", "payload", "slot us", "chan",
+           "arq", "thr %", "kbit/s", "frames/s", "p50 us", "p90 us", "p99 us", "max us", "retry %", "dropped", "lost",
+           "ns/frame", "SPI B/f");
+
+    for (size_t i = 0; i < (sizeof(bench_cases) / sizeof(bench_cases[0])); i++) {
+        bench_case = &bench_cases[i];
+
+        printf("%7u %8" PRIu32 " %4u %-7s %5u ", bench_case->payload_size, bench_case->timeslot_us,
+               bench_case->channel_count, bench_arq_name[bench_case->arq], bench_case->throttling_ratio);
+        if (!run_bench_case(bench_case, &result)) {
+            printf("FAIL: link not established\n");
+            fail_count++;
+            continue;
+        }
+        if (result.rx_count == 0) {
+            printf("FAIL: no frame received\n");
+            fail_count++;
+            continue;
+        }
+
+        rx_per_ms = (double)result.rx_count / bench_cfg.duration_ms;
+        printf("%9.1f %8.0f %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %7.2f %7" PRIu64 " %7" PRIu64
+               " %9.0f %7.1f\n", (double)result.rx_byte_count * 8 / bench_cfg.duration_ms, rx_per_ms * 1000,
+               result.latency_p50_us, result.latency_p90_us, result.latency_p99_us, result.latency_max_us,
+               (double)result.tx_retry_count * 100 / result.rx_count, result.tx_dropped_count, result.rx_missed_count,
+               (double)result.host_time_ns / result.rx_count, (double)result.spi_byte_count / result.rx_count);
+    }
+
+    if (fail_count > 0) {
+        printf("%" PRIu32 " case(s) failed\n", fail_count);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Parse the command line options.
+ *
+ *  @param[in] argc  Number of arguments.
+ *  @param[in] argv  Arguments.
+ *  @retval True   Options are valid.
+ *  @retval False  Options are invalid.
+ */
+static bool parse_options(int argc, char *argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:d:l:c:s:h")) != -1) {
+        switch (opt) {
+        case 'w':
+            bench_cfg.warmup_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            bench_cfg.duration_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'l':
+            bench_cfg.loss_percent = strtod(optarg, NULL);
+            break;
+        case 'c':
+            bench_cfg.drift_ppm = strtod(optarg, NULL);
+            break;
+        case 's':
+            bench_cfg.seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return false;
+        }
+    }
+
+    if ((bench_cfg.duration_ms == 0) || (bench_cfg.loss_percent < 0.0) || (bench_cfg.loss_percent > 100.0) ||
+        (bench_cfg.drift_ppm < 0.0) || (bench_cfg.seed == 0)) {
+        return false;
+    }
+
+    return true;
+}
+
+/** @brief Print the command line usage.
+ *
+ *  @param[in] name  Name of the executable.
+ */
+static void print_usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -w <ms>   Emulated duration before measuring each case (default %u)\n", BENCH_DEFAULT_WARMUP_MS);
+    printf("  -d <ms>   Emulated duration measured for each case (default %u)\n", BENCH_DEFAULT_DURATION_MS);
+    printf("  -l <%%>    Frame loss probability between the transceivers (default %.2f)\n",
+           BENCH_DEFAULT_LOSS_PERCENT);
+    printf("  -c <ppm>  Maximum drift of the transceiver timers (default %.1f)\n", BENCH_DEFAULT_DRIFT_PPM);
+    printf("  -s <n>    Non-zero seed of the loss and drift generators (default %u)\n", BENCH_DEFAULT_SEED);
+}
+
+/** @brief Run a benchmark case.
+ *
+ *  The emulator is reinitialized with the same seed, so every case starts from the same state.
+ *
+ *  @param[in]  bench_case  Benchmark case to run.
+ *  @param[out] result      Results measured after the warmup.
+ *  @retval True   Results are valid.
+ *  @retval False  The link could not be created or was not synchronized after the warmup.
+ */
+static bool run_bench_case(const bench_case_t *bench_case, bench_result_t *result)
+{
+    const swc_emu_app_stats_t *stats;
+    uint64_t warmup_end = EMU_US_TO_CYCLES((uint64_t)bench_cfg.warmup_ms * 1000);
+    uint64_t host_time_ns[BENCH_NODE_COUNT];
+    uint64_t spi_byte_count[BENCH_NODE_COUNT];
+    bool success = true;
+
+    memset(result, 0, sizeof(bench_result_t));
+    memset(latency_histogram, 0, sizeof(latency_histogram));
+    random_state = bench_cfg.seed;
+
+    emu_sched_init();
+    emu_air_init(bench_cfg.seed);
+    if (!create_link(bench_case)) {
+        destroy_link();
+        emu_sched_deinit();
+        return false;
+    }
+
+    emu_sched_run_until(warmup_end);
+    for (uint8_t i = 0; i < BENCH_NODE_COUNT; i++) {
+        stats = get_node_stats(nodes[i]);
+        if ((stats == NULL) || (stats->rx_count == 0) || !reset_node_stats(nodes[i])) {
+            success = false;
+        }
+        host_time_ns[i]   = nodes[i]->stats.host_time_ns;
+        spi_byte_count[i] = nodes[i]->stats.spi_byte_count;
+    }
+
+    if (success) {
+        emu_sched_run_until(warmup_end + EMU_US_TO_CYCLES((uint64_t)bench_cfg.duration_ms * 1000));
+        for (uint8_t i = 0; i < BENCH_NODE_COUNT; i++) {
+            stats = get_node_stats(nodes[i]);
+            result->rx_count += stats->rx_count;
+            result->rx_byte_count += stats->rx_byte_count;
+            result->rx_missed_count += stats->rx_missed_count;
+            result->tx_retry_count += stats->tx_retry_count;
+            result->tx_dropped_count += stats->tx_dropped_count;
+            if (stats->latency_max_us > result->latency_max_us) {
+                result->latency_max_us = stats->latency_max_us;
+            }
+            for (uint32_t bin = 0; bin < SWC_EMU_APP_LATENCY_BIN_COUNT; bin++) {
+                latency_histogram[bin] += stats->latency_histogram[bin];
+            }
+            result->host_time_ns += nodes[i]->stats.host_time_ns - host_time_ns[i];
+            result->spi_byte_count += nodes[i]->stats.spi_byte_count - spi_byte_count[i];
+        }
+        result->latency_p50_us = get_latency_percentile(result->rx_count, 50, result->latency_max_us);
+        result->latency_p90_us = get_latency_percentile(result->rx_count, 90, result->latency_max_us);
+        result->latency_p99_us = get_latency_percentile(result->rx_count, 99, result->latency_max_us);
+    }
+
+    destroy_link();
+    emu_sched_deinit();
+
+    return success;
+}
+
+/** @brief Create the coordinator and the node and power them up.
+ *
+ *  @param[in] bench_case  Benchmark case to configure the link for.
+ *  @retval True   Link is running.
+ *  @retval False  A node could not be created.
+ */
+static bool create_link(const bench_case_t *bench_case)
+{
+    emu_air_link_t link;
+    double drift;
+
+    for (uint8_t i = 0; i < BENCH_NODE_COUNT; i++) {
+        nodes[i] = emu_node_create(SWC_EMULATOR_APP_PATH, BENCH_CHIP_ID_BASE + i);
+        if (nodes[i] == NULL) {
+            return false;
+        }
+        drift = ((double)get_random() / UINT32_MAX * 2.0 - 1.0) * bench_cfg.drift_ppm;
+        emu_sr1000_set_drift(&nodes[i]->radio, drift);
+    }
+
+    for (uint8_t from = 0; from < BENCH_NODE_COUNT; from++) {
+        link = *emu_air_get_link(nodes[from]->radio.air_index, nodes[1 - from]->radio.air_index);
+        link.loss = bench_cfg.loss_percent / 100.0;
+        emu_air_set_link(nodes[from]->radio.air_index, nodes[1 - from]->radio.air_index, &link);
+    }
+
+    /* Node 0 is the coordinator, node 1 powers up later to have to find its beacons */
+    for (uint8_t i = 0; i < BENCH_NODE_COUNT; i++) {
+        app_cfg[i] = (swc_emu_app_cfg_t){
+            .coordinator = (i == 0),
+            .node_index = 0,
+            .node_count = 1,
+            .payload_size = bench_case->payload_size,
+            .timeslot_us = bench_case->timeslot_us,
+            .channel_count = bench_case->channel_count,
+            .ack_enabled = (bench_case->arq != BENCH_ARQ_NONE),
+            .arq_enabled = (bench_case->arq >= BENCH_ARQ_RETRY_3),
+            .arq_retry_count = (bench_case->arq == BENCH_ARQ_RETRY_3) ? 3 : 0,
+            .throttling_ratio = bench_case->throttling_ratio
+        };
+        emu_sched_run_until(EMU_US_TO_CYCLES((uint64_t)i * BENCH_START_OFFSET_US));
+        emu_node_start(nodes[i], &app_cfg[i], BENCH_PROCESS_PERIOD_US, emu_sched_get_time());
+    }
+
+    return true;
+}
+
+/** @brief Destroy the coordinator and the node.
+ */
+static void destroy_link(void)
+{
+    for (uint8_t i = 0; i < BENCH_NODE_COUNT; i++) {
+        if (nodes[i] != NULL) {
+            emu_node_destroy(nodes[i]);
+            nodes[i] = NULL;
+        }
+    }
+}
+
+/** @brief Get the application statistics of a node.
+ *
+ *  @param[in] node  Node.
+ *  @return Application statistics, NULL if the node application does not export them.
+ */
+static const swc_emu_app_stats_t *get_node_stats(emu_node_t *node)
+{
+    swc_emu_app_get_stats_t get_stats;
+    const swc_emu_app_stats_t *stats;
+
+    get_stats = (swc_emu_app_get_stats_t)emu_node_get_symbol(node, SWC_EMU_APP_GET_STATS_SYMBOL);
+    if (get_stats == NULL) {
+        return NULL;
+    }
+    emu_node_enter(node);
+    stats = get_stats();
+    emu_node_exit(node);
+
+    return stats;
+}
+
+/** @brief Reset the application and Wireless Core statistics of a node.
+ *
+ *  @param[in] node  Node.
+ *  @retval True   Statistics are reset.
+ *  @retval False  The node application does not export the reset function.
+ */
+static bool reset_node_stats(emu_node_t *node)
+{
+    swc_emu_app_reset_stats_t reset_stats;
+
+    reset_stats = (swc_emu_app_reset_stats_t)emu_node_get_symbol(node, SWC_EMU_APP_RESET_STATS_SYMBOL);
+    if (reset_stats == NULL) {
+        return false;
+    }
+    emu_node_enter(node);
+    reset_stats();
+    emu_node_exit(node);
+
+    return true;
+}
+
+/** @brief Get a latency percentile from the merged latency histogram.
+ *
+ *  The upper bound of the bin holding the percentile is returned, bounded by the maximum latency.
+ *
+ *  @param[in] count           Number of latencies in the histogram.
+ *  @param[in] percent         Percentile, from 1 to 100.
+ *  @param[in] latency_max_us  Maximum latency.
+ *  @return Latency in microseconds.
+ */
+static uint32_t get_latency_percentile(uint64_t count, uint32_t percent, uint32_t latency_max_us)
+{
+    uint64_t target = (count * percent + 99) / 100;
+    uint64_t cumulative = 0;
+    uint32_t latency_us;
+
+    for (uint32_t bin = 0; bin < SWC_EMU_APP_LATENCY_BIN_COUNT; bin++) {
+        cumulative += latency_histogram[bin];
+        if (cumulative >= target) {
+            latency_us = (bin + 1) * SWC_EMU_APP_LATENCY_BIN_US;
+            return (latency_us < latency_max_us) ? latency_us : latency_max_us;
+        }
+    }
+
+    return latency_max_us;
+}
+
+/** @brief Get a pseudo-random number.
+ *
+ *  @return Random number.
+ */
+static uint32_t get_random(void)
+{
+    /* Xorshift32 */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
@@ -0,0 +1,323 @@
+/** @file  swc_emulator.c
+ *  @brief This application runs a network of SPARK Wireless Core nodes on a host computer.
+ *         Each node runs the unmodified Wireless Core against an emulated SR1000 transceiver
+ *         and microcontroller, the transceivers sharing an emulated medium with configurable
+ *         frame loss. Everything runs from a virtual clock, so every run with the same options
+ *         gives the same results.
+ *
+ *         Build and run with CMake:
+ *             cmake -S app/example/swc_emulator -B build
+ *             cmake --build build
+ *             ./build/swc_emulator -h
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "emu.h"
+#include "swc_emulator_app.h"
+
+/* CONSTANTS ******************************************************************/
+#define SWC_EMU_PROCESS_PERIOD_US    50     /* Main loop pass period of every node */
+#define SWC_EMU_START_OFFSET_US      1234   /* Power up offset between two nodes */
+#define SWC_EMU_CHIP_ID_BASE         0x1000
+
+/* Default emulation options */
+#define SWC_EMU_DEFAULT_NODE_COUNT   1
+#define SWC_EMU_DEFAULT_DURATION_MS  5000
+#define SWC_EMU_DEFAULT_PAYLOAD_SIZE 16
+#define SWC_EMU_DEFAULT_TIMESLOT_US  500
+#define SWC_EMU_DEFAULT_LOSS_PERCENT 0.0
+#define SWC_EMU_DEFAULT_DRIFT_PPM    20.0
+#define SWC_EMU_DEFAULT_SEED         1
+
+/* TYPES **********************************************************************/
+/** @brief Emulation Options.
+ */
+typedef struct emu_cfg {
+    uint8_t node_count;    /*!< Number of nodes around the coordinator */
+    uint32_t duration_ms;  /*!< Emulated duration in milliseconds */
+    uint8_t payload_size;  /*!< Size of each payload sent */
+    uint32_t timeslot_us;  /*!< Duration of each timeslot */
+    double loss_percent;   /*!< Probability of losing a frame between any two transceivers */
+    double drift_ppm;      /*!< Maximum drift of the transceiver timers, uniformly distributed */
+    uint32_t seed;         /*!< Seed of the medium loss and drift generators */
+    bool verbose;          /*!< Print the Wireless Core statistics of every connection */
+    bool rx_in_place;      /*!< Receive in application buffers instead of the reception queue */
+} emu_cfg_t;
+
+/* PRIVATE GLOBALS ************************************************************/
+static emu_cfg_t emu_cfg = {
+    .node_count = SWC_EMU_DEFAULT_NODE_COUNT,
+    .duration_ms = SWC_EMU_DEFAULT_DURATION_MS,
+    .payload_size = SWC_EMU_DEFAULT_PAYLOAD_SIZE,
+    .timeslot_us = SWC_EMU_DEFAULT_TIMESLOT_US,
+    .loss_percent = SWC_EMU_DEFAULT_LOSS_PERCENT,
+    .drift_ppm = SWC_EMU_DEFAULT_DRIFT_PPM,
+    .seed = SWC_EMU_DEFAULT_SEED,
+    .verbose = false,
+    .rx_in_place = false,
+};
+static emu_node_t *nodes[SWC_EMU_APP_MAX_NODE_COUNT + 1];
+static swc_emu_app_cfg_t app_cfg[SWC_EMU_APP_MAX_NODE_COUNT + 1];
+static uint32_t random_state;
+
+/* PRIVATE FUNCTION PROTOTYPE *************************************************/
+static bool parse_options(int argc, char *argv[]);
+static void print_usage(const char *name);
+static bool create_network(void);
+static void destroy_network(void);
+static bool print_stats(void);
+static uint32_t get_random(void);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+int main(int argc, char *argv[])
+{
+    bool success;
+
+    if (!parse_options(argc, argv)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("Emulating %" PRIu32 " ms: %u node(s), payload %u bytes, timeslot %" PRIu32 " us, loss %.2f %%, "
+           "drift %.1f ppm\n", emu_cfg.duration_ms, emu_cfg.node_count, emu_cfg.payload_size, emu_cfg.timeslot_us,
+           emu_cfg.loss_percent, emu_cfg.drift_ppm);
+
+    emu_sched_init();
+    emu_air_init(emu_cfg.seed);
+    if (!create_network()) {
+        destroy_network();
+        emu_sched_deinit();
+        return EXIT_FAILURE;
+    }
+
+    emu_sched_run_until(EMU_US_TO_CYCLES((uint64_t)emu_cfg.duration_ms * 1000));
+
+    success = print_stats();
+    destroy_network();
+    emu_sched_deinit();
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Parse the command line options.
+ *
+ *  @param[in] argc  Number of arguments.
+ *  @param[in] argv  Arguments.
+ *  @retval True   Options are valid.
+ *  @retval False  Options are invalid.
+ */
+static bool parse_options(int argc, char *argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:p:t:l:c:s:rvh")) != -1) {
+        switch (opt) {
+        case 'n':
+            emu_cfg.node_count = (uint8_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            emu_cfg.duration_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            emu_cfg.payload_size = (uint8_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            emu_cfg.timeslot_us = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'l':
+            emu_cfg.loss_percent = strtod(optarg, NULL);
+            break;
+        case 'c':
+            emu_cfg.drift_ppm = strtod(optarg, NULL);
+            break;
+        case 's':
+            emu_cfg.seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            emu_cfg.rx_in_place = true;
+            break;
+        case 'v':
+            emu_cfg.verbose = true;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    if ((emu_cfg.node_count == 0) || (emu_cfg.node_count > SWC_EMU_APP_MAX_NODE_COUNT) ||
+        (emu_cfg.payload_size < SWC_EMU_APP_MIN_PAYLOAD_SIZE) ||
+        (emu_cfg.payload_size > SWC_EMU_APP_MAX_PAYLOAD_SIZE) || (emu_cfg.timeslot_us == 0) ||
+        (emu_cfg.loss_percent < 0.0) || (emu_cfg.loss_percent > 100.0) || (emu_cfg.drift_ppm < 0.0) ||
+        (emu_cfg.seed == 0)) {
+        return false;
+    }
+    random_state = emu_cfg.seed;
+
+    return true;
+}
+
+/** @brief Print the command line usage.
+ *
+ *  @param[in] name  Name of the executable.
+ */
+static void print_usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -n <n>    Number of nodes around the coordinator, up to %u (default %u)\n", SWC_EMU_APP_MAX_NODE_COUNT,
+           SWC_EMU_DEFAULT_NODE_COUNT);
+    printf("  -d <ms>   Emulated duration (default %u)\n", SWC_EMU_DEFAULT_DURATION_MS);
+    printf("  -p <n>    Payload size, from %u to %u bytes (default %u)\n", SWC_EMU_APP_MIN_PAYLOAD_SIZE,
+           SWC_EMU_APP_MAX_PAYLOAD_SIZE, SWC_EMU_DEFAULT_PAYLOAD_SIZE);
+    printf("  -t <us>   Timeslot duration (default %u)\n", SWC_EMU_DEFAULT_TIMESLOT_US);
+    printf("  -l <%%>    Frame loss probability between transceivers (default %.2f)\n", SWC_EMU_DEFAULT_LOSS_PERCENT);
+    printf("  -c <ppm>  Maximum drift of the transceiver timers (default %.1f)\n", SWC_EMU_DEFAULT_DRIFT_PPM);
+    printf("  -s <n>    Non-zero seed of the loss and drift generators (default %u)\n", SWC_EMU_DEFAULT_SEED);
+    printf("  -r        Receive in place in buffers exchanged with the reception queue\n");
+    printf("  -v        Print the Wireless Core statistics of every connection\n");
+}
+
+/** @brief Create the coordinator and the nodes and power them up.
+ *
+ *  @retval True   Network is running.
+ *  @retval False  A node could not be created.
+ */
+static bool create_network(void)
+{
+    emu_air_link_t link;
+    double drift;
+    uint8_t count = emu_cfg.node_count + 1;
+
+    for (uint8_t i = 0; i < count; i++) {
+        nodes[i] = emu_node_create(SWC_EMULATOR_APP_PATH, SWC_EMU_CHIP_ID_BASE + i);
+        if (nodes[i] == NULL) {
+            return false;
+        }
+        drift = ((double)get_random() / UINT32_MAX * 2.0 - 1.0) * emu_cfg.drift_ppm;
+        emu_sr1000_set_drift(&nodes[i]->radio, drift);
+    }
+
+    for (uint8_t from = 0; from < count; from++) {
+        for (uint8_t to = 0; to < count; to++) {
+            if (from != to) {
+                link = *emu_air_get_link(nodes[from]->radio.air_index, nodes[to]->radio.air_index);
+                link.loss = emu_cfg.loss_percent / 100.0;
+                emu_air_set_link(nodes[from]->radio.air_index, nodes[to]->radio.air_index, &link);
+            }
+        }
+    }
+
+    /* Node 0 is the coordinator, the others power up later to have to find its beacons */
+    for (uint8_t i = 0; i < count; i++) {
+        app_cfg[i] = (swc_emu_app_cfg_t){
+            .coordinator = (i == 0),
+            .node_index = (i == 0) ? 0 : (i - 1),
+            .node_count = emu_cfg.node_count,
+            .payload_size = emu_cfg.payload_size,
+            .timeslot_us = emu_cfg.timeslot_us,
+            .channel_count = SWC_EMU_APP_MAX_CHANNEL_COUNT,
+            .ack_enabled = true,
+            .arq_enabled = true,
+            .arq_retry_count = 0,
+            .throttling_ratio = 100,
+            .rx_in_place = emu_cfg.rx_in_place
+        };
+        emu_sched_run_until(EMU_US_TO_CYCLES((uint64_t)i * SWC_EMU_START_OFFSET_US));
+        emu_node_start(nodes[i], &app_cfg[i], SWC_EMU_PROCESS_PERIOD_US, emu_sched_get_time());
+    }
+
+    return true;
+}
+
+/** @brief Destroy the coordinator and the nodes.
+ */
+static void destroy_network(void)
+{
+    for (uint8_t i = 0; i <= emu_cfg.node_count; i++) {
+        if (nodes[i] != NULL) {
+            emu_node_destroy(nodes[i]);
+            nodes[i] = NULL;
+        }
+    }
+}
+
+/** @brief Print the statistics of every node and of the medium.
+ *
+ *  @retval True   The coordinator received frames from every node and every node from the coordinator.
+ *  @retval False  At least one link never carried a frame.
+ */
+static bool print_stats(void)
+{
+    const swc_emu_app_stats_t *stats;
+    const emu_air_stats_t *air_stats = emu_air_get_stats();
+    swc_emu_app_get_stats_t get_stats;
+    swc_emu_app_print_stats_t print_swc_stats;
+    bool success = true;
+    emu_node_t *node;
+
+    printf("%-12s %10s %10s %10s %10s %10s %10s %10s %10s %12s\n", "Node", "TX ACKed", "TX NACKed", "RX",
+           "RX missed", "Lat avg us", "Lat max us", "Radio IRQ", "DMA IRQ", "SPI bytes");
+    for (uint8_t i = 0; i <= emu_cfg.node_count; i++) {
+        node      = nodes[i];
+        get_stats = (swc_emu_app_get_stats_t)emu_node_get_symbol(node, SWC_EMU_APP_GET_STATS_SYMBOL);
+        if (get_stats == NULL) {
+            return false;
+        }
+        emu_node_enter(node);
+        stats = get_stats();
+        emu_node_exit(node);
+        if (i == 0) {
+            printf("%-12s ", "Coordinator");
+        } else {
+            printf("Node %-7u ", i);
+        }
+        printf("%10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu64 " %10" PRIu32 " %10" PRIu64
+               " %10" PRIu64 " %12" PRIu64 "\n",
+               stats->tx_acked_count, stats->tx_not_acked_count, stats->rx_count, stats->rx_missed_count,
+               (stats->rx_count > 0) ? (stats->latency_sum_us / stats->rx_count) : 0, stats->latency_max_us,
+               node->stats.irq_count[EMU_IRQ_RADIO], node->stats.irq_count[EMU_IRQ_RADIO_DMA],
+               node->stats.spi_byte_count);
+
+        /* Every node, including the coordinator, must have exchanged frames once synchronized */
+        if ((stats->rx_count == 0) || (stats->tx_acked_count == 0)) {
+            success = false;
+        }
+
+        if (emu_cfg.verbose) {
+            print_swc_stats = (swc_emu_app_print_stats_t)emu_node_get_symbol(node, SWC_EMU_APP_PRINT_STATS_SYMBOL);
+            if (print_swc_stats != NULL) {
+                emu_node_enter(node);
+                print_swc_stats();
+                emu_node_exit(node);
+            }
+        }
+    }
+    printf("Medium: %" PRIu64 " frames, %" PRIu64 " lost, %" PRIu64 " collisions\n", air_stats->frame_count,
+           air_stats->loss_count, air_stats->collision_count);
+
+    return success;
+}
+
+/** @brief Get a pseudo-random number.
+ *
+ *  @return Random number.
+ */
+static uint32_t get_random(void)
+{
+    /* Xorshift32 */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
@@ -0,0 +1,432 @@
+/** @file  swc_emulator_app.c
+ *  @brief Node application of the SPARK Wireless Core emulator.
+ *
+ *  A star network based on the hello world example: the coordinator and each
+ *  node exchange acknowledged frames carrying a sequence number and the time
+ *  they were sent, so the host can measure the loss and the latency.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "emu_timer.h"
+#include "iface_wireless.h"
+#include "swc_api.h"
+#include "swc_emulator_app.h"
+#include "swc_stats.h"
+
+/* CONSTANTS ******************************************************************/
+#define SWC_MEM_POOL_SIZE  40000
+#define PAN_ID             0xBCD
+#define TX_DATA_QUEUE_SIZE 2
+#define RX_DATA_QUEUE_SIZE 2
+#define PULSE_COUNT        3
+#define PULSE_WIDTH        6
+#define PULSE_GAIN         0
+#define MAX_CONN_COUNT     SWC_EMU_APP_MAX_NODE_COUNT /* Per direction */
+#define RX_BUFFER_HEADROOM 16 /* Room for the frame header in front of a payload received in place */
+#define RX_BUFFER_COUNT    (RX_DATA_QUEUE_SIZE + 1) /* One in each reception queue entry and a spare */
+
+/* PRIVATE GLOBALS ************************************************************/
+/* ** Wireless Core ** */
+static uint8_t swc_memory_pool[SWC_MEM_POOL_SIZE];
+static swc_hal_t hal;
+static swc_node_t *node;
+static swc_connection_t *tx_conn[MAX_CONN_COUNT];
+static swc_connection_t *rx_conn[MAX_CONN_COUNT];
+static uint8_t conn_count;
+
+static uint32_t timeslot_us[2 * MAX_CONN_COUNT];
+static uint32_t channel_sequence[SWC_EMU_APP_MAX_CHANNEL_COUNT] = {0, 1, 2, 3, 4};
+static uint32_t channel_frequency[SWC_EMU_APP_MAX_CHANNEL_COUNT] = {164, 171, 178, 185, 192};
+static int32_t tx_timeslots[MAX_CONN_COUNT][1];
+static int32_t rx_timeslots[MAX_CONN_COUNT][1];
+
+/* ** Application Specific ** */
+static swc_emu_app_cfg_t app_cfg;
+static swc_emu_app_stats_t app_stats;
+static uint32_t tx_sequence[MAX_CONN_COUNT];
+static uint32_t rx_sequence[MAX_CONN_COUNT];
+static bool rx_started[MAX_CONN_COUNT];
+static uint8_t rx_buffer[MAX_CONN_COUNT][RX_BUFFER_COUNT][RX_BUFFER_HEADROOM + SWC_EMU_APP_MAX_PAYLOAD_SIZE];
+static uint8_t *rx_spare_payload[MAX_CONN_COUNT];
+static char stats_string[1000];
+
+/* PRIVATE FUNCTION PROTOTYPE *************************************************/
+static void app_swc_core_init(swc_error_t *err);
+static void app_rx_in_place_init(uint8_t index, swc_error_t *err);
+static swc_connection_t *app_connection_init(char *name, uint8_t source, uint8_t destination,
+                                             int32_t *timeslot, bool tx, swc_error_t *err);
+static void conn_tx_success_callback(void *conn);
+static void conn_tx_fail_callback(void *conn);
+static void conn_rx_success_callback(void *conn);
+static void update_swc_stats(void);
+static void write_uint32(uint8_t *buffer, uint32_t value);
+static uint32_t read_uint32(const uint8_t *buffer);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void emu_app_init(void *context)
+{
+    swc_error_t swc_err;
+
+    app_cfg = *(const swc_emu_app_cfg_t *)context;
+    memset(&app_stats, 0, sizeof(app_stats));
+
+    app_swc_core_init(&swc_err);
+    if (swc_err != SWC_ERR_NONE) {
+        fprintf(stderr, "Wireless Core initialization error %d\n", swc_err);
+        return;
+    }
+
+    /* The Wireless Core holds a single pending ratio change, so only the first connection is throttled */
+    if (app_cfg.throttling_ratio < 100) {
+        swc_connection_set_throttling_active_ratio(tx_conn[0], app_cfg.throttling_ratio, &swc_err);
+    }
+
+    swc_connect();
+}
+
+void emu_app_process(void)
+{
+    swc_error_t swc_err;
+    uint8_t *buf;
+
+    for (uint8_t i = 0; i < conn_count; i++) {
+        buf = NULL;
+        swc_connection_get_payload_buffer(tx_conn[i], &buf, &swc_err);
+        if (buf != NULL) {
+            memset(buf, 0, app_cfg.payload_size);
+            write_uint32(&buf[0], tx_sequence[i]++);
+            write_uint32(&buf[4], emu_timer_get_tick_us());
+            swc_connection_send(tx_conn[i], buf, app_cfg.payload_size, &swc_err);
+        }
+    }
+}
+
+const swc_emu_app_stats_t *swc_emu_app_get_stats(void)
+{
+    update_swc_stats();
+
+    return &app_stats;
+}
+
+void swc_emu_app_reset_stats(void)
+{
+    memset(&app_stats, 0, sizeof(app_stats));
+    for (uint8_t i = 0; i < conn_count; i++) {
+        swc_connection_reset_stats(tx_conn[i]);
+        swc_connection_reset_stats(rx_conn[i]);
+    }
+}
+
+void swc_emu_app_print_stats(void)
+{
+    for (uint8_t i = 0; i < conn_count; i++) {
+        swc_connection_update_stats(tx_conn[i]);
+        swc_connection_format_stats(tx_conn[i], node, stats_string, sizeof(stats_string));
+        printf("%s", stats_string);
+        swc_connection_update_stats(rx_conn[i]);
+        swc_connection_format_stats(rx_conn[i], node, stats_string, sizeof(stats_string));
+        printf("%s", stats_string);
+    }
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Initialize the Wireless Core.
+ *
+ *  @param[out] err  Wireless Core error code.
+ */
+static void app_swc_core_init(swc_error_t *err)
+{
+    uint8_t local_address;
+    uint8_t remote_address;
+
+    iface_swc_hal_init(&hal);
+    iface_swc_handlers_init();
+
+    for (uint8_t i = 0; i < (2 * app_cfg.node_count); i++) {
+        timeslot_us[i] = app_cfg.timeslot_us;
+    }
+
+    swc_cfg_t core_cfg = {
+        .timeslot_sequence = timeslot_us,
+        .timeslot_sequence_length = 2 * app_cfg.node_count,
+        .channel_sequence = channel_sequence,
+        .channel_sequence_length = app_cfg.channel_count,
+        .fast_sync_enabled = false,
+        .random_channel_sequence_enabled = false,
+        .memory_pool = swc_memory_pool,
+        .memory_pool_size = SWC_MEM_POOL_SIZE
+    };
+    swc_init(core_cfg, &hal, err);
+    if (*err != SWC_ERR_NONE) {
+        return;
+    }
+
+    local_address = app_cfg.coordinator ? SWC_EMU_APP_COORDINATOR_ADDRESS :
+                                          (SWC_EMU_APP_FIRST_NODE_ADDRESS + app_cfg.node_index);
+    swc_node_cfg_t node_cfg = {
+        .role = app_cfg.coordinator ? NETWORK_COORDINATOR : NETWORK_NODE,
+        .pan_id = PAN_ID,
+        .coordinator_address = SWC_EMU_APP_COORDINATOR_ADDRESS,
+        .local_address = local_address,
+        /* Sleep periods grow with the node count, the idle level would overflow the wake-up timer */
+        .sleep_level = SLEEP_SHALLOW
+    };
+    node = swc_node_init(node_cfg, err);
+    if (*err != SWC_ERR_NONE) {
+        return;
+    }
+
+    swc_radio_cfg_t radio_cfg = {
+        .irq_polarity = IRQ_ACTIVE_HIGH,
+        .std_spi = SPI_STANDARD
+    };
+    swc_node_add_radio(node, radio_cfg, &hal, err);
+    if (*err != SWC_ERR_NONE) {
+        return;
+    }
+
+    /* The coordinator has one connection per direction with every node */
+    conn_count = app_cfg.coordinator ? app_cfg.node_count : 1;
+    for (uint8_t i = 0; i < conn_count; i++) {
+        uint8_t slot_pair = app_cfg.coordinator ? i : app_cfg.node_index;
+
+        remote_address = app_cfg.coordinator ? (SWC_EMU_APP_FIRST_NODE_ADDRESS + i) : SWC_EMU_APP_COORDINATOR_ADDRESS;
+        tx_timeslots[i][0] = MAIN_TIMESLOT(2 * slot_pair + (app_cfg.coordinator ? 0 : 1));
+        rx_timeslots[i][0] = MAIN_TIMESLOT(2 * slot_pair + (app_cfg.coordinator ? 1 : 0));
+
+        tx_conn[i] = app_connection_init("TX Connection", local_address, remote_address, tx_timeslots[i], true, err);
+        if (*err != SWC_ERR_NONE) {
+            return;
+        }
+        rx_conn[i] = app_connection_init("RX Connection", remote_address, local_address, rx_timeslots[i], false, err);
+        if (*err != SWC_ERR_NONE) {
+            return;
+        }
+        if (app_cfg.rx_in_place) {
+            app_rx_in_place_init(i, err);
+            if (*err != SWC_ERR_NONE) {
+                return;
+            }
+        }
+    }
+
+    swc_setup(node);
+}
+
+/** @brief Make a reception connection receive in the application buffers.
+ *
+ *  @param[in]  index  Index of the reception connection.
+ *  @param[out] err    Wireless Core error code.
+ */
+static void app_rx_in_place_init(uint8_t index, swc_error_t *err)
+{
+    uint8_t headroom = swc_connection_get_rx_headroom(rx_conn[index]);
+
+    *err = SWC_ERR_NONE;
+
+    if (headroom > RX_BUFFER_HEADROOM) {
+        *err = SWC_ERR_NOT_ENOUGH_MEMORY;
+        return;
+    }
+    for (uint8_t i = 0; i < RX_DATA_QUEUE_SIZE; i++) {
+        swc_connection_set_rx_payload_buffer(rx_conn[index], i, &rx_buffer[index][i][RX_BUFFER_HEADROOM], err);
+        if (*err != SWC_ERR_NONE) {
+            return;
+        }
+    }
+    rx_spare_payload[index] = &rx_buffer[index][RX_DATA_QUEUE_SIZE][RX_BUFFER_HEADROOM];
+}
+
+/** @brief Initialize a connection on every channel.
+ *
+ *  @param[in]  name         Connection name.
+ *  @param[in]  source       Source address.
+ *  @param[in]  destination  Destination address.
+ *  @param[in]  timeslot     Timeslot of the connection.
+ *  @param[in]  tx           True for a connection sending frames.
+ *  @param[out] err          Wireless Core error code.
+ *  @return Connection handle.
+ */
+static swc_connection_t *app_connection_init(char *name, uint8_t source, uint8_t destination,
+                                             int32_t *timeslot, bool tx, swc_error_t *err)
+{
+    swc_connection_t *conn;
+
+    swc_connection_cfg_t conn_cfg = {
+        .name = name,
+        .source_address = source,
+        .destination_address = destination,
+        .max_payload_size = app_cfg.payload_size,
+        .queue_size = tx ? TX_DATA_QUEUE_SIZE : RX_DATA_QUEUE_SIZE,
+        .modulation = MODULATION_2BITPPM,
+        .fec = FEC_LVL_2,
+        .timeslot_id = timeslot,
+        .timeslot_count = 1,
+        .allocate_payload_memory = true,
+        .ack_enabled = app_cfg.ack_enabled,
+        .arq_enabled = app_cfg.arq_enabled,
+        .arq_settings.retry_count = app_cfg.arq_retry_count,
+        .arq_settings.time_deadline = 0,
+        .auto_sync_enabled = false,
+        .cca_enabled = false,
+        .throttling_enabled = tx && (app_cfg.throttling_ratio < 100),
+        .rdo_enabled = false,
+        .fallback_enabled = false
+    };
+    conn = swc_connection_init(node, conn_cfg, &hal, err);
+    if (*err != SWC_ERR_NONE) {
+        return NULL;
+    }
+
+    swc_channel_cfg_t channel_cfg = {
+        .tx_pulse_count = PULSE_COUNT,
+        .tx_pulse_width = PULSE_WIDTH,
+        .tx_pulse_gain  = PULSE_GAIN,
+        .rx_pulse_count = PULSE_COUNT
+    };
+    for (uint8_t i = 0; i < app_cfg.channel_count; i++) {
+        channel_cfg.frequency = channel_frequency[i];
+        swc_connection_add_channel(conn, node, channel_cfg, err);
+        if (*err != SWC_ERR_NONE) {
+            return NULL;
+        }
+    }
+
+    if (tx) {
+        swc_connection_set_tx_success_callback(conn, conn_tx_success_callback);
+        swc_connection_set_tx_fail_callback(conn, conn_tx_fail_callback);
+    } else {
+        swc_connection_set_rx_success_callback(conn, conn_rx_success_callback);
+    }
+
+    return conn;
+}
+
+/** @brief Callback function when a previously sent frame has been ACK'd.
+ *
+ *  @param[in] conn  Connection the callback function has been linked to.
+ */
+static void conn_tx_success_callback(void *conn)
+{
+    (void)conn;
+
+    app_stats.tx_acked_count++;
+}
+
+/** @brief Callback function when a previously sent frame has not been ACK'd.
+ *
+ *  @param[in] conn  Connection the callback function has been linked to.
+ */
+static void conn_tx_fail_callback(void *conn)
+{
+    (void)conn;
+
+    app_stats.tx_not_acked_count++;
+}
+
+/** @brief Callback function when a frame has been successfully received.
+ *
+ *  @param[in] conn  Connection the callback function has been linked to.
+ */
+static void conn_rx_success_callback(void *conn)
+{
+    swc_error_t err;
+    uint8_t *payload = NULL;
+    uint32_t sequence;
+    uint32_t latency_us;
+    uint8_t size;
+    uint8_t i;
+
+    for (i = 0; (i < conn_count) && (rx_conn[i] != conn); i++);
+    if (i == conn_count) {
+        return;
+    }
+
+    if (app_cfg.rx_in_place) {
+        /* The payload is handed over and the queue entry receives in the spare buffer */
+        size = swc_connection_receive_exchange(rx_conn[i], &payload, rx_spare_payload[i], &err);
+    } else {
+        size = swc_connection_receive(rx_conn[i], &payload, &err);
+    }
+    if ((payload != NULL) && (size >= SWC_EMU_APP_MIN_PAYLOAD_SIZE)) {
+        sequence   = read_uint32(&payload[0]);
+        latency_us = emu_timer_get_tick_us() - read_uint32(&payload[4]);
+
+        if (rx_started[i] && (sequence > rx_sequence[i])) {
+            app_stats.rx_missed_count += sequence - rx_sequence[i];
+        }
+        rx_sequence[i] = sequence + 1;
+        rx_started[i]  = true;
+
+        app_stats.rx_count++;
+        app_stats.rx_byte_count += size;
+        app_stats.latency_sum_us += latency_us;
+        if (latency_us > app_stats.latency_max_us) {
+            app_stats.latency_max_us = latency_us;
+        }
+        if ((latency_us / SWC_EMU_APP_LATENCY_BIN_US) < SWC_EMU_APP_LATENCY_BIN_COUNT) {
+            app_stats.latency_histogram[latency_us / SWC_EMU_APP_LATENCY_BIN_US]++;
+        } else {
+            app_stats.latency_histogram[SWC_EMU_APP_LATENCY_BIN_COUNT - 1]++;
+        }
+    }
+
+    /* Free the payload memory */
+    swc_connection_receive_complete(rx_conn[i], &err);
+    if (app_cfg.rx_in_place && (payload != NULL)) {
+        /* The received buffer is the next one to exchange */
+        rx_spare_payload[i] = payload;
+    }
+}
+
+/** @brief Sum the Wireless Core statistics of every connection into the application statistics.
+ */
+static void update_swc_stats(void)
+{
+    swc_statistics_t *swc_stats;
+
+    app_stats.tx_retry_count = 0;
+    app_stats.tx_dropped_count = 0;
+    app_stats.rx_duplicated_count = 0;
+    app_stats.rx_overrun_count = 0;
+    for (uint8_t i = 0; i < conn_count; i++) {
+        swc_stats = swc_connection_update_stats(tx_conn[i]);
+        if (app_cfg.ack_enabled) {
+            app_stats.tx_retry_count += swc_stats->packet_sent_and_not_acked_count;
+        }
+        app_stats.tx_dropped_count += swc_stats->packet_dropped_count;
+        swc_stats = swc_connection_update_stats(rx_conn[i]);
+        app_stats.rx_duplicated_count += swc_stats->packet_duplicated_count;
+        app_stats.rx_overrun_count += swc_stats->packet_overrun_count;
+    }
+}
+
+/** @brief Write a 32-bit value in little endian.
+ *
+ *  @param[out] buffer  Destination.
+ *  @param[in]  value   Value.
+ */
+static void write_uint32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+    buffer[2] = (value >> 16) & 0xFF;
+    buffer[3] = (value >> 24) & 0xFF;
+}
+
+/** @brief Read a 32-bit value in little endian.
+ *
+ *  @param[in] buffer  Source.
+ *  @return Value.
+ */
+static uint32_t read_uint32(const uint8_t *buffer)
+{
+    return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
@@ -0,0 +1,97 @@
+/** @file  swc_emulator_app.h
+ *  @brief Interface between the SPARK Wireless Core emulator and its node application.
+ *
+ *  The node application is built as a shared library loaded once per emulated
+ *  node. The host passes an application configuration to emu_app_init() and
+ *  reads the statistics back with the exported functions below. Both the
+ *  emulator and the benchmark drive the same application.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef SWC_EMULATOR_APP_H_
+#define SWC_EMULATOR_APP_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define SWC_EMU_APP_MAX_NODE_COUNT      8   /*!< Maximum number of nodes around the coordinator */
+#define SWC_EMU_APP_MIN_PAYLOAD_SIZE    8   /*!< Sequence number and timestamp */
+#define SWC_EMU_APP_MAX_PAYLOAD_SIZE    100 /*!< Largest payload fitting the transceiver FIFO with the headers */
+#define SWC_EMU_APP_MAX_CHANNEL_COUNT   5   /*!< Channels of the hello world example */
+#define SWC_EMU_APP_COORDINATOR_ADDRESS 0x01
+#define SWC_EMU_APP_FIRST_NODE_ADDRESS  0x02
+#define SWC_EMU_APP_LATENCY_BIN_US      50  /*!< Width of the latency histogram bins */
+#define SWC_EMU_APP_LATENCY_BIN_COUNT   400 /*!< Latency histogram bins, the last one counts every longer latency */
+
+#define SWC_EMU_APP_GET_STATS_SYMBOL    "swc_emu_app_get_stats"    /*!< Symbol of swc_emu_app_get_stats() */
+#define SWC_EMU_APP_RESET_STATS_SYMBOL  "swc_emu_app_reset_stats"  /*!< Symbol of swc_emu_app_reset_stats() */
+#define SWC_EMU_APP_PRINT_STATS_SYMBOL  "swc_emu_app_print_stats"  /*!< Symbol of swc_emu_app_print_stats() */
+
+/* TYPES **********************************************************************/
+/** @brief Node application configuration.
+ *
+ *  The coordinator exchanges frames with each node in turn: timeslot 2k
+ *  carries the frames to the node k and timeslot 2k+1 the frames from it.
+ */
+typedef struct swc_emu_app_cfg {
+    bool coordinator;         /*!< True for the coordinator, false for a node */
+    uint8_t node_index;       /*!< Index of the node, unused by the coordinator */
+    uint8_t node_count;       /*!< Number of nodes around the coordinator */
+    uint8_t payload_size;     /*!< Size of each payload sent */
+    uint32_t timeslot_us;     /*!< Duration of each timeslot */
+    uint8_t channel_count;    /*!< Number of channels hopped through, from 1 to SWC_EMU_APP_MAX_CHANNEL_COUNT */
+    bool ack_enabled;         /*!< Acknowledge the frames */
+    bool arq_enabled;         /*!< Retransmit the frames not acknowledged, needs ack_enabled */
+    uint32_t arq_retry_count; /*!< Retries before dropping a frame, 0 is infinite */
+    uint8_t throttling_ratio; /*!< Percentage of the TX timeslots used, 100 disables the throttling */
+    bool rx_in_place;         /*!< Receive in application buffers exchanged for each payload instead of copying it */
+} swc_emu_app_cfg_t;
+
+/** @brief Node application statistics.
+ */
+typedef struct swc_emu_app_stats {
+    uint32_t tx_acked_count;     /*!< Frames acknowledged */
+    uint32_t tx_not_acked_count; /*!< Frame transmissions without acknowledge */
+    uint32_t rx_count;           /*!< Frames received */
+    uint32_t rx_missed_count;    /*!< Frames missing in the received sequence numbers */
+    uint64_t rx_byte_count;      /*!< Payload bytes received */
+    uint64_t latency_sum_us;     /*!< Sum of the latencies between sending and receiving the frames */
+    uint32_t latency_max_us;     /*!< Maximum latency between sending and receiving a frame */
+    uint32_t latency_histogram[SWC_EMU_APP_LATENCY_BIN_COUNT]; /*!< Received frames per latency bin */
+    /* Wireless Core statistics, summed over the connections */
+    uint32_t tx_retry_count;      /*!< Transmissions not acknowledged, each one retried or dropped, 0 without ACK */
+    uint32_t tx_dropped_count;    /*!< Frames dropped by the ARQ retry count or deadline */
+    uint32_t rx_duplicated_count; /*!< Retransmitted frames received twice */
+    uint32_t rx_overrun_count;    /*!< Frames discarded because the reception queue was full */
+} swc_emu_app_stats_t;
+
+/** @brief Get the statistics of the application.
+ *
+ *  The Wireless Core statistics are updated first, so this is node code.
+ *
+ *  @return Application statistics.
+ */
+typedef const swc_emu_app_stats_t *(*swc_emu_app_get_stats_t)(void);
+
+/** @brief Reset the statistics of the application and of the Wireless Core.
+ */
+typedef void (*swc_emu_app_reset_stats_t)(void);
+
+/** @brief Print the Wireless Core statistics of every connection.
+ */
+typedef void (*swc_emu_app_print_stats_t)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWC_EMULATOR_APP_H_ */
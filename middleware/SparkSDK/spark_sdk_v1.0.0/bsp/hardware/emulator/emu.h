@@ -0,0 +1,25 @@
+/** @file  emu.h
+ *  @brief Board Support Package of the host emulator.
+ *
+ *  The emulator runs Wireless Core nodes on a host computer. Each node has an
+ *  emulated microcontroller and SR1000 transceiver, and the transceivers talk
+ *  over a virtual air medium, all driven by one deterministic virtual clock.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_H_
+#define EMU_H_
+
+/* INCLUDES *******************************************************************/
+#include "emu_air.h"
+#include "emu_it.h"
+#include "emu_node.h"
+#include "emu_radio.h"
+#include "emu_sched.h"
+#include "emu_sr1000.h"
+#include "emu_timer.h"
+
+#endif /* EMU_H_ */
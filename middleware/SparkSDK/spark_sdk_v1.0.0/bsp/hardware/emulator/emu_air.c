@@ -0,0 +1,164 @@
+/** @file  emu_air.c
+ *  @brief Virtual air medium shared by the emulated SR1000 transceivers.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "emu_air.h"
+#include "emu_sched.h"
+#include "emu_sr1000.h"
+
+/* CONSTANTS ******************************************************************/
+#define EMU_AIR_FRAME_POOL_SIZE 256 /* Frames kept for the collision checks, far more than can overlap */
+
+/* PRIVATE GLOBALS ************************************************************/
+static struct emu_sr1000 *radios[EMU_AIR_MAX_RADIO_COUNT];
+static uint8_t radio_count;
+static emu_air_link_t links[EMU_AIR_MAX_RADIO_COUNT][EMU_AIR_MAX_RADIO_COUNT];
+static emu_air_frame_t frame_pool[EMU_AIR_FRAME_POOL_SIZE];
+static bool frame_valid[EMU_AIR_FRAME_POOL_SIZE];
+static uint32_t frame_index;
+static uint32_t random_state;
+static emu_air_stats_t air_stats;
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static void deliver(void *context, uint32_t arg);
+static uint32_t get_random(void);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void emu_air_init(uint32_t seed)
+{
+    memset(radios, 0, sizeof(radios));
+    memset(frame_valid, 0, sizeof(frame_valid));
+    memset(&air_stats, 0, sizeof(air_stats));
+    radio_count = 0;
+    frame_index = 0;
+    random_state = (seed == 0) ? 1 : seed;
+}
+
+uint8_t emu_air_attach(struct emu_sr1000 *radio)
+{
+    emu_air_link_t default_link = {
+        .connected = true,
+        .loss = 0.0,
+        .rssi = EMU_AIR_DEFAULT_RSSI,
+        .rnsi = EMU_AIR_DEFAULT_RNSI,
+        .delay = 0
+    };
+    uint8_t index = radio_count;
+
+    if (radio_count >= EMU_AIR_MAX_RADIO_COUNT) {
+        fprintf(stderr, "Too many transceivers on the virtual air, the maximum is %u\n", EMU_AIR_MAX_RADIO_COUNT);
+        exit(EXIT_FAILURE);
+    }
+    radios[radio_count++] = radio;
+
+    for (uint8_t i = 0; i < radio_count; i++) {
+        links[index][i] = default_link;
+        links[i][index] = default_link;
+    }
+    links[index][index].connected = false;
+
+    return index;
+}
+
+void emu_air_set_link(uint8_t from, uint8_t to, const emu_air_link_t *link)
+{
+    if ((from < EMU_AIR_MAX_RADIO_COUNT) && (to < EMU_AIR_MAX_RADIO_COUNT) && (from != to)) {
+        links[from][to] = *link;
+    }
+}
+
+const emu_air_link_t *emu_air_get_link(uint8_t from, uint8_t to)
+{
+    return &links[from][to];
+}
+
+void emu_air_transmit(const emu_air_frame_t *frame)
+{
+    uint32_t slot = frame_index++ % EMU_AIR_FRAME_POOL_SIZE;
+
+    frame_pool[slot] = *frame;
+    frame_valid[slot] = true;
+    air_stats.frame_count++;
+
+    for (uint8_t receiver = 0; receiver < radio_count; receiver++) {
+        if (links[frame->source][receiver].connected) {
+            emu_sched_add(frame->detect + links[frame->source][receiver].delay, deliver, &frame_pool[slot],
+                          receiver);
+        }
+    }
+}
+
+bool emu_air_is_collided(uint8_t receiver, const emu_air_frame_t *frame)
+{
+    const emu_air_link_t *link = &links[frame->source][receiver];
+    const emu_air_link_t *other_link;
+    const emu_air_frame_t *other;
+    uint64_t start = frame->start + link->delay;
+    uint64_t end = frame->end + link->delay;
+
+    for (uint32_t slot = 0; slot < EMU_AIR_FRAME_POOL_SIZE; slot++) {
+        other = &frame_pool[slot];
+        if (!frame_valid[slot] || (other == frame) || (other->channel != frame->channel) ||
+            (other->source == receiver)) {
+            continue;
+        }
+        other_link = &links[other->source][receiver];
+        if (other_link->connected && ((other->start + other_link->delay) < end) &&
+            ((other->end + other_link->delay) > start)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void emu_air_count_collision(void)
+{
+    air_stats.collision_count++;
+}
+
+const emu_air_stats_t *emu_air_get_stats(void)
+{
+    return &air_stats;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Offer a frame to a receiver when its syncword ends at the receiver.
+ *
+ *  @param[in] context  Frame in the pool.
+ *  @param[in] arg      Medium index of the receiver.
+ */
+static void deliver(void *context, uint32_t arg)
+{
+    const emu_air_frame_t *frame = (const emu_air_frame_t *)context;
+    const emu_air_link_t *link = &links[frame->source][arg];
+
+    if ((link->loss > 0.0) && (get_random() < (uint32_t)(link->loss * UINT32_MAX))) {
+        air_stats.loss_count++;
+        return;
+    }
+    emu_sr1000_detect_frame(radios[arg], frame, link);
+}
+
+/** @brief Get the next pseudo-random number of the loss generator.
+ *
+ *  @return 32-bit pseudo-random number.
+ */
+static uint32_t get_random(void)
+{
+    /* Xorshift32 */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
@@ -0,0 +1,129 @@
+/** @file  emu_air.h
+ *  @brief Virtual air medium shared by the emulated SR1000 transceivers.
+ *
+ *  Each pair of transceivers is connected by a one-way link with its own frame
+ *  loss probability, RSSI and propagation delay. A frame is heard by every
+ *  connected transceiver listening on the same channel, and frames overlapping
+ *  at a receiver corrupt each other.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_AIR_H_
+#define EMU_AIR_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define EMU_AIR_MAX_RADIO_COUNT 32  /*!< Maximum number of transceivers on the medium */
+#define EMU_AIR_MAX_FRAME_SIZE  128 /*!< Largest frame, the size of the SR1000 FIFO */
+#define EMU_AIR_DEFAULT_RSSI    40  /*!< Raw RSSI register value of a new link */
+#define EMU_AIR_DEFAULT_RNSI    10  /*!< Raw RNSI register value of a new link */
+
+/* TYPES **********************************************************************/
+struct emu_sr1000;
+
+/** @brief Frame on the air.
+ */
+typedef struct emu_air_frame {
+    uint8_t source;                         /*!< Medium index of the transmitter */
+    uint32_t channel;                       /*!< Channel key, frames are only heard on the same key */
+    uint16_t address;                       /*!< Destination address */
+    uint8_t size;                           /*!< Number of bytes of data */
+    uint8_t data[EMU_AIR_MAX_FRAME_SIZE];   /*!< Content of the transmitter FIFO sent as payload */
+    uint64_t start;                         /*!< Time the preamble starts at the transmitter, in PLL cycles */
+    uint64_t detect;                        /*!< Time the syncword ends at the transmitter, in PLL cycles */
+    uint64_t end;                           /*!< Time the frame ends at the transmitter, in PLL cycles */
+} emu_air_frame_t;
+
+/** @brief One-way link between two transceivers.
+ */
+typedef struct emu_air_link {
+    bool connected;  /*!< False if the receiver never hears the transmitter */
+    double loss;     /*!< Probability a frame is not detected at all, from 0 to 1 */
+    uint8_t rssi;    /*!< Raw RSSI register value of the frames received */
+    uint8_t rnsi;    /*!< Raw RNSI register value of the frames received */
+    uint32_t delay;  /*!< Propagation delay in PLL cycles */
+} emu_air_link_t;
+
+/** @brief Medium statistics.
+ */
+typedef struct emu_air_stats {
+    uint64_t frame_count;      /*!< Frames transmitted */
+    uint64_t loss_count;       /*!< Frame deliveries dropped by the link loss probability */
+    uint64_t collision_count;  /*!< Receptions corrupted by an overlapping frame */
+} emu_air_stats_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Initialize the medium with no transceiver.
+ *
+ *  @param[in] seed  Non-zero seed of the loss generator.
+ */
+void emu_air_init(uint32_t seed);
+
+/** @brief Attach a transceiver to the medium.
+ *
+ *  The transceiver is connected to every other one with the default link.
+ *
+ *  @param[in] radio  Transceiver.
+ *  @return Medium index of the transceiver.
+ */
+uint8_t emu_air_attach(struct emu_sr1000 *radio);
+
+/** @brief Set the link from a transceiver to another.
+ *
+ *  @param[in] from  Medium index of the transmitter.
+ *  @param[in] to    Medium index of the receiver.
+ *  @param[in] link  Link parameters.
+ */
+void emu_air_set_link(uint8_t from, uint8_t to, const emu_air_link_t *link);
+
+/** @brief Get the link from a transceiver to another.
+ *
+ *  @param[in] from  Medium index of the transmitter.
+ *  @param[in] to    Medium index of the receiver.
+ *  @return Link parameters.
+ */
+const emu_air_link_t *emu_air_get_link(uint8_t from, uint8_t to);
+
+/** @brief Put a frame on the air.
+ *
+ *  Every connected transceiver is offered the frame when its syncword ends
+ *  at the receiver, unless the link loses it.
+ *
+ *  @param[in] frame  Frame, copied by the medium.
+ */
+void emu_air_transmit(const emu_air_frame_t *frame);
+
+/** @brief Check if another frame overlaps a reception.
+ *
+ *  @param[in] receiver  Medium index of the receiver.
+ *  @param[in] frame     Frame received.
+ *  @retval true   Another frame on the same channel is heard during the reception.
+ *  @retval false  Reception is clean.
+ */
+bool emu_air_is_collided(uint8_t receiver, const emu_air_frame_t *frame);
+
+/** @brief Count a reception corrupted by a collision.
+ */
+void emu_air_count_collision(void);
+
+/** @brief Get the medium statistics.
+ *
+ *  @return Medium statistics.
+ */
+const emu_air_stats_t *emu_air_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_AIR_H_ */
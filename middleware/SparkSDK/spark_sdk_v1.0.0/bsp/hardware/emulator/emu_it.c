@@ -0,0 +1,42 @@
+/** @file  emu_it.c
+ *  @brief This module emulates the interrupt handlers configuration.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include "emu_it.h"
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void emu_set_radio_irq_callback(emu_irq_callback_t callback)
+{
+    emu_node_get_current()->irq_callback[EMU_IRQ_RADIO] = callback;
+}
+
+void emu_set_radio_dma_rx_callback(emu_irq_callback_t callback)
+{
+    emu_node_get_current()->irq_callback[EMU_IRQ_RADIO_DMA] = callback;
+}
+
+void emu_set_pendsv_callback(emu_irq_callback_t callback)
+{
+    emu_node_get_current()->irq_callback[EMU_IRQ_PENDSV] = callback;
+}
+
+void emu_enter_critical(void)
+{
+    emu_node_get_current()->critical_nesting++;
+}
+
+void emu_exit_critical(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    if (--node->critical_nesting == 0) {
+        /* Interrupts pended inside the critical section are taken on exit */
+        emu_node_service_irq(node);
+    }
+}
@@ -0,0 +1,53 @@
+/** @file  emu_it.h
+ *  @brief This module emulates the interrupt handlers configuration.
+ *
+ *  Same interface as the EVK interrupt module. Every function acts on the
+ *  node being executed.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_IT_H_
+#define EMU_IT_H_
+
+/* INCLUDES *******************************************************************/
+#include "emu_node.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief This function set the function callback for the radio pin interrupt.
+ *
+ *  @param[in] callback  External interrupt callback function pointer.
+ */
+void emu_set_radio_irq_callback(emu_irq_callback_t callback);
+
+/** @brief This function sets the function callback for the DMA_RX ISR.
+ *
+ *  @param[in] callback  External interrupt callback function pointer.
+ */
+void emu_set_radio_dma_rx_callback(emu_irq_callback_t callback);
+
+/** @brief This function sets the function callback for the pendsv.
+ *
+ *  @param[in] callback  External interrupt callback function pointer.
+ */
+void emu_set_pendsv_callback(emu_irq_callback_t callback);
+
+/** @brief Disable IRQ Interrupts
+ */
+void emu_enter_critical(void);
+
+/** @brief Enable IRQ Interrupts
+ */
+void emu_exit_critical(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_IT_H_ */
@@ -0,0 +1,282 @@
+/** @file  emu_node.c
+ *  @brief Emulated microcontroller running one Wireless Core node.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "emu_node.h"
+
+/* CONSTANTS ******************************************************************/
+#define THREAD_PRIORITY       256 /* Lower than any interrupt */
+#define ENTER_STACK_SIZE      32  /* Maximum nesting of node code executions */
+#define SPI_CYCLES_PER_BYTE   8   /* SPI clock close to the PLL frequency */
+#define COPY_BUFFER_SIZE      65536
+#define LIBRARY_COPY_TEMPLATE "/tmp/emu_node_XXXXXX"
+
+/* PRIVATE GLOBALS ************************************************************/
+/* Same priorities as the EVK, the radio interrupt is taken first when both are pending */
+static const uint16_t irq_priority[EMU_IRQ_COUNT] = {
+    [EMU_IRQ_RADIO]     = 2,
+    [EMU_IRQ_RADIO_DMA] = 2,
+    [EMU_IRQ_PENDSV]    = 15
+};
+static emu_node_t *enter_stack[ENTER_STACK_SIZE];
+static uint32_t enter_count;
+static uint8_t node_count;
+static uint64_t host_time_mark_ns;
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static void *load_library_copy(const char *library_path);
+static void radio_irq_edge(void *context);
+static void dma_complete(void *context, uint32_t arg);
+static void app_process(void *context, uint32_t arg);
+static void charge_host_time(void);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+emu_node_t *emu_node_create(const char *library_path, uint32_t chip_id)
+{
+    emu_node_t *node = calloc(1, sizeof(emu_node_t));
+
+    if (node == NULL) {
+        return NULL;
+    }
+    node->library = load_library_copy(library_path);
+    if (node->library == NULL) {
+        free(node);
+        return NULL;
+    }
+    node->app_process = (emu_app_process_t)dlsym(node->library, EMU_NODE_APP_PROCESS_SYMBOL);
+
+    node->index           = node_count++;
+    node->active_priority = THREAD_PRIORITY;
+    for (uint8_t irq = 0; irq < EMU_IRQ_COUNT; irq++) {
+        node->irq_enabled[irq] = true;
+    }
+    emu_sr1000_init(&node->radio, chip_id);
+    emu_sr1000_set_irq_callback(&node->radio, radio_irq_edge, node);
+
+    return node;
+}
+
+void emu_node_destroy(emu_node_t *node)
+{
+    emu_sched_cancel(&node->dma_event);
+    emu_sched_cancel(&node->process_event);
+    emu_sr1000_set_irq_callback(&node->radio, NULL, NULL);
+    dlclose(node->library);
+    free(node);
+}
+
+void emu_node_start(emu_node_t *node, void *context, uint32_t period_us, uint64_t start_time)
+{
+    emu_app_init_t app_init = (emu_app_init_t)dlsym(node->library, EMU_NODE_APP_INIT_SYMBOL);
+
+    if (app_init != NULL) {
+        emu_node_enter(node);
+        app_init(context);
+        emu_node_exit(node);
+    }
+    node->app_period = EMU_US_TO_CYCLES(period_us);
+    if ((node->app_process != NULL) && (node->app_period > 0)) {
+        node->process_event = emu_sched_add(start_time, app_process, node, 0);
+    }
+}
+
+void *emu_node_get_symbol(emu_node_t *node, const char *name)
+{
+    return dlsym(node->library, name);
+}
+
+void emu_node_enter(emu_node_t *node)
+{
+    if (enter_count >= ENTER_STACK_SIZE) {
+        fprintf(stderr, "Emulated node code nested too deeply\n");
+        exit(EXIT_FAILURE);
+    }
+    charge_host_time();
+    enter_stack[enter_count++] = node;
+    node->depth++;
+}
+
+void emu_node_exit(emu_node_t *node)
+{
+    emu_node_service_irq(node);
+    charge_host_time();
+    node->depth--;
+    enter_count--;
+}
+
+emu_node_t *emu_node_get_current(void)
+{
+    return (enter_count > 0) ? enter_stack[enter_count - 1] : NULL;
+}
+
+void emu_node_pend_irq(emu_node_t *node, emu_irq_t irq)
+{
+    node->irq_pending[irq] = true;
+    if (node->depth == 0) {
+        /* The node is idle in its main loop, the interrupt is taken right away */
+        emu_node_enter(node);
+        emu_node_exit(node);
+    }
+}
+
+void emu_node_set_irq_enable(emu_node_t *node, emu_irq_t irq, bool enable)
+{
+    node->irq_enabled[irq] = enable;
+}
+
+void emu_node_service_irq(emu_node_t *node)
+{
+    uint16_t preempted_priority;
+    int selected;
+
+    while (node->critical_nesting == 0) {
+        selected = -1;
+        for (uint8_t irq = 0; irq < EMU_IRQ_COUNT; irq++) {
+            if (node->irq_pending[irq] && node->irq_enabled[irq] &&
+                (irq_priority[irq] < node->active_priority) &&
+                ((selected < 0) || (irq_priority[irq] < irq_priority[selected]))) {
+                selected = irq;
+            }
+        }
+        if (selected < 0) {
+            break;
+        }
+
+        node->irq_pending[selected] = false;
+        node->stats.irq_count[selected]++;
+        preempted_priority    = node->active_priority;
+        node->active_priority = irq_priority[selected];
+        if (node->irq_callback[selected] != NULL) {
+            emu_node_enter(node);
+            node->irq_callback[selected]();
+            emu_node_exit(node);
+        }
+        node->active_priority = preempted_priority;
+    }
+}
+
+void emu_node_start_dma(emu_node_t *node, uint16_t size)
+{
+    emu_sched_cancel(&node->dma_event);
+    node->dma_event = emu_sched_add(emu_sched_get_time() + (uint64_t)size * SPI_CYCLES_PER_BYTE, dma_complete,
+                                    node, 0);
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Load a private copy of a shared library.
+ *
+ *  The dynamic loader maps a library only once per path, so a copy is made for
+ *  each node to get its own static variables.
+ *
+ *  @param[in] library_path  Path of the shared library.
+ *  @return Library handle, NULL on error.
+ */
+static void *load_library_copy(const char *library_path)
+{
+    char copy_path[] = LIBRARY_COPY_TEMPLATE;
+    char buffer[COPY_BUFFER_SIZE];
+    void *library = NULL;
+    FILE *source;
+    FILE *copy;
+    size_t size;
+    int fd;
+
+    source = fopen(library_path, "rb");
+    if (source == NULL) {
+        fprintf(stderr, "Cannot open %s\n", library_path);
+        return NULL;
+    }
+    fd = mkstemp(copy_path);
+    copy = (fd < 0) ? NULL : fdopen(fd, "wb");
+    if (copy == NULL) {
+        fprintf(stderr, "Cannot create a copy of %s\n", library_path);
+        fclose(source);
+        return NULL;
+    }
+    while ((size = fread(buffer, 1, sizeof(buffer), source)) > 0) {
+        fwrite(buffer, 1, size, copy);
+    }
+    fclose(source);
+    fclose(copy);
+
+    library = dlopen(copy_path, RTLD_NOW | RTLD_LOCAL);
+    if (library == NULL) {
+        fprintf(stderr, "%s\n", dlerror());
+    }
+    /* The mapping stays valid once the file is removed */
+    unlink(copy_path);
+
+    return library;
+}
+
+/** @brief Rising edge of the radio interrupt line.
+ *
+ *  @param[in] context  Node.
+ */
+static void radio_irq_edge(void *context)
+{
+    emu_node_t *node = (emu_node_t *)context;
+
+    if (node->radio_exti_enabled) {
+        emu_node_pend_irq(node, EMU_IRQ_RADIO);
+    }
+}
+
+/** @brief SPI DMA transfer complete event.
+ *
+ *  @param[in] context  Node.
+ *  @param[in] arg      Unused.
+ */
+static void dma_complete(void *context, uint32_t arg)
+{
+    emu_node_t *node = (emu_node_t *)context;
+
+    (void)arg;
+
+    node->dma_event = (emu_sched_handle_t){0};
+    emu_node_pend_irq(node, EMU_IRQ_RADIO_DMA);
+}
+
+/** @brief Main loop pass event.
+ *
+ *  @param[in] context  Node.
+ *  @param[in] arg      Unused.
+ */
+static void app_process(void *context, uint32_t arg)
+{
+    emu_node_t *node = (emu_node_t *)context;
+
+    (void)arg;
+
+    node->process_event = emu_sched_add(emu_sched_get_time() + node->app_period, app_process, node, 0);
+    emu_node_enter(node);
+    node->app_process();
+    emu_node_exit(node);
+}
+
+/** @brief Charge the host time elapsed since the last node switch to the node being executed.
+ */
+static void charge_host_time(void)
+{
+    struct timespec now;
+    uint64_t now_ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    now_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    if (enter_count > 0) {
+        enter_stack[enter_count - 1]->stats.host_time_ns += now_ns - host_time_mark_ns;
+    }
+    host_time_mark_ns = now_ns;
+}
@@ -0,0 +1,181 @@
+/** @file  emu_node.h
+ *  @brief Emulated microcontroller running one Wireless Core node.
+ *
+ *  The Wireless Core keeps its state in static variables, so each node loads
+ *  its own copy of a shared library containing the Wireless Core, the
+ *  emulator wireless interface and the application. The library calls back
+ *  the emulator BSP, which acts on the node being executed.
+ *
+ *  Node code runs in zero virtual time. The interrupt controller mirrors the
+ *  EVK priorities: the radio and SPI DMA interrupts preempt the PendSV
+ *  callback processing, which preempts the application thread. Pending
+ *  interrupts are taken when the virtual clock advances and each time the
+ *  node calls the BSP, as a Cortex-M would take them between instructions.
+ *
+ *  The application library must export:
+ *      void emu_app_init(void *context);  Called once, as the start of main().
+ *      void emu_app_process(void);        Called periodically, as one pass of the main loop.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_NODE_H_
+#define EMU_NODE_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "emu_sched.h"
+#include "emu_sr1000.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define EMU_NODE_APP_INIT_SYMBOL    "emu_app_init"    /*!< Application entry point */
+#define EMU_NODE_APP_PROCESS_SYMBOL "emu_app_process" /*!< Application main loop pass */
+
+/* TYPES **********************************************************************/
+/** @brief Interrupt function callback type.
+ */
+typedef void (*emu_irq_callback_t)(void);
+
+/** @brief Application entry point.
+ *
+ *  @param[in] context  Context given by the host.
+ */
+typedef void (*emu_app_init_t)(void *context);
+
+/** @brief Application main loop pass.
+ */
+typedef void (*emu_app_process_t)(void);
+
+/** @brief Interrupt lines of the emulated microcontroller.
+ */
+typedef enum emu_irq {
+    EMU_IRQ_RADIO,     /*!< Radio interrupt pin, also pended by the radio context switch */
+    EMU_IRQ_RADIO_DMA, /*!< Radio SPI DMA transfer complete */
+    EMU_IRQ_PENDSV,    /*!< Wireless Core callbacks processing */
+    EMU_IRQ_COUNT
+} emu_irq_t;
+
+/** @brief Node statistics.
+ */
+typedef struct emu_node_stats {
+    uint64_t irq_count[EMU_IRQ_COUNT]; /*!< Number of times each interrupt handler ran */
+    uint64_t spi_byte_count;           /*!< Bytes transferred over the radio SPI */
+    uint64_t spi_transfer_count;       /*!< Radio SPI transfers, blocking or not */
+    uint64_t host_time_ns;             /*!< Host time spent executing the node code, excluding the other nodes */
+} emu_node_stats_t;
+
+/** @brief Emulated node.
+ */
+typedef struct emu_node {
+    uint8_t index;                               /*!< Node index, in creation order */
+    void *library;                               /*!< Handle of the node's copy of the application library */
+    emu_app_process_t app_process;               /*!< Application main loop pass */
+    uint64_t app_period;                         /*!< Period of the main loop passes, in PLL cycles */
+    emu_sr1000_t radio;                          /*!< Transceiver of the node */
+    emu_irq_callback_t irq_callback[EMU_IRQ_COUNT]; /*!< Interrupt handlers */
+    bool irq_pending[EMU_IRQ_COUNT];             /*!< Interrupts pending in the NVIC */
+    bool irq_enabled[EMU_IRQ_COUNT];             /*!< Interrupts enabled in the NVIC */
+    bool radio_exti_enabled;                     /*!< True if the radio pin edges pend the radio interrupt */
+    uint32_t critical_nesting;                   /*!< Critical section nesting, interrupts are masked when non zero */
+    uint16_t active_priority;                    /*!< Priority of the code being executed */
+    uint32_t depth;                              /*!< Nesting of node code currently executing */
+    emu_sched_handle_t dma_event;                /*!< Completion of the SPI DMA transfer in progress */
+    emu_sched_handle_t process_event;            /*!< Next main loop pass */
+    emu_node_stats_t stats;                      /*!< Node statistics */
+} emu_node_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Create a node running its own copy of an application library.
+ *
+ *  The transceiver of the node is attached to the air medium.
+ *
+ *  @param[in] library_path  Path of the application shared library.
+ *  @param[in] chip_id       Chip ID of the node's transceiver.
+ *  @return Node, NULL on error.
+ */
+emu_node_t *emu_node_create(const char *library_path, uint32_t chip_id);
+
+/** @brief Destroy a node and unload its library.
+ *
+ *  @param[in] node  Node.
+ */
+void emu_node_destroy(emu_node_t *node);
+
+/** @brief Run the application entry point then start the main loop passes.
+ *
+ *  @param[in] node        Node.
+ *  @param[in] context     Context given to the application entry point.
+ *  @param[in] period_us   Period of the main loop passes in microseconds.
+ *  @param[in] start_time  Time of the application start, in PLL cycles.
+ */
+void emu_node_start(emu_node_t *node, void *context, uint32_t period_us, uint64_t start_time);
+
+/** @brief Get a symbol of the node's copy of the application library.
+ *
+ *  Functions of the library called by the host must be wrapped with
+ *  emu_node_enter() and emu_node_exit().
+ *
+ *  @param[in] node  Node.
+ *  @param[in] name  Symbol name.
+ *  @return Address of the symbol, NULL if not found.
+ */
+void *emu_node_get_symbol(emu_node_t *node, const char *name);
+
+/** @brief Start executing node code from the host.
+ *
+ *  @param[in] node  Node.
+ */
+void emu_node_enter(emu_node_t *node);
+
+/** @brief Stop executing node code, taking the interrupts pended meanwhile.
+ *
+ *  @param[in] node  Node.
+ */
+void emu_node_exit(emu_node_t *node);
+
+/** @brief Get the node being executed.
+ *
+ *  @return Node, NULL if no node code is executing.
+ */
+emu_node_t *emu_node_get_current(void);
+
+/** @brief Pend an interrupt.
+ *
+ *  @param[in] node  Node.
+ *  @param[in] irq   Interrupt line.
+ */
+void emu_node_pend_irq(emu_node_t *node, emu_irq_t irq);
+
+/** @brief Enable or disable an interrupt in the NVIC, its pending state is kept.
+ *
+ *  @param[in] node    Node.
+ *  @param[in] irq     Interrupt line.
+ *  @param[in] enable  True to enable.
+ */
+void emu_node_set_irq_enable(emu_node_t *node, emu_irq_t irq, bool enable);
+
+/** @brief Run the pending interrupts allowed to preempt the code being executed.
+ *
+ *  @param[in] node  Node.
+ */
+void emu_node_service_irq(emu_node_t *node);
+
+/** @brief Start the SPI DMA transfer complete timer.
+ *
+ *  @param[in] node  Node.
+ *  @param[in] size  Number of bytes transferred.
+ */
+void emu_node_start_dma(emu_node_t *node, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_NODE_H_ */
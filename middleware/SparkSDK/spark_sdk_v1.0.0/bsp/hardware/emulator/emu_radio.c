@@ -0,0 +1,138 @@
+/** @file  emu_radio.c
+ *  @brief This module emulates the peripherals controlling the SR10x0 radio.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include "emu_node.h"
+#include "emu_radio.h"
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+bool emu_radio_read_irq_pin(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    return emu_sr1000_read_irq_pin(&node->radio);
+}
+
+void emu_radio_enable_irq_it(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    node->radio_exti_enabled = true;
+    emu_node_service_irq(node);
+}
+
+void emu_radio_disable_irq_it(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    /* Only the external interrupt line is masked, an interrupt already pending in the NVIC stays pending */
+    node->radio_exti_enabled = false;
+}
+
+void emu_radio_enable_dma_irq_it(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    emu_node_set_irq_enable(node, EMU_IRQ_RADIO_DMA, true);
+    emu_node_service_irq(node);
+}
+
+void emu_radio_disable_dma_irq_it(void)
+{
+    emu_node_set_irq_enable(emu_node_get_current(), EMU_IRQ_RADIO_DMA, false);
+}
+
+void emu_radio_set_shutdown_pin(void)
+{
+}
+
+void emu_radio_reset_shutdown_pin(void)
+{
+}
+
+void emu_radio_set_reset_pin(void)
+{
+}
+
+void emu_radio_reset_reset_pin(void)
+{
+    emu_sr1000_reset(&emu_node_get_current()->radio);
+}
+
+void emu_radio_spi_set_cs(void)
+{
+    emu_sr1000_spi_select(&emu_node_get_current()->radio, false);
+}
+
+void emu_radio_spi_reset_cs(void)
+{
+    emu_sr1000_spi_select(&emu_node_get_current()->radio, true);
+}
+
+void emu_radio_spi_transfer_full_duplex_blocking(uint8_t *tx_data, uint8_t *rx_data, uint16_t size)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    node->stats.spi_transfer_count++;
+    node->stats.spi_byte_count += size;
+    emu_sr1000_spi_transfer(&node->radio, tx_data, rx_data, size);
+    emu_node_service_irq(node);
+}
+
+void emu_radio_spi_transfer_full_duplex_non_blocking(uint8_t *tx_data, uint8_t *rx_data, uint16_t size)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    node->stats.spi_transfer_count++;
+    node->stats.spi_byte_count += size;
+    emu_sr1000_spi_transfer(&node->radio, tx_data, rx_data, size);
+    emu_node_start_dma(node, size);
+    emu_node_service_irq(node);
+}
+
+void emu_radio_spi_transfer_chain_non_blocking(uint8_t **tx_data, uint8_t **rx_data, uint16_t *size, bool *release_cs,
+                                               uint8_t count)
+{
+    emu_node_t *node = emu_node_get_current();
+    uint16_t total_size = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if ((i > 0) && release_cs[i - 1]) {
+            emu_sr1000_spi_select(&node->radio, false);
+            emu_sr1000_spi_select(&node->radio, true);
+        }
+        node->stats.spi_transfer_count++;
+        node->stats.spi_byte_count += size[i];
+        emu_sr1000_spi_transfer(&node->radio, tx_data[i], rx_data[i], size[i]);
+        total_size += size[i];
+    }
+    emu_node_start_dma(node, total_size);
+    emu_node_service_irq(node);
+}
+
+bool emu_radio_is_spi_busy(void)
+{
+    return false;
+}
+
+void emu_radio_context_switch(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    emu_node_pend_irq(node, EMU_IRQ_RADIO);
+    emu_node_service_irq(node);
+}
+
+void emu_radio_callback_context_switch(void)
+{
+    emu_node_t *node = emu_node_get_current();
+
+    emu_node_pend_irq(node, EMU_IRQ_PENDSV);
+    emu_node_service_irq(node);
+}
@@ -0,0 +1,122 @@
+/** @file  emu_radio.h
+ *  @brief This module emulates the peripherals controlling the SR10x0 radio.
+ *
+ *  Same interface as the EVK radio module. Every function acts on the node
+ *  being executed.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_RADIO_H_
+#define EMU_RADIO_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Read the status of the radio IRQ pin.
+ *
+ *  @retval True   Pin is high.
+ *  @retval False  Pin is low.
+ */
+bool emu_radio_read_irq_pin(void);
+
+/** @brief Enable the radio IRQ external interrupt.
+ */
+void emu_radio_enable_irq_it(void);
+
+/** @brief Disable the radio IRQ external interrupt.
+ */
+void emu_radio_disable_irq_it(void);
+
+/** @brief Enable the DMA SPI interrupt of the radio.
+ */
+void emu_radio_enable_dma_irq_it(void);
+
+/** @brief Disable the DMA SPI interrupt of the radio.
+ */
+void emu_radio_disable_dma_irq_it(void);
+
+/** @brief Set radio shutdown pin.
+ */
+void emu_radio_set_shutdown_pin(void);
+
+/** @brief Reset radio shutdown pin.
+ */
+void emu_radio_reset_shutdown_pin(void);
+
+/** @brief Set radio reset pin, releasing the radio from reset.
+ */
+void emu_radio_set_reset_pin(void);
+
+/** @brief Reset radio reset pin, holding the radio in reset.
+ */
+void emu_radio_reset_reset_pin(void);
+
+/** @brief Set the radio SPI chip select pin.
+ */
+void emu_radio_spi_set_cs(void);
+
+/** @brief Reset the radio SPI chip select pin.
+ */
+void emu_radio_spi_reset_cs(void);
+
+/** @brief Read and Write data full duplex on the radio in blocking mode.
+ *
+ *  @param tx_data  Data buffer to write.
+ *  @param rx_data  Data received.
+ *  @param size     Size of the data.
+ */
+void emu_radio_spi_transfer_full_duplex_blocking(uint8_t *tx_data, uint8_t *rx_data, uint16_t size);
+
+/** @brief Read and Write data full duplex on the radio in non-blocking mode.
+ *
+ *  The data is exchanged right away, the DMA interrupt fires once the
+ *  transfer time elapsed.
+ *
+ *  @param tx_data  Data buffer to write.
+ *  @param rx_data  Data received.
+ *  @param size     Size of the data.
+ */
+void emu_radio_spi_transfer_full_duplex_non_blocking(uint8_t *tx_data, uint8_t *rx_data, uint16_t size);
+
+/** @brief Read and Write a chain of data buffers full duplex on the radio in non-blocking mode.
+ *
+ *  The data is exchanged right away, a single DMA interrupt fires once the
+ *  transfer time of the whole chain elapsed.
+ *
+ *  @param tx_data     Data buffers to write.
+ *  @param rx_data     Data buffers received.
+ *  @param size        Size of each data buffer.
+ *  @param release_cs  Chip select is pulsed after a buffer when its entry is set.
+ *  @param count       Number of data buffers.
+ */
+void emu_radio_spi_transfer_chain_non_blocking(uint8_t **tx_data, uint8_t **rx_data, uint16_t *size, bool *release_cs,
+                                               uint8_t count);
+
+/** @brief Read the status of the radio's SPI.
+ *
+ *  @retval false  SPI is never busy, transfers are instantaneous for the MCU.
+ */
+bool emu_radio_is_spi_busy(void);
+
+/** @brief Software interrupt trigger to force the cpu to get into the interrupt handler.
+ */
+void emu_radio_context_switch(void);
+
+/** @brief Induce a context switch to the pendSV ISR.
+ */
+void emu_radio_callback_context_switch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_RADIO_H_ */
@@ -0,0 +1,220 @@
+/** @file  emu_sched.c
+ *  @brief Discrete event scheduler of the host emulator.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "emu_sched.h"
+
+/* CONSTANTS ******************************************************************/
+#define EMU_SCHED_INITIAL_CAPACITY 256
+
+/* TYPES **********************************************************************/
+/** @brief Event of the pool.
+ */
+typedef struct emu_sched_event {
+    uint64_t time;                 /*!< Time of the event in PLL cycles */
+    uint64_t sequence;             /*!< Insertion order, to break ties between events due at the same time */
+    emu_sched_callback_t callback; /*!< Event callback */
+    void *context;                 /*!< Context given to the callback */
+    uint32_t arg;                  /*!< Argument given to the callback */
+    uint32_t generation;           /*!< Incremented each time the slot is reused */
+    bool pending;                  /*!< False once the event ran or was cancelled */
+} emu_sched_event_t;
+
+/* PRIVATE GLOBALS ************************************************************/
+static emu_sched_event_t *event_pool;
+static uint32_t *free_slots;
+static uint32_t free_slot_count;
+static uint32_t *heap;
+static uint32_t heap_count;
+static uint32_t capacity;
+static uint64_t current_time;
+static uint64_t next_sequence;
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static void grow(void);
+static bool is_before(uint32_t slot_a, uint32_t slot_b);
+static void heap_push(uint32_t slot);
+static uint32_t heap_pop(void);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void emu_sched_init(void)
+{
+    emu_sched_deinit();
+    grow();
+}
+
+void emu_sched_deinit(void)
+{
+    free(event_pool);
+    free(free_slots);
+    free(heap);
+    event_pool = NULL;
+    free_slots = NULL;
+    heap = NULL;
+    free_slot_count = 0;
+    heap_count = 0;
+    capacity = 0;
+    current_time = 0;
+    next_sequence = 0;
+}
+
+uint64_t emu_sched_get_time(void)
+{
+    return current_time;
+}
+
+emu_sched_handle_t emu_sched_add(uint64_t time, emu_sched_callback_t callback, void *context, uint32_t arg)
+{
+    emu_sched_handle_t handle;
+    emu_sched_event_t *event;
+    uint32_t slot;
+
+    if (free_slot_count == 0) {
+        grow();
+    }
+    slot = free_slots[--free_slot_count];
+    event = &event_pool[slot];
+
+    event->time = (time < current_time) ? current_time : time;
+    event->sequence = next_sequence++;
+    event->callback = callback;
+    event->context = context;
+    event->arg = arg;
+    event->generation++;
+    event->pending = true;
+    heap_push(slot);
+
+    handle.slot = slot;
+    handle.generation = event->generation;
+
+    return handle;
+}
+
+void emu_sched_cancel(emu_sched_handle_t *handle)
+{
+    if (emu_sched_is_pending(handle)) {
+        /* The event stays in the heap and its slot is freed when it is popped */
+        event_pool[handle->slot].pending = false;
+    }
+    handle->generation = 0;
+}
+
+bool emu_sched_is_pending(const emu_sched_handle_t *handle)
+{
+    return (handle->generation != 0) && (handle->slot < capacity) &&
+           (event_pool[handle->slot].generation == handle->generation) && event_pool[handle->slot].pending;
+}
+
+void emu_sched_run_until(uint64_t time)
+{
+    emu_sched_event_t *event;
+    uint32_t slot;
+
+    while ((heap_count > 0) && (event_pool[heap[0]].time <= time)) {
+        slot = heap_pop();
+        event = &event_pool[slot];
+        free_slots[free_slot_count++] = slot;
+        if (event->pending) {
+            event->pending = false;
+            current_time = event->time;
+            event->callback(event->context, event->arg);
+        }
+    }
+    if (time > current_time) {
+        current_time = time;
+    }
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Double the capacity of the event pool.
+ */
+static void grow(void)
+{
+    uint32_t new_capacity = (capacity == 0) ? EMU_SCHED_INITIAL_CAPACITY : (capacity * 2);
+
+    event_pool = realloc(event_pool, new_capacity * sizeof(emu_sched_event_t));
+    free_slots = realloc(free_slots, new_capacity * sizeof(uint32_t));
+    heap = realloc(heap, new_capacity * sizeof(uint32_t));
+    if ((event_pool == NULL) || (free_slots == NULL) || (heap == NULL)) {
+        fprintf(stderr, "Emulator scheduler out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* New slots are handed out in increasing order */
+    for (uint32_t slot = new_capacity; slot > capacity; slot--) {
+        event_pool[slot - 1].generation = 0;
+        event_pool[slot - 1].pending = false;
+        free_slots[free_slot_count++] = slot - 1;
+    }
+    capacity = new_capacity;
+}
+
+/** @brief Check if an event must run before another one.
+ *
+ *  @param[in] slot_a  Slot of the first event.
+ *  @param[in] slot_b  Slot of the second event.
+ *  @retval true   First event runs first.
+ *  @retval false  Second event runs first.
+ */
+static bool is_before(uint32_t slot_a, uint32_t slot_b)
+{
+    if (event_pool[slot_a].time != event_pool[slot_b].time) {
+        return event_pool[slot_a].time < event_pool[slot_b].time;
+    }
+
+    return event_pool[slot_a].sequence < event_pool[slot_b].sequence;
+}
+
+/** @brief Push an event in the heap.
+ *
+ *  @param[in] slot  Slot of the event.
+ */
+static void heap_push(uint32_t slot)
+{
+    uint32_t index = heap_count++;
+    uint32_t parent;
+
+    while (index > 0) {
+        parent = (index - 1) / 2;
+        if (!is_before(slot, heap[parent])) {
+            break;
+        }
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    heap[index] = slot;
+}
+
+/** @brief Pop the earliest event of the heap.
+ *
+ *  @return Slot of the event.
+ */
+static uint32_t heap_pop(void)
+{
+    uint32_t top = heap[0];
+    uint32_t last = heap[--heap_count];
+    uint32_t index = 0;
+    uint32_t child;
+
+    while ((child = (2 * index) + 1) < heap_count) {
+        if (((child + 1) < heap_count) && is_before(heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!is_before(heap[child], last)) {
+            break;
+        }
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = last;
+
+    return top;
+}
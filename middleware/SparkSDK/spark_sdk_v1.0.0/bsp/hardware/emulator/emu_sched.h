@@ -0,0 +1,100 @@
+/** @file  emu_sched.h
+ *  @brief Discrete event scheduler of the host emulator.
+ *
+ *  Every emulated peripheral runs from a single virtual clock counting the
+ *  20.48 MHz PLL cycles of the SR1000. Events are executed in time order, and
+ *  in insertion order for events due at the same time, so a run is fully
+ *  deterministic.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_SCHED_H_
+#define EMU_SCHED_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define EMU_PLL_FREQ_HZ 20480000ULL /*!< Frequency of the virtual clock, the SR1000 PLL */
+
+/* MACROS *********************************************************************/
+#define EMU_US_TO_CYCLES(us)     (((uint64_t)(us) * EMU_PLL_FREQ_HZ) / 1000000ULL) /*!< Microseconds to PLL cycles */
+#define EMU_CYCLES_TO_US(cycles) (((uint64_t)(cycles) * 1000000ULL) / EMU_PLL_FREQ_HZ) /*!< PLL cycles to microseconds */
+
+/* TYPES **********************************************************************/
+/** @brief Event callback.
+ *
+ *  @param[in] context  Context given when the event was added.
+ *  @param[in] arg      Argument given when the event was added.
+ */
+typedef void (*emu_sched_callback_t)(void *context, uint32_t arg);
+
+/** @brief Handle of a pending event, used to cancel it.
+ *
+ *  A zero-initialized handle refers to no event.
+ */
+typedef struct emu_sched_handle {
+    uint32_t slot;       /*!< Slot of the event in the event pool */
+    uint32_t generation; /*!< Generation of the slot when the event was added, 0 for no event */
+} emu_sched_handle_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Initialize the scheduler and reset the virtual clock to 0.
+ */
+void emu_sched_init(void);
+
+/** @brief Free the memory of the scheduler.
+ */
+void emu_sched_deinit(void);
+
+/** @brief Get the time of the virtual clock.
+ *
+ *  @return Time in PLL cycles.
+ */
+uint64_t emu_sched_get_time(void);
+
+/** @brief Add an event.
+ *
+ *  @param[in] time      Time of the event in PLL cycles, events in the past run immediately.
+ *  @param[in] callback  Event callback.
+ *  @param[in] context   Context given to the callback.
+ *  @param[in] arg       Argument given to the callback.
+ *  @return Handle of the event.
+ */
+emu_sched_handle_t emu_sched_add(uint64_t time, emu_sched_callback_t callback, void *context, uint32_t arg);
+
+/** @brief Cancel a pending event.
+ *
+ *  Cancelling an event which already ran or was already cancelled has no effect.
+ *
+ *  @param[in,out] handle  Handle of the event, cleared on return.
+ */
+void emu_sched_cancel(emu_sched_handle_t *handle);
+
+/** @brief Check if an event is pending.
+ *
+ *  @param[in] handle  Handle of the event.
+ *  @retval true   Event is pending.
+ *  @retval false  Event ran, was cancelled or the handle is cleared.
+ */
+bool emu_sched_is_pending(const emu_sched_handle_t *handle);
+
+/** @brief Run the events up to a time then move the virtual clock to that time.
+ *
+ *  @param[in] time  Time in PLL cycles.
+ */
+void emu_sched_run_until(uint64_t time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_SCHED_H_ */
@@ -0,0 +1,790 @@
+/** @file  emu_sr1000.c
+ *  @brief Software model of the SR1000 transceiver.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include <string.h>
+#include "emu_sr1000.h"
+#include "sr_reg.h"
+
+/* CONSTANTS ******************************************************************/
+#define SPI_STATE_COMMAND     0 /* Next byte is a command */
+#define SPI_STATE_READ        1 /* Next byte returns the register value */
+#define SPI_STATE_WRITE       2 /* Next byte is the register value */
+#define SPI_STATE_BURST_READ  3 /* Each byte returns a register value */
+#define SPI_STATE_BURST_WRITE 4 /* Each byte is a register value */
+
+#define REG_ADDRESS_MASK      0x3F
+#define STATUS1_IRQ_BITS      0x7F /* STAT2IRQ is not an interrupt source */
+#define TIMER_WRAP_TICKS      65536
+#define RXTIMEOUT_TICK_CYCLES 8
+#define PWRUPDELAY_TICK_CYCLES 4
+#define CRC_SIZE              2
+#define DLTUNE_LEAD_THRESHOLD 6  /* Delay line setting where the DLL starts to lead */
+#define CALIB_BASE_FREQ       240 /* Calibration result of the lowest DCRO code */
+#define CALIB_FREQ_STEP       3   /* Calibration result decrease per DCRO code */
+#define PACKETCFG_RESET_VALUE 0x79
+#define NVM_KEY_TERMINATOR    0
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static uint8_t spi_exchange(emu_sr1000_t *radio, uint8_t tx_byte);
+static uint8_t read_register(emu_sr1000_t *radio, uint8_t address);
+static void write_register(emu_sr1000_t *radio, uint8_t address, uint8_t value);
+static void write_actions(emu_sr1000_t *radio, uint8_t actions);
+static void update_irq(emu_sr1000_t *radio);
+static void raise_status(emu_sr1000_t *radio, uint8_t status1, uint8_t status2);
+static uint32_t get_sleep_tick_cycles(emu_sr1000_t *radio);
+static uint32_t get_rx_timeout_cycles(emu_sr1000_t *radio);
+static uint32_t get_channel_key(emu_sr1000_t *radio);
+static uint8_t get_tx_freq_code(emu_sr1000_t *radio);
+static uint64_t get_frame_cycles(emu_sr1000_t *radio, uint8_t size, uint64_t *detect_offset);
+static uint64_t get_drifted_cycles(emu_sr1000_t *radio, uint64_t cycles);
+static void schedule_wake(emu_sr1000_t *radio);
+static void start_operation(emu_sr1000_t *radio, uint8_t actions, uint64_t time);
+static void finish_operation(emu_sr1000_t *radio);
+static void start_rx(emu_sr1000_t *radio, uint64_t start, uint32_t power_up, bool auto_reply);
+static void on_wake(void *context, uint32_t arg);
+static void on_tx_start(void *context, uint32_t arg);
+static void on_tx_end(void *context, uint32_t arg);
+static void on_rx_end(void *context, uint32_t arg);
+static void on_rx_timeout(void *context, uint32_t arg);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void emu_sr1000_init(emu_sr1000_t *radio, uint32_t chip_id)
+{
+    uint8_t nvm_image[] = {
+        1,  0x01,                                    /* Layout version */
+        2,  0x49, 0x54, 0x00, 0x00,                  /* Serial number, binning setup then chip ID */
+            (chip_id >> 24) & 0xFF, (chip_id >> 16) & 0xFF, (chip_id >> 8) & 0xFF, chip_id & 0xFF,
+        3,  0x77,                                    /* Calibration */
+        10, 0x01, 0x21,                              /* Product ID, SR1020 QFN48 */
+        11, 0x00, 0x00,                              /* VCRO shift */
+        NVM_KEY_TERMINATOR
+    };
+
+    memset(radio, 0, sizeof(emu_sr1000_t));
+    memcpy(radio->nvm, nvm_image, sizeof(nvm_image));
+    emu_sr1000_reset(radio);
+    radio->air_index = emu_air_attach(radio);
+}
+
+void emu_sr1000_set_irq_callback(emu_sr1000_t *radio, emu_sr1000_irq_callback_t callback, void *context)
+{
+    radio->irq_callback = callback;
+    radio->irq_context  = context;
+}
+
+void emu_sr1000_set_drift(emu_sr1000_t *radio, double drift_ppm)
+{
+    radio->drift_ppm = drift_ppm;
+}
+
+void emu_sr1000_reset(emu_sr1000_t *radio)
+{
+    emu_sched_cancel(&radio->wake_event);
+    emu_sched_cancel(&radio->state_event);
+
+    memset(radio->reg, 0, sizeof(radio->reg));
+    radio->reg[REG_PACKETCFG] = PACKETCFG_RESET_VALUE;
+    radio->status[0]     = 0;
+    radio->status[1]     = 0;
+    radio->tx_fifo_count = 0;
+    radio->rx_fifo_head  = 0;
+    radio->rx_fifo_count = 0;
+    radio->state         = EMU_SR1000_STATE_SLEEP;
+    radio->sleep_actions = 0;
+    radio->timer_epoch   = emu_sched_get_time();
+    radio->auto_reply    = false;
+    radio->rx_locked     = false;
+    radio->spi_state     = SPI_STATE_COMMAND;
+    radio->irq_asserted  = false;
+}
+
+void emu_sr1000_spi_select(emu_sr1000_t *radio, bool active)
+{
+    if (active && !radio->cs_active) {
+        radio->spi_state = SPI_STATE_COMMAND;
+    }
+    radio->cs_active = active;
+}
+
+void emu_sr1000_spi_transfer(emu_sr1000_t *radio, const uint8_t *tx_data, uint8_t *rx_data, uint16_t size)
+{
+    uint8_t rx_byte;
+
+    for (uint16_t i = 0; i < size; i++) {
+        rx_byte = spi_exchange(radio, tx_data[i]);
+        if (rx_data != NULL) {
+            rx_data[i] = rx_byte;
+        }
+    }
+}
+
+bool emu_sr1000_read_irq_pin(emu_sr1000_t *radio)
+{
+    bool active_high = (radio->reg[REG_IRQMASK1] & BIT_IRQPOLAR) != 0;
+
+    return active_high ? radio->irq_asserted : !radio->irq_asserted;
+}
+
+void emu_sr1000_detect_frame(emu_sr1000_t *radio, const emu_air_frame_t *frame, const emu_air_link_t *link)
+{
+    uint64_t now = emu_sched_get_time();
+    uint64_t start = frame->start + link->delay;
+    uint64_t waited;
+
+    if ((radio->state != EMU_SR1000_STATE_RX) || (frame->channel != get_channel_key(radio))) {
+        return;
+    }
+    if (radio->rx_locked) {
+        /* A second frame on the channel corrupts the one being received */
+        if (!radio->rx_collided) {
+            radio->rx_collided = true;
+            emu_air_count_collision();
+        }
+        return;
+    }
+    if ((start < radio->rx_window_start + radio->rx_power_up) || (now > radio->rx_window_end)) {
+        return;
+    }
+
+    emu_sched_cancel(&radio->state_event);
+    radio->rx_locked   = true;
+    radio->rx_collided = emu_air_is_collided(radio->air_index, frame);
+    if (radio->rx_collided) {
+        emu_air_count_collision();
+    }
+    radio->rx_frame        = *frame;
+    radio->rx_frame.start  = start;
+    radio->rx_frame.detect = now;
+    radio->rx_frame.end    = frame->end + link->delay;
+    radio->rssi            = link->rssi;
+    radio->rnsi            = link->rnsi;
+
+    waited = now - radio->rx_window_start;
+    radio->rx_waited = (waited > 0x7FFF) ? 0x7FFF : (uint16_t)waited;
+
+    if (radio->reg[REG_TIMERCONF] & BIT_SYNRXSTA) {
+        radio->timer_epoch = now;
+        schedule_wake(radio);
+    }
+    raise_status(radio, BIT_PKBEGINI, 0);
+    radio->state_event = emu_sched_add(radio->rx_frame.end, on_rx_end, radio, 0);
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Exchange one byte over the SPI.
+ *
+ *  @param[in] radio    Transceiver instance.
+ *  @param[in] tx_byte  Byte sent to the transceiver.
+ *  @return Byte received from the transceiver.
+ */
+static uint8_t spi_exchange(emu_sr1000_t *radio, uint8_t tx_byte)
+{
+    uint8_t rx_byte = 0;
+
+    if (!radio->cs_active) {
+        return 0;
+    }
+
+    switch (radio->spi_state) {
+    case SPI_STATE_COMMAND:
+        radio->spi_address = tx_byte & REG_ADDRESS_MASK;
+        if ((tx_byte & REG_WRITE_BURST) == REG_WRITE_BURST) {
+            radio->spi_state = SPI_STATE_BURST_WRITE;
+            if ((radio->spi_address >= REG_TXPULSE12) && (radio->spi_address <= REG_TXPULSE1)) {
+                radio->tx_pulse_start = radio->spi_address;
+            }
+        } else if (tx_byte & REG_READ_BURST) {
+            radio->spi_state = SPI_STATE_BURST_READ;
+        } else if (tx_byte & REG_WRITE) {
+            radio->spi_state = SPI_STATE_WRITE;
+        } else {
+            radio->spi_state = SPI_STATE_READ;
+        }
+        break;
+    case SPI_STATE_READ:
+        rx_byte = read_register(radio, radio->spi_address);
+        radio->spi_state = SPI_STATE_COMMAND;
+        break;
+    case SPI_STATE_WRITE:
+        if ((radio->spi_address >= REG_TXPULSE12) && (radio->spi_address <= REG_TXPULSE1)) {
+            radio->tx_pulse_start = radio->spi_address;
+        }
+        write_register(radio, radio->spi_address, tx_byte);
+        radio->spi_state = SPI_STATE_COMMAND;
+        break;
+    case SPI_STATE_BURST_READ:
+        rx_byte = read_register(radio, radio->spi_address);
+        if (radio->spi_address != REG_RXFIFO) {
+            radio->spi_address = (radio->spi_address + 1) & REG_ADDRESS_MASK;
+        }
+        break;
+    case SPI_STATE_BURST_WRITE:
+        write_register(radio, radio->spi_address, tx_byte);
+        if (radio->spi_address != REG_TXFIFO) {
+            radio->spi_address = (radio->spi_address + 1) & REG_ADDRESS_MASK;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return rx_byte;
+}
+
+/** @brief Read a register, with the side effects of the read.
+ *
+ *  @param[in] radio    Transceiver instance.
+ *  @param[in] address  Register address.
+ *  @return Register value.
+ */
+static uint8_t read_register(emu_sr1000_t *radio, uint8_t address)
+{
+    uint8_t value;
+
+    switch (address) {
+    case REG_STATUS1:
+        value = radio->status[0];
+        if (radio->status[1] & radio->reg[REG_IRQMASK2]) {
+            value |= BIT_STAT2IRQ;
+        }
+        radio->status[0] = 0;
+        update_irq(radio);
+        break;
+    case REG_STATUS2:
+        value = radio->status[1];
+        radio->status[1] = 0;
+        update_irq(radio);
+        break;
+    case REG_TXFIFOSTAT:
+        value = radio->tx_fifo_count;
+        break;
+    case REG_RXFIFOSTAT:
+        value = radio->rx_fifo_count;
+        break;
+    case REG_DLLTUNING:
+        value = radio->reg[REG_DLLTUNING] & ~BIT_LEADLAG;
+        if (MASK2VAL(radio->reg[REG_DLLTUNING], BITS_DLTUNE) >= DLTUNE_LEAD_THRESHOLD) {
+            value |= BIT_LEADLAG;
+        }
+        break;
+    case REG_CALIBRESULT:
+        value = radio->calib_result;
+        break;
+    case REG_PWRSTATUS:
+        value = 0;
+        if (radio->reg[REG_NVMADDRESS] & BIT_ROMPWRSW) {
+            value |= BIT_ROMEN;
+        }
+        if (radio->state != EMU_SR1000_STATE_SLEEP) {
+            value |= BIT_AWAKE;
+        }
+        if (radio->state == EMU_SR1000_STATE_RX) {
+            value |= BIT_RXEN;
+        } else if (radio->state == EMU_SR1000_STATE_TX) {
+            value |= BIT_TXEN;
+        }
+        break;
+    case REG_NVMVALUE:
+        value = radio->nvm[(radio->reg[REG_NVMADDRESS] & ~BIT_ROMPWRSW) % EMU_SR1000_NVM_SIZE];
+        break;
+    case REG_RSSI:
+        value = radio->rssi;
+        break;
+    case REG_RNSI:
+        value = radio->rnsi;
+        break;
+    case REG_RXWAITTIME1:
+        value = (radio->rx_waited >> 8) & BITS_RXWAITED8;
+        break;
+    case REG_RXWAITTIME0:
+        value = radio->rx_waited & 0xFF;
+        break;
+    case REG_FRAMEADDR1:
+        value = radio->frame_address >> 8;
+        break;
+    case REG_FRAMEADDR0:
+        value = radio->frame_address & 0xFF;
+        break;
+    case REG_PHSDATA1:
+    case REG_PHSDATA2:
+    case REG_PHSDATA3:
+    case REG_PHSDATA4:
+        value = 0;
+        break;
+    case REG_RXFIFO:
+        if (radio->rx_fifo_count > 0) {
+            value = radio->rx_fifo[radio->rx_fifo_head++];
+            if (--radio->rx_fifo_count == 0) {
+                radio->rx_fifo_head = 0;
+            }
+        } else {
+            value = 0;
+            raise_status(radio, 0, BIT_RXOVRFLI);
+        }
+        break;
+    default:
+        value = radio->reg[address];
+        break;
+    }
+
+    return value;
+}
+
+/** @brief Write a register, with the side effects of the write.
+ *
+ *  @param[in] radio    Transceiver instance.
+ *  @param[in] address  Register address.
+ *  @param[in] value    Register value.
+ */
+static void write_register(emu_sr1000_t *radio, uint8_t address, uint8_t value)
+{
+    switch (address) {
+    case REG_ACTIONS:
+        write_actions(radio, value);
+        break;
+    case REG_TXFIFO:
+        if (radio->tx_fifo_count < EMU_SR1000_FIFO_SIZE) {
+            radio->tx_fifo[radio->tx_fifo_count++] = value;
+        } else {
+            raise_status(radio, 0, BIT_TXOVRFLI);
+        }
+        break;
+    case REG_IRQMASK1:
+    case REG_IRQMASK2:
+        radio->reg[address] = value;
+        update_irq(radio);
+        break;
+    case REG_TIMERCONF:
+    case REG_TIMERPERIOD1:
+    case REG_TIMERPERIOD0:
+        radio->reg[address] = value;
+        schedule_wake(radio);
+        break;
+    default:
+        radio->reg[address] = value;
+        break;
+    }
+}
+
+/** @brief Execute a write to the ACTIONS register.
+ *
+ *  @param[in] radio    Transceiver instance.
+ *  @param[in] actions  Register value.
+ */
+static void write_actions(emu_sr1000_t *radio, uint8_t actions)
+{
+    uint8_t code;
+
+    if (actions & BIT_FLUSHRX) {
+        radio->rx_fifo_head  = 0;
+        radio->rx_fifo_count = 0;
+    }
+    if (actions & BIT_FLUSHTX) {
+        radio->tx_fifo_count = 0;
+    }
+    if (actions & BIT_CALIBRAT) {
+        code = radio->reg[REG_CALIBREQUEST] & REG_ADDRESS_MASK;
+        radio->calib_result = (CALIB_FREQ_STEP * code < CALIB_BASE_FREQ) ? (CALIB_BASE_FREQ - CALIB_FREQ_STEP * code) : 0;
+    }
+
+    radio->sleep_actions = actions;
+    if (actions & BIT_GOTOSLP) {
+        /* A busy transceiver sleeps at the end of the current operation */
+        if (radio->state == EMU_SR1000_STATE_IDLE) {
+            radio->state = EMU_SR1000_STATE_SLEEP;
+        }
+    } else if (radio->state == EMU_SR1000_STATE_SLEEP) {
+        radio->state = EMU_SR1000_STATE_IDLE;
+    }
+
+    if (actions & BIT_INITTIME) {
+        radio->timer_epoch = emu_sched_get_time();
+        schedule_wake(radio);
+    }
+}
+
+/** @brief Update the interrupt line and notify its assertion.
+ *
+ *  @param[in] radio  Transceiver instance.
+ */
+static void update_irq(emu_sr1000_t *radio)
+{
+    bool asserted = ((radio->status[0] & radio->reg[REG_IRQMASK1] & STATUS1_IRQ_BITS) != 0) ||
+                    ((radio->status[1] & radio->reg[REG_IRQMASK2]) != 0);
+    bool rising = asserted && !radio->irq_asserted;
+
+    radio->irq_asserted = asserted;
+    if (rising && (radio->irq_callback != NULL)) {
+        radio->irq_callback(radio->irq_context);
+    }
+}
+
+/** @brief Latch interrupt flags.
+ *
+ *  Flags latch whatever the interrupt mask.
+ *
+ *  @param[in] radio    Transceiver instance.
+ *  @param[in] status1  STATUS1 flags to set.
+ *  @param[in] status2  STATUS2 flags to set.
+ */
+static void raise_status(emu_sr1000_t *radio, uint8_t status1, uint8_t status2)
+{
+    radio->status[0] |= status1;
+    radio->status[1] |= status2;
+    update_irq(radio);
+}
+
+/** @brief Get the wake-up timer tick for the configured sleep depth.
+ *
+ *  @param[in] radio  Transceiver instance.
+ *  @return Tick duration in PLL cycles.
+ */
+static uint32_t get_sleep_tick_cycles(emu_sr1000_t *radio)
+{
+    return (radio->reg[REG_SLEEPCONF] & BITS_SLPDEPTH) ? EMU_SR1000_SLEEP_TICK_CYCLES : 1;
+}
+
+/** @brief Get the receiver timeout.
+ *
+ *  @param[in] radio  Transceiver instance.
+ *  @return Timeout in PLL cycles.
+ */
+static uint32_t get_rx_timeout_cycles(emu_sr1000_t *radio)
+{
+    uint32_t ticks = ((uint32_t)radio->reg[REG_RXTIMEOUT1] << 4) | (radio->reg[REG_RXTIMEOUT0] >> 4);
+
+    return ticks * RXTIMEOUT_TICK_CYCLES;
+}
+
+/** @brief Get the DCRO code of the transmitted pulses.
+ *
+ *  The channel burst only writes the pulse registers in use, starting from the
+ *  first one written.
+ *
+ *  @param[in] radio  Transceiver instance.
+ *  @return DCRO code of the first pulse.
+ */
+static uint8_t get_tx_freq_code(emu_sr1000_t *radio)
+{
+    uint8_t start = (radio->tx_pulse_start < REG_TXPULSE12) ? REG_TXPULSE12 : radio->tx_pulse_start;
+
+    for (uint8_t address = start; address <= REG_TXPULSE1; address++) {
+        if (radio->reg[address] != 0) {
+            return MASK2VAL(radio->reg[address], BITS_PULSEFREQ);
+        }
+    }
+
+    return 0;
+}
+
+/** @brief Get the channel key of the current operation.
+ *
+ *  A receiver only hears frames sent with the same frequency, syncword,
+ *  modulation and FEC level.
+ *
+ *  @param[in] radio  Transceiver instance.
+ *  @return Channel key.
+ */
+static uint32_t get_channel_key(emu_sr1000_t *radio)
+{
+    uint32_t freq_code;
+    uint32_t syncword;
+
+    if (radio->state == EMU_SR1000_STATE_TX) {
+        freq_code = get_tx_freq_code(radio);
+    } else {
+        freq_code = MASK2VAL(radio->reg[REG_RXFILTERS], BITS_RFFILFREQ);
+    }
+    syncword = ((uint32_t)radio->reg[REG_SYNCWORD3] << 24) | ((uint32_t)radio->reg[REG_SYNCWORD2] << 16) |
+               ((uint32_t)radio->reg[REG_SYNCWORD1] << 8) | (uint32_t)radio->reg[REG_SYNCWORD0];
+
+    return (freq_code << 27) ^
+           (((uint32_t)radio->reg[REG_MAINMODEM] & (BITS_MODULATION | BITS_FECLEVEL)) << 23) ^ syncword;
+}
+
+/** @brief Get the air time of a frame.
+ *
+ *  @param[in]  radio          Transceiver instance.
+ *  @param[in]  size           Number of bytes of data.
+ *  @param[out] detect_offset  Time from the start of the preamble to the end of the syncword, in PLL cycles.
+ *  @return Air time in PLL cycles.
+ */
+static uint64_t get_frame_cycles(emu_sr1000_t *radio, uint8_t size, uint64_t *detect_offset)
+{
+    uint8_t packet_cfg = radio->reg[REG_PACKETCFG];
+    uint32_t preamble_bits = (radio->reg[REG_PREAMBLEN] + 8) * 2;
+    uint32_t syncword_bits = (radio->reg[REG_SYNCWORDCFG] & BIT_SWLENGTH) ? 32 : 16;
+    uint32_t fec_level = MASK2VAL(radio->reg[REG_MAINMODEM], BITS_FECLEVEL);
+    uint32_t bytes = size + CRC_SIZE;
+
+    if (packet_cfg & BIT_SIZEHDRE) {
+        bytes += 1;
+    }
+    if (packet_cfg & BIT_ADDRHDRE) {
+        bytes += (packet_cfg & BIT_ADDRLEN) ? 2 : 1;
+    }
+    *detect_offset = preamble_bits + syncword_bits;
+
+    /* FEC levels 0 to 3 code at a rate of 1, 3/4, 3/5 and 1/2 */
+    return *detect_offset + ((uint64_t)bytes * 8 * (3 + fec_level)) / 3;
+}
+
+/** @brief Get the duration of a wake-up timer period.
+ *
+ *  The fraction of cycle left is carried over once the wake-up happens, so
+ *  drifts far below one cycle per period still accumulate.
+ *
+ *  @param[in] radio   Transceiver instance.
+ *  @param[in] cycles  Duration in cycles of the drifting clock.
+ *  @return Duration in PLL cycles of the virtual clock.
+ */
+static uint64_t get_drifted_cycles(emu_sr1000_t *radio, uint64_t cycles)
+{
+    double drift = ((double)cycles * radio->drift_ppm / 1000000.0) + radio->drift_fraction;
+    int64_t drift_cycles = (int64_t)drift;
+
+    radio->drift_fraction_next = drift - (double)drift_cycles;
+
+    return cycles + drift_cycles;
+}
+
+/** @brief Schedule the next wake-up from the timer settings.
+ *
+ *  @param[in] radio  Transceiver instance.
+ */
+static void schedule_wake(emu_sr1000_t *radio)
+{
+    uint64_t now = emu_sched_get_time();
+    uint64_t tick = get_sleep_tick_cycles(radio);
+    uint64_t wrap = TIMER_WRAP_TICKS * tick;
+    uint16_t period = (uint16_t)(((uint32_t)radio->reg[REG_TIMERPERIOD1] << 8) | radio->reg[REG_TIMERPERIOD0]);
+    uint64_t wake = radio->timer_epoch + get_drifted_cycles(radio, ((uint64_t)period + 1) * tick);
+
+    emu_sched_cancel(&radio->wake_event);
+    if (!(radio->reg[REG_TIMERCONF] & BIT_AUTOWAKE)) {
+        return;
+    }
+    if (wake <= now) {
+        /* The period is already elapsed, the counter wraps around first */
+        wake += (((now - wake) / wrap) + 1) * wrap;
+    }
+    radio->wake_event = emu_sched_add(wake, on_wake, radio, 0);
+}
+
+/** @brief Start the operation selected by the actions.
+ *
+ *  @param[in] radio    Transceiver instance.
+ *  @param[in] actions  ACTIONS register value.
+ *  @param[in] time     Wake-up time in PLL cycles.
+ */
+static void start_operation(emu_sr1000_t *radio, uint8_t actions, uint64_t time)
+{
+    radio->auto_reply = false;
+    if (actions & BIT_STARTTX) {
+        radio->state = EMU_SR1000_STATE_TX;
+        radio->state_event = emu_sched_add(time + radio->reg[REG_PWRUPDELAY] * PWRUPDELAY_TICK_CYCLES, on_tx_start,
+                                           radio, 0);
+    } else if (actions & BIT_RXMODE) {
+        start_rx(radio, time, radio->reg[REG_PWRUPDELAY] * PWRUPDELAY_TICK_CYCLES, false);
+    } else {
+        radio->state = EMU_SR1000_STATE_IDLE;
+    }
+}
+
+/** @brief End the current operation.
+ *
+ *  @param[in] radio  Transceiver instance.
+ */
+static void finish_operation(emu_sr1000_t *radio)
+{
+    emu_sched_cancel(&radio->state_event);
+    radio->rx_locked  = false;
+    radio->auto_reply = false;
+    radio->state = (radio->sleep_actions & BIT_GOTOSLP) ? EMU_SR1000_STATE_SLEEP : EMU_SR1000_STATE_IDLE;
+}
+
+/** @brief Open a reception window.
+ *
+ *  The receiver only listens once powered up, but the timeout and the RX
+ *  waited time count from the start of the window.
+ *
+ *  @param[in] radio       Transceiver instance.
+ *  @param[in] start       Start of the window in PLL cycles.
+ *  @param[in] power_up    Power up delay of the receiver in PLL cycles.
+ *  @param[in] auto_reply  True if the window waits for an auto-reply.
+ */
+static void start_rx(emu_sr1000_t *radio, uint64_t start, uint32_t power_up, bool auto_reply)
+{
+    radio->state           = EMU_SR1000_STATE_RX;
+    radio->auto_reply      = auto_reply;
+    radio->rx_locked       = false;
+    radio->rx_window_start = start;
+    radio->rx_power_up     = power_up;
+    radio->rx_window_end   = start + get_rx_timeout_cycles(radio);
+    radio->state_event     = emu_sched_add(radio->rx_window_end, on_rx_timeout, radio, 0);
+}
+
+/** @brief Wake-up timer event.
+ *
+ *  @param[in] context  Transceiver instance.
+ *  @param[in] arg      Unused.
+ */
+static void on_wake(void *context, uint32_t arg)
+{
+    emu_sr1000_t *radio = (emu_sr1000_t *)context;
+    uint64_t now = emu_sched_get_time();
+
+    (void)arg;
+
+    radio->wake_event     = (emu_sched_handle_t){0};
+    radio->timer_epoch    = now;
+    radio->drift_fraction = radio->drift_fraction_next;
+    if (!(radio->reg[REG_TIMERCONF] & BIT_WAKEONCE)) {
+        schedule_wake(radio);
+    }
+    raise_status(radio, 0, BIT_WAKEUPI);
+
+    if ((radio->state == EMU_SR1000_STATE_SLEEP) || (radio->state == EMU_SR1000_STATE_IDLE)) {
+        start_operation(radio, radio->sleep_actions, now);
+    }
+}
+
+/** @brief Start of a transmission, the TX FIFO content is sent.
+ *
+ *  @param[in] context  Transceiver instance.
+ *  @param[in] arg      Unused.
+ */
+static void on_tx_start(void *context, uint32_t arg)
+{
+    emu_sr1000_t *radio = (emu_sr1000_t *)context;
+    emu_air_frame_t frame;
+    uint64_t detect_offset;
+    uint8_t size = radio->reg[REG_TXPKTSIZE];
+
+    (void)arg;
+
+    if (size > radio->tx_fifo_count) {
+        raise_status(radio, 0, BIT_TXUDRFLI);
+        size = radio->tx_fifo_count;
+    }
+    frame.source  = radio->air_index;
+    frame.channel = get_channel_key(radio);
+    frame.address = (uint16_t)(((uint32_t)radio->reg[REG_REMOTADDR1] << 8) | radio->reg[REG_REMOTADDR0]);
+    frame.size    = size;
+    memcpy(frame.data, radio->tx_fifo, size);
+    radio->tx_fifo_count -= size;
+    memmove(radio->tx_fifo, &radio->tx_fifo[size], radio->tx_fifo_count);
+
+    frame.start  = emu_sched_get_time();
+    frame.end    = frame.start + get_frame_cycles(radio, size, &detect_offset);
+    frame.detect = frame.start + detect_offset;
+    if (radio->reg[REG_TIMERCONF] & BIT_SYNTXSTA) {
+        radio->timer_epoch = frame.start;
+        schedule_wake(radio);
+    }
+    emu_air_transmit(&frame);
+
+    radio->state_event = emu_sched_add(frame.end, on_tx_end, radio, 0);
+}
+
+/** @brief End of a transmission.
+ *
+ *  @param[in] context  Transceiver instance.
+ *  @param[in] arg      Unused.
+ */
+static void on_tx_end(void *context, uint32_t arg)
+{
+    emu_sr1000_t *radio = (emu_sr1000_t *)context;
+
+    (void)arg;
+
+    radio->state_event = (emu_sched_handle_t){0};
+    if (!radio->auto_reply && (radio->reg[REG_MAINMODEM] & BIT_AUTORPLY)) {
+        /* Listen for the auto-reply, the timeout counts from the end of the frame */
+        start_rx(radio, emu_sched_get_time(), 0, true);
+        raise_status(radio, BIT_TXENDI, 0);
+    } else {
+        finish_operation(radio);
+        raise_status(radio, BIT_TXENDI, 0);
+    }
+}
+
+/** @brief End of a frame reception.
+ *
+ *  @param[in] context  Transceiver instance.
+ *  @param[in] arg      Unused.
+ */
+static void on_rx_end(void *context, uint32_t arg)
+{
+    emu_sr1000_t *radio = (emu_sr1000_t *)context;
+    emu_air_frame_t *frame = &radio->rx_frame;
+    uint8_t packet_cfg = radio->reg[REG_PACKETCFG];
+    uint16_t local_address = (uint16_t)(((uint32_t)radio->reg[REG_LOCALADDR1] << 8) | radio->reg[REG_LOCALADDR0]);
+    uint16_t address_mask = (packet_cfg & BIT_ADDRLEN) ? 0xFFFF : 0x00FF;
+    uint8_t status1 = BIT_NEWPKTI;
+    bool reply;
+
+    (void)arg;
+
+    radio->state_event = (emu_sched_handle_t){0};
+    radio->rx_locked   = false;
+
+    if (!radio->rx_collided) {
+        status1 |= BIT_CRCPASSI;
+    }
+    if ((frame->address & address_mask) == (local_address & address_mask)) {
+        status1 |= BIT_ADDRMATI;
+    }
+    if ((frame->address & 0xFF) == 0xFF) {
+        status1 |= BIT_BRDCASTI;
+    }
+    radio->frame_address = frame->address;
+
+    /* Frames are appended to the RX FIFO, the stack flushes it between slots */
+    if (radio->rx_fifo_head + radio->rx_fifo_count + frame->size + 1 <= EMU_SR1000_FIFO_SIZE) {
+        if (packet_cfg & BIT_SAVESIZE) {
+            radio->rx_fifo[radio->rx_fifo_head + radio->rx_fifo_count++] = frame->size;
+        }
+        memcpy(&radio->rx_fifo[radio->rx_fifo_head + radio->rx_fifo_count], frame->data, frame->size);
+        radio->rx_fifo_count += frame->size;
+    } else {
+        status1 &= ~BIT_CRCPASSI;
+        raise_status(radio, 0, BIT_RXOVRFLI);
+    }
+
+    reply = !radio->auto_reply && (radio->reg[REG_MAINMODEM] & BIT_AUTORPLY) &&
+            ((status1 & (BIT_CRCPASSI | BIT_ADDRMATI)) == (BIT_CRCPASSI | BIT_ADDRMATI));
+    if (reply) {
+        radio->state       = EMU_SR1000_STATE_TX;
+        radio->auto_reply  = true;
+        radio->state_event = emu_sched_add(frame->end + EMU_SR1000_REPLY_DELAY, on_tx_start, radio, 0);
+    } else {
+        finish_operation(radio);
+    }
+    raise_status(radio, status1, 0);
+}
+
+/** @brief End of a reception window.
+ *
+ *  @param[in] context  Transceiver instance.
+ *  @param[in] arg      Unused.
+ */
+static void on_rx_timeout(void *context, uint32_t arg)
+{
+    emu_sr1000_t *radio = (emu_sr1000_t *)context;
+
+    (void)arg;
+
+    radio->state_event = (emu_sched_handle_t){0};
+    if (!radio->rx_locked) {
+        finish_operation(radio);
+        raise_status(radio, BIT_RXTIMEOI, 0);
+    }
+}
@@ -0,0 +1,173 @@
+/** @file  emu_sr1000.h
+ *  @brief Software model of the SR1000 transceiver.
+ *
+ *  The model decodes the SPI register accesses of the Wireless Core and
+ *  implements the register file, the TX and RX FIFOs, the interrupt flags and
+ *  pin, the wake-up timer, the NVM and the calibration results. Frames are
+ *  exchanged through the virtual air medium.
+ *
+ *  Timing follows the register settings: a transmission starts PWRUPDELAY
+ *  after the wake-up, a reception window lasts RXTIMEOUT from the wake-up and
+ *  the frame length is computed from the preamble, syncword, headers, payload,
+ *  CRC and FEC level at one chip per PLL cycle. Cut-through (BUFLOAD), clear
+ *  channel assessment and the dual radio synchronization are not modeled.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_SR1000_H_
+#define EMU_SR1000_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "emu_air.h"
+#include "emu_sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define EMU_SR1000_REG_COUNT         64  /*!< Number of 8-bit registers */
+#define EMU_SR1000_FIFO_SIZE         128 /*!< Size of each FIFO in bytes */
+#define EMU_SR1000_NVM_SIZE          128 /*!< Size of the NVM in bytes */
+#define EMU_SR1000_REPLY_DELAY       147 /*!< Delay between the end of a frame and the start of its auto-reply, in PLL cycles */
+#define EMU_SR1000_SLEEP_TICK_CYCLES 625 /*!< PLL cycles per wake-up timer tick in shallow and deep sleep */
+
+/* TYPES **********************************************************************/
+/** @brief Transceiver power state.
+ */
+typedef enum emu_sr1000_state {
+    EMU_SR1000_STATE_SLEEP, /*!< Asleep, waiting for the wake-up timer */
+    EMU_SR1000_STATE_IDLE,  /*!< Awake, neither transmitting nor receiving */
+    EMU_SR1000_STATE_RX,    /*!< Listening or receiving a frame */
+    EMU_SR1000_STATE_TX     /*!< Transmitting a frame */
+} emu_sr1000_state_t;
+
+/** @brief Interrupt pin rising edge callback.
+ *
+ *  @param[in] context  Context given with the callback.
+ */
+typedef void (*emu_sr1000_irq_callback_t)(void *context);
+
+/** @brief Transceiver instance.
+ */
+typedef struct emu_sr1000 {
+    uint8_t air_index;                       /*!< Medium index of the transceiver */
+    double drift_ppm;                        /*!< Drift of the wake-up timer clock */
+    double drift_fraction;                   /*!< Fraction of PLL cycle of drift not applied yet */
+    double drift_fraction_next;              /*!< Fraction of PLL cycle of drift left after the next wake-up */
+    uint8_t reg[EMU_SR1000_REG_COUNT];       /*!< Values written to the registers */
+    uint8_t status[2];                       /*!< Interrupt flags, STATUS1 and STATUS2 */
+    uint8_t nvm[EMU_SR1000_NVM_SIZE];        /*!< NVM content */
+    uint8_t calib_result;                    /*!< Last calibration result */
+    uint8_t rssi;                            /*!< RSSI of the last frame received */
+    uint8_t rnsi;                            /*!< RNSI of the last frame received */
+    uint16_t rx_waited;                      /*!< Time waited before the last frame received, in PLL cycles */
+    uint16_t frame_address;                  /*!< Destination address of the last frame received */
+    uint8_t tx_pulse_start;                  /*!< First TXPULSE register of the last channel written */
+    /* SPI */
+    bool cs_active;                          /*!< True while the chip select is low */
+    uint8_t spi_state;                       /*!< Decoding state of the current SPI transaction */
+    uint8_t spi_address;                     /*!< Register accessed by the current SPI transaction */
+    /* FIFOs */
+    uint8_t tx_fifo[EMU_SR1000_FIFO_SIZE];   /*!< TX FIFO content */
+    uint8_t tx_fifo_count;                   /*!< Bytes in the TX FIFO */
+    uint8_t rx_fifo[EMU_SR1000_FIFO_SIZE];   /*!< RX FIFO content */
+    uint8_t rx_fifo_head;                    /*!< Index of the next byte read from the RX FIFO */
+    uint8_t rx_fifo_count;                   /*!< Bytes in the RX FIFO */
+    /* Power and timer */
+    emu_sr1000_state_t state;                /*!< Power state */
+    uint8_t sleep_actions;                   /*!< ACTIONS latched by the last GOTOSLP, run at the next wake-up */
+    uint64_t timer_epoch;                    /*!< Time the wake-up timer period counts from, in PLL cycles */
+    emu_sched_handle_t wake_event;           /*!< Next wake-up */
+    emu_sched_handle_t state_event;          /*!< End of the current transmission, reception or reception window */
+    /* Transmission and reception */
+    bool auto_reply;                         /*!< True if the current operation is the auto-reply phase */
+    bool rx_locked;                          /*!< True while a frame is being received */
+    bool rx_collided;                        /*!< True if the frame being received is corrupted */
+    uint64_t rx_window_start;                /*!< Start of the reception window, in PLL cycles */
+    uint32_t rx_power_up;                    /*!< Delay before the receiver listens in the window, in PLL cycles */
+    uint64_t rx_window_end;                  /*!< End of the reception window, in PLL cycles */
+    emu_air_frame_t rx_frame;                /*!< Frame being received, times at the receiver */
+    /* Interrupt */
+    bool irq_asserted;                       /*!< True while an unmasked interrupt flag is set */
+    emu_sr1000_irq_callback_t irq_callback;  /*!< Called on each assertion of the interrupt */
+    void *irq_context;                       /*!< Context of the interrupt callback */
+} emu_sr1000_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Initialize a transceiver and attach it to the air medium.
+ *
+ *  @param[out] radio    Transceiver instance.
+ *  @param[in]  chip_id  Chip ID burned in the NVM serial number.
+ */
+void emu_sr1000_init(emu_sr1000_t *radio, uint32_t chip_id);
+
+/** @brief Set the interrupt callback.
+ *
+ *  @param[in] radio     Transceiver instance.
+ *  @param[in] callback  Called on each assertion of the interrupt pin.
+ *  @param[in] context   Context given to the callback.
+ */
+void emu_sr1000_set_irq_callback(emu_sr1000_t *radio, emu_sr1000_irq_callback_t callback, void *context);
+
+/** @brief Set the drift of the wake-up timer clock.
+ *
+ *  Without drift, transceivers sharing the virtual clock never slip against
+ *  each other, which real crystals always do.
+ *
+ *  @param[in] radio      Transceiver instance.
+ *  @param[in] drift_ppm  Drift in ppm, positive when the timer runs slow.
+ */
+void emu_sr1000_set_drift(emu_sr1000_t *radio, double drift_ppm);
+
+/** @brief Reset the registers, the FIFOs and the state, as the reset pin does.
+ *
+ *  @param[in] radio  Transceiver instance.
+ */
+void emu_sr1000_reset(emu_sr1000_t *radio);
+
+/** @brief Drive the SPI chip select.
+ *
+ *  Asserting an already asserted chip select continues the current transaction.
+ *
+ *  @param[in] radio   Transceiver instance.
+ *  @param[in] active  True to pull the chip select low.
+ */
+void emu_sr1000_spi_select(emu_sr1000_t *radio, bool active);
+
+/** @brief Transfer bytes full duplex over the SPI.
+ *
+ *  @param[in]  radio    Transceiver instance.
+ *  @param[in]  tx_data  Bytes sent to the transceiver.
+ *  @param[out] rx_data  Bytes received from the transceiver, can point to tx_data.
+ *  @param[in]  size     Number of bytes.
+ */
+void emu_sr1000_spi_transfer(emu_sr1000_t *radio, const uint8_t *tx_data, uint8_t *rx_data, uint16_t size);
+
+/** @brief Read the interrupt pin.
+ *
+ *  @param[in] radio  Transceiver instance.
+ *  @return Level of the pin, following the IRQPOLAR setting.
+ */
+bool emu_sr1000_read_irq_pin(emu_sr1000_t *radio);
+
+/** @brief Offer a frame whose syncword ends at the receiver.
+ *
+ *  Called by the air medium.
+ *
+ *  @param[in] radio  Transceiver instance.
+ *  @param[in] frame  Frame, times at the transmitter.
+ *  @param[in] link   Link from the transmitter.
+ */
+void emu_sr1000_detect_frame(emu_sr1000_t *radio, const emu_air_frame_t *frame, const emu_air_link_t *link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_SR1000_H_ */
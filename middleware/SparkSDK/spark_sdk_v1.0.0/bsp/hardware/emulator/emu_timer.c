@@ -0,0 +1,37 @@
+/** @file  emu_timer.c
+ *  @brief This module emulates the timers, all running from the virtual clock.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include "emu_sched.h"
+#include "emu_timer.h"
+
+/* CONSTANTS ******************************************************************/
+#define CYCLES_PER_MS         (EMU_PLL_FREQ_HZ / 1000)
+#define CYCLES_PER_QUARTER_MS (EMU_PLL_FREQ_HZ / 4000)
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+uint32_t emu_timer_get_ms_tick(void)
+{
+    return (uint32_t)(emu_sched_get_time() / CYCLES_PER_MS);
+}
+
+void emu_timer_delay_ms(uint32_t ms)
+{
+    (void)ms;
+}
+
+uint32_t emu_timer_get_tick_us(void)
+{
+    return (uint32_t)EMU_CYCLES_TO_US(emu_sched_get_time());
+}
+
+uint64_t emu_timer_get_free_running_tick_quarter_ms(void)
+{
+    return emu_sched_get_time() / CYCLES_PER_QUARTER_MS;
+}
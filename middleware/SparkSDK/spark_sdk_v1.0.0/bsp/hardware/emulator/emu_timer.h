@@ -0,0 +1,50 @@
+/** @file  emu_timer.h
+ *  @brief This module emulates the timers, all running from the virtual clock.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef EMU_TIMER_H_
+#define EMU_TIMER_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Get timebase tick value.
+ *
+ *  @return Tick value in milliseconds.
+ */
+uint32_t emu_timer_get_ms_tick(void);
+
+/** @brief Blocking delay with a 1ms resolution.
+ *
+ *  Node code runs in zero virtual time, so the delay returns right away.
+ *
+ *  @param[in] ms  Delay in milliseconds.
+ */
+void emu_timer_delay_ms(uint32_t ms);
+
+/** @brief Get the current tick in micro seconds.
+ *
+ *  @return Current value of the micro seconds timer.
+ */
+uint32_t emu_timer_get_tick_us(void);
+
+/** @brief Free running timer with a tick of 250 us.
+ *
+ *  @return Tick count.
+ */
+uint64_t emu_timer_get_free_running_tick_quarter_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EMU_TIMER_H_ */
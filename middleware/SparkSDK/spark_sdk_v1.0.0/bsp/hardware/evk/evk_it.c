@@ -10,6 +10,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "evk_it.h"
 #include "evk_dbg.h"
+#include "evk_radio.h"
 
 /* EXTERNS ********************************************************************/
 extern PCD_HandleTypeDef  hpcd_USB_FS;
@@ -207,6 +208,11 @@ void DMA1_Channel2_IRQHandler(void)
     /* Process Unlocked */
     __HAL_UNLOCK(&hradio_dma_spi_rx);
 
+    /* Only notify the radio once the whole chain of transfers is complete */
+    if (evk_radio_spi_transfer_chain_next()) {
+        return;
+    }
+
     radio1_dma_callback();
 }
 
@@ -16,6 +16,17 @@ SPI_HandleTypeDef  hradio_spi;
 DMA_HandleTypeDef  hradio_dma_spi_rx;
 DMA_HandleTypeDef  hradio_dma_spi_tx;
 
+/** @brief Chain of SPI transfers in progress.
+ */
+static struct {
+    uint8_t **tx_data;    /*!< Data buffers to write */
+    uint8_t **rx_data;    /*!< Data buffers received */
+    uint16_t *size;       /*!< Size of each data buffer */
+    bool     *release_cs; /*!< Chip select is pulsed after a buffer when its entry is set */
+    uint8_t   count;      /*!< Number of data buffers */
+    uint8_t   index;      /*!< Next data buffer to transfer */
+} spi_chain;
+
 /* PUBLIC FUNCTIONS ***********************************************************/
 bool evk_radio_read_irq_pin(void)
 {
@@ -205,6 +216,36 @@ void evk_radio_spi_transfer_full_duplex_non_blocking(uint8_t *tx_data, uint8_t *
     SET_BIT((spi_local)->Instance->CR2, SPI_CR2_TXDMAEN);
 }
 
+void evk_radio_spi_transfer_chain_non_blocking(uint8_t **tx_data, uint8_t **rx_data, uint16_t *size, bool *release_cs,
+                                               uint8_t count)
+{
+    spi_chain.tx_data    = tx_data;
+    spi_chain.rx_data    = rx_data;
+    spi_chain.size       = size;
+    spi_chain.release_cs = release_cs;
+    spi_chain.count      = count;
+    spi_chain.index      = 1;
+
+    evk_radio_spi_transfer_full_duplex_non_blocking(tx_data[0], rx_data[0], size[0]);
+}
+
+bool evk_radio_spi_transfer_chain_next(void)
+{
+    if (spi_chain.index >= spi_chain.count) {
+        return false;
+    }
+
+    if (spi_chain.release_cs[spi_chain.index - 1]) {
+        evk_radio_spi_set_cs();
+    }
+    evk_radio_spi_transfer_full_duplex_non_blocking(spi_chain.tx_data[spi_chain.index],
+                                                    spi_chain.rx_data[spi_chain.index],
+                                                    spi_chain.size[spi_chain.index]);
+    spi_chain.index++;
+
+    return true;
+}
+
 bool evk_radio_is_spi_busy(void)
 {
     return (&hradio_spi)->Instance->SR & SPI_SR_BSY;
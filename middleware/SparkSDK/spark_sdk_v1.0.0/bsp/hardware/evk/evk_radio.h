@@ -102,6 +102,30 @@ void evk_radio_spi_transfer_full_duplex_blocking(uint8_t *tx_data, uint8_t *rx_d
  */
 void evk_radio_spi_transfer_full_duplex_non_blocking(uint8_t *tx_data, uint8_t *rx_data, uint16_t size);
 
+/** @brief Read and Write a chain of data buffers full duplex on the radio in non-blocking mode.
+ *
+ *  The DMA channels have no descriptor chaining, so the next buffer is started
+ *  from the DMA interrupt by evk_radio_spi_transfer_chain_next() and the radio
+ *  DMA callback only runs once the last buffer is transferred.
+ *
+ *  @param tx_data     Data buffers to write.
+ *  @param rx_data     Data buffers received.
+ *  @param size        Size of each data buffer.
+ *  @param release_cs  Chip select is pulsed after a buffer when its entry is set.
+ *  @param count       Number of data buffers.
+ */
+void evk_radio_spi_transfer_chain_non_blocking(uint8_t **tx_data, uint8_t **rx_data, uint16_t *size, bool *release_cs,
+                                               uint8_t count);
+
+/** @brief Start the next data buffer of a chain of transfers.
+ *
+ *  @note Called by the DMA interrupt handler.
+ *
+ *  @retval true   Next data buffer started, the chain is not complete.
+ *  @retval false  No chain of transfers in progress.
+ */
+bool evk_radio_spi_transfer_chain_next(void);
+
 /** @brief Read the status of the radio's SPI.
  *
  *  @retval true   SPI is busy.
@@ -24,6 +24,7 @@ extern "C" {
  */
 typedef struct ep_swc_instance {
     swc_connection_t *connection; /*!< Wireless connection to use when producing or consuming */
+    sac_endpoint_t *lender;       /*!< Endpoint lending its audio packets to the connection, NULL to copy them */
 } ep_swc_instance_t;
 
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
@@ -35,6 +36,31 @@ typedef struct ep_swc_instance {
 void iface_audio_swc_endpoint_init(sac_endpoint_interface_t *swc_producer_iface,
                                    sac_endpoint_interface_t *swc_consumer_iface);
 
+/** @brief Lend the audio packets of a Wireless Core consumer endpoint to its connection.
+ *
+ *  Audio packets are transmitted from the Audio Core queue nodes instead of being copied
+ *  in the connection transmission queue. Must be called before the connection is started.
+ *
+ *  @param[in] instance  Wireless Core consumer endpoint instance.
+ *  @param[in] consumer  Audio endpoint of the instance, configured with a lent_queue_size
+ *                       at least as large as the connection queue size.
+ */
+void iface_audio_swc_endpoint_lend_packets(ep_swc_instance_t *instance, sac_endpoint_t *consumer);
+
+/** @brief Receive the audio packets of a Wireless Core producer endpoint in place.
+ *
+ *  The connection reception queue receives in Audio Core packets, exchanged for the packet
+ *  being produced instead of being copied in it. Must be called after sac_pipeline_setup()
+ *  and before the connection is started. The endpoint keeps copying if it is not configured
+ *  for it.
+ *
+ *  @param[in] instance  Wireless Core producer endpoint instance.
+ *  @param[in] producer  Audio endpoint of the instance, configured with a lent_queue_size at least
+ *                       as large as the connection queue size and a packet_headroom of at least
+ *                       swc_connection_get_rx_headroom().
+ */
+void iface_audio_swc_endpoint_receive_in_place(ep_swc_instance_t *instance, sac_endpoint_t *producer);
+
 /** @brief Initialize MAX98091 audio endpoint interfaces.
  *
  *  @param[out] max98091_producer_iface  MAX98091 producer audio endpoint interface.
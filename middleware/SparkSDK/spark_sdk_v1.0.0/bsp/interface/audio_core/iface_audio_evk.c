@@ -34,6 +34,7 @@ static uint16_t ep_swc_produce(void *instance, uint8_t *samples, uint16_t size);
 static uint16_t ep_swc_consume(void *instance, uint8_t *samples, uint16_t size);
 static void ep_swc_start(void *instance);
 static void ep_swc_stop(void *instance);
+static void ep_swc_release(void *parg, uint8_t *payload_buffer);
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 void iface_audio_swc_endpoint_init(sac_endpoint_interface_t *swc_producer_iface,
@@ -54,6 +55,30 @@ void iface_audio_swc_endpoint_init(sac_endpoint_interface_t *swc_producer_iface,
     }
 }
 
+void iface_audio_swc_endpoint_lend_packets(ep_swc_instance_t *instance, sac_endpoint_t *consumer)
+{
+    instance->lender = consumer;
+    swc_connection_set_tx_release_callback(instance->connection, ep_swc_release, consumer);
+}
+
+void iface_audio_swc_endpoint_receive_in_place(ep_swc_instance_t *instance, sac_endpoint_t *producer)
+{
+    swc_error_t err;
+    uint8_t queue_size = instance->connection->cfg.queue_size;
+
+    if ((producer->cfg.lent_queue_size < queue_size) ||
+        (producer->cfg.packet_headroom < swc_connection_get_rx_headroom(instance->connection)))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < queue_size; i++)
+    {
+        swc_connection_set_rx_payload_buffer(instance->connection, i, sac_endpoint_lend_packet(producer), &err);
+    }
+    instance->lender = producer;
+}
+
 void iface_audio_max98091_endpoint_init(sac_endpoint_interface_t *max98091_producer_iface,
                                         sac_endpoint_interface_t *max98091_consumer_iface)
 {
@@ -187,6 +212,18 @@ static uint16_t ep_swc_produce(void *instance, uint8_t *samples, uint16_t size)
     ep_swc_instance_t *inst = (ep_swc_instance_t *)instance;
     (void)size;
 
+    if (inst->lender != NULL)
+    {
+        /* Produce the packet received in place, the connection receives in the current one instead */
+        payload_size = swc_connection_receive_exchange(inst->connection, &payload, samples, &err);
+        if (payload != NULL)
+        {
+            sac_endpoint_exchange_packet(inst->lender, payload);
+        }
+        swc_connection_receive_complete(inst->connection, &err);
+        return payload_size;
+    }
+
     payload_size = swc_connection_receive(inst->connection, &payload, &err);
 
     memcpy(samples, payload, payload_size);
@@ -208,6 +245,13 @@ static uint16_t ep_swc_consume(void *instance, uint8_t *samples, uint16_t size)
     swc_error_t err;
     ep_swc_instance_t *inst = (ep_swc_instance_t *)instance;
 
+    if (inst->lender != NULL)
+    {
+        /* Transmit from the Audio Core node, it is held until ep_swc_release() */
+        swc_connection_send(inst->connection, samples, size, &err);
+        return (err == SWC_ERR_NONE) ? size : 0;
+    }
+
     swc_connection_get_payload_buffer(inst->connection, &buf, &err);
     if (buf != NULL)
     {
@@ -238,3 +282,15 @@ static void ep_swc_stop(void *instance)
 {
     (void)instance;
 }
+
+/** @brief Release an audio packet the Wireless Core is done transmitting.
+ *
+ *  @param[in] parg            Consumer endpoint which lent the audio packet.
+ *  @param[in] payload_buffer  Lent payload buffer.
+ */
+static void ep_swc_release(void *parg, uint8_t *payload_buffer)
+{
+    (void)payload_buffer;
+
+    sac_endpoint_release_packet((sac_endpoint_t *)parg);
+}
@@ -0,0 +1,32 @@
+/** @file  circular_queue_critical_section.h
+ *  @brief SPARK circular queue critical section macros definition for host builds.
+ *
+ *  Host builds run the queues from a single thread, so no interrupt needs to be masked.
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef CIRCULAR_QUEUE_CRITICAL_SECTION_H_
+#define CIRCULAR_QUEUE_CRITICAL_SECTION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* MACROS *********************************************************************/
+/** @brief Macro for entering a critical region.
+ */
+#define CRITICAL_SECTION_ENTER()
+
+/** @brief Macro for leaving a critical region.
+ */
+#define CRITICAL_SECTION_EXIT()
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CIRCULAR_QUEUE_CRITICAL_SECTION_H_ */
@@ -26,6 +26,7 @@ void iface_swc_hal_init(swc_hal_t *hal)
 
     hal->radio_hal[0].transfer_full_duplex_blocking     = evk_radio_spi_transfer_full_duplex_blocking;
     hal->radio_hal[0].transfer_full_duplex_non_blocking = evk_radio_spi_transfer_full_duplex_non_blocking;
+    hal->radio_hal[0].transfer_chain_non_blocking       = evk_radio_spi_transfer_chain_non_blocking;
     hal->radio_hal[0].is_spi_busy                       = evk_radio_is_spi_busy;
     hal->radio_hal[0].context_switch                    = evk_radio_context_switch;
     hal->radio_hal[0].disable_radio_irq                 = evk_radio_disable_irq_it;
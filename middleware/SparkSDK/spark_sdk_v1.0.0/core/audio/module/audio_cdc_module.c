@@ -15,6 +15,8 @@
 /* CONSTANTS ******************************************************************/
 #define BIT_PER_BYTE   8
 #define DECIMAL_FACTOR 100
+#define POLYPHASE_GAIN 2   /* Resampling ratio in ppm applied per hundredth of audio packet of queue level error */
+#define LINEAR_HOLD_DIV 8  /* Check the queue average again once 1/LINEAR_HOLD_DIV of it is renewed after a linear correction */
 
 /* PRIVATE FUNCTION PROTOTYPES ************************************************/
 static void cdc_update_queue_status(sac_cdc_instance_t *instance, queue_node_t *in_node);
@@ -66,7 +68,8 @@ void audio_cdc_module_init(sac_pipeline_t *pipeline, mem_pool_t *mem_pool, sac_e
     resampling_config_t resampling_config = {
         .nb_sample = (pipeline->consumer->cfg.audio_payload_size / cdc_instance->size_of_buffer_type),
         .nb_channel = pipeline->consumer->cfg.channel_count,
-        .resampling_length = pipeline->cfg.cdc_resampling_length
+        .resampling_length = pipeline->cfg.cdc_resampling_length,
+        .mode = pipeline->cfg.cdc_resampling_mode
     };
 
     resampling_config.buffer_type = pipeline->consumer->cfg.bit_depth - 1;
@@ -128,6 +131,18 @@ void audio_cdc_module_update_queue_avg(sac_pipeline_t *pipeline)
 /* PRIVATE FUNCTIONS **********************************************************/
 static void cdc_update_queue_status(sac_cdc_instance_t *instance, queue_node_t *in_node)
 {
+    if (instance->resampling_instance.mode == RESAMPLING_MODE_POLYPHASE) {
+        if (instance->count > instance->queue_avg_size) {
+            /* Consume faster when the queue is above its normal level and slower when below */
+            resampling_set_ratio_ppm(&instance->resampling_instance,
+                                     ((int32_t)instance->avg_val - (int32_t)instance->normal_queue_size) * POLYPHASE_GAIN);
+        } else {
+            /* Give time to the avg to stabilize before adjusting the ratio */
+            instance->count++;
+        }
+        return;
+    }
+
     if ((sac_node_get_header(in_node)->tx_queue_level_high == 1) &&
         (resample_get_state(&instance->resampling_instance) == RESAMPLING_IDLE)) {
         instance->wait_for_queue_full = true;
@@ -146,10 +161,10 @@ static void cdc_update_queue_status(sac_cdc_instance_t *instance, queue_node_t *
             if (instance->count > instance->queue_avg_size) {
                 if (instance->avg_val > (instance->normal_queue_size + instance->max_queue_offset)) {
                     resampling_start(&instance->resampling_instance, RESAMPLING_REMOVE_SAMPLE);
-                    instance->count = 0;
+                    instance->count = instance->queue_avg_size - (instance->queue_avg_size / LINEAR_HOLD_DIV);
                 } else if (instance->avg_val < (instance->normal_queue_size - instance->max_queue_offset)) {
                     resampling_start(&instance->resampling_instance, RESAMPLING_ADD_SAMPLE);
-                    instance->count = 0;
+                    instance->count = instance->queue_avg_size - (instance->queue_avg_size / LINEAR_HOLD_DIV);
                 }
             } else {
                 /* Give time to the avg to stabilize before checking */
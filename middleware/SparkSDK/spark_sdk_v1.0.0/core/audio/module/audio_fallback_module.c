@@ -184,6 +184,19 @@ uint32_t fallback_get_fallback_count(void)
     return audio_fallback_module->fallback_count;
 }
 
+int16_t fallback_get_link_margin(void)
+{
+    if (audio_fallback_module == NULL) {
+        return 0;
+    }
+    return audio_fallback_module->link_margin_metrics.link_margin_acc_avg;
+}
+
+bool fallback_is_initialized(void)
+{
+    return (audio_fallback_module != NULL);
+}
+
 /* PRIVATE FUNCTIONS **********************************************************/
 /** @brief Clear the TXQ stats.
  */
@@ -100,6 +100,19 @@ void fallback_clear_fallback_flag(void);
  */
 uint32_t fallback_get_fallback_count(void);
 
+/** @brief Get the link margin average reported by the node, updated every ~1/4 sec.
+ *
+ *  @return Link margin average, 0 if the fallback module is not initialized.
+ */
+int16_t fallback_get_link_margin(void);
+
+/** @brief Get whether the fallback module has been initialized.
+ *
+ *  @retval true   Fallback module is initialized.
+ *  @retval false  Fallback module is not initialized.
+ */
+bool fallback_is_initialized(void);
+
 
 #ifdef __cplusplus
 }
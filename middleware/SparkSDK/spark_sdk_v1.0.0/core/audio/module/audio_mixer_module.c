@@ -10,10 +10,28 @@
 /* INCLUDES *******************************************************************/
 #include "audio_mixer_module.h"
 #include <stddef.h>
+#include "arm_math.h"
+
+/* CONSTANTS ******************************************************************/
+#define AUDIO_MIXER_16BITS_FULL_SCALE INT16_MAX
+
+/* MACROS *********************************************************************/
+#define AUDIO_MIXER_FULL_SCALE(bit_depth) ((1 << ((bit_depth) - 1)) - 1)
+
+/* Offsets in the input queues are masked */
+#if (MAX_NB_OF_BYTES_PER_BUFFER & (MAX_NB_OF_BYTES_PER_BUFFER - 1)) != 0
+#error "MAX_NB_OF_BYTES_PER_BUFFER must be a power of two"
+#endif
 
 /* PRIVATE FUNCTION PROTOTYPE *************************************************/
-static void algo_mix_int16_samples(audio_mixer_module_t *audio_mixer_module);
-static uint8_t get_audio_payload_samples_count(audio_mixer_module_t *audio_mixer_module);
+static void algo_mix_int16_samples_saturate(audio_mixer_module_t *audio_mixer_module, int16_t **input_samples,
+                                            int16_t *output, uint16_t samples_count);
+static void algo_mix_int16_samples(audio_mixer_module_t *audio_mixer_module, int16_t **input_samples,
+                                   int16_t *output, uint16_t samples_count);
+static void algo_mix_int32_samples(audio_mixer_module_t *audio_mixer_module, int32_t **input_samples,
+                                   int32_t *output, uint16_t samples_count);
+static uint8_t get_audio_sample_size(audio_mixer_module_t *audio_mixer_module);
+static inline int32_t limit_sample(int32_t sample, int32_t full_scale, bool soft_clip);
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 audio_mixer_module_t *audio_mixer_module_init(audio_mixer_module_cfg_t cfg, mem_pool_t *mem_pool, sac_error_t *audio_error)
@@ -33,7 +51,7 @@ audio_mixer_module_t *audio_mixer_module_init(audio_mixer_module_cfg_t cfg, mem_
         return NULL;
     }
 
-    if (cfg.bit_depth != 16) {
+    if ((cfg.bit_depth != 16) && (cfg.bit_depth != 20) && (cfg.bit_depth != 24)) {
         *audio_error = SAC_ERR_MIXER_INIT_FAILURE;
         return NULL;
     }
@@ -46,42 +64,124 @@ audio_mixer_module_t *audio_mixer_module_init(audio_mixer_module_cfg_t cfg, mem_
 
     /* Apply the configurations */
     audio_mixer_module->cfg = cfg;
+    for (uint8_t input = 0; input < MAX_NB_OF_INPUTS; input++) {
+        audio_mixer_module->input_gain[input] = AUDIO_MIXER_GAIN_UNITY;
+    }
+    audio_mixer_module->_unity_gain = true;
 
     return audio_mixer_module;
 }
 
 void audio_mixer_module_mix_packets(audio_mixer_module_t *audio_mixer_module)
 {
-    if (audio_mixer_module->cfg.bit_depth == 16) {
-        algo_mix_int16_samples(audio_mixer_module);
+    uint8_t *input_samples[MAX_NB_OF_INPUTS];
+    uint16_t read_index[MAX_NB_OF_INPUTS];
+    uint16_t payload_size = audio_mixer_module->cfg.payload_size;
+    uint8_t sample_size = get_audio_sample_size(audio_mixer_module);
+    uint16_t mixed_size = 0;
+    uint16_t chunk_size;
+
+    for (uint8_t input = 0; input < audio_mixer_module->cfg.nb_of_inputs; input++) {
+        read_index[input] = audio_mixer_module->input_samples_queue[input].read_index;
+    }
+
+    /* Mix up to the next wrap of any input queue, a payload is mixed in at most nb_of_inputs + 1 chunks */
+    while (mixed_size < payload_size) {
+        chunk_size = payload_size - mixed_size;
+        for (uint8_t input = 0; input < audio_mixer_module->cfg.nb_of_inputs; input++) {
+            input_samples[input] = &audio_mixer_module->input_samples_queue[input].samples[read_index[input]];
+            if (chunk_size > (MAX_NB_OF_BYTES_PER_BUFFER - read_index[input])) {
+                chunk_size = MAX_NB_OF_BYTES_PER_BUFFER - read_index[input];
+            }
+        }
+
+        if (audio_mixer_module->cfg.bit_depth == 16) {
+            if (audio_mixer_module->_unity_gain && !audio_mixer_module->cfg.soft_clip) {
+                algo_mix_int16_samples_saturate(audio_mixer_module, (int16_t **)input_samples,
+                                                (int16_t *)&audio_mixer_module->output_packet_buffer[mixed_size],
+                                                chunk_size / sample_size);
+            } else {
+                algo_mix_int16_samples(audio_mixer_module, (int16_t **)input_samples,
+                                       (int16_t *)&audio_mixer_module->output_packet_buffer[mixed_size],
+                                       chunk_size / sample_size);
+            }
+        } else {
+            algo_mix_int32_samples(audio_mixer_module, (int32_t **)input_samples,
+                                   (int32_t *)&audio_mixer_module->output_packet_buffer[mixed_size],
+                                   chunk_size / sample_size);
+        }
+
+        mixed_size += chunk_size;
+        for (uint8_t input = 0; input < audio_mixer_module->cfg.nb_of_inputs; input++) {
+            read_index[input] = (read_index[input] + chunk_size) & (MAX_NB_OF_BYTES_PER_BUFFER - 1);
+        }
     }
 
     audio_mixer_module_handle_remainder(audio_mixer_module);
 }
 
-void audio_mixer_module_append_samples(audio_mixer_queue_t *input_samples_queue, uint8_t *samples, uint8_t size)
+void audio_mixer_module_set_input_gain(audio_mixer_module_t *audio_mixer_module, uint8_t input, int16_t gain)
 {
-    uint8_t mem_offset = 0;
+    if (input >= MAX_NB_OF_INPUTS) {
+        return;
+    }
+    audio_mixer_module->input_gain[input] = gain;
 
-    /* Use the current size for the memory offset */
-    mem_offset = input_samples_queue->current_size;
+    audio_mixer_module->_unity_gain = true;
+    for (input = 0; input < audio_mixer_module->cfg.nb_of_inputs; input++) {
+        if (audio_mixer_module->input_gain[input] != AUDIO_MIXER_GAIN_UNITY) {
+            audio_mixer_module->_unity_gain = false;
+        }
+    }
+}
+
+void audio_mixer_module_append_samples(audio_mixer_queue_t *input_samples_queue, uint8_t *samples, uint16_t size)
+{
+    uint16_t write_index;
+    uint16_t contiguous_size;
+
+    /* Samples that do not fit are dropped */
+    if (size > (MAX_NB_OF_BYTES_PER_BUFFER - input_samples_queue->current_size)) {
+        size = MAX_NB_OF_BYTES_PER_BUFFER - input_samples_queue->current_size;
+    }
+
+    /* Write after the current samples, wrapping at the end of the buffer */
+    write_index = (input_samples_queue->read_index + input_samples_queue->current_size) & (MAX_NB_OF_BYTES_PER_BUFFER - 1);
+    contiguous_size = MAX_NB_OF_BYTES_PER_BUFFER - write_index;
 
     /* Add the payload to the Input Samples Queue */
-    memcpy(input_samples_queue->samples + mem_offset, samples, size);
+    if (size > contiguous_size) {
+        memcpy(&input_samples_queue->samples[write_index], samples, contiguous_size);
+        memcpy(input_samples_queue->samples, samples + contiguous_size, size - contiguous_size);
+    } else {
+        memcpy(&input_samples_queue->samples[write_index], samples, size);
+    }
 
     /* Update Input Samples Queue size */
     input_samples_queue->current_size += size;
 }
 
-void audio_mixer_module_append_silence(audio_mixer_queue_t *input_samples_queue, uint8_t size)
+void audio_mixer_module_append_silence(audio_mixer_queue_t *input_samples_queue, uint16_t size)
 {
-    uint8_t mem_offset = 0;
+    uint16_t write_index;
+    uint16_t contiguous_size;
+
+    /* Samples that do not fit are dropped */
+    if (size > (MAX_NB_OF_BYTES_PER_BUFFER - input_samples_queue->current_size)) {
+        size = MAX_NB_OF_BYTES_PER_BUFFER - input_samples_queue->current_size;
+    }
 
-    /* Use the current size for the memory offset */
-    mem_offset = input_samples_queue->current_size;
+    /* Write after the current samples, wrapping at the end of the buffer */
+    write_index = (input_samples_queue->read_index + input_samples_queue->current_size) & (MAX_NB_OF_BYTES_PER_BUFFER - 1);
+    contiguous_size = MAX_NB_OF_BYTES_PER_BUFFER - write_index;
 
     /* Add the payload to the Input Samples Queue */
-    memset(input_samples_queue->samples + mem_offset, 0, size);
+    if (size > contiguous_size) {
+        memset(&input_samples_queue->samples[write_index], 0, contiguous_size);
+        memset(input_samples_queue->samples, 0, size - contiguous_size);
+    } else {
+        memset(&input_samples_queue->samples[write_index], 0, size);
+    }
 
     /* Update Input Samples Queue size */
     input_samples_queue->current_size += size;
@@ -89,62 +189,153 @@ void audio_mixer_module_append_silence(audio_mixer_queue_t *input_samples_queue,
 
 void audio_mixer_module_handle_remainder(audio_mixer_module_t *audio_mixer_module)
 {
-    uint8_t sample_remainder = 0;
-    uint8_t current_size = 0;
-    uint8_t sample_size = 0;
+    uint16_t payload_size = audio_mixer_module->cfg.payload_size;
+    audio_mixer_queue_t *input_samples_queue;
 
-    sample_size = audio_mixer_module->cfg.payload_size;
-
-    /* Move the remaining input samples to the front of the queue */
+    /* The remaining input samples become the front of the queue */
     for (uint8_t input = 0; input < audio_mixer_module->cfg.nb_of_inputs; input++) {
+        input_samples_queue = &audio_mixer_module->input_samples_queue[input];
 
-        current_size = audio_mixer_module->input_samples_queue[input].current_size;
-        sample_remainder = current_size - sample_size;
-
-        if (sample_remainder > 0) {
-            memcpy(audio_mixer_module->input_samples_queue[input].samples,
-                   audio_mixer_module->input_samples_queue[input].samples + sample_size,
-                   sample_remainder);
+        if (input_samples_queue->current_size > payload_size) {
+            input_samples_queue->read_index = (input_samples_queue->read_index + payload_size) & (MAX_NB_OF_BYTES_PER_BUFFER - 1);
+            input_samples_queue->current_size -= payload_size;
+        } else {
+            input_samples_queue->read_index = 0;
+            input_samples_queue->current_size = 0;
         }
-        audio_mixer_module->input_samples_queue[input].current_size = sample_remainder;
     }
 }
 
 /* PRIVATE FUNCTIONS **********************************************************/
-/** @brief Mixing algorithm using int16 samples.
+/** @brief Mixing algorithm using int16 samples with unity gains and saturation.
  *
- *  @param[in] audio_mixer_module  Audio Mixer Module structure.
+ *  Two inputs are summed two samples at once with saturating dual 16-bit additions. With
+ *  more inputs, chained saturations would differ from saturating the sum so they are summed
+ *  one sample at a time.
+ *
+ *  @param[in]  audio_mixer_module  Audio Mixer Module structure.
+ *  @param[in]  input_samples       Contiguous samples of each input.
+ *  @param[out] output              Mixed samples.
+ *  @param[in]  samples_count       Number of samples to mix.
  */
-static void algo_mix_int16_samples(audio_mixer_module_t *audio_mixer_module)
+static void algo_mix_int16_samples_saturate(audio_mixer_module_t *audio_mixer_module, int16_t **input_samples,
+                                            int16_t *output, uint16_t samples_count)
 {
-    uint8_t nb_of_inputs = 0;
-    uint8_t packet_size = 0;
-    int32_t sample_summation = 0;
+    uint8_t nb_of_inputs = audio_mixer_module->cfg.nb_of_inputs;
+    uint16_t sample = 0;
+    int32_t sample_summation;
 
-    nb_of_inputs = audio_mixer_module->cfg.nb_of_inputs;
-    packet_size = get_audio_payload_samples_count(audio_mixer_module);
+#if defined(ARM_MATH_DSP)
+    if (nb_of_inputs == 2) {
+        for (; sample < (samples_count & ~0x01); sample += 2) {
+            write_q15x2(&output[sample], (q31_t)__QADD16(read_q15x2(&input_samples[0][sample]),
+                                                         read_q15x2(&input_samples[1][sample])));
+        }
+    }
+#endif
+    for (; sample < samples_count; sample++) {
+        sample_summation = 0;
+        for (uint8_t input = 0; input < nb_of_inputs; input++) {
+            sample_summation += input_samples[input][sample];
+        }
+        output[sample] = clip_q31_to_q15(sample_summation);
+    }
+}
+
+/** @brief Mixing algorithm using int16 samples.
+ *
+ *  @param[in]  audio_mixer_module  Audio Mixer Module structure.
+ *  @param[in]  input_samples       Contiguous samples of each input.
+ *  @param[out] output              Mixed samples.
+ *  @param[in]  samples_count       Number of samples to mix.
+ */
+static void algo_mix_int16_samples(audio_mixer_module_t *audio_mixer_module, int16_t **input_samples,
+                                   int16_t *output, uint16_t samples_count)
+{
+    uint8_t nb_of_inputs = audio_mixer_module->cfg.nb_of_inputs;
+    bool soft_clip = audio_mixer_module->cfg.soft_clip;
+    int32_t sample_summation;
 
-    for (uint8_t sample = 0; sample < packet_size; sample++) {
+    for (uint16_t sample = 0; sample < samples_count; sample++) {
+        sample_summation = 0;
         for (uint8_t input = 0; input < nb_of_inputs; input++) {
-            sample_summation += ((int16_t *)audio_mixer_module->input_samples_queue[input].samples)[sample];
+            sample_summation += ((int32_t)input_samples[input][sample] * audio_mixer_module->input_gain[input]) >>
+                                AUDIO_MIXER_GAIN_FRAC_BITS;
         }
-        ((int16_t *)audio_mixer_module->output_packet_buffer)[sample] = (sample_summation / nb_of_inputs);
+        output[sample] = (int16_t)limit_sample(sample_summation, AUDIO_MIXER_16BITS_FULL_SCALE, soft_clip);
+    }
+}
+
+/** @brief Mixing algorithm using 20 or 24-bit samples in int32 words.
+ *
+ *  @param[in]  audio_mixer_module  Audio Mixer Module structure.
+ *  @param[in]  input_samples       Contiguous samples of each input.
+ *  @param[out] output              Mixed samples.
+ *  @param[in]  samples_count       Number of samples to mix.
+ */
+static void algo_mix_int32_samples(audio_mixer_module_t *audio_mixer_module, int32_t **input_samples,
+                                   int32_t *output, uint16_t samples_count)
+{
+    uint8_t nb_of_inputs = audio_mixer_module->cfg.nb_of_inputs;
+    int32_t full_scale = AUDIO_MIXER_FULL_SCALE(audio_mixer_module->cfg.bit_depth);
+    bool soft_clip = audio_mixer_module->cfg.soft_clip;
+    int32_t sample_summation;
+
+    for (uint16_t sample = 0; sample < samples_count; sample++) {
         sample_summation = 0;
+        for (uint8_t input = 0; input < nb_of_inputs; input++) {
+            sample_summation += (int32_t)(((int64_t)input_samples[input][sample] * audio_mixer_module->input_gain[input]) >>
+                                          AUDIO_MIXER_GAIN_FRAC_BITS);
+        }
+        output[sample] = limit_sample(sample_summation, full_scale, soft_clip);
     }
 }
 
-/** @brief Get the number of samples forming an audio payload.
+/** @brief Get the size of a sample in the payload.
  *
  *  @param[in] audio_mixer_module  Audio Mixer Module structure.
- *  @return Number of samples.
+ *  @return Sample size in bytes.
  */
-static uint8_t get_audio_payload_samples_count(audio_mixer_module_t *audio_mixer_module)
+static uint8_t get_audio_sample_size(audio_mixer_module_t *audio_mixer_module)
 {
-    uint8_t size_type;
-
     if (audio_mixer_module->cfg.bit_depth == 16) {
-        size_type = sizeof(int16_t);
+        return sizeof(int16_t);
+    }
+    return sizeof(int32_t);
+}
+
+/** @brief Bring a mixed sample back to full scale.
+ *
+ *  The soft clip curve is linear up to 3/4 of full scale, then compresses the excess
+ *  so the output approaches full scale without reaching it. The division only occurs
+ *  for samples above the knee.
+ *
+ *  @param[in] sample      Mixed sample.
+ *  @param[in] full_scale  Largest sample value of the bit depth.
+ *  @param[in] soft_clip   Soft clip instead of saturating.
+ *  @return Limited sample.
+ */
+static inline int32_t limit_sample(int32_t sample, int32_t full_scale, bool soft_clip)
+{
+    int32_t knee = full_scale - (full_scale >> 2);
+    int64_t range = full_scale - knee;
+    int64_t excess;
+
+    if (!soft_clip) {
+        if (sample > full_scale) {
+            return full_scale;
+        } else if (sample < -full_scale - 1) {
+            return -full_scale - 1;
+        }
+        return sample;
     }
 
-    return audio_mixer_module->cfg.payload_size / size_type;
+    if (sample > knee) {
+        excess = sample - knee;
+        return knee + (int32_t)((excess * range) / (excess + range));
+    } else if (sample < -knee) {
+        excess = -knee - sample;
+        return -knee - (int32_t)((excess * range) / (excess + range));
+    }
+    return sample;
 }
@@ -22,32 +22,48 @@ extern "C" {
 /* CONSTANTS ******************************************************************/
 #define MIN_NB_OF_INPUTS 2 /*!< The minimum number of input audio streams to be mixed */
 #define MAX_NB_OF_INPUTS 3 /*!< The maximum supported number of input audio streams to be mixed */
+/*
+ * The default input queue size fits the largest payload a SAC header can describe. Define
+ * MAX_NB_OF_BYTES_PER_BUFFER to another power of two to trade the payload size limit against
+ * memory: the module takes MAX_NB_OF_INPUTS queues plus one payload from the memory pool.
+ */
+#ifndef MAX_NB_OF_BYTES_PER_BUFFER
+#define MAX_NB_OF_BYTES_PER_BUFFER 512 /*!< Size of each input queue, must be a power of two */
+#endif
 #define MIN_NB_OF_BYTES_PER_PAYLOAD 2   /*!< The minimum number of bytes a payload can contain */
-#define MAX_NB_OF_BYTES_PER_PAYLOAD 122 /*!< The maximum number of bytes a payload can contain  */
-#define MAX_NB_OF_BYTES_PER_BUFFER (MAX_NB_OF_BYTES_PER_PAYLOAD * 2) /*!< Give a buffer to have at least 2 packets */
+#define MAX_NB_OF_BYTES_PER_PAYLOAD (MAX_NB_OF_BYTES_PER_BUFFER / 2) /*!< Give a buffer to have at least 2 packets, raise MAX_NB_OF_BYTES_PER_BUFFER for larger payloads */
+#define AUDIO_MIXER_GAIN_FRAC_BITS 14 /*!< Number of fractional bits of the Q2.14 input gains */
+#define AUDIO_MIXER_GAIN_UNITY (1 << AUDIO_MIXER_GAIN_FRAC_BITS) /*!< Input gain of 1.0 */
 
 /* TYPES **********************************************************************/
 /** @brief The Audio Mixer Module configurations.
  */
 typedef struct audio_mixer_module_cfg {
-    uint8_t nb_of_inputs; /*!< The number of inputs to be mixed */
-    uint8_t payload_size; /*!< The audio payload size in bytes which must match the output consuming endpoint */
-    uint8_t bit_depth;    /*!< Bit depth of each sample in the payload */
+    uint8_t nb_of_inputs;  /*!< The number of inputs to be mixed */
+    uint16_t payload_size; /*!< The audio payload size in bytes which must match the output consuming endpoint */
+    uint8_t bit_depth;     /*!< Bit depth of each sample in the payload, 20 and 24-bit samples are in 32-bit words */
+    bool soft_clip;        /*!< Soft clip the mix above 3/4 of full scale instead of saturating it */
 } audio_mixer_module_cfg_t;
 
 /** @brief The Audio Mixer queue.
+ *
+ *  Circular buffer of MAX_NB_OF_BYTES_PER_BUFFER bytes, samples are mixed where they
+ *  were appended and wrap from the end of the buffer to its beginning.
  */
 typedef struct audio_mixer_queue {
-    uint8_t samples[MAX_NB_OF_BYTES_PER_BUFFER]; /*!< Can have up to 2x the maximum payload in bytes */
-    uint8_t current_size;                        /*!< The current size of the queue in bytes */
+    uint8_t samples[MAX_NB_OF_BYTES_PER_BUFFER] __attribute__((aligned(4))); /*!< Can have up to 2x the maximum payload in bytes */
+    uint16_t read_index;   /*!< Offset of the oldest byte in samples */
+    uint16_t current_size; /*!< The current size of the queue in bytes */
 } audio_mixer_queue_t;
 
 /** @brief The Audio Mixer Module instance.
  */
 typedef struct audio_mixer_module {
     audio_mixer_queue_t input_samples_queue[MAX_NB_OF_INPUTS]; /*!< Pointer to the input samples to be mixed */
-    uint8_t output_packet_buffer[MAX_NB_OF_BYTES_PER_PAYLOAD]; /*!< The mixed output packets array */
+    uint8_t output_packet_buffer[MAX_NB_OF_BYTES_PER_PAYLOAD] __attribute__((aligned(4))); /*!< The mixed output packets array */
     audio_mixer_module_cfg_t cfg;                              /*!< Audio Mixer Module configurations */
+    int16_t input_gain[MAX_NB_OF_INPUTS];                      /*!< Q2.14 gain of each input, unity by default */
+    bool _unity_gain;                                          /*!< All input gains are unity */
 } audio_mixer_module_t;
 
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
@@ -61,27 +77,40 @@ typedef struct audio_mixer_module {
 audio_mixer_module_t *audio_mixer_module_init(audio_mixer_module_cfg_t cfg, mem_pool_t *mem_pool, sac_error_t *audio_error);
 
 /** @brief The Audio Mixer Module uses an algo to mix samples.
+ *
+ *  Inputs are scaled by their gain and summed, then the mix is saturated or soft clipped
+ *  to the bit depth. 16-bit inputs with unity gains and no soft clip are only summed and
+ *  saturated. When there are exactly two of them and the core has the DSP extension, they
+ *  are mixed two samples at a time with saturating dual 16-bit additions.
  *
  *  @param[in] audio_mixer_module  Audio Mixer Module instance.
  */
 void audio_mixer_module_mix_packets(audio_mixer_module_t *audio_mixer_module);
 
+/** @brief Set the gain of an input.
+ *
+ *  @param[in] audio_mixer_module  Audio Mixer Module instance.
+ *  @param[in] input               Input index.
+ *  @param[in] gain                Q2.14 gain, AUDIO_MIXER_GAIN_UNITY for 1.0.
+ */
+void audio_mixer_module_set_input_gain(audio_mixer_module_t *audio_mixer_module, uint8_t input, int16_t gain);
+
 /** @brief A payload is added to the input queue.
  *
  *  @param[in] input_samples_queue  The samples are stored in this queue.
  *  @param[in] samples              The stored audio samples.
  *  @param[in] size                 The stored audio samples size in bytes.
  */
-void audio_mixer_module_append_samples(audio_mixer_queue_t *input_samples_queue, uint8_t *samples, uint8_t size);
+void audio_mixer_module_append_samples(audio_mixer_queue_t *input_samples_queue, uint8_t *samples, uint16_t size);
 
 /** @brief Silence samples are added to the input queue.
  *
  *  @param[in] input_samples_queue  The samples are stored in this queue.
  *  @param[in] size                 The stored audio samples size in bytes.
  */
-void audio_mixer_module_append_silence(audio_mixer_queue_t *input_samples_queue, uint8_t size);
+void audio_mixer_module_append_silence(audio_mixer_queue_t *input_samples_queue, uint16_t size);
 
-/** @brief Put the remainder in front of the queue.
+/** @brief Remove the mixed payload from the input queues, the remainder stays in place.
  *
  *  @param[in] audio_mixer_module  Audio Mixer Module instance.
  */
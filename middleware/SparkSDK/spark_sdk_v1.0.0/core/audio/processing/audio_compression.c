@@ -10,16 +10,85 @@
 /* INCLUDES *******************************************************************/
 #include <string.h>
 #include "audio_compression.h"
+#include "audio_fallback_module.h"
+
+/* CONSTANTS ******************************************************************/
+#define LOSSLESS_VERBATIM            0xFF /* Rice parameter value flagging an uncompressed lossless payload */
+#define LOSSLESS_RICE_PARAMETER_MAX  16   /* Largest Rice parameter */
+#define LOSSLESS_QUOTIENT_MAX        16   /* Unary quotient length from which the residual is written raw */
+#define LOSSLESS_RESIDUAL_BITS       17   /* Size of a raw zigzag encoded residual */
+#define LOSSLESS_CHANNEL_HEADER_SIZE 3    /* Rice parameter and first sample of a channel */
+#define CODEC_SAMPLE_BITS_MIN        1    /* Fewest bits a multi-rate codec spends on a sample */
 
 /* MACROS *********************************************************************/
 #define AUDIO_NB_SAMPLE_TO_BYTE(nb_sample) (2 * (nb_sample))
 #define AUDIO_BYTE_TO_NB_SAMPLE(nb_byte)   ((nb_byte) / 2)
+#define ZIGZAG_ENCODE(value) ((((uint32_t)(value)) << 1) ^ (uint32_t)((value) >> 31))
+#define ZIGZAG_DECODE(value) ((int32_t)((value) >> 1) ^ -(int32_t)((value) & 1))
+
+/* TYPES **********************************************************************/
+/** @brief LSB first bit writer of the lossless codec.
+ */
+typedef struct bit_writer {
+    uint8_t *buffer;      /*!< Next byte to write */
+    uint8_t *buffer_end;  /*!< End of the output buffer */
+    uint32_t bit_buffer;  /*!< Bits not yet written */
+    uint8_t bit_count;    /*!< Number of bits in bit_buffer */
+    bool overflow;        /*!< Output buffer too small */
+} bit_writer_t;
+
+/** @brief LSB first bit reader of the lossless codec.
+ */
+typedef struct bit_reader {
+    const uint8_t *buffer;     /*!< Next byte to read */
+    const uint8_t *buffer_end; /*!< End of the input buffer */
+    uint32_t bit_buffer;       /*!< Bits not yet read */
+    uint8_t bit_count;         /*!< Number of bits in bit_buffer */
+    bool underflow;            /*!< Read past the end of the input buffer */
+} bit_reader_t;
 
 /* PRIVATE FUNCTION PROTOTYPES *************************************************/
 static uint16_t pack_stereo(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
 static uint16_t unpack_stereo(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
 static uint16_t pack_mono(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
 static uint16_t unpack_mono(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
+static uint16_t pack_multi_rate(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
+static uint16_t unpack_multi_rate(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
+static audio_compression_codec_t select_codec(audio_compression_instance_t *compress_inst, int16_t link_margin);
+static uint16_t encode_adpcm(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                             adpcm_state_t *state, uint8_t *payload, uint8_t code_size);
+static bool decode_adpcm(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count, uint8_t channel_count,
+                         adpcm_state_t *state, int16_t *pcm, uint8_t code_size);
+static uint16_t encode_adpcm_4bits(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                   adpcm_state_t *state, uint8_t *payload);
+static bool decode_adpcm_4bits(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                               uint8_t channel_count, adpcm_state_t *state, int16_t *pcm);
+static uint16_t encode_adpcm_3bits(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                   adpcm_state_t *state, uint8_t *payload);
+static bool decode_adpcm_3bits(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                               uint8_t channel_count, adpcm_state_t *state, int16_t *pcm);
+static uint16_t encode_adpcm_2bits(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                   adpcm_state_t *state, uint8_t *payload);
+static bool decode_adpcm_2bits(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                               uint8_t channel_count, adpcm_state_t *state, int16_t *pcm);
+static uint16_t encode_lossless(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                adpcm_state_t *state, uint8_t *payload);
+static bool decode_lossless(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                            uint8_t channel_count, adpcm_state_t *state, int16_t *pcm);
+static uint8_t get_rice_parameter(uint32_t residual_sum, uint16_t residual_count);
+static inline void write_bits(bit_writer_t *writer, uint32_t value, uint8_t bit_count);
+static inline void write_rice(bit_writer_t *writer, uint32_t value, uint8_t rice_parameter);
+static inline uint32_t read_bits(bit_reader_t *reader, uint8_t bit_count);
+static inline uint32_t read_rice(bit_reader_t *reader, uint8_t rice_parameter);
+
+/* PRIVATE GLOBALS ************************************************************/
+/* Codecs of the multi-rate modes, indexed by audio_compression_codec_t */
+static const audio_compression_codec_interface_t codec_interface[AUDIO_COMPRESSION_CODEC_COUNT] = {
+    [AUDIO_COMPRESSION_CODEC_ADPCM_4BITS] = {encode_adpcm_4bits, decode_adpcm_4bits},
+    [AUDIO_COMPRESSION_CODEC_ADPCM_3BITS] = {encode_adpcm_3bits, decode_adpcm_3bits},
+    [AUDIO_COMPRESSION_CODEC_ADPCM_2BITS] = {encode_adpcm_2bits, decode_adpcm_2bits},
+    [AUDIO_COMPRESSION_CODEC_LOSSLESS]    = {encode_lossless,    decode_lossless},
+};
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 void audio_compression_init(void *instance, mem_pool_t *mem_pool)
@@ -40,7 +109,6 @@ void audio_compression_deinit(void *instance)
 
 uint32_t audio_compression_ctrl(void *instance, uint8_t cmd, uint32_t arg)
 {
-    (void)arg;
     uint32_t ret = 0;
     audio_compression_instance_t *compress_inst = (audio_compression_instance_t *)instance;
 
@@ -54,6 +122,15 @@ uint32_t audio_compression_ctrl(void *instance, uint8_t cmd, uint32_t arg)
     case AUDIO_COMPRESSION_GET_STATE:
         ret = compress_inst->compression_enabled;
         break;
+    case AUDIO_COMPRESSION_SET_CODEC:
+        if (arg < AUDIO_COMPRESSION_CODEC_COUNT) {
+            compress_inst->codec = (audio_compression_codec_t)arg;
+        }
+        ret = compress_inst->codec;
+        break;
+    case AUDIO_COMPRESSION_GET_CODEC:
+        ret = compress_inst->codec;
+        break;
     default:
         break;
     }
@@ -66,7 +143,7 @@ uint16_t audio_compression_process(void *instance, sac_header_t *header,
     (void)header;
 
     audio_compression_instance_t *compress_inst = (audio_compression_instance_t *) instance;
-    uint8_t output_size = 0;
+    uint16_t output_size = 0;
 
     if (compress_inst->compression_enabled) {
         switch (compress_inst->compression_mode) {
@@ -82,6 +159,12 @@ uint16_t audio_compression_process(void *instance, sac_header_t *header,
         case AUDIO_COMPRESSION_UNPACK_MONO:
             output_size = unpack_mono(instance, data_in, size, data_out);
             break;
+        case AUDIO_COMPRESSION_PACK_MULTI_RATE:
+            output_size = pack_multi_rate(instance, data_in, size, data_out);
+            break;
+        case AUDIO_COMPRESSION_UNPACK_MULTI_RATE:
+            output_size = unpack_multi_rate(instance, data_in, size, data_out);
+            break;
         }
     }
     return output_size;
@@ -111,8 +194,22 @@ uint16_t audio_compression_process_discard(void *instance, sac_header_t *header,
             data_in += (size - discard_size);
             pack_mono(instance, data_in, discard_size, discard_buffer);
             break;
+        case AUDIO_COMPRESSION_PACK_MULTI_RATE: {
+            /* Only need the last frame, to be added to the history of every ADPCM codec */
+            adpcm_state_t state[ADPCM_PACKED_CHANNEL_MAX] = {compress_inst->adpcm_left_state,
+                                                             compress_inst->adpcm_right_state};
+
+            discard_size = AUDIO_NB_SAMPLE_TO_BYTE(compress_inst->channel_count);
+            data_in += (size - discard_size);
+            adpcm_encode_block_packed((int16_t *)data_in, discard_buffer, 1, compress_inst->channel_count,
+                                      ADPCM_CODE_SIZE_MAX, state);
+            compress_inst->adpcm_left_state = state[0];
+            compress_inst->adpcm_right_state = state[1];
+            break;
+        }
         case AUDIO_COMPRESSION_UNPACK_STEREO:
         case AUDIO_COMPRESSION_UNPACK_MONO:
+        case AUDIO_COMPRESSION_UNPACK_MULTI_RATE:
             break;
         }
     }
@@ -132,8 +229,6 @@ static uint16_t pack_stereo(void *instance, uint8_t *buffer_in, uint16_t buffer_
 {
     uint16_t pcm_sample_count;
     int16_t *input_buffer;
-    uint8_t left_code;
-    uint8_t right_code;
 
     audio_compression_instance_t *compress_inst = (audio_compression_instance_t *)instance;
 
@@ -148,15 +243,9 @@ static uint16_t pack_stereo(void *instance, uint8_t *buffer_in, uint16_t buffer_
 
     buffer_out += sizeof(audio_compression_adpcm_stereo_header_t);
 
-    /* Since two samples get compressed into a single byte,
-     * the loop will work with two samples at the same time (left and right samples)
-     */
-    for (uint8_t i = 0; i < pcm_sample_count / 2; i++) {
-        left_code  = adpcm_encode(*input_buffer++, &(compress_inst->adpcm_left_state));
-        right_code = adpcm_encode(*input_buffer++, &(compress_inst->adpcm_right_state));
-        /* Concatenate two ADPCM samples code per byte in the output buffer (4 bit msb, 4 bit lsb) */
-        *buffer_out++ = (left_code & 0x0F) | ((right_code << 4) & 0xF0);
-    }
+    /* Left and right samples are compressed into a single byte (4 bit lsb, 4 bit msb) */
+    adpcm_encode_block_stereo(input_buffer, buffer_out, pcm_sample_count / 2,
+                              &(compress_inst->adpcm_left_state), &(compress_inst->adpcm_right_state));
 
     return (pcm_sample_count / 2) + sizeof(audio_compression_adpcm_stereo_header_t);
 }
@@ -187,13 +276,9 @@ static uint16_t unpack_stereo(void *instance, uint8_t *buffer_in, uint16_t buffe
     buffer_in += sizeof(audio_compression_adpcm_stereo_header_t);
     pcm_sample_count = (buffer_in_size - sizeof(audio_compression_adpcm_stereo_header_t)) * 2;
 
-    /* Since two samples are compressed into a single byte, the loop will work with two compressed
-     * samples at the same time (left and right samples)
-     */
-    for (uint8_t i = 0; i < pcm_sample_count / 2; i++) {
-        *output_buffer++ = adpcm_decode((*buffer_in) & 0x0F, &(compress_inst->adpcm_left_state));
-        *output_buffer++ = adpcm_decode(((*buffer_in++) >> 4) & 0x0F, &(compress_inst->adpcm_right_state));
-    }
+    /* Left and right samples are compressed into a single byte (4 bit lsb, 4 bit msb) */
+    adpcm_decode_block_stereo(buffer_in, output_buffer, pcm_sample_count / 2,
+                              &(compress_inst->adpcm_left_state), &(compress_inst->adpcm_right_state));
     return AUDIO_NB_SAMPLE_TO_BYTE(pcm_sample_count);
 }
 
@@ -209,8 +294,6 @@ static uint16_t pack_mono(void *instance, uint8_t *buffer_in, uint16_t buffer_in
 {
     uint16_t pcm_sample_count;
     int16_t *input_buffer;
-    uint8_t left_code;
-    uint8_t right_code;
 
     audio_compression_instance_t *compress_inst = (audio_compression_instance_t *)instance;
 
@@ -221,19 +304,8 @@ static uint16_t pack_mono(void *instance, uint8_t *buffer_in, uint16_t buffer_in
     input_buffer = (int16_t *)buffer_in;
     pcm_sample_count = AUDIO_BYTE_TO_NB_SAMPLE(buffer_in_size);
 
-    /* Since two samples get compressed into a single byte, the loop will work with two samples at the same time */
-    for (uint8_t i = 0; i < pcm_sample_count / 2; i++) {
-        left_code  = adpcm_encode(*input_buffer++, &(compress_inst->adpcm_left_state));
-        right_code = adpcm_encode(*input_buffer++, &(compress_inst->adpcm_left_state));
-        /* Concatenate two ADPCM samples code per byte in the output buffer (4 bit msb, 4 bit lsb) */
-        *buffer_out++ = (left_code & 0x0F) | (right_code << 4);
-    }
-
-    /* Manage odd number of samples */
-    if (pcm_sample_count & 0x01) {
-        left_code  = adpcm_encode(*input_buffer, &(compress_inst->adpcm_left_state));
-        *buffer_out = left_code & 0x0F;
-    }
+    /* Two samples are compressed into a single byte, an odd last sample uses the 4 lsb of the last byte */
+    adpcm_encode_block(input_buffer, buffer_out, pcm_sample_count, &(compress_inst->adpcm_left_state));
 
     return ((pcm_sample_count / 2) + (pcm_sample_count & 0x01)) * sizeof(uint8_t) + sizeof(state_variable_t);
 }
@@ -262,13 +334,437 @@ static uint16_t unpack_mono(void *instance, uint8_t *buffer_in, uint16_t buffer_
     /* Get number of mono samples */
     pcm_sample_count = (buffer_in_size -sizeof(adpcm_state_t)) * 2;
 
-    /* Since two samples are compressed into a single byte, the loop will work with two compressed
-     * samples at the same time (left and right samples)
-     */
-    for (uint8_t i = 0; i < pcm_sample_count / 2; i++) {
-        *output_buffer++ = adpcm_decode((*buffer_in & 0x0F), &(compress_inst->adpcm_left_state));
-        *output_buffer++ = adpcm_decode((*buffer_in++ >> 4) & 0x0F, &(compress_inst->adpcm_left_state));
-    }
+    /* Two samples are compressed into a single byte */
+    adpcm_decode_block(buffer_in, output_buffer, pcm_sample_count, &(compress_inst->adpcm_left_state));
 
     return AUDIO_NB_SAMPLE_TO_BYTE(pcm_sample_count);
 }
+
+/** @brief Pack uncompressed stream with the multi-rate codec.
+ *
+ *  @param[in]  instance        Compression instance.
+ *  @param[in]  buffer_in       Array of the uncompressed interleaved data.
+ *  @param[in]  buffer_in_size  Size in byte of the input array.
+ *  @param[out] buffer_out      Array where the codec header and payload are written to.
+ *  @return written size, in byte, to the output buffer.
+ */
+static uint16_t pack_multi_rate(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
+{
+    audio_compression_instance_t *compress_inst = (audio_compression_instance_t *)instance;
+    audio_compression_codec_header_t *codec_header = (audio_compression_codec_header_t *)buffer_out;
+    adpcm_state_t state[ADPCM_PACKED_CHANNEL_MAX] = {compress_inst->adpcm_left_state,
+                                                     compress_inst->adpcm_right_state};
+    uint16_t frame_count;
+    uint16_t payload_size;
+
+    if ((compress_inst->channel_count == 0) || (compress_inst->channel_count > ADPCM_PACKED_CHANNEL_MAX)) {
+        return 0;
+    }
+    frame_count = AUDIO_BYTE_TO_NB_SAMPLE(buffer_in_size) / compress_inst->channel_count;
+
+    if (compress_inst->link_margin_adaptive && fallback_is_initialized()) {
+        compress_inst->codec = select_codec(compress_inst, fallback_get_link_margin());
+    }
+
+    codec_header->codec = (uint8_t)compress_inst->codec;
+    codec_header->frame_count = frame_count;
+    payload_size = codec_interface[compress_inst->codec].encode((int16_t *)buffer_in, frame_count,
+                                                                compress_inst->channel_count, state,
+                                                                &buffer_out[sizeof(audio_compression_codec_header_t)]);
+
+    compress_inst->adpcm_left_state = state[0];
+    compress_inst->adpcm_right_state = state[1];
+
+    return payload_size + sizeof(audio_compression_codec_header_t);
+}
+
+/** @brief Unpack a multi-rate compressed stream with the codec found in its header.
+ *
+ *  A payload announcing more samples than max_payload_size or than its size can hold is dropped,
+ *  any other malformed payload is replaced by silence.
+ *
+ *  @param[in]  instance        Compression instance.
+ *  @param[in]  buffer_in       Array of the codec header and payload.
+ *  @param[in]  buffer_in_size  Size in byte of the input array.
+ *  @param[out] buffer_out      Array where the uncompressed interleaved stream is written to.
+ *  @return written size, in byte, to the output buffer.
+ */
+static uint16_t unpack_multi_rate(void *instance, uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
+{
+    audio_compression_instance_t *compress_inst = (audio_compression_instance_t *)instance;
+    audio_compression_codec_header_t *codec_header = (audio_compression_codec_header_t *)buffer_in;
+    adpcm_state_t state[ADPCM_PACKED_CHANNEL_MAX];
+    uint16_t frame_count;
+    uint16_t payload_size;
+    uint32_t sample_count;
+
+    if ((compress_inst->channel_count == 0) || (compress_inst->channel_count > ADPCM_PACKED_CHANNEL_MAX) ||
+        (buffer_in_size < sizeof(audio_compression_codec_header_t)) ||
+        (codec_header->codec >= AUDIO_COMPRESSION_CODEC_COUNT)) {
+        return 0;
+    }
+    frame_count = codec_header->frame_count;
+    payload_size = buffer_in_size - sizeof(audio_compression_codec_header_t);
+    sample_count = (uint32_t)frame_count * compress_inst->channel_count;
+
+    /* The codec header is not covered by the audio header CRC, never trust it to size the output */
+    if ((AUDIO_NB_SAMPLE_TO_BYTE(sample_count) > compress_inst->max_payload_size) ||
+        (sample_count > (((uint32_t)payload_size * 8) / CODEC_SAMPLE_BITS_MIN) + compress_inst->channel_count)) {
+        return 0;
+    }
+    compress_inst->codec = (audio_compression_codec_t)codec_header->codec;
+
+    if (!codec_interface[compress_inst->codec].decode(&buffer_in[sizeof(audio_compression_codec_header_t)],
+                                                      payload_size, frame_count, compress_inst->channel_count,
+                                                      state, (int16_t *)buffer_out)) {
+        memset(buffer_out, 0, AUDIO_NB_SAMPLE_TO_BYTE(sample_count));
+    }
+
+    return AUDIO_NB_SAMPLE_TO_BYTE(sample_count);
+}
+
+/** @brief Select the multi-rate codec from the link margin.
+ *
+ *  @param[in] compress_inst  Compression instance.
+ *  @param[in] link_margin    Link margin.
+ *  @return Codec to use.
+ */
+static audio_compression_codec_t select_codec(audio_compression_instance_t *compress_inst, int16_t link_margin)
+{
+    if (link_margin >= compress_inst->lossless_link_margin) {
+        return AUDIO_COMPRESSION_CODEC_LOSSLESS;
+    } else if (link_margin < compress_inst->adpcm_2bits_link_margin) {
+        return AUDIO_COMPRESSION_CODEC_ADPCM_2BITS;
+    } else if (link_margin < compress_inst->adpcm_3bits_link_margin) {
+        return AUDIO_COMPRESSION_CODEC_ADPCM_3BITS;
+    }
+    return AUDIO_COMPRESSION_CODEC_ADPCM_4BITS;
+}
+
+/** @brief Encode with an ADPCM codec, the payload is the encoder state of each channel followed by the codes.
+ *
+ *  @param[in]     pcm            Interleaved 16-bit PCM samples.
+ *  @param[in]     frame_count    Number of frames.
+ *  @param[in]     channel_count  Number of interleaved channels.
+ *  @param[in,out] state          ADPCM state of each channel.
+ *  @param[out]    payload        Encoded payload.
+ *  @param[in]     code_size      ADPCM code size in bits.
+ *  @return Payload size in bytes.
+ */
+static uint16_t encode_adpcm(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                             adpcm_state_t *state, uint8_t *payload, uint8_t code_size)
+{
+    uint16_t header_size = channel_count * sizeof(adpcm_state_t);
+
+    memcpy(payload, state, header_size);
+    adpcm_encode_block_packed(pcm, &payload[header_size], frame_count, channel_count, code_size, state);
+
+    return header_size + ADPCM_PACKED_NB_BYTES(frame_count * channel_count, code_size);
+}
+
+/** @brief Decode an ADPCM codec payload.
+ *
+ *  @param[in]  payload        Encoded payload.
+ *  @param[in]  payload_size   Payload size in bytes.
+ *  @param[in]  frame_count    Number of frames.
+ *  @param[in]  channel_count  Number of interleaved channels.
+ *  @param[out] state          ADPCM state of each channel.
+ *  @param[out] pcm            Interleaved 16-bit PCM samples.
+ *  @param[in]  code_size      ADPCM code size in bits.
+ *  @return false if the payload is too small.
+ */
+static bool decode_adpcm(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count, uint8_t channel_count,
+                         adpcm_state_t *state, int16_t *pcm, uint8_t code_size)
+{
+    uint16_t header_size = channel_count * sizeof(adpcm_state_t);
+
+    if (payload_size < (header_size + ADPCM_PACKED_NB_BYTES(frame_count * channel_count, code_size))) {
+        return false;
+    }
+    memcpy(state, payload, header_size);
+    adpcm_decode_block_packed(&payload[header_size], pcm, frame_count, channel_count, code_size, state);
+
+    return true;
+}
+
+/** @brief Encode with the ADPCM 4-bit codec, see encode_adpcm().
+ */
+static uint16_t encode_adpcm_4bits(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                   adpcm_state_t *state, uint8_t *payload)
+{
+    return encode_adpcm(pcm, frame_count, channel_count, state, payload, 4);
+}
+
+/** @brief Decode an ADPCM 4-bit codec payload, see decode_adpcm().
+ */
+static bool decode_adpcm_4bits(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                               uint8_t channel_count, adpcm_state_t *state, int16_t *pcm)
+{
+    return decode_adpcm(payload, payload_size, frame_count, channel_count, state, pcm, 4);
+}
+
+/** @brief Encode with the ADPCM 3-bit codec, see encode_adpcm().
+ */
+static uint16_t encode_adpcm_3bits(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                   adpcm_state_t *state, uint8_t *payload)
+{
+    return encode_adpcm(pcm, frame_count, channel_count, state, payload, 3);
+}
+
+/** @brief Decode an ADPCM 3-bit codec payload, see decode_adpcm().
+ */
+static bool decode_adpcm_3bits(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                               uint8_t channel_count, adpcm_state_t *state, int16_t *pcm)
+{
+    return decode_adpcm(payload, payload_size, frame_count, channel_count, state, pcm, 3);
+}
+
+/** @brief Encode with the ADPCM 2-bit codec, see encode_adpcm().
+ */
+static uint16_t encode_adpcm_2bits(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                   adpcm_state_t *state, uint8_t *payload)
+{
+    return encode_adpcm(pcm, frame_count, channel_count, state, payload, 2);
+}
+
+/** @brief Decode an ADPCM 2-bit codec payload, see decode_adpcm().
+ */
+static bool decode_adpcm_2bits(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                               uint8_t channel_count, adpcm_state_t *state, int16_t *pcm)
+{
+    return decode_adpcm(payload, payload_size, frame_count, channel_count, state, pcm, 2);
+}
+
+/** @brief Encode with the lossless codec.
+ *
+ *  Each channel is predicted from its previous sample and the zigzag encoded residuals are Rice
+ *  coded, interleaved like the samples. The payload starts with the Rice parameter and the first
+ *  sample of each channel. When this is not smaller than the samples themselves, the payload is
+ *  LOSSLESS_VERBATIM followed by the samples.
+ *
+ *  @param[in]     pcm            Interleaved 16-bit PCM samples.
+ *  @param[in]     frame_count    Number of frames.
+ *  @param[in]     channel_count  Number of interleaved channels.
+ *  @param[in,out] state          ADPCM state of each channel, its prediction follows the signal.
+ *  @param[out]    payload        Encoded payload.
+ *  @return Payload size in bytes.
+ */
+static uint16_t encode_lossless(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                                adpcm_state_t *state, uint8_t *payload)
+{
+    uint16_t raw_size = AUDIO_NB_SAMPLE_TO_BYTE(frame_count * channel_count);
+    uint16_t header_size = channel_count * LOSSLESS_CHANNEL_HEADER_SIZE;
+    uint8_t rice_parameter[ADPCM_PACKED_CHANNEL_MAX];
+    bit_writer_t writer;
+    uint32_t residual_sum;
+    int32_t residual;
+
+    if (frame_count == 0) {
+        payload[0] = LOSSLESS_VERBATIM;
+        return 1;
+    }
+
+    /* Keep the ADPCM predictors on the signal for a clean switch back to an ADPCM codec */
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        state[ch].state.predicted_sample = pcm[(frame_count - 1) * channel_count + ch];
+    }
+
+    if (raw_size > header_size) {
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            residual_sum = 0;
+            for (uint16_t i = channel_count + ch; i < frame_count * channel_count; i += channel_count) {
+                residual = pcm[i] - pcm[i - channel_count];
+                residual_sum += ZIGZAG_ENCODE(residual);
+            }
+            rice_parameter[ch] = get_rice_parameter(residual_sum, frame_count - 1);
+            payload[ch * LOSSLESS_CHANNEL_HEADER_SIZE] = rice_parameter[ch];
+            memcpy(&payload[ch * LOSSLESS_CHANNEL_HEADER_SIZE + 1], &pcm[ch], sizeof(int16_t));
+        }
+
+        writer.buffer = &payload[header_size];
+        writer.buffer_end = &payload[raw_size];
+        writer.bit_buffer = 0;
+        writer.bit_count = 0;
+        writer.overflow = false;
+        for (uint16_t i = channel_count; (i < frame_count * channel_count) && !writer.overflow; i += channel_count) {
+            for (uint8_t ch = 0; ch < channel_count; ch++) {
+                residual = pcm[i + ch] - pcm[i + ch - channel_count];
+                write_rice(&writer, ZIGZAG_ENCODE(residual), rice_parameter[ch]);
+            }
+        }
+        if (writer.bit_count > 0) {
+            write_bits(&writer, 0, 8 - writer.bit_count);
+        }
+        if (!writer.overflow) {
+            return writer.buffer - payload;
+        }
+    }
+
+    payload[0] = LOSSLESS_VERBATIM;
+    memcpy(&payload[1], pcm, raw_size);
+
+    return raw_size + 1;
+}
+
+/** @brief Decode a lossless codec payload.
+ *
+ *  @param[in]  payload        Encoded payload.
+ *  @param[in]  payload_size   Payload size in bytes.
+ *  @param[in]  frame_count    Number of frames.
+ *  @param[in]  channel_count  Number of interleaved channels.
+ *  @param[out] state          Unused, the lossless codec has no state.
+ *  @param[out] pcm            Interleaved 16-bit PCM samples.
+ *  @return false if the payload is malformed.
+ */
+static bool decode_lossless(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count,
+                            uint8_t channel_count, adpcm_state_t *state, int16_t *pcm)
+{
+    (void)state;
+
+    uint16_t raw_size = AUDIO_NB_SAMPLE_TO_BYTE(frame_count * channel_count);
+    uint16_t header_size = channel_count * LOSSLESS_CHANNEL_HEADER_SIZE;
+    uint8_t rice_parameter[ADPCM_PACKED_CHANNEL_MAX];
+    bit_reader_t reader;
+    uint32_t value;
+
+    if (payload_size < 1) {
+        return false;
+    }
+    if (payload[0] == LOSSLESS_VERBATIM) {
+        if (payload_size < (raw_size + 1)) {
+            return false;
+        }
+        memcpy(pcm, &payload[1], raw_size);
+        return true;
+    }
+    if ((payload_size < header_size) || (frame_count == 0)) {
+        return false;
+    }
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        rice_parameter[ch] = payload[ch * LOSSLESS_CHANNEL_HEADER_SIZE];
+        if (rice_parameter[ch] > LOSSLESS_RICE_PARAMETER_MAX) {
+            return false;
+        }
+        memcpy(&pcm[ch], &payload[ch * LOSSLESS_CHANNEL_HEADER_SIZE + 1], sizeof(int16_t));
+    }
+
+    reader.buffer = &payload[header_size];
+    reader.buffer_end = &payload[payload_size];
+    reader.bit_buffer = 0;
+    reader.bit_count = 0;
+    reader.underflow = false;
+    for (uint16_t i = channel_count; (i < frame_count * channel_count) && !reader.underflow; i += channel_count) {
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            value = read_rice(&reader, rice_parameter[ch]);
+            pcm[i + ch] = (int16_t)(pcm[i + ch - channel_count] + ZIGZAG_DECODE(value));
+        }
+    }
+
+    return !reader.underflow;
+}
+
+/** @brief Get the Rice parameter closest to the mean of the residuals.
+ *
+ *  @param[in] residual_sum    Sum of the zigzag encoded residuals.
+ *  @param[in] residual_count  Number of residuals.
+ *  @return Rice parameter.
+ */
+static uint8_t get_rice_parameter(uint32_t residual_sum, uint16_t residual_count)
+{
+    uint8_t rice_parameter = 0;
+
+    if (residual_count == 0) {
+        return 0;
+    }
+    while ((rice_parameter < LOSSLESS_RICE_PARAMETER_MAX) &&
+           (((uint32_t)residual_count << (rice_parameter + 1)) <= residual_sum)) {
+        rice_parameter++;
+    }
+    return rice_parameter;
+}
+
+/** @brief Write up to LOSSLESS_RESIDUAL_BITS bits.
+ *
+ *  @param[in,out] writer     Bit writer.
+ *  @param[in]     value      Bits to write.
+ *  @param[in]     bit_count  Number of bits to write.
+ */
+static inline void write_bits(bit_writer_t *writer, uint32_t value, uint8_t bit_count)
+{
+    writer->bit_buffer |= value << writer->bit_count;
+    writer->bit_count += bit_count;
+    while (writer->bit_count >= 8) {
+        if (writer->buffer == writer->buffer_end) {
+            writer->overflow = true;
+        } else {
+            *writer->buffer++ = (uint8_t)writer->bit_buffer;
+        }
+        writer->bit_buffer >>= 8;
+        writer->bit_count -= 8;
+    }
+}
+
+/** @brief Write a Rice code, the quotient in unary followed by the remainder. A quotient of
+ *         LOSSLESS_QUOTIENT_MAX or more is escaped and followed by the raw value.
+ *
+ *  @param[in,out] writer          Bit writer.
+ *  @param[in]     value           Value to write.
+ *  @param[in]     rice_parameter  Number of bits of the remainder.
+ */
+static inline void write_rice(bit_writer_t *writer, uint32_t value, uint8_t rice_parameter)
+{
+    uint32_t quotient = value >> rice_parameter;
+
+    if (quotient < LOSSLESS_QUOTIENT_MAX) {
+        write_bits(writer, (1 << quotient) - 1, quotient + 1);
+        write_bits(writer, value & ((1 << rice_parameter) - 1), rice_parameter);
+    } else {
+        write_bits(writer, (1 << LOSSLESS_QUOTIENT_MAX) - 1, LOSSLESS_QUOTIENT_MAX);
+        write_bits(writer, value, LOSSLESS_RESIDUAL_BITS);
+    }
+}
+
+/** @brief Read up to LOSSLESS_RESIDUAL_BITS bits, 0 is returned past the end of the input.
+ *
+ *  @param[in,out] reader     Bit reader.
+ *  @param[in]     bit_count  Number of bits to read.
+ *  @return Bits read.
+ */
+static inline uint32_t read_bits(bit_reader_t *reader, uint8_t bit_count)
+{
+    uint32_t value;
+
+    while (reader->bit_count < bit_count) {
+        if (reader->buffer == reader->buffer_end) {
+            reader->underflow = true;
+            return 0;
+        }
+        reader->bit_buffer |= (uint32_t)(*reader->buffer++) << reader->bit_count;
+        reader->bit_count += 8;
+    }
+    value = reader->bit_buffer & ((1 << bit_count) - 1);
+    reader->bit_buffer >>= bit_count;
+    reader->bit_count -= bit_count;
+
+    return value;
+}
+
+/** @brief Read a Rice code written by write_rice().
+ *
+ *  @param[in,out] reader          Bit reader.
+ *  @param[in]     rice_parameter  Number of bits of the remainder.
+ *  @return Value read.
+ */
+static inline uint32_t read_rice(bit_reader_t *reader, uint8_t rice_parameter)
+{
+    uint32_t quotient = 0;
+
+    while ((quotient < LOSSLESS_QUOTIENT_MAX) && read_bits(reader, 1)) {
+        quotient++;
+    }
+    if (quotient == LOSSLESS_QUOTIENT_MAX) {
+        return read_bits(reader, LOSSLESS_RESIDUAL_BITS);
+    }
+    return (quotient << rice_parameter) | read_bits(reader, rice_parameter);
+}
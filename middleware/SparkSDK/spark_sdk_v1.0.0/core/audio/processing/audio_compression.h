@@ -19,6 +19,8 @@ extern "C" {
 
 /* CONSTANTS ******************************************************************/
 #define AUDIO_COMPRESSION_OVERHEAD_MAX_SIZE 6 /*!< 3 bytes for the decoder state per channel */
+#define AUDIO_COMPRESSION_MULTI_RATE_OVERHEAD_MAX_SIZE 9 /*!< Codec header and 3 bytes for the decoder state per channel,
+                                                          the output_overhead of a multi-rate stage interface */
 
 /* TYPES **********************************************************************/
 /** @brief Audio Compression Commands.
@@ -26,7 +28,9 @@ extern "C" {
 typedef enum audio_compression_cmd {
     AUDIO_COMPRESSION_ENABLE,   /*!< Enable the Audio Compression */
     AUDIO_COMPRESSION_DISABLE,  /*!< Disable the Audio Compression */
-    AUDIO_COMPRESSION_GET_STATE /*!< Get the Audio Compression state */
+    AUDIO_COMPRESSION_GET_STATE, /*!< Get the Audio Compression state */
+    AUDIO_COMPRESSION_SET_CODEC, /*!< Set the multi-rate codec, arg is an audio_compression_codec_t */
+    AUDIO_COMPRESSION_GET_CODEC  /*!< Get the multi-rate codec used for the last packed payload */
 } audio_compression_cmd_t;
 
 /** @brief Audio Compression Mode.
@@ -35,9 +39,39 @@ typedef enum audio_compression_mode {
     AUDIO_COMPRESSION_PACK_STEREO,   /*!< Pack stereo uncompressed stream to stereo compressed stream mode */
     AUDIO_COMPRESSION_UNPACK_STEREO, /*!< Unpack stereo compressed stream to stereo uncompressed stream mode */
     AUDIO_COMPRESSION_PACK_MONO,     /*!< Pack mono uncompressed stream to mono compressed stream mode */
-    AUDIO_COMPRESSION_UNPACK_MONO    /*!< Unpack mono compressed stream to mono uncompressed stream mode */
+    AUDIO_COMPRESSION_UNPACK_MONO,   /*!< Unpack mono compressed stream to mono uncompressed stream mode */
+    AUDIO_COMPRESSION_PACK_MULTI_RATE,  /*!< Pack uncompressed stream with the selected multi-rate codec mode */
+    AUDIO_COMPRESSION_UNPACK_MULTI_RATE /*!< Unpack a multi-rate compressed stream, whatever its codec, mode */
 } audio_compression_mode_t;
 
+/** @brief Audio Compression Multi-Rate Codec.
+ *
+ *  Sorted from the highest to the lowest compression ratio is ADPCM 2-bit, ADPCM 3-bit,
+ *  ADPCM 4-bit and lossless, the latter having a data rate that depends on the audio content.
+ */
+typedef enum audio_compression_codec {
+    AUDIO_COMPRESSION_CODEC_ADPCM_4BITS, /*!< IMA ADPCM, 4 bits per sample */
+    AUDIO_COMPRESSION_CODEC_ADPCM_3BITS, /*!< IMA ADPCM, 3 bits per sample */
+    AUDIO_COMPRESSION_CODEC_ADPCM_2BITS, /*!< IMA ADPCM, 2 bits per sample */
+    AUDIO_COMPRESSION_CODEC_LOSSLESS,    /*!< Lossless delta and Rice coding, sent uncompressed when it does not compress */
+    AUDIO_COMPRESSION_CODEC_COUNT        /*!< Number of codecs */
+} audio_compression_codec_t;
+
+/** @brief Audio Compression Codec Interface.
+ *
+ *  A codec packs a block of interleaved 16-bit samples into a self-contained payload, so any
+ *  payload can be decoded without the previous ones. The ADPCM states are shared between codecs
+ *  so the encoder keeps its history when the codec changes.
+ */
+typedef struct audio_compression_codec_interface {
+    /*! Encode frame_count frames, return the payload size in bytes, never more than the size of the samples plus 6 */
+    uint16_t (*encode)(const int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                       adpcm_state_t *state, uint8_t *payload);
+    /*! Decode frame_count frames, return false if the payload is malformed */
+    bool (*decode)(const uint8_t *payload, uint16_t payload_size, uint16_t frame_count, uint8_t channel_count,
+                   adpcm_state_t *state, int16_t *pcm);
+} audio_compression_codec_interface_t;
+
 /** @brief Audio Compression Instance.
  */
 typedef struct audio_compression_instance {
@@ -45,6 +79,16 @@ typedef struct audio_compression_instance {
     adpcm_state_t adpcm_left_state;            /*!< Left ADPCM encoder state */
     adpcm_state_t adpcm_right_state;           /*!< Right ADPCM encoder state */
     audio_compression_mode_t compression_mode; /*!< Audio Compression mode */
+    uint8_t channel_count;                     /*!< Number of interleaved channels, multi-rate modes only */
+    uint16_t max_payload_size;                 /*!< Largest uncompressed payload in bytes the unpack multi-rate mode
+                                                    can write, usually the consumer max_audio_payload_size. Payloads
+                                                    announcing more samples are dropped */
+    audio_compression_codec_t codec;           /*!< Codec used by the multi-rate pack mode */
+    bool link_margin_adaptive;                 /*!< Select the multi-rate codec from the fallback module link margin,
+                                                    the codec stays fixed while the fallback module is not initialized */
+    int16_t lossless_link_margin;              /*!< Link margin from which the lossless codec is selected */
+    int16_t adpcm_3bits_link_margin;           /*!< Link margin under which the ADPCM 3-bit codec is selected */
+    int16_t adpcm_2bits_link_margin;           /*!< Link margin under which the ADPCM 2-bit codec is selected */
 } audio_compression_instance_t;
 
 /** @brief Audio Compression Stereo Header.
@@ -54,6 +98,13 @@ typedef struct audio_compression_adpcm_stereo_header {
     adpcm_state_t adpcm_header_right_state; /*!< Audio compression right channel state */
 } audio_compression_adpcm_stereo_header_t;
 
+/** @brief Audio Compression Multi-Rate Header.
+ */
+typedef struct audio_compression_codec_header {
+    uint8_t codec;        /*!< Codec of the payload, audio_compression_codec_t */
+    uint16_t frame_count; /*!< Number of frames in the payload */
+} __attribute__((packed)) audio_compression_codec_header_t;
+
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
 /** @brief Initialize compression process.
  *
@@ -78,6 +129,13 @@ void audio_compression_deinit(void *instance);
 uint32_t audio_compression_ctrl(void *instance, uint8_t cmd, uint32_t arg);
 
 /** @brief Process audio samples compression.
+ *
+ *  In AUDIO_COMPRESSION_PACK_MULTI_RATE mode, each payload starts with an
+ *  audio_compression_codec_header_t telling the unpacking side which codec to use. When
+ *  link_margin_adaptive is set, the codec is selected before each payload from the link margin
+ *  average of the audio fallback module, when it is initialized. The header is not covered by
+ *  the audio header CRC, so the unpacking side drops a payload announcing more samples than
+ *  max_payload_size or than its size can hold.
  *
  *  @param[in]  instance     Compression instance.
  *  @param[in]  header       Audio header.
@@ -0,0 +1,551 @@
+/** @file  audio_eq_cmsis.c
+ *  @brief Parametric equalizer and peak limiter processing stage using the CMSIS DSP software library.
+ *
+ *  @note This processing stage requires an Arm Cortex-M processor based device.
+ *
+ *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include "audio_eq_cmsis.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* CONSTANTS ******************************************************************/
+#define BIQUAD_COEFF_COUNT      5        /* b0, b1, b2, a1 and a2 of each stage */
+#define BIQUAD_COEFF_COUNT_Q15  6        /* The Q15 cascade expects a zero padding after b0 */
+#define BIQUAD_STATE_COUNT      4        /* x[n-1], x[n-2], y[n-1] and y[n-2] of each stage */
+#define BIQUAD_MAX_POST_SHIFT   4        /* Coefficients up to 16 in magnitude */
+#define Q31_HEADROOM_BITS       2        /* The Q31 cascade wraps on overflow, keep room for 12 dB of boost */
+#define LIMITER_GAIN_UNITY      (1 << 30)
+#define PI_F                    3.14159265358979f
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static void compute_band_coefficients(const audio_eq_band_cfg_t *band, uint32_t sample_rate,
+                                      float coeffs[BIQUAD_COEFF_COUNT]);
+static void compute_coefficients(audio_eq_cmsis_instance_t *eq, uint8_t set);
+static void swap_coefficients(audio_eq_cmsis_instance_t *eq);
+static void update_limiter(audio_eq_cmsis_instance_t *eq);
+static int32_t float_to_fixed(float value, uint8_t fractional_bits);
+static void filter_q15(audio_eq_cmsis_instance_t *eq, int16_t *samples_in, int16_t *samples_out,
+                       uint16_t frame_count);
+static void filter_q31(audio_eq_cmsis_instance_t *eq, void *samples_in, void *samples_out, uint16_t frame_count);
+static void apply_limiter_16bits(audio_eq_cmsis_instance_t *eq, int16_t *samples, uint16_t frame_count);
+static void apply_limiter_32bits(audio_eq_cmsis_instance_t *eq, int32_t *samples, uint16_t frame_count);
+static inline int32_t get_limiter_gain(audio_eq_cmsis_instance_t *eq, int32_t gain, int32_t peak);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void audio_eq_cmsis_init(void *instance, mem_pool_t *mem_pool)
+{
+    audio_eq_cmsis_instance_t *eq = (audio_eq_cmsis_instance_t *)instance;
+    uint8_t word_size = (eq->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE;
+    uint16_t coeff_set_size;
+    uint16_t state_size;
+    void *state[SAC_MAX_CHANNEL_COUNT] = {NULL};
+    bool allocated;
+
+    if (eq->cfg.channel_count == 0) {
+        eq->cfg.channel_count = 1;
+    } else if (eq->cfg.channel_count > SAC_MAX_CHANNEL_COUNT) {
+        eq->cfg.channel_count = SAC_MAX_CHANNEL_COUNT;
+    }
+    eq->_band_count = (eq->cfg.band_count > AUDIO_EQ_MAX_BAND_COUNT) ? AUDIO_EQ_MAX_BAND_COUNT : eq->cfg.band_count;
+    eq->_use_q31 = (eq->cfg.bit_depth != AUDIO_16BITS) || eq->cfg.high_precision;
+
+    if (!eq->_use_q31) {
+        coeff_set_size = eq->_band_count * BIQUAD_COEFF_COUNT_Q15 * sizeof(q15_t);
+    } else {
+        coeff_set_size = eq->_band_count * BIQUAD_COEFF_COUNT * sizeof(q31_t);
+    }
+    eq->_mem_pool = mem_pool;
+    eq->_coeffs[0] = mem_pool_alloc(mem_pool, coeff_set_size, SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    eq->_coeffs[1] = mem_pool_alloc(mem_pool, coeff_set_size, SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+
+    eq->_scratch_frame_count = eq->cfg.payload_size / (word_size * eq->cfg.channel_count);
+    eq->_scratch = mem_pool_alloc(mem_pool, eq->_scratch_frame_count * sizeof(int32_t),
+                                  SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+
+    state_size = eq->_band_count * BIQUAD_STATE_COUNT * (eq->_use_q31 ? sizeof(q31_t) : sizeof(q15_t));
+    allocated = (eq->_coeffs[0] != NULL) && (eq->_coeffs[1] != NULL) && (eq->_scratch != NULL);
+    for (uint8_t ch = 0; (ch < eq->cfg.channel_count) && (eq->_band_count > 0); ch++) {
+        state[ch] = mem_pool_alloc(mem_pool, state_size, SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+        allocated = allocated && (state[ch] != NULL);
+    }
+    if (!allocated) {
+        /* Out of memory, the stage stays disabled */
+        for (uint8_t ch = 0; ch < SAC_MAX_CHANNEL_COUNT; ch++) {
+            mem_pool_release(mem_pool, state[ch]);
+        }
+        eq->_band_count = 0;
+        audio_eq_cmsis_deinit(eq);
+        return;
+    }
+
+    compute_coefficients(eq, 0);
+    eq->_active_coeffs = 0;
+    eq->_coeffs_pending = false;
+
+    if (eq->_band_count > 0) {
+        for (uint8_t ch = 0; ch < eq->cfg.channel_count; ch++) {
+            if (!eq->_use_q31) {
+                arm_biquad_cascade_df1_init_q15(&eq->_biquad[ch].q15, eq->_band_count, eq->_coeffs[0],
+                                                state[ch], eq->_post_shift[0]);
+            } else {
+                arm_biquad_cascade_df1_init_q31(&eq->_biquad[ch].q31, eq->_band_count, eq->_coeffs[0],
+                                                state[ch], eq->_post_shift[0]);
+            }
+        }
+    }
+
+    eq->_limiter_gain = LIMITER_GAIN_UNITY;
+    update_limiter(eq);
+}
+
+void audio_eq_cmsis_deinit(void *instance)
+{
+    audio_eq_cmsis_instance_t *eq = (audio_eq_cmsis_instance_t *)instance;
+
+    if (eq->_band_count > 0) {
+        for (uint8_t ch = 0; ch < eq->cfg.channel_count; ch++) {
+            mem_pool_release(eq->_mem_pool, eq->_use_q31 ? (void *)eq->_biquad[ch].q31.pState :
+                                                           (void *)eq->_biquad[ch].q15.pState);
+        }
+    }
+    mem_pool_release(eq->_mem_pool, eq->_coeffs[0]);
+    mem_pool_release(eq->_mem_pool, eq->_coeffs[1]);
+    mem_pool_release(eq->_mem_pool, eq->_scratch);
+    eq->_coeffs[0] = NULL;
+    eq->_coeffs[1] = NULL;
+    eq->_scratch = NULL;
+}
+
+uint32_t audio_eq_cmsis_ctrl(void *instance, uint8_t cmd, uint32_t arg)
+{
+    (void)arg;
+    uint32_t ret = 0;
+    audio_eq_cmsis_instance_t *eq = (audio_eq_cmsis_instance_t *)instance;
+
+    switch ((audio_eq_cmd_t)cmd) {
+    case AUDIO_EQ_APPLY_BANDS:
+        /* The other set may still be read by the process until it has been swapped in */
+        if ((eq->_coeffs[0] != NULL) && !eq->_coeffs_pending) {
+            compute_coefficients(eq, eq->_active_coeffs ^ 1);
+            __sync_synchronize();
+            eq->_coeffs_pending = true;
+            ret = 1;
+        }
+        break;
+    case AUDIO_EQ_APPLY_LIMITER:
+        update_limiter(eq);
+        break;
+    case AUDIO_EQ_GET_LIMITER_GAIN:
+        ret = (uint32_t)(((int64_t)eq->_limiter_gain * 10000) >> 30);
+        break;
+    case AUDIO_EQ_GET_STATE:
+        ret = (eq->_coeffs[0] != NULL);
+        break;
+    }
+    return ret;
+}
+
+uint16_t audio_eq_cmsis_process(void *instance, sac_header_t *header,
+                                uint8_t *data_in, uint16_t bytes_count, uint8_t *data_out)
+{
+    (void)header;
+    audio_eq_cmsis_instance_t *eq = (audio_eq_cmsis_instance_t *)instance;
+    uint8_t word_size = (eq->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE;
+    uint16_t frame_count = bytes_count / (word_size * eq->cfg.channel_count);
+    uint16_t chunk_size;
+
+    if (eq->_coeffs[0] == NULL) {
+        /* Not initialized */
+        return 0;
+    }
+
+    if (eq->_coeffs_pending) {
+        swap_coefficients(eq);
+    }
+
+    if ((eq->_band_count > 0) && (eq->_scratch_frame_count > 0)) {
+        /* The payload size can grow up to cfg.payload_size, filter in chunks the scratch can hold */
+        for (uint16_t frame = 0; frame < frame_count; frame += chunk_size) {
+            chunk_size = frame_count - frame;
+            if (chunk_size > eq->_scratch_frame_count) {
+                chunk_size = eq->_scratch_frame_count;
+            }
+            if (!eq->_use_q31) {
+                filter_q15(eq, (int16_t *)data_in + frame * eq->cfg.channel_count,
+                           (int16_t *)data_out + frame * eq->cfg.channel_count, chunk_size);
+            } else {
+                filter_q31(eq, data_in + frame * eq->cfg.channel_count * word_size,
+                           data_out + frame * eq->cfg.channel_count * word_size, chunk_size);
+            }
+        }
+    } else if (data_out != data_in) {
+        memcpy(data_out, data_in, bytes_count);
+    }
+
+    if (eq->cfg.bit_depth == AUDIO_16BITS) {
+        apply_limiter_16bits(eq, (int16_t *)data_out, frame_count);
+    } else {
+        apply_limiter_32bits(eq, (int32_t *)data_out, frame_count);
+    }
+
+    return bytes_count;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Compute the coefficients of a band.
+ *
+ *  Formulas are from the Audio EQ Cookbook by Robert Bristow-Johnson. The feedback
+ *  coefficients are negated as the CMSIS biquad cascade adds them.
+ *
+ *  @param[in]  band         Band configuration.
+ *  @param[in]  sample_rate  Sampling rate, in Hz.
+ *  @param[out] coeffs       b0, b1, b2, a1 and a2 normalized by a0.
+ */
+static void compute_band_coefficients(const audio_eq_band_cfg_t *band, uint32_t sample_rate,
+                                      float coeffs[BIQUAD_COEFF_COUNT])
+{
+    float a = powf(10.0f, band->gain_db / 40.0f);
+    float w0 = 2.0f * PI_F * band->frequency_hz / (float)sample_rate;
+    float cos_w0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * ((band->q > 0.0f) ? band->q : 0.707f));
+    float sqrt_a_alpha = 2.0f * sqrtf(a) * alpha;
+    float b0, b1, b2, a0, a1, a2;
+
+    switch (band->type) {
+    case AUDIO_EQ_LOW_SHELF:
+        b0 = a * ((a + 1.0f) - (a - 1.0f) * cos_w0 + sqrt_a_alpha);
+        b1 = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cos_w0);
+        b2 = a * ((a + 1.0f) - (a - 1.0f) * cos_w0 - sqrt_a_alpha);
+        a0 = (a + 1.0f) + (a - 1.0f) * cos_w0 + sqrt_a_alpha;
+        a1 = -2.0f * ((a - 1.0f) + (a + 1.0f) * cos_w0);
+        a2 = (a + 1.0f) + (a - 1.0f) * cos_w0 - sqrt_a_alpha;
+        break;
+    case AUDIO_EQ_HIGH_SHELF:
+        b0 = a * ((a + 1.0f) + (a - 1.0f) * cos_w0 + sqrt_a_alpha);
+        b1 = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cos_w0);
+        b2 = a * ((a + 1.0f) + (a - 1.0f) * cos_w0 - sqrt_a_alpha);
+        a0 = (a + 1.0f) - (a - 1.0f) * cos_w0 + sqrt_a_alpha;
+        a1 = 2.0f * ((a - 1.0f) - (a + 1.0f) * cos_w0);
+        a2 = (a + 1.0f) - (a - 1.0f) * cos_w0 - sqrt_a_alpha;
+        break;
+    case AUDIO_EQ_LOW_PASS:
+        b1 = 1.0f - cos_w0;
+        b0 = b1 / 2.0f;
+        b2 = b0;
+        a0 = 1.0f + alpha;
+        a1 = -2.0f * cos_w0;
+        a2 = 1.0f - alpha;
+        break;
+    case AUDIO_EQ_HIGH_PASS:
+        b1 = -(1.0f + cos_w0);
+        b0 = -b1 / 2.0f;
+        b2 = b0;
+        a0 = 1.0f + alpha;
+        a1 = -2.0f * cos_w0;
+        a2 = 1.0f - alpha;
+        break;
+    case AUDIO_EQ_PEAKING:
+    default:
+        b0 = 1.0f + alpha * a;
+        b1 = -2.0f * cos_w0;
+        b2 = 1.0f - alpha * a;
+        a0 = 1.0f + alpha / a;
+        a1 = -2.0f * cos_w0;
+        a2 = 1.0f - alpha / a;
+        break;
+    }
+
+    coeffs[0] = b0 / a0;
+    coeffs[1] = b1 / a0;
+    coeffs[2] = b2 / a0;
+    coeffs[3] = -a1 / a0;
+    coeffs[4] = -a2 / a0;
+}
+
+/** @brief Compute the coefficients of every band in a coefficient set.
+ *
+ *  The coefficients are scaled down by a power of two so that the largest one fits
+ *  the fixed point format, the cascade shifts its output back by the same amount.
+ *
+ *  @param[in] eq   EQ CMSIS instance.
+ *  @param[in] set  Coefficient set to write, which must not be in use.
+ */
+static void compute_coefficients(audio_eq_cmsis_instance_t *eq, uint8_t set)
+{
+    float coeffs[AUDIO_EQ_MAX_BAND_COUNT][BIQUAD_COEFF_COUNT];
+    float max_coeff = 0.0f;
+    float scale;
+    int8_t post_shift = 0;
+    q15_t *coeffs_q15 = eq->_coeffs[set];
+    q31_t *coeffs_q31 = eq->_coeffs[set];
+
+    for (uint8_t band = 0; band < eq->_band_count; band++) {
+        compute_band_coefficients(&eq->cfg.band[band], eq->cfg.sample_rate, coeffs[band]);
+        for (uint8_t i = 0; i < BIQUAD_COEFF_COUNT; i++) {
+            if (fabsf(coeffs[band][i]) > max_coeff) {
+                max_coeff = fabsf(coeffs[band][i]);
+            }
+        }
+    }
+
+    while ((max_coeff >= (float)(1 << post_shift)) && (post_shift < BIQUAD_MAX_POST_SHIFT)) {
+        post_shift++;
+    }
+    scale = 1.0f / (float)(1 << post_shift);
+
+    for (uint8_t band = 0; band < eq->_band_count; band++) {
+        if (!eq->_use_q31) {
+            *coeffs_q15++ = (q15_t)float_to_fixed(coeffs[band][0] * scale, 15);
+            *coeffs_q15++ = 0;
+            for (uint8_t i = 1; i < BIQUAD_COEFF_COUNT; i++) {
+                *coeffs_q15++ = (q15_t)float_to_fixed(coeffs[band][i] * scale, 15);
+            }
+        } else {
+            for (uint8_t i = 0; i < BIQUAD_COEFF_COUNT; i++) {
+                *coeffs_q31++ = float_to_fixed(coeffs[band][i] * scale, 31);
+            }
+        }
+    }
+    eq->_post_shift[set] = post_shift;
+}
+
+/** @brief Make the biquad cascades use the pending coefficient set.
+ *
+ *  @param[in] eq  EQ CMSIS instance.
+ */
+static void swap_coefficients(audio_eq_cmsis_instance_t *eq)
+{
+    eq->_active_coeffs ^= 1;
+
+    for (uint8_t ch = 0; ch < eq->cfg.channel_count; ch++) {
+        if (!eq->_use_q31) {
+            eq->_biquad[ch].q15.pCoeffs = eq->_coeffs[eq->_active_coeffs];
+            eq->_biquad[ch].q15.postShift = eq->_post_shift[eq->_active_coeffs];
+        } else {
+            eq->_biquad[ch].q31.pCoeffs = eq->_coeffs[eq->_active_coeffs];
+            eq->_biquad[ch].q31.postShift = (uint8_t)eq->_post_shift[eq->_active_coeffs];
+        }
+    }
+    eq->_coeffs_pending = false;
+}
+
+/** @brief Convert the limiter configuration to the values used by the process.
+ *
+ *  @param[in] eq  EQ CMSIS instance.
+ */
+static void update_limiter(audio_eq_cmsis_instance_t *eq)
+{
+    float full_scale = (float)((1UL << (eq->cfg.bit_depth - 1)) - 1);
+    float release_samples = eq->cfg.limiter_release_ms * (float)eq->cfg.sample_rate / 1000.0f;
+
+    if (release_samples > 1.0f) {
+        eq->_limiter_release = float_to_fixed(1.0f - expf(-1.0f / release_samples), 30);
+    } else {
+        eq->_limiter_release = LIMITER_GAIN_UNITY;
+    }
+
+    if (eq->cfg.limiter_threshold_db < 0.0f) {
+        eq->_limiter_threshold = (int32_t)(full_scale * powf(10.0f, eq->cfg.limiter_threshold_db / 20.0f));
+    } else {
+        eq->_limiter_threshold = 0;
+    }
+}
+
+/** @brief Convert a value to fixed point, rounded and saturated.
+ *
+ *  @param[in] value            Value to convert.
+ *  @param[in] fractional_bits  Number of fractional bits of the fixed point format, up to 31.
+ *  @return Fixed point value.
+ */
+static int32_t float_to_fixed(float value, uint8_t fractional_bits)
+{
+    float scaled = value * (float)(1UL << fractional_bits);
+    float max = (float)((1UL << fractional_bits) - 1);
+
+    if (scaled >= max) {
+        return (fractional_bits == 31) ? INT32_MAX : (int32_t)max;
+    } else if (scaled <= -max) {
+        return (fractional_bits == 31) ? INT32_MIN : -(int32_t)max - 1;
+    }
+
+    return (int32_t)((scaled >= 0.0f) ? (scaled + 0.5f) : (scaled - 0.5f));
+}
+
+/** @brief Filter 16-bit samples in Q15.
+ *
+ *  Stereo channels are filtered one at a time from the scratch buffer since the
+ *  biquad cascade expects contiguous samples.
+ *
+ *  @param[in]  eq           EQ CMSIS instance.
+ *  @param[in]  samples_in   Interleaved samples to filter.
+ *  @param[out] samples_out  Filtered samples, can point to samples_in.
+ *  @param[in]  frame_count  Number of samples per channel, up to _scratch_frame_count.
+ */
+static void filter_q15(audio_eq_cmsis_instance_t *eq, int16_t *samples_in, int16_t *samples_out,
+                       uint16_t frame_count)
+{
+    uint8_t channel_count = eq->cfg.channel_count;
+    q15_t *scratch = (q15_t *)eq->_scratch;
+
+    if (channel_count == 1) {
+        arm_biquad_cascade_df1_q15(&eq->_biquad[0].q15, samples_in, samples_out, frame_count);
+        return;
+    }
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        for (uint16_t i = 0; i < frame_count; i++) {
+            scratch[i] = samples_in[i * channel_count + ch];
+        }
+        arm_biquad_cascade_df1_q15(&eq->_biquad[ch].q15, scratch, scratch, frame_count);
+        for (uint16_t i = 0; i < frame_count; i++) {
+            samples_out[i * channel_count + ch] = scratch[i];
+        }
+    }
+}
+
+/** @brief Filter samples in Q31.
+ *
+ *  Samples are scaled up to Q31, leaving Q31_HEADROOM_BITS bits of headroom, then
+ *  scaled back and saturated to the bit depth.
+ *
+ *  @param[in]  eq           EQ CMSIS instance.
+ *  @param[in]  samples_in   Interleaved 16-bit or 32-bit words to filter.
+ *  @param[out] samples_out  Filtered samples, can point to samples_in.
+ *  @param[in]  frame_count  Number of samples per channel, up to _scratch_frame_count.
+ */
+static void filter_q31(audio_eq_cmsis_instance_t *eq, void *samples_in, void *samples_out, uint16_t frame_count)
+{
+    uint8_t channel_count = eq->cfg.channel_count;
+    uint8_t shift = 32 - eq->cfg.bit_depth - Q31_HEADROOM_BITS;
+    int32_t max = (1L << (eq->cfg.bit_depth - 1)) - 1;
+    int32_t sample;
+    q31_t *scratch = eq->_scratch;
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        for (uint16_t i = 0; i < frame_count; i++) {
+            if (eq->cfg.bit_depth == AUDIO_16BITS) {
+                sample = ((int16_t *)samples_in)[i * channel_count + ch];
+            } else {
+                sample = ((int32_t *)samples_in)[i * channel_count + ch];
+            }
+            scratch[i] = (q31_t)((uint32_t)sample << shift);
+        }
+        arm_biquad_cascade_df1_q31(&eq->_biquad[ch].q31, scratch, scratch, frame_count);
+        for (uint16_t i = 0; i < frame_count; i++) {
+            sample = scratch[i] >> shift;
+            if (sample > max) {
+                sample = max;
+            } else if (sample < -max - 1) {
+                sample = -max - 1;
+            }
+            if (eq->cfg.bit_depth == AUDIO_16BITS) {
+                ((int16_t *)samples_out)[i * channel_count + ch] = (int16_t)sample;
+            } else {
+                ((int32_t *)samples_out)[i * channel_count + ch] = sample;
+            }
+        }
+    }
+}
+
+/** @brief Limit 16-bit samples.
+ *
+ *  @param[in]     eq           EQ CMSIS instance.
+ *  @param[in,out] samples      Interleaved samples.
+ *  @param[in]     frame_count  Number of samples per channel.
+ */
+static void apply_limiter_16bits(audio_eq_cmsis_instance_t *eq, int16_t *samples, uint16_t frame_count)
+{
+    uint8_t channel_count = eq->cfg.channel_count;
+    int32_t gain = eq->_limiter_gain;
+    int32_t peak;
+
+    if ((eq->_limiter_threshold == 0) && (gain == LIMITER_GAIN_UNITY)) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < frame_count; i++, samples += channel_count) {
+        /* Channels share the gain so the stereo image does not move */
+        peak = 0;
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            if (abs(samples[ch]) > peak) {
+                peak = abs(samples[ch]);
+            }
+        }
+        gain = get_limiter_gain(eq, gain, peak);
+        if (gain != LIMITER_GAIN_UNITY) {
+            for (uint8_t ch = 0; ch < channel_count; ch++) {
+                samples[ch] = (int16_t)(((int64_t)samples[ch] * gain) >> 30);
+            }
+        }
+    }
+    eq->_limiter_gain = gain;
+}
+
+/** @brief Limit 20-bit or 24-bit samples.
+ *
+ *  @param[in]     eq           EQ CMSIS instance.
+ *  @param[in,out] samples      Interleaved samples.
+ *  @param[in]     frame_count  Number of samples per channel.
+ */
+static void apply_limiter_32bits(audio_eq_cmsis_instance_t *eq, int32_t *samples, uint16_t frame_count)
+{
+    uint8_t channel_count = eq->cfg.channel_count;
+    int32_t gain = eq->_limiter_gain;
+    int32_t peak;
+
+    if ((eq->_limiter_threshold == 0) && (gain == LIMITER_GAIN_UNITY)) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < frame_count; i++, samples += channel_count) {
+        peak = 0;
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            if (abs(samples[ch]) > peak) {
+                peak = abs(samples[ch]);
+            }
+        }
+        gain = get_limiter_gain(eq, gain, peak);
+        if (gain != LIMITER_GAIN_UNITY) {
+            for (uint8_t ch = 0; ch < channel_count; ch++) {
+                samples[ch] = (int32_t)(((int64_t)samples[ch] * gain) >> 30);
+            }
+        }
+    }
+    eq->_limiter_gain = gain;
+}
+
+/** @brief Get the limiter gain of the next sample.
+ *
+ *  The gain drops instantly to bring a peak down to the threshold, then goes back
+ *  towards unity with the release time constant.
+ *
+ *  @param[in] eq    EQ CMSIS instance.
+ *  @param[in] gain  Gain of the previous sample, in Q30.
+ *  @param[in] peak  Absolute peak value of the sample across channels.
+ *  @return Gain of the sample, in Q30.
+ */
+static inline int32_t get_limiter_gain(audio_eq_cmsis_instance_t *eq, int32_t gain, int32_t peak)
+{
+    int32_t threshold = eq->_limiter_threshold;
+    int32_t target = LIMITER_GAIN_UNITY;
+    int32_t step;
+
+    if ((threshold != 0) && (peak > threshold)) {
+        target = (int32_t)((float)threshold / (float)peak * (float)LIMITER_GAIN_UNITY);
+    }
+
+    if (target <= gain) {
+        return target;
+    }
+
+    step = (int32_t)(((int64_t)(target - gain) * eq->_limiter_release) >> 30);
+
+    return (step > 0) ? (gain + step) : target;
+}
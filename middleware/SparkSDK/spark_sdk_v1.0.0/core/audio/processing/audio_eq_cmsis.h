@@ -0,0 +1,153 @@
+/** @file  audio_eq_cmsis.h
+ *  @brief Parametric equalizer and peak limiter processing stage using the CMSIS DSP software library.
+ *
+ *  Each band is a second order section of an Arm biquad cascade (Direct Form I). 16-bit
+ *  samples are filtered in Q15 and 20/24-bit samples in Q31. Q15 coefficients are too coarse
+ *  for bands below about a hundredth of the sampling rate, cfg.high_precision filters 16-bit
+ *  samples in Q31 for those. The limiter follows the equalizer so that bands with a positive
+ *  gain cannot clip the output.
+ *
+ *  Band and limiter settings are changed by editing the configuration then sending
+ *  AUDIO_EQ_APPLY_BANDS or AUDIO_EQ_APPLY_LIMITER through sac_processing_ctrl(). New
+ *  coefficients are computed in a second coefficient set and only swapped in by the next
+ *  call to audio_eq_cmsis_process(), so an audio packet is never filtered with a partially
+ *  written set. The Direct Form I state holds past input and output samples, which stay
+ *  valid across the swap.
+ *
+ *  @note This processing stage requires an Arm Cortex-M processor based device.
+ *
+ *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef AUDIO_EQ_CMSIS_H_
+#define AUDIO_EQ_CMSIS_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "arm_math.h"
+#include "sac_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define AUDIO_EQ_MAX_BAND_COUNT 5 /*!< Maximum number of bands of the equalizer */
+
+/* TYPES **********************************************************************/
+/** @brief EQ Commands.
+ */
+typedef enum audio_eq_cmd {
+    AUDIO_EQ_APPLY_BANDS,     /*!< Compute the coefficients of cfg.band, return 0 if the previous ones are not in use yet */
+    AUDIO_EQ_APPLY_LIMITER,   /*!< Apply the cfg.limiter_threshold_db and cfg.limiter_release_ms values */
+    AUDIO_EQ_GET_LIMITER_GAIN, /*!< Get the current limiter gain (between 0 and 10000) */
+    AUDIO_EQ_GET_STATE         /*!< Get 1 if the stage is initialized, 0 if its memory could not be allocated */
+} audio_eq_cmd_t;
+
+/** @brief EQ Band Type.
+ */
+typedef enum audio_eq_band_type {
+    AUDIO_EQ_PEAKING,    /*!< Boost or cut around frequency_hz */
+    AUDIO_EQ_LOW_SHELF,  /*!< Boost or cut below frequency_hz */
+    AUDIO_EQ_HIGH_SHELF, /*!< Boost or cut above frequency_hz */
+    AUDIO_EQ_LOW_PASS,   /*!< Attenuate above frequency_hz, gain_db is ignored */
+    AUDIO_EQ_HIGH_PASS   /*!< Attenuate below frequency_hz, gain_db is ignored */
+} audio_eq_band_type_t;
+
+/** @brief EQ Band Configuration.
+ */
+typedef struct audio_eq_band_cfg {
+    audio_eq_band_type_t type; /*!< Type of filter */
+    float frequency_hz;        /*!< Center, corner or cutoff frequency */
+    float q;                   /*!< Quality factor, 0.707 for a Butterworth response */
+    float gain_db;             /*!< Gain of peaking and shelf filters, in dB */
+} audio_eq_band_cfg_t;
+
+/** @brief EQ CMSIS Configuration.
+ */
+typedef struct audio_eq_cfg {
+    sac_bit_depth_t bit_depth;   /*!< Bit depth selected from the sac_bit_depth_t enum */
+    uint8_t channel_count;       /*!< 1 for mono and 2 for interleaved stereo payloads */
+    uint16_t payload_size;       /*!< Maximum size of the payload in bytes expected at input */
+    uint32_t sample_rate;        /*!< Sampling rate of the audio, in Hz */
+    bool high_precision;         /*!< Filter 16-bit samples in Q31 instead of Q15, at a higher cycle count */
+    uint8_t band_count;          /*!< Number of bands used, up to AUDIO_EQ_MAX_BAND_COUNT, read at initialization only */
+    audio_eq_band_cfg_t band[AUDIO_EQ_MAX_BAND_COUNT]; /*!< Bands configuration */
+    float limiter_threshold_db;  /*!< Limiter threshold in dBFS, 0 or more disables the limiter */
+    float limiter_release_ms;    /*!< Time constant of the limiter gain going back to unity */
+} audio_eq_cfg_t;
+
+/** @brief EQ CMSIS Biquad Instance.
+ */
+typedef union audio_eq_biquad_instance {
+    arm_biquad_casd_df1_inst_q15 q15; /*!< Instance for 16-bit samples */
+    arm_biquad_casd_df1_inst_q31 q31; /*!< Instance for 20-bit, 24-bit and high precision 16-bit samples */
+} audio_eq_biquad_instance_t;
+
+/** @brief EQ CMSIS Instance.
+ */
+typedef struct audio_eq_cmsis_instance {
+    audio_eq_cfg_t cfg;                                           /*!< EQ CMSIS user configuration */
+    mem_pool_t *_mem_pool;                                        /*!< Internal: memory pool the buffers come from */
+    audio_eq_biquad_instance_t _biquad[SAC_MAX_CHANNEL_COUNT];    /*!< Internal: biquad cascade of each channel */
+    uint8_t _band_count;                                          /*!< Internal: number of stages of the biquad cascades */
+    bool _use_q31;                                                /*!< Internal: true if the Q31 biquad cascades are used */
+    void *_coeffs[2];                                             /*!< Internal: active and pending coefficient sets */
+    int8_t _post_shift[2];                                        /*!< Internal: post shift of each coefficient set */
+    uint8_t _active_coeffs;                                       /*!< Internal: index of the coefficient set in use */
+    volatile bool _coeffs_pending;                                /*!< Internal: true when the other set is to be swapped in */
+    int32_t *_scratch;                                            /*!< Internal: one channel worth of samples */
+    uint16_t _scratch_frame_count;                                /*!< Internal: number of samples _scratch holds */
+    volatile int32_t _limiter_threshold;                          /*!< Internal: limiter threshold in sample units, 0 if disabled */
+    volatile int32_t _limiter_release;                            /*!< Internal: limiter release coefficient, in Q30 */
+    int32_t _limiter_gain;                                        /*!< Internal: current limiter gain, in Q30 */
+} audio_eq_cmsis_instance_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Initialize the EQ CMSIS processing stage.
+ *
+ *  If its memory can not be allocated, the stage stays disabled: it leaves the audio
+ *  untouched and AUDIO_EQ_GET_STATE returns 0.
+ *
+ *  @param[in] instance  EQ CMSIS instance.
+ *  @param[in] mem_pool  Memory pool for memory allocation.
+ */
+void audio_eq_cmsis_init(void *instance, mem_pool_t *mem_pool);
+
+/** @brief Deinitialize the EQ CMSIS processing stage.
+ *
+ *  @param[in] instance  EQ CMSIS instance.
+ */
+void audio_eq_cmsis_deinit(void *instance);
+
+/** @brief Process the equalizer and limiter on an audio packet.
+ *
+ *  @note data_out can point to data_in, the stage can run in place.
+ *
+ *  @param[in]  instance     EQ CMSIS instance.
+ *  @param[in]  header       Audio header.
+ *  @param[in]  data_in      Data in to be processed.
+ *  @param[in]  bytes_count  Number of bytes to process.
+ *  @param[out] data_out     Processed samples out.
+ *  @return Number of bytes processed. Return 0 if no samples processed.
+ */
+uint16_t audio_eq_cmsis_process(void *instance, sac_header_t *header, uint8_t *data_in,
+                                uint16_t bytes_count, uint8_t *data_out);
+
+/** @brief EQ CMSIS control function.
+ *
+ *  @param[in] instance  EQ CMSIS instance.
+ *  @param[in] cmd       Control command.
+ *  @param[in] arg       Control argument.
+ *  @return Value returned dependent on command.
+ */
+uint32_t audio_eq_cmsis_ctrl(void *instance, uint8_t cmd, uint32_t arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIO_EQ_CMSIS_H_ */
@@ -12,15 +12,24 @@
 #include "audio_packing.h"
 
 /* MACROS *********************************************************************/
-#define SAMPLE_SIZE_20BITS (2.5f)
-#define PACKED_SIZE_20BITS ((uint8_t)(SAMPLE_SIZE_20BITS * 2.0f))
-#define SAMPLE_SIZE_16BITS 2
-#define SAMPLE_SIZE_24BITS 3
-#define SAMPLE_SIZE_32BITS 4
+#define SAMPLE_SIZE_16BITS      2
+#define SAMPLE_SIZE_24BITS      3
+#define SAMPLE_SIZE_32BITS      4
+#define PACKED_SIZE_20BITS      5  /* Two 20-bit samples */
+#define PACKED_SIZE_20BITS_LAST 3  /* Last 20-bit sample of an odd sample count */
+#define BLOCK_SAMPLE_COUNT      4  /* Samples packed or unpacked per iteration, two stereo frames */
+#define BLOCK_SIZE_20BITS       10 /* Size of BLOCK_SAMPLE_COUNT packed 20-bit samples */
+#define BLOCK_SIZE_24BITS       12 /* Size of BLOCK_SAMPLE_COUNT packed 24-bit samples */
+#define MASK_20BITS             0x000FFFFF
+#define MASK_24BITS             0x00FFFFFF
 
 /* PRIVATE FUNCTION PROTOTYPES *************************************************/
-static void extend_msb_20bits_value(uint32_t *value);
-static void extend_msb_24bits_value(uint32_t *value);
+static inline uint32_t load_u32(const uint8_t *src);
+static inline uint16_t load_u16(const uint8_t *src);
+static inline void store_u32(uint8_t *dst, uint32_t value);
+static inline void store_u16(uint8_t *dst, uint16_t value);
+static inline int32_t extend_20bits_value(uint32_t value);
+static inline int32_t extend_24bits_value(uint32_t value);
 static uint16_t pack_20bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
 static uint16_t pack_24bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
 static uint16_t pack_20bits_16bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out);
@@ -123,7 +132,79 @@ uint16_t audio_packing_process(void *instance, sac_header_t *header,
 }
 
 /* PRIVATE FUNCTIONS ***********************************************************/
+/** @brief Load a little-endian 32 bits word from an unaligned address.
+ *
+ *  @param[in] src  Address to load from.
+ *  @return Loaded word.
+ */
+static inline uint32_t load_u32(const uint8_t *src)
+{
+    uint32_t value;
+
+    memcpy(&value, src, sizeof(value));
+
+    return value;
+}
+
+/** @brief Load a little-endian 16 bits half-word from an unaligned address.
+ *
+ *  @param[in] src  Address to load from.
+ *  @return Loaded half-word.
+ */
+static inline uint16_t load_u16(const uint8_t *src)
+{
+    uint16_t value;
+
+    memcpy(&value, src, sizeof(value));
+
+    return value;
+}
+
+/** @brief Store a little-endian 32 bits word to an unaligned address.
+ *
+ *  @param[out] dst    Address to store to.
+ *  @param[in]  value  Word to store.
+ */
+static inline void store_u32(uint8_t *dst, uint32_t value)
+{
+    memcpy(dst, &value, sizeof(value));
+}
+
+/** @brief Store a little-endian 16 bits half-word to an unaligned address.
+ *
+ *  @param[out] dst    Address to store to.
+ *  @param[in]  value  Half-word to store.
+ */
+static inline void store_u16(uint8_t *dst, uint16_t value)
+{
+    memcpy(dst, &value, sizeof(value));
+}
+
+/** @brief Extend the sign bit of a 20 bits audio sample into a 32 bits word.
+ *
+ *  @param[in] value  Word containing the 20 bits audio sample in its lsb, upper bits are ignored.
+ *  @return Sign extended sample.
+ */
+static inline int32_t extend_20bits_value(uint32_t value)
+{
+    return ((int32_t)(value << 12)) >> 12;
+}
+
+/** @brief Extend the sign bit of a 24 bits audio sample into a 32 bits word.
+ *
+ *  @param[in] value  Word containing the 24 bits audio sample in its lsb, upper bits are ignored.
+ *  @return Sign extended sample.
+ */
+static inline int32_t extend_24bits_value(uint32_t value)
+{
+    return ((int32_t)(value << 8)) >> 8;
+}
+
 /** @brief Pack 32 bits audio samples into 20 bits audio samples.
+ *
+ *  Samples are packed by pairs in 5 bytes, the first sample in the 20 lsb. A last odd
+ *  sample is written in 3 bytes. Four samples, which is two stereo frames, are packed
+ *  into 10 bytes per iteration.
  *
  *  @param[in]  buffer_in       Array of the input 32 bits samples containing 20 bits audio.
  *  @param[in]  buffer_in_size  Size in byte of the input array.
@@ -135,34 +216,49 @@ static uint16_t pack_20bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t
     uint32_t *data32_in = (uint32_t *)buffer_in;
     uint8_t *data_out = buffer_out;
     uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_32BITS;
-    uint16_t i;
-    uint16_t ret = 0;
+    uint32_t s0, s1, s2, s3;
+
+    for (; sample_count >= BLOCK_SAMPLE_COUNT; sample_count -= BLOCK_SAMPLE_COUNT) {
+        s0 = data32_in[0] & MASK_20BITS;
+        s1 = data32_in[1] & MASK_20BITS;
+        s2 = data32_in[2] & MASK_20BITS;
+        s3 = data32_in[3] & MASK_20BITS;
+
+        store_u32(&data_out[0], s0 | (s1 << 20));
+        store_u32(&data_out[4], (s1 >> 12) | (s2 << 8) | (s3 << 28));
+        store_u16(&data_out[8], (uint16_t)(s3 >> 4));
+
+        data_out += BLOCK_SIZE_20BITS;
+        data32_in += BLOCK_SAMPLE_COUNT;
+    }
+
+    for (; sample_count >= 2; sample_count -= 2) {
+        s0 = data32_in[0] & MASK_20BITS;
+        s1 = data32_in[1] & MASK_20BITS;
+
+        store_u32(&data_out[0], s0 | (s1 << 20));
+        data_out[4] = (uint8_t)(s1 >> 12);
 
-    for (i = 0; i < sample_count; i += 2) {
-        *(uint32_t *)(&(data_out[0])) = 0;
-        /* Check if sample #2 exists */
-        if ((i + 1) < sample_count) {
-            /* Copy Sample #2 */
-            *(uint32_t *)(&(data_out[2])) = ((data32_in[1]) & 0xFFFFF);
-            /* Shift Sample #2 by 4 bits */
-            *(uint32_t *)(&(data_out[2])) <<= 4;
-            /* Increment return size by (floor(2.5)) */
-            ret += 2;
-        }
-        /* Copy Sample #1 without erasing Sample #2 */
-        *(uint32_t *)(&(data_out[0])) |=  ((data32_in[0]) & 0xFFFFF);
-        /* Increment return size by (ceil(2.5)) */
-        ret += 3;
-
-        /* Increment pointers */
         data_out += PACKED_SIZE_20BITS;
         data32_in += 2;
     }
 
-    return ret;
+    if (sample_count > 0) {
+        s0 = data32_in[0] & MASK_20BITS;
+
+        data_out[0] = (uint8_t)s0;
+        data_out[1] = (uint8_t)(s0 >> 8);
+        data_out[2] = (uint8_t)(s0 >> 16);
+
+        data_out += PACKED_SIZE_20BITS_LAST;
+    }
+
+    return (uint16_t)(data_out - buffer_out);
 }
 
 /** @brief Pack 32 bits audio samples into 24 bits audio samples.
+ *
+ *  Four samples, which is two stereo frames, are packed into 12 bytes per iteration.
  *
  *  @param[in]  buffer_in       Array of the input 32 bits samples containing 24 bits audio.
  *  @param[in]  buffer_in_size  Size in byte of the input array.
@@ -174,21 +270,34 @@ static uint16_t pack_24bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t
     uint32_t *data32_in = (uint32_t *)buffer_in;
     uint8_t *data_out = buffer_out;
     uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_32BITS;
-    uint16_t i;
-    uint16_t ret = 0;
+    uint32_t s0, s1, s2, s3;
 
-    for (i = 0; i < sample_count; i ++) {
-        /* Copy Sample */
-        *(uint32_t *)(&(data_out[0])) =  ((*data32_in) & 0xFFFFFF);
-        /* Increment return size */
-        ret += SAMPLE_SIZE_24BITS;
+    for (; sample_count >= BLOCK_SAMPLE_COUNT; sample_count -= BLOCK_SAMPLE_COUNT) {
+        s0 = data32_in[0] & MASK_24BITS;
+        s1 = data32_in[1] & MASK_24BITS;
+        s2 = data32_in[2] & MASK_24BITS;
+        s3 = data32_in[3] & MASK_24BITS;
+
+        store_u32(&data_out[0], s0 | (s1 << 24));
+        store_u32(&data_out[4], (s1 >> 8) | (s2 << 16));
+        store_u32(&data_out[8], (s2 >> 16) | (s3 << 8));
+
+        data_out += BLOCK_SIZE_24BITS;
+        data32_in += BLOCK_SAMPLE_COUNT;
+    }
+
+    for (; sample_count > 0; sample_count--) {
+        s0 = *data32_in;
+
+        data_out[0] = (uint8_t)s0;
+        data_out[1] = (uint8_t)(s0 >> 8);
+        data_out[2] = (uint8_t)(s0 >> 16);
 
-        /* Increment pointers */
         data_out += SAMPLE_SIZE_24BITS;
         data32_in++;
     }
 
-    return ret;
+    return (uint16_t)(data_out - buffer_out);
 }
 
 /** @brief Pack 32 bits words containing 20 bits audio samples into 16 bits audio samples.
@@ -242,6 +351,8 @@ static uint16_t pack_24bits_16bits(uint8_t *buffer_in, uint16_t buffer_in_size,
 }
 
 /** @brief Unpack 20 bits audio samples into 32 bits audio samples.
+ *
+ *  Four samples, which is two stereo frames, are unpacked from 10 bytes per iteration.
  *
  *  @param[in]  buffer_in       Array of the input 20 bits samples.
  *  @param[in]  buffer_in_size  Size in byte of the input array.
@@ -250,40 +361,50 @@ static uint16_t pack_24bits_16bits(uint8_t *buffer_in, uint16_t buffer_in_size,
  */
 static uint16_t unpack_20bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
 {
-    uint32_t *data32_out = (uint32_t *)buffer_out;
+    int32_t *data32_out = (int32_t *)buffer_out;
     uint8_t *data_in = buffer_in;
-    uint16_t sample_count = (uint16_t)((float)buffer_in_size / SAMPLE_SIZE_20BITS);
-    uint16_t i;
-    uint16_t ret = 0;
+    /* 2.5 bytes per sample, a trailing half sample is dropped */
+    uint16_t sample_count = (uint16_t)(((uint32_t)buffer_in_size * 2) / PACKED_SIZE_20BITS);
+    uint16_t ret = sample_count * SAMPLE_SIZE_32BITS;
+    uint32_t w0, w1, w2;
+
+    for (; sample_count >= BLOCK_SAMPLE_COUNT; sample_count -= BLOCK_SAMPLE_COUNT) {
+        w0 = load_u32(&data_in[0]);
+        w1 = load_u32(&data_in[4]);
+        w2 = load_u16(&data_in[8]);
+
+        data32_out[0] = extend_20bits_value(w0);
+        data32_out[1] = extend_20bits_value((w0 >> 20) | (w1 << 12));
+        data32_out[2] = extend_20bits_value(w1 >> 8);
+        data32_out[3] = extend_20bits_value((w1 >> 28) | (w2 << 4));
+
+        data_in += BLOCK_SIZE_20BITS;
+        data32_out += BLOCK_SAMPLE_COUNT;
+    }
 
-    for (i = 0; i < sample_count; i += 2) {
+    for (; sample_count >= 2; sample_count -= 2) {
+        w0 = data_in[0] | (data_in[1] << 8) | (data_in[2] << 16);
+        w1 = data_in[2] | (data_in[3] << 8) | (data_in[4] << 16);
+
+        data32_out[0] = extend_20bits_value(w0);
+        data32_out[1] = extend_20bits_value(w1 >> 4);
 
-        /* Copy Sample #1 */
-        (data32_out[0]) = (*(uint32_t *)(&(data_in[0])));
-        extend_msb_20bits_value(&data32_out[0]);
-        /* Increment return size */
-        ret += SAMPLE_SIZE_32BITS;
-
-        /* Check if sample #2 exists */
-        if ((i + 1) < sample_count) {
-            /* Copy Sample #2 */
-            (data32_out[1]) = (*(uint32_t *)(&(data_in[2])) & 0xFFFFF0);
-            /* Shift Sample #2 by 4 bits */
-            (data32_out[1]) >>= 4;
-            extend_msb_20bits_value(&data32_out[1]);
-            /* Increment return size */
-            ret += SAMPLE_SIZE_32BITS;
-        }
-
-        /* Increment pointers */
         data_in += PACKED_SIZE_20BITS;
         data32_out += 2;
     }
 
+    if (sample_count > 0) {
+        w0 = data_in[0] | (data_in[1] << 8) | (data_in[2] << 16);
+
+        data32_out[0] = extend_20bits_value(w0);
+    }
+
     return ret;
 }
 
 /** @brief Unpack 24 bits audio samples into 32 bits audio samples.
+ *
+ *  Four samples, which is two stereo frames, are unpacked from 12 bytes per iteration.
  *
  *  @param[in]  buffer_in       Array of the input 24 bits samples.
  *  @param[in]  buffer_in_size  Size in byte of the input array.
@@ -292,20 +413,31 @@ static uint16_t unpack_20bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8
  */
 static uint16_t unpack_24bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
 {
-    uint32_t *data32_out = (uint32_t *)buffer_out;
+    int32_t *data32_out = (int32_t *)buffer_out;
     uint8_t *data_in = buffer_in;
-    uint16_t sample_count = (uint16_t)((float)buffer_in_size / SAMPLE_SIZE_24BITS);
-    uint16_t i;
-    uint16_t ret = 0;
+    uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_24BITS;
+    uint16_t ret = sample_count * SAMPLE_SIZE_32BITS;
+    uint32_t w0, w1, w2;
+
+    for (; sample_count >= BLOCK_SAMPLE_COUNT; sample_count -= BLOCK_SAMPLE_COUNT) {
+        w0 = load_u32(&data_in[0]);
+        w1 = load_u32(&data_in[4]);
+        w2 = load_u32(&data_in[8]);
+
+        data32_out[0] = extend_24bits_value(w0);
+        data32_out[1] = extend_24bits_value((w0 >> 24) | (w1 << 8));
+        data32_out[2] = extend_24bits_value((w1 >> 16) | (w2 << 16));
+        data32_out[3] = ((int32_t)w2) >> 8;
+
+        data_in += BLOCK_SIZE_24BITS;
+        data32_out += BLOCK_SAMPLE_COUNT;
+    }
 
-    for (i = 0; i < sample_count; i ++) {
-        /* Copy Sample */
-        (*data32_out) = (*(uint32_t *)(&(data_in[0])) & 0xFFFFFF);
-        extend_msb_24bits_value(data32_out);
-        /* Increment return size */
-        ret += SAMPLE_SIZE_32BITS;
+    for (; sample_count > 0; sample_count--) {
+        w0 = data_in[0] | (data_in[1] << 8) | (data_in[2] << 16);
+
+        *data32_out = extend_24bits_value(w0);
 
-        /* Increment pointers */
         data_in += SAMPLE_SIZE_24BITS;
         data32_out++;
     }
@@ -322,21 +454,17 @@ static uint16_t unpack_24bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8
  */
 static uint16_t unpack_20bits_16bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
 {
-    uint16_t *data32_in = (uint16_t *)buffer_in;
-    uint32_t *data_out = (uint32_t *)buffer_out;
+    int16_t *data16_in = (int16_t *)buffer_in;
+    int32_t *data_out = (int32_t *)buffer_out;
     uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_16BITS;
     uint16_t i;
-    uint16_t ret = 0;
 
     for (i = 0; i < sample_count; i++) {
-        /* Copy input sample */
-        data_out[i] =  ((data32_in[i] << 4) & 0x000FFFF0);
-        extend_msb_20bits_value(&data_out[i]);
-        /* Increment return size */
-        ret += SAMPLE_SIZE_32BITS;
+        /* Input sample becomes the 16 bits MSB, sign extended */
+        data_out[i] = data16_in[i] * (1 << 4);
     }
 
-    return ret;
+    return sample_count * SAMPLE_SIZE_32BITS;
 }
 
 /** @brief Unpack 16 bits audio samples into 32 bits words containing 24 bits audio.
@@ -348,43 +476,38 @@ static uint16_t unpack_20bits_16bits(uint8_t *buffer_in, uint16_t buffer_in_size
  */
 static uint16_t unpack_24bits_16bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
 {
-    uint16_t *data32_in = (uint16_t *)buffer_in;
-    uint32_t *data_out = (uint32_t *)buffer_out;
+    int16_t *data16_in = (int16_t *)buffer_in;
+    int32_t *data_out = (int32_t *)buffer_out;
     uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_16BITS;
     uint16_t i;
-    uint16_t ret = 0;
 
     for (i = 0; i < sample_count; i++) {
-        /* Copy input sample */
-        data_out[i] =  ((data32_in[i] << 8) & 0x00FFFF00);
-        extend_msb_24bits_value(&data_out[i]);
-        /* Increment return size */
-        ret += SAMPLE_SIZE_32BITS;
+        /* Input sample becomes the 16 bits MSB, sign extended */
+        data_out[i] = data16_in[i] * (1 << 8);
     }
 
-    return ret;
+    return sample_count * SAMPLE_SIZE_32BITS;
 }
 
 /** @brief Extend 20 bits audio samples sign bit into 32 bits word.
  *
  *  @param[in]  buffer_in       Array of the input 32 bits samples containing 20 bits audio.
  *  @param[in]  buffer_in_size  Size in byte of the input array.
- *  @param[out] buffer_out      Output of the input 32 bits samples.
+ *  @param[out] buffer_out      Output of the input 32 bits samples, can be buffer_in.
  *  @return written size, in byte, to the output buffer.
  */
 static uint16_t extend_20bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
 {
-    uint32_t *data32_out = (uint32_t *)buffer_out;
+    uint32_t *data32_in = (uint32_t *)buffer_in;
+    int32_t *data32_out = (int32_t *)buffer_out;
     uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_32BITS;
     uint16_t i;
 
-    /* Copy data into output buffer */
-    memcpy(buffer_out, buffer_in, buffer_in_size);
-
-    /* Extend sign bit of output buffer samples */
     for (i = 0; i < sample_count; i++) {
-        extend_msb_20bits_value(&data32_out[i]);
+        data32_out[i] = extend_20bits_value(data32_in[i]);
     }
+    /* Copy any trailing bytes unchanged */
+    memmove(&data32_out[i], &data32_in[i], buffer_in_size % SAMPLE_SIZE_32BITS);
 
     return buffer_in_size;
 }
@@ -393,44 +516,21 @@ static uint16_t extend_20bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8
  *
  *  @param[in]  buffer_in       Array of the input 32 bits samples containing 24 bits audio.
  *  @param[in]  buffer_in_size  Size in byte of the input array.
- *  @param[out] buffer_out      Output of the input 32 bits samples.
+ *  @param[out] buffer_out      Output of the input 32 bits samples, can be buffer_in.
  *  @return written size, in byte, to the output buffer.
  */
 static uint16_t extend_24bits(uint8_t *buffer_in, uint16_t buffer_in_size, uint8_t *buffer_out)
 {
-    uint32_t *data32_out = (uint32_t *)buffer_out;
+    uint32_t *data32_in = (uint32_t *)buffer_in;
+    int32_t *data32_out = (int32_t *)buffer_out;
     uint16_t sample_count = buffer_in_size / SAMPLE_SIZE_32BITS;
     uint16_t i;
 
-    /* Copy data into output buffer */
-    memcpy(buffer_out, buffer_in, buffer_in_size);
-
-    /* Extend sign bit of output buffer samples */
     for (i = 0; i < sample_count; i++) {
-        extend_msb_24bits_value(&data32_out[i]);
+        data32_out[i] = extend_24bits_value(data32_in[i]);
     }
+    /* Copy any trailing bytes unchanged */
+    memmove(&data32_out[i], &data32_in[i], buffer_in_size % SAMPLE_SIZE_32BITS);
 
     return buffer_in_size;
 }
-
-static void extend_msb_20bits_value(uint32_t *value) {
-
-    if ((*value) & (1 << 19)) {
-        /* Negative value */
-        *value |= 0xFFF00000;
-    } else {
-        /* Positive value */
-        *value &= 0x000FFFFF;
-    }
-}
-
-static void extend_msb_24bits_value(uint32_t *value) {
-
-    if ((*value) & (1 << 23)) {
-        /* Negative value */
-        *value |= 0xFF000000;
-    } else {
-        /* Positive value */
-        *value &= 0x00FFFFFF;
-    }
-}
@@ -0,0 +1,621 @@
+/** @file  audio_plc.c
+ *  @brief Packet loss concealment processing stage.
+ *
+ *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include "audio_plc.h"
+#include <string.h>
+
+/* CONSTANTS ******************************************************************/
+#define PITCH_WINDOW_MS      5 /* Duration of the most recent audio compared with the past periods */
+#define MAX_DECIMATION       255
+#define SUBMULTIPLE_SCORE    0.9f /* Score relative to the best a shorter period needs to be preferred */
+#define GAIN_UNITY           (1 << 15)
+
+/* Concealment state handed from audio_plc_conceal() back to audio_plc_process() */
+#define CONCEAL_STATE_ACTIVE          (1UL << 31)
+#define CONCEAL_STATE_SNAPSHOT_POS    30
+#define CONCEAL_STATE_FRAME_COUNT_MSK ((1UL << CONCEAL_STATE_SNAPSHOT_POS) - 1)
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static void write_history(audio_plc_instance_t *plc, uint8_t *samples, uint16_t frame_count);
+static void write_decimated(audio_plc_instance_t *plc, uint8_t *samples, uint16_t frame_count);
+static void publish_snapshot(audio_plc_instance_t *plc);
+static uint16_t find_pitch_period(audio_plc_instance_t *plc);
+static uint16_t find_decimated_pitch_period(audio_plc_instance_t *plc);
+static float get_decimated_score(const int16_t *recent, uint16_t window, uint16_t lag);
+static float get_pitch_score(audio_plc_instance_t *plc, uint16_t end, uint16_t period);
+static inline float get_score(int64_t correlation, int64_t energy);
+static void get_synthetic_frame(audio_plc_instance_t *plc, uint8_t snapshot, uint16_t position,
+                                uint32_t concealed_frame_count, int32_t *frame);
+static void crossfade(audio_plc_instance_t *plc, uint32_t conceal_state, uint8_t *samples, uint16_t frame_count);
+static inline uint16_t get_history_index(audio_plc_instance_t *plc, uint16_t end, uint16_t back);
+static inline int32_t read_sample(audio_plc_instance_t *plc, void *buffer, uint32_t index);
+static inline void write_sample(audio_plc_instance_t *plc, void *buffer, uint32_t index, int32_t sample);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void audio_plc_init(void *instance, mem_pool_t *mem_pool)
+{
+    audio_plc_instance_t *plc = (audio_plc_instance_t *)instance;
+    uint8_t frame_size;
+    uint32_t decimation;
+
+    if (plc->cfg.channel_count == 0) {
+        plc->cfg.channel_count = 1;
+    } else if (plc->cfg.channel_count > SAC_MAX_CHANNEL_COUNT) {
+        plc->cfg.channel_count = SAC_MAX_CHANNEL_COUNT;
+    }
+    frame_size = ((plc->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) * plc->cfg.channel_count;
+
+    plc->_min_period = plc->cfg.sample_rate / AUDIO_PLC_MAX_PITCH_HZ;
+    plc->_max_period = plc->cfg.sample_rate / AUDIO_PLC_MIN_PITCH_HZ;
+    plc->_window = (plc->cfg.sample_rate * PITCH_WINDOW_MS) / 1000;
+    plc->_hold_frame_count = (plc->cfg.sample_rate * plc->cfg.hold_ms) / 1000;
+    plc->_fade_frame_count = (plc->cfg.sample_rate * plc->cfg.fade_ms) / 1000;
+    if (plc->_min_period == 0) {
+        /* Invalid sampling rate */
+        return;
+    }
+    decimation = plc->cfg.sample_rate / AUDIO_PLC_SEARCH_RATE_HZ;
+    plc->_decimation = (decimation == 0) ? 1 : ((decimation > MAX_DECIMATION) ? MAX_DECIMATION : decimation);
+    /* The window and the longest period, rounded up to whole decimated samples */
+    plc->_decimated_frame_count = (plc->_max_period + plc->_decimation - 1) / plc->_decimation +
+                                  plc->_window / plc->_decimation + 1;
+
+    /* The period repeated and the window before it must not be overwritten by the next packet */
+    plc->_history_frame_count = plc->_max_period + plc->_window + (plc->cfg.payload_size / frame_size);
+    plc->_mem_pool = mem_pool;
+    plc->_history = mem_pool_alloc(mem_pool, plc->_history_frame_count * frame_size,
+                                   SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    plc->_snapshot[0] = mem_pool_alloc(mem_pool, plc->_max_period * frame_size,
+                                       SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    plc->_snapshot[1] = mem_pool_alloc(mem_pool, plc->_max_period * frame_size,
+                                       SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    plc->_decimated = mem_pool_alloc(mem_pool, 2 * plc->_decimated_frame_count * sizeof(int16_t),
+                                     SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    if ((plc->_history == NULL) || (plc->_snapshot[0] == NULL) || (plc->_snapshot[1] == NULL) ||
+        (plc->_decimated == NULL)) {
+        audio_plc_deinit(plc);
+        return;
+    }
+
+    audio_plc_ctrl(plc, AUDIO_PLC_RESET, 0);
+}
+
+void audio_plc_deinit(void *instance)
+{
+    audio_plc_instance_t *plc = (audio_plc_instance_t *)instance;
+
+    mem_pool_release(plc->_mem_pool, plc->_history);
+    mem_pool_release(plc->_mem_pool, plc->_snapshot[0]);
+    mem_pool_release(plc->_mem_pool, plc->_snapshot[1]);
+    mem_pool_release(plc->_mem_pool, plc->_decimated);
+    plc->_history = NULL;
+    plc->_snapshot[0] = NULL;
+    plc->_snapshot[1] = NULL;
+    plc->_decimated = NULL;
+}
+
+uint32_t audio_plc_ctrl(void *instance, uint8_t cmd, uint32_t arg)
+{
+    (void)arg;
+    uint32_t ret = 0;
+    audio_plc_instance_t *plc = (audio_plc_instance_t *)instance;
+
+    switch ((audio_plc_cmd_t)cmd) {
+    case AUDIO_PLC_RESET:
+        __atomic_store_n(&plc->_conceal_state, 0, __ATOMIC_RELEASE);
+        plc->_snapshot_period[0] = 0;
+        plc->_snapshot_period[1] = 0;
+        plc->_history_fill = 0;
+        plc->_history_index = 0;
+        plc->_decimated_fill = 0;
+        plc->_decimated_index = 0;
+        plc->_decimation_phase = 0;
+        plc->_decimation_sum = 0;
+        plc->_search_countdown = 0;
+        plc->_pitch_period = plc->_max_period;
+        plc->_period = 0;
+        break;
+    case AUDIO_PLC_GET_PITCH_HZ:
+        ret = (plc->_period == 0) ? 0 : (plc->cfg.sample_rate / plc->_period);
+        break;
+    }
+    return ret;
+}
+
+uint16_t audio_plc_process(void *instance, sac_header_t *header,
+                           uint8_t *data_in, uint16_t bytes_count, uint8_t *data_out)
+{
+    (void)header;
+    audio_plc_instance_t *plc = (audio_plc_instance_t *)instance;
+    uint8_t frame_size = ((plc->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) *
+                         plc->cfg.channel_count;
+    uint16_t frame_count = bytes_count / frame_size;
+    uint32_t conceal_state;
+
+    if (plc->_history == NULL) {
+        return 0;
+    }
+
+    if (data_out != data_in) {
+        memcpy(data_out, data_in, bytes_count);
+    }
+
+    /* Take the concealment back, audio_plc_conceal() starts over from the published period after this */
+    conceal_state = __atomic_exchange_n(&plc->_conceal_state, 0, __ATOMIC_ACQ_REL);
+    if (conceal_state & CONCEAL_STATE_ACTIVE) {
+        /* Go from the synthesized waveform back to the received audio */
+        crossfade(plc, conceal_state, data_out, frame_count);
+    }
+
+    write_history(plc, data_out, frame_count);
+    write_decimated(plc, data_out, frame_count);
+    if (plc->_history_fill >= (plc->_max_period + plc->_window)) {
+        /* The pitch changes slowly, only search it every AUDIO_PLC_SEARCH_INTERVAL_MS */
+        plc->_search_countdown -= frame_count;
+        if (plc->_search_countdown <= 0) {
+            plc->_pitch_period = find_pitch_period(plc);
+            plc->_search_countdown = (plc->cfg.sample_rate * AUDIO_PLC_SEARCH_INTERVAL_MS) / 1000;
+        }
+        publish_snapshot(plc);
+    }
+
+    return bytes_count;
+}
+
+uint16_t audio_plc_conceal(void *instance, uint8_t *data_out, uint16_t bytes_count)
+{
+    audio_plc_instance_t *plc = (audio_plc_instance_t *)instance;
+    uint8_t channel_count = plc->cfg.channel_count;
+    uint8_t frame_size = ((plc->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) * channel_count;
+    uint16_t frame_count = bytes_count / frame_size;
+    uint32_t conceal_state = __atomic_load_n(&plc->_conceal_state, __ATOMIC_ACQUIRE);
+    uint32_t concealed_frame_count;
+    uint16_t position, period;
+    uint8_t snapshot;
+    int32_t frame[SAC_MAX_CHANNEL_COUNT];
+
+    if (!(conceal_state & CONCEAL_STATE_ACTIVE)) {
+        if (plc->_history == NULL) {
+            return 0;
+        }
+        /* Start the concealment from the last period published */
+        snapshot = __atomic_load_n(&plc->_snapshot_index, __ATOMIC_ACQUIRE);
+        conceal_state = CONCEAL_STATE_ACTIVE | ((uint32_t)snapshot << CONCEAL_STATE_SNAPSHOT_POS);
+        plc->_period = plc->_snapshot_period[snapshot];
+    }
+    snapshot = (conceal_state >> CONCEAL_STATE_SNAPSHOT_POS) & 1;
+    concealed_frame_count = conceal_state & CONCEAL_STATE_FRAME_COUNT_MSK;
+    period = plc->_snapshot_period[snapshot];
+
+    if ((period == 0) || (concealed_frame_count >= (plc->_hold_frame_count + plc->_fade_frame_count))) {
+        /* No period published yet or faded out, the consumer can underflow and buffer again */
+        return 0;
+    }
+
+    position = concealed_frame_count % period;
+    for (uint16_t i = 0; i < frame_count; i++) {
+        get_synthetic_frame(plc, snapshot, position, concealed_frame_count, frame);
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            write_sample(plc, data_out, i * channel_count + ch, frame[ch]);
+        }
+        if (++position >= period) {
+            position = 0;
+        }
+        concealed_frame_count++;
+    }
+
+    conceal_state = (conceal_state & ~CONCEAL_STATE_FRAME_COUNT_MSK) | concealed_frame_count;
+    __atomic_store_n(&plc->_conceal_state, conceal_state, __ATOMIC_RELEASE);
+
+    return frame_count * frame_size;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Append samples to the history.
+ *
+ *  @param[in] plc          PLC instance.
+ *  @param[in] samples      Interleaved samples.
+ *  @param[in] frame_count  Number of samples per channel.
+ */
+static void write_history(audio_plc_instance_t *plc, uint8_t *samples, uint16_t frame_count)
+{
+    uint8_t frame_size = ((plc->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) *
+                         plc->cfg.channel_count;
+    uint16_t index = plc->_history_index;
+    uint16_t count;
+
+    if (frame_count > plc->_history_frame_count) {
+        samples += (frame_count - plc->_history_frame_count) * frame_size;
+        frame_count = plc->_history_frame_count;
+    }
+
+    count = plc->_history_frame_count - index;
+    if (count > frame_count) {
+        count = frame_count;
+    }
+    memcpy((uint8_t *)plc->_history + index * frame_size, samples, count * frame_size);
+    memcpy(plc->_history, samples + count * frame_size, (frame_count - count) * frame_size);
+
+    index += frame_count;
+    if (index >= plc->_history_frame_count) {
+        index -= plc->_history_frame_count;
+    }
+    plc->_history_index = index;
+
+    if ((plc->_history_fill + frame_count) < plc->_history_frame_count) {
+        plc->_history_fill += frame_count;
+    } else {
+        plc->_history_fill = plc->_history_frame_count;
+    }
+}
+
+/** @brief Append the first channel of samples to the decimated history.
+ *
+ *  Each decimated sample is the average of plc->_decimation samples, scaled to 16 bits.
+ *
+ *  @param[in] plc          PLC instance.
+ *  @param[in] samples      Interleaved samples.
+ *  @param[in] frame_count  Number of samples per channel.
+ */
+static void write_decimated(audio_plc_instance_t *plc, uint8_t *samples, uint16_t frame_count)
+{
+    uint8_t channel_count = plc->cfg.channel_count;
+    uint8_t shift = plc->cfg.bit_depth - AUDIO_16BITS;
+    uint16_t index = plc->_decimated_index;
+    int32_t sum = plc->_decimation_sum;
+    uint8_t phase = plc->_decimation_phase;
+    int16_t value;
+
+    for (uint16_t i = 0; i < frame_count; i++) {
+        if (plc->cfg.bit_depth == AUDIO_16BITS) {
+            sum += ((int16_t *)samples)[i * channel_count];
+        } else {
+            sum += ((int32_t *)samples)[i * channel_count] >> shift;
+        }
+        if (++phase < plc->_decimation) {
+            continue;
+        }
+        value = (int16_t)(sum / plc->_decimation);
+        plc->_decimated[index] = value;
+        plc->_decimated[index + plc->_decimated_frame_count] = value;
+        if (++index >= plc->_decimated_frame_count) {
+            index = 0;
+        }
+        if (plc->_decimated_fill < plc->_decimated_frame_count) {
+            plc->_decimated_fill++;
+        }
+        sum = 0;
+        phase = 0;
+    }
+
+    plc->_decimated_index = index;
+    plc->_decimation_sum = sum;
+    plc->_decimation_phase = phase;
+}
+
+/** @brief Copy the last pitch period of the history and publish it for the next concealment.
+ *
+ *  The copy not published is rewritten. audio_plc_process() takes the concealment back before
+ *  calling this, so audio_plc_conceal() only reads the published copy from then on.
+ *
+ *  @param[in] plc  PLC instance.
+ */
+static void publish_snapshot(audio_plc_instance_t *plc)
+{
+    uint8_t frame_size = ((plc->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) *
+                         plc->cfg.channel_count;
+    uint8_t snapshot = plc->_snapshot_index ^ 1;
+    uint16_t period = plc->_pitch_period;
+    uint16_t start = get_history_index(plc, plc->_history_index, period);
+    uint16_t count = plc->_history_frame_count - start;
+
+    if (count > period) {
+        count = period;
+    }
+    memcpy(plc->_snapshot[snapshot], (uint8_t *)plc->_history + start * frame_size, count * frame_size);
+    memcpy((uint8_t *)plc->_snapshot[snapshot] + count * frame_size, plc->_history, (period - count) * frame_size);
+    plc->_snapshot_period[snapshot] = period;
+
+    __atomic_store_n(&plc->_snapshot_index, snapshot, __ATOMIC_RELEASE);
+}
+
+/** @brief Find the pitch period of the most recent audio.
+ *
+ *  The last PITCH_WINDOW_MS of the first channel are correlated with the audio one
+ *  period earlier. Every period between the shortest and the longest is tried on the
+ *  decimated history, then the best one is refined at the full rate.
+ *
+ *  @param[in] plc  PLC instance.
+ *  @return Pitch period, in samples. The longest period if none correlates.
+ */
+static uint16_t find_pitch_period(audio_plc_instance_t *plc)
+{
+    uint16_t coarse_period = find_decimated_pitch_period(plc);
+    uint16_t best_period = coarse_period;
+    uint16_t first, last;
+    float best_score = 0.0f;
+    float score;
+
+    if ((coarse_period == 0) || (plc->_decimation == 1)) {
+        return (coarse_period == 0) ? plc->_max_period : coarse_period;
+    }
+
+    /* The decimated search is accurate to one decimated sample */
+    first = (coarse_period > (plc->_min_period + plc->_decimation - 1)) ?
+            (coarse_period - plc->_decimation + 1) : plc->_min_period;
+    last = coarse_period + plc->_decimation - 1;
+    if (last > plc->_max_period) {
+        last = plc->_max_period;
+    }
+    for (uint16_t period = first; period <= last; period++) {
+        score = get_pitch_score(plc, plc->_history_index, period);
+        if (score > best_score) {
+            best_score = score;
+            best_period = period;
+        }
+    }
+
+    return best_period;
+}
+
+/** @brief Find the pitch period of the most recent audio on the decimated history.
+ *
+ *  Multiples of the pitch period correlate as well as the period itself and, once rounded
+ *  to whole decimated samples, sometimes better. The shortest sub-multiple of the best
+ *  period scoring close to it is returned, so the period repeated is as accurate as possible.
+ *
+ *  @param[in] plc  PLC instance.
+ *  @return Pitch period, in samples at the full rate, 0 if none correlates.
+ */
+static uint16_t find_decimated_pitch_period(audio_plc_instance_t *plc)
+{
+    uint16_t window = plc->_window / plc->_decimation;
+    uint16_t min_lag = plc->_min_period / plc->_decimation;
+    uint16_t max_lag = plc->_max_period / plc->_decimation;
+    uint16_t best_lag = 0;
+    uint16_t best_submultiple_lag, lag;
+    float best_score = 0.0f;
+    float best_submultiple_score, score;
+    const int16_t *recent;
+
+    if ((plc->_decimated_fill < plc->_decimated_frame_count) || (window == 0)) {
+        return 0;
+    }
+    if (min_lag == 0) {
+        min_lag = 1;
+    }
+
+    /* The ring buffer is written twice, so its samples in order start at the write index */
+    recent = &plc->_decimated[plc->_decimated_index + plc->_decimated_frame_count - window];
+    for (lag = min_lag; lag <= max_lag; lag++) {
+        score = get_decimated_score(recent, window, lag);
+        if (score > best_score) {
+            best_score = score;
+            best_lag = lag;
+        }
+    }
+    if (best_lag == 0) {
+        return 0;
+    }
+
+    for (uint16_t divisor = best_lag / min_lag; divisor >= 2; divisor--) {
+        /* Keep the best lag around the sub-multiple, the rounding can be off by one */
+        lag = (best_lag + divisor / 2) / divisor;
+        best_submultiple_lag = 0;
+        best_submultiple_score = 0.0f;
+        for (uint16_t candidate = lag - 1; candidate <= (lag + 1); candidate++) {
+            score = (candidate >= min_lag) ? get_decimated_score(recent, window, candidate) : 0.0f;
+            if (score > best_submultiple_score) {
+                best_submultiple_score = score;
+                best_submultiple_lag = candidate;
+            }
+        }
+        if (best_submultiple_score >= (SUBMULTIPLE_SCORE * best_score)) {
+            return best_submultiple_lag * plc->_decimation;
+        }
+    }
+
+    return best_lag * plc->_decimation;
+}
+
+/** @brief Get how well the most recent decimated audio matches the audio one lag earlier.
+ *
+ *  @param[in] recent  Most recent decimated samples, preceded by at least lag samples.
+ *  @param[in] window  Number of recent samples compared.
+ *  @param[in] lag     Lag to try, in decimated samples.
+ *  @return Squared correlation normalized by the energy of the earlier audio, 0 if negative.
+ */
+static float get_decimated_score(const int16_t *recent, uint16_t window, uint16_t lag)
+{
+    const int16_t *past = recent - lag;
+    int64_t correlation = 0;
+    int64_t energy = 0;
+
+    for (uint16_t i = 0; i < window; i++) {
+        correlation += (int32_t)recent[i] * past[i];
+        energy += (int32_t)past[i] * past[i];
+    }
+
+    return get_score(correlation, energy);
+}
+
+/** @brief Get how well the most recent audio matches the audio one period earlier.
+ *
+ *  @param[in] plc     PLC instance.
+ *  @param[in] end     History index following the most recent sample.
+ *  @param[in] period  Period to try, in samples.
+ *  @return Squared correlation normalized by the energy of the earlier audio, 0 if negative.
+ */
+static float get_pitch_score(audio_plc_instance_t *plc, uint16_t end, uint16_t period)
+{
+    uint8_t channel_count = plc->cfg.channel_count;
+    uint16_t history_frame_count = plc->_history_frame_count;
+    uint16_t recent = get_history_index(plc, end, plc->_window);
+    uint16_t past = get_history_index(plc, end, plc->_window + period);
+    int64_t correlation = 0;
+    int64_t energy = 0;
+    int32_t recent_sample, past_sample;
+
+    for (uint16_t i = 0; i < plc->_window; i++) {
+        if (plc->cfg.bit_depth == AUDIO_16BITS) {
+            recent_sample = ((int16_t *)plc->_history)[recent * channel_count];
+            past_sample = ((int16_t *)plc->_history)[past * channel_count];
+        } else {
+            recent_sample = ((int32_t *)plc->_history)[recent * channel_count];
+            past_sample = ((int32_t *)plc->_history)[past * channel_count];
+        }
+        correlation += (int64_t)recent_sample * past_sample;
+        energy += (int64_t)past_sample * past_sample;
+        if (++recent == history_frame_count) {
+            recent = 0;
+        }
+        if (++past == history_frame_count) {
+            past = 0;
+        }
+    }
+
+    return get_score(correlation, energy);
+}
+
+/** @brief Get the pitch score of a correlation.
+ *
+ *  @param[in] correlation  Correlation of the recent audio with the earlier audio.
+ *  @param[in] energy       Energy of the earlier audio.
+ *  @return Squared correlation normalized by the energy, 0 if the correlation is negative.
+ */
+static inline float get_score(int64_t correlation, int64_t energy)
+{
+    if ((correlation <= 0) || (energy == 0)) {
+        return 0.0f;
+    }
+
+    return ((float)correlation * (float)correlation) / (float)energy;
+}
+
+/** @brief Synthesize a sample of each channel.
+ *
+ *  @param[in]  plc                    PLC instance.
+ *  @param[in]  snapshot               Copy of the pitch period repeated.
+ *  @param[in]  position               Position in the period.
+ *  @param[in]  concealed_frame_count  Samples synthesized since the loss started.
+ *  @param[out] frame                  One sample per channel.
+ */
+static void get_synthetic_frame(audio_plc_instance_t *plc, uint8_t snapshot, uint16_t position,
+                                uint32_t concealed_frame_count, int32_t *frame)
+{
+    uint8_t channel_count = plc->cfg.channel_count;
+    uint32_t fade_end = plc->_hold_frame_count + plc->_fade_frame_count;
+    int32_t gain;
+
+    if (concealed_frame_count < plc->_hold_frame_count) {
+        gain = GAIN_UNITY;
+    } else if (concealed_frame_count < fade_end) {
+        gain = (int32_t)(((uint64_t)(fade_end - concealed_frame_count) * GAIN_UNITY) / plc->_fade_frame_count);
+    } else {
+        gain = 0;
+    }
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        frame[ch] = (int32_t)(((int64_t)read_sample(plc, plc->_snapshot[snapshot], position * channel_count + ch) *
+                               gain) >> 15);
+    }
+}
+
+/** @brief Crossfade the synthesized waveform into received samples.
+ *
+ *  The crossfade continues the concealment where audio_plc_conceal() left it and lasts one
+ *  pitch period, or the whole packet if it is shorter.
+ *
+ *  @param[in]     plc            PLC instance.
+ *  @param[in]     conceal_state  Concealment state taken back from audio_plc_conceal().
+ *  @param[in,out] samples        Interleaved samples received.
+ *  @param[in]     frame_count    Number of samples per channel.
+ */
+static void crossfade(audio_plc_instance_t *plc, uint32_t conceal_state, uint8_t *samples, uint16_t frame_count)
+{
+    uint8_t channel_count = plc->cfg.channel_count;
+    uint8_t snapshot = (conceal_state >> CONCEAL_STATE_SNAPSHOT_POS) & 1;
+    uint32_t concealed_frame_count = conceal_state & CONCEAL_STATE_FRAME_COUNT_MSK;
+    uint16_t period = plc->_snapshot_period[snapshot];
+    uint16_t length = (frame_count < period) ? frame_count : period;
+    uint16_t position;
+    int32_t frame[SAC_MAX_CHANNEL_COUNT];
+    int32_t weight;
+    uint32_t index;
+
+    if (period == 0) {
+        return;
+    }
+
+    position = concealed_frame_count % period;
+    for (uint16_t i = 0; i < length; i++) {
+        get_synthetic_frame(plc, snapshot, position, concealed_frame_count++, frame);
+        if (++position >= period) {
+            position = 0;
+        }
+        weight = ((i + 1) * GAIN_UNITY) / (length + 1);
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            index = i * channel_count + ch;
+            write_sample(plc, samples, index,
+                         (int32_t)(((int64_t)read_sample(plc, samples, index) * weight +
+                                    (int64_t)frame[ch] * (GAIN_UNITY - weight)) >> 15));
+        }
+    }
+}
+
+/** @brief Get the history index a number of samples before another.
+ *
+ *  @param[in] plc   PLC instance.
+ *  @param[in] end   History index.
+ *  @param[in] back  Number of samples to go back, up to the history size.
+ *  @return History index.
+ */
+static inline uint16_t get_history_index(audio_plc_instance_t *plc, uint16_t end, uint16_t back)
+{
+    int32_t index = (int32_t)end - back;
+
+    if (index < 0) {
+        index += plc->_history_frame_count;
+    }
+
+    return (uint16_t)index;
+}
+
+/** @brief Read a sample of the stage bit depth.
+ *
+ *  @param[in] plc     PLC instance.
+ *  @param[in] buffer  Samples.
+ *  @param[in] index   Index of the sample.
+ *  @return Sample.
+ */
+static inline int32_t read_sample(audio_plc_instance_t *plc, void *buffer, uint32_t index)
+{
+    if (plc->cfg.bit_depth == AUDIO_16BITS) {
+        return ((int16_t *)buffer)[index];
+    }
+
+    return ((int32_t *)buffer)[index];
+}
+
+/** @brief Write a sample of the stage bit depth.
+ *
+ *  @param[in] plc     PLC instance.
+ *  @param[in] buffer  Samples.
+ *  @param[in] index   Index of the sample.
+ *  @param[in] sample  Sample.
+ */
+static inline void write_sample(audio_plc_instance_t *plc, void *buffer, uint32_t index, int32_t sample)
+{
+    if (plc->cfg.bit_depth == AUDIO_16BITS) {
+        ((int16_t *)buffer)[index] = (int16_t)sample;
+    } else {
+        ((int32_t *)buffer)[index] = sample;
+    }
+}
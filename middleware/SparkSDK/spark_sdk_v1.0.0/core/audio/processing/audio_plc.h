@@ -0,0 +1,151 @@
+/** @file  audio_plc.h
+ *  @brief Packet loss concealment processing stage.
+ *
+ *  The stage keeps a history of the audio packets it processes and tracks their pitch. The
+ *  pitch is searched every AUDIO_PLC_SEARCH_INTERVAL_MS on the first channel decimated to
+ *  about AUDIO_PLC_SEARCH_RATE_HZ, then refined at the full rate. After each packet, the
+ *  stage only publishes a copy of the last pitch period. When a consumer runs out of
+ *  packets, the audio core calls audio_plc_conceal() from the consumer interrupt, which
+ *  repeats the published period, holds it for cfg.hold_ms then fades it out over cfg.fade_ms.
+ *  The first packet received afterwards is crossfaded with the synthesized waveform.
+ *
+ *  audio_plc_process() runs in the process context and audio_plc_conceal() may interrupt it.
+ *  The two periods are double buffered so the one being concealed is never rewritten, and the
+ *  concealment progress is handed back to the process context in a single atomic word.
+ *
+ *  The stage must be the last processing stage of the consumer side pipeline, since the
+ *  concealed payloads go straight to the consumer. sac_pipeline_setup() rejects it otherwise.
+ *
+ *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef AUDIO_PLC_H_
+#define AUDIO_PLC_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "sac_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define AUDIO_PLC_MIN_PITCH_HZ 66  /*!< Lowest pitch detected, sets the longest period repeated */
+#define AUDIO_PLC_MAX_PITCH_HZ 400 /*!< Highest pitch detected, sets the shortest period repeated */
+#ifndef AUDIO_PLC_SEARCH_INTERVAL_MS
+#define AUDIO_PLC_SEARCH_INTERVAL_MS 10   /*!< Audio processed between two pitch searches */
+#endif
+#ifndef AUDIO_PLC_SEARCH_RATE_HZ
+#define AUDIO_PLC_SEARCH_RATE_HZ     8000 /*!< Sampling rate the coarse pitch search runs at */
+#endif
+
+/* TYPES **********************************************************************/
+/** @brief PLC Commands.
+ */
+typedef enum audio_plc_cmd {
+    AUDIO_PLC_RESET,          /*!< Clear the history, for a discontinuity in the stream */
+    AUDIO_PLC_GET_PITCH_HZ    /*!< Get the pitch of the last concealment, 0 if none happened */
+} audio_plc_cmd_t;
+
+/** @brief PLC Configuration.
+ */
+typedef struct audio_plc_cfg {
+    sac_bit_depth_t bit_depth; /*!< Bit depth selected from the sac_bit_depth_t enum */
+    uint8_t channel_count;     /*!< 1 for mono and 2 for interleaved stereo payloads */
+    uint16_t payload_size;     /*!< Maximum size of the payload in bytes expected at input */
+    uint32_t sample_rate;      /*!< Sampling rate of the audio, in Hz */
+    uint16_t hold_ms;          /*!< Time the synthesized waveform is played at full level */
+    uint16_t fade_ms;          /*!< Time the synthesized waveform then takes to fade out, after which
+                                    the consumer is left to underflow */
+} audio_plc_cfg_t;
+
+/** @brief PLC Instance.
+ */
+typedef struct audio_plc_instance {
+    audio_plc_cfg_t cfg;               /*!< PLC user configuration */
+    mem_pool_t *_mem_pool;             /*!< Internal: memory pool the history and copies come from */
+    void *_history;                    /*!< Internal: ring buffer of the last samples processed */
+    uint16_t _history_frame_count;     /*!< Internal: number of samples per channel the history holds */
+    uint16_t _history_fill;            /*!< Internal: number of valid samples per channel in the history */
+    uint16_t _history_index;           /*!< Internal: index in the history where the next sample goes */
+    uint16_t _min_period;              /*!< Internal: shortest pitch period, in samples */
+    uint16_t _max_period;              /*!< Internal: longest pitch period, in samples */
+    uint16_t _window;                  /*!< Internal: number of samples compared by the pitch detection */
+    int16_t *_decimated;               /*!< Internal: first channel decimated for the coarse pitch search, a
+                                            ring buffer written twice so the last samples are contiguous */
+    uint16_t _decimated_frame_count;   /*!< Internal: number of samples the decimated ring buffer holds */
+    uint16_t _decimated_fill;          /*!< Internal: number of valid samples in the decimated ring buffer */
+    uint16_t _decimated_index;         /*!< Internal: index in the decimated ring buffer where the next sample goes */
+    uint8_t _decimation;               /*!< Internal: samples averaged per decimated sample */
+    uint8_t _decimation_phase;         /*!< Internal: samples averaged so far for the next decimated sample */
+    int32_t _decimation_sum;           /*!< Internal: sum of the samples averaged so far */
+    int32_t _search_countdown;         /*!< Internal: samples left to process before the next pitch search */
+    uint16_t _pitch_period;            /*!< Internal: pitch period found by the last search, in samples */
+    void *_snapshot[2];                /*!< Internal: copies of the last pitch period, one is published */
+    uint16_t _snapshot_period[2];      /*!< Internal: pitch period of each copy, in samples, 0 if empty */
+    uint8_t _snapshot_index;           /*!< Internal: copy published for the next concealment */
+    uint16_t _period;                  /*!< Internal: pitch period of the last concealment, in samples */
+    uint32_t _hold_frame_count;        /*!< Internal: cfg.hold_ms in samples */
+    uint32_t _fade_frame_count;        /*!< Internal: cfg.fade_ms in samples */
+    uint32_t _conceal_state;           /*!< Internal: concealing flag, copy concealed and samples synthesized
+                                            since the loss started, 0 when not concealing */
+} audio_plc_instance_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Initialize the PLC processing stage.
+ *
+ *  @param[in] instance  PLC instance.
+ *  @param[in] mem_pool  Memory pool for memory allocation.
+ */
+void audio_plc_init(void *instance, mem_pool_t *mem_pool);
+
+/** @brief Deinitialize the PLC processing stage.
+ *
+ *  @param[in] instance  PLC instance.
+ */
+void audio_plc_deinit(void *instance);
+
+/** @brief Record an audio packet in the history and publish its last pitch period.
+ *
+ *  @note data_out can point to data_in, the stage can run in place.
+ *
+ *  @param[in]  instance     PLC instance.
+ *  @param[in]  header       Audio header.
+ *  @param[in]  data_in      Data in to be processed.
+ *  @param[in]  bytes_count  Number of bytes to process.
+ *  @param[out] data_out     Processed samples out.
+ *  @return Number of bytes processed. Return 0 if no samples processed.
+ */
+uint16_t audio_plc_process(void *instance, sac_header_t *header, uint8_t *data_in,
+                           uint16_t bytes_count, uint8_t *data_out);
+
+/** @brief Synthesize an audio payload replacing a lost packet.
+ *
+ *  @note Runs in O(bytes_count), the pitch is tracked by audio_plc_process().
+ *
+ *  @param[in]  instance     PLC instance.
+ *  @param[out] data_out     Synthesized samples out.
+ *  @param[in]  bytes_count  Number of bytes to synthesize.
+ *  @return Number of bytes synthesized. Return 0 if there is not enough history or the
+ *          synthesized waveform has faded out.
+ */
+uint16_t audio_plc_conceal(void *instance, uint8_t *data_out, uint16_t bytes_count);
+
+/** @brief PLC control function.
+ *
+ *  @param[in] instance  PLC instance.
+ *  @param[in] cmd       Control command.
+ *  @param[in] arg       Control argument.
+ *  @return Value returned dependent on command.
+ */
+uint32_t audio_plc_ctrl(void *instance, uint8_t cmd, uint32_t arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIO_PLC_H_ */
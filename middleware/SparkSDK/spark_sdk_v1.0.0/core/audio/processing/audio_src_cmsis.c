@@ -50,7 +50,10 @@ void audio_src_cmsis_init(void *instance, mem_pool_t *mem_pool)
     src_cmsis_instance_t *src_instance = (src_cmsis_instance_t *)instance;
     uint32_t block_size = src_instance->cfg.payload_size / (src_instance->cfg.bit_depth / 8);
 
-    fir_state = mem_pool_malloc(mem_pool, sizeof(int16_t) * (FIR_NUMTAPS + block_size));
+    fir_state = mem_pool_alloc(mem_pool, sizeof(int16_t) * (FIR_NUMTAPS + block_size),
+                               SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    src_instance->_mem_pool = mem_pool;
+    src_instance->_fir_state = fir_state;
 
     switch (src_instance->cfg.ratio) {
     case AUDIO_SRC_SIX:
@@ -77,7 +80,10 @@ void audio_src_cmsis_init(void *instance, mem_pool_t *mem_pool)
 
 void audio_src_cmsis_deinit(void *instance)
 {
-    (void)instance;
+    src_cmsis_instance_t *src_instance = (src_cmsis_instance_t *)instance;
+
+    mem_pool_release(src_instance->_mem_pool, src_instance->_fir_state);
+    src_instance->_fir_state = NULL;
 }
 
 uint32_t audio_src_cmsis_ctrl(void *instance, uint8_t cmd, uint32_t arg)
@@ -50,6 +50,8 @@ typedef struct src_cmsis_cfg {
 typedef struct src_cmsis_instance {
     src_cmsis_cfg_t cfg;                   /*!< SRC CMSIS user configuration */
     src_cmsis_fir_instance_t fir_instance; /*!< Instance for the arm_fir module */
+    mem_pool_t *_mem_pool;                 /*!< Internal: memory pool the FIR state comes from */
+    int16_t *_fir_state;                   /*!< Internal: FIR state */
 } src_cmsis_instance_t;
 
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
@@ -0,0 +1,358 @@
+/** @file  audio_src_rational.c
+ *  @brief Sampling rate converter processing stage for any rational ratio.
+ *
+ *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+
+/* INCLUDES *******************************************************************/
+#include "audio_src_rational.h"
+#include <math.h>
+#include <string.h>
+
+/* CONSTANTS ******************************************************************/
+#define FILTER_CUTOFF       0.8f /* Cutoff of the lowpass filter, relative to the lowest Nyquist frequency */
+#define FILTER_KAISER_BETA  6.0f /* About 60 dB of stopband attenuation */
+#define PI_F                3.14159265358979f
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static uint32_t get_gcd(uint32_t a, uint32_t b);
+static float bessel_i0(float x);
+static void generate_filter(audio_src_rational_instance_t *src);
+static uint16_t src_16bits(audio_src_rational_instance_t *src, int16_t *samples_in, uint16_t frame_count,
+                           int16_t *samples_out);
+static uint16_t src_32bits(audio_src_rational_instance_t *src, int32_t *samples_in, uint16_t frame_count,
+                           int32_t *samples_out);
+
+/* PUBLIC FUNCTIONS ***********************************************************/
+void audio_src_rational_init(void *instance, mem_pool_t *mem_pool)
+{
+    audio_src_rational_instance_t *src = (audio_src_rational_instance_t *)instance;
+    uint8_t word_size = (src->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE;
+    uint32_t gcd;
+
+    src->_interpolation = 0;
+    src->_decimation = 0;
+    if ((src->cfg.input_sample_rate == 0) || (src->cfg.output_sample_rate == 0)) {
+        return;
+    }
+    if (src->cfg.channel_count == 0) {
+        src->cfg.channel_count = 1;
+    } else if (src->cfg.channel_count > SAC_MAX_CHANNEL_COUNT) {
+        src->cfg.channel_count = SAC_MAX_CHANNEL_COUNT;
+    }
+
+    gcd = get_gcd(src->cfg.input_sample_rate, src->cfg.output_sample_rate);
+    if (((src->cfg.output_sample_rate / gcd) > AUDIO_SRC_RATIONAL_MAX_FACTOR) ||
+        ((src->cfg.input_sample_rate / gcd) > AUDIO_SRC_RATIONAL_MAX_FACTOR)) {
+        /* Unsupported ratio */
+        return;
+    }
+    src->_interpolation = src->cfg.output_sample_rate / gcd;
+    src->_decimation = src->cfg.input_sample_rate / gcd;
+    src->_step = src->_decimation / src->_interpolation;
+    src->_step_phase = src->_decimation % src->_interpolation;
+
+    if (src->_interpolation == src->_decimation) {
+        /* Same sampling rates, samples go through untouched */
+        return;
+    }
+
+    /* Decimation needs a longer filter for its narrower passband */
+    src->_tap_count = AUDIO_SRC_RATIONAL_TAPS;
+    if (src->_decimation > src->_interpolation) {
+        src->_tap_count = (AUDIO_SRC_RATIONAL_TAPS * src->_decimation + src->_interpolation - 1) / src->_interpolation;
+    }
+    src->_mem_pool = mem_pool;
+    src->_coeffs = mem_pool_alloc(mem_pool, src->_interpolation * src->_tap_count * sizeof(int16_t),
+                                  SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    src->_buffer_frame_count = (src->_tap_count - 1) + (src->cfg.payload_size / (word_size * src->cfg.channel_count));
+    src->_buffer = mem_pool_alloc(mem_pool, src->_buffer_frame_count * src->cfg.channel_count * word_size,
+                                  SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
+    if ((src->_coeffs == NULL) || (src->_buffer == NULL)) {
+        /* Out of memory, handled like an unsupported ratio */
+        audio_src_rational_deinit(src);
+        src->_interpolation = 0;
+        src->_decimation = 0;
+        return;
+    }
+    generate_filter(src);
+
+    audio_src_rational_ctrl(src, AUDIO_SRC_RATIONAL_RESET, 0);
+}
+
+void audio_src_rational_deinit(void *instance)
+{
+    audio_src_rational_instance_t *src = (audio_src_rational_instance_t *)instance;
+
+    mem_pool_release(src->_mem_pool, src->_coeffs);
+    mem_pool_release(src->_mem_pool, src->_buffer);
+    src->_coeffs = NULL;
+    src->_buffer = NULL;
+}
+
+uint32_t audio_src_rational_ctrl(void *instance, uint8_t cmd, uint32_t arg)
+{
+    (void)arg;
+    uint32_t ret = 0;
+    audio_src_rational_instance_t *src = (audio_src_rational_instance_t *)instance;
+    uint8_t word_size = (src->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE;
+
+    switch ((audio_src_rational_cmd_t)cmd) {
+    case AUDIO_SRC_RATIONAL_RESET:
+        if (src->_buffer != NULL) {
+            memset(src->_buffer, 0, (src->_tap_count - 1) * src->cfg.channel_count * word_size);
+        }
+        src->_position = src->_tap_count - 1;
+        src->_phase = 0;
+        break;
+    case AUDIO_SRC_RATIONAL_GET_INTERPOLATION:
+        ret = src->_interpolation;
+        break;
+    case AUDIO_SRC_RATIONAL_GET_DECIMATION:
+        ret = (src->_interpolation == 0) ? 0 : src->_decimation;
+        break;
+    }
+    return ret;
+}
+
+uint16_t audio_src_rational_process(void *instance, sac_header_t *header,
+                                    uint8_t *data_in, uint16_t bytes_count, uint8_t *data_out)
+{
+    (void)header;
+    audio_src_rational_instance_t *src = (audio_src_rational_instance_t *)instance;
+    uint8_t frame_size = ((src->cfg.bit_depth == AUDIO_16BITS) ? AUDIO_16BITS_BYTE : AUDIO_32BITS_BYTE) *
+                         src->cfg.channel_count;
+    uint16_t frame_count = bytes_count / frame_size;
+    uint16_t chunk_size;
+    uint16_t max_chunk_size;
+    uint16_t frame_count_out = 0;
+
+    /* Unsupported ratio or same sampling rates */
+    if (src->_interpolation == src->_decimation) {
+        return 0;
+    }
+
+    max_chunk_size = src->_buffer_frame_count - (src->_tap_count - 1);
+    if (max_chunk_size == 0) {
+        return 0;
+    }
+
+    /* The payload size can grow up to cfg.payload_size, convert in chunks the buffer can hold */
+    for (uint16_t frame = 0; frame < frame_count; frame += chunk_size) {
+        chunk_size = frame_count - frame;
+        if (chunk_size > max_chunk_size) {
+            chunk_size = max_chunk_size;
+        }
+        if (src->cfg.bit_depth == AUDIO_16BITS) {
+            frame_count_out += src_16bits(src, (int16_t *)(data_in + frame * frame_size), chunk_size,
+                                          (int16_t *)(data_out + frame_count_out * frame_size));
+        } else {
+            frame_count_out += src_32bits(src, (int32_t *)(data_in + frame * frame_size), chunk_size,
+                                          (int32_t *)(data_out + frame_count_out * frame_size));
+        }
+    }
+
+    return frame_count_out * frame_size;
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Get the greatest common divisor of two numbers.
+ *
+ *  @param[in] a  First number.
+ *  @param[in] b  Second number.
+ *  @return Greatest common divisor.
+ */
+static uint32_t get_gcd(uint32_t a, uint32_t b)
+{
+    uint32_t tmp;
+
+    while (b != 0) {
+        tmp = a % b;
+        a = b;
+        b = tmp;
+    }
+
+    return a;
+}
+
+/** @brief Zeroth order modified Bessel function of the first kind.
+ *
+ *  @param[in] x  Function argument.
+ *  @return I0(x).
+ */
+static float bessel_i0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    float half_x = x / 2.0f;
+
+    for (uint8_t k = 1; k < 32; k++) {
+        term *= (half_x / k) * (half_x / k);
+        sum += term;
+        if (term < (sum * 1e-7f)) {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+/** @brief Generate the polyphase filter coefficients.
+ *
+ *  The filter runs at L times the input sampling rate with L * taps per phase taps.
+ *  Tap k of phase p is tap k * L + p of the filter, stored in reverse order so that the
+ *  samples in are read forward. Each phase is scaled by L to make up for the zeros the
+ *  interpolation inserts.
+ *
+ *  @param[in] src  SRC rational instance.
+ */
+static void generate_filter(audio_src_rational_instance_t *src)
+{
+    uint16_t interpolation = src->_interpolation;
+    uint16_t tap_count = src->_tap_count;
+    uint32_t filter_length = (uint32_t)interpolation * tap_count;
+    float cutoff = FILTER_CUTOFF / ((interpolation > src->_decimation) ? interpolation : src->_decimation);
+    float i0_beta = bessel_i0(FILTER_KAISER_BETA);
+    float center = (filter_length - 1) / 2.0f;
+    float t, window, coeff;
+    uint32_t n;
+
+    for (uint16_t phase = 0; phase < interpolation; phase++) {
+        for (uint16_t k = 0; k < tap_count; k++) {
+            n = (uint32_t)k * interpolation + phase;
+            t = ((float)n - center) / center;
+            window = bessel_i0(FILTER_KAISER_BETA * sqrtf(1.0f - t * t)) / i0_beta;
+            t = ((float)n - center) * cutoff;
+            coeff = (t == 0.0f) ? cutoff : (sinf(PI_F * t) / (PI_F * t)) * cutoff;
+            coeff *= window * interpolation * 32768.0f;
+            if (coeff > 32767.0f) {
+                coeff = 32767.0f;
+            } else if (coeff < -32768.0f) {
+                coeff = -32768.0f;
+            }
+            src->_coeffs[phase * tap_count + (tap_count - 1 - k)] =
+                (int16_t)((coeff >= 0.0f) ? (coeff + 0.5f) : (coeff - 0.5f));
+        }
+    }
+}
+
+/** @brief Convert 16-bit samples.
+ *
+ *  @param[in]  src          SRC rational instance.
+ *  @param[in]  samples_in   Interleaved samples in.
+ *  @param[in]  frame_count  Number of samples in per channel, fitting the buffer.
+ *  @param[out] samples_out  Interleaved samples out.
+ *  @return Number of samples out per channel.
+ */
+static uint16_t src_16bits(audio_src_rational_instance_t *src, int16_t *samples_in, uint16_t frame_count,
+                           int16_t *samples_out)
+{
+    uint8_t channel_count = src->cfg.channel_count;
+    uint16_t tap_count = src->_tap_count;
+    uint16_t history_count = tap_count - 1;
+    uint16_t end = history_count + frame_count;
+    uint16_t position = src->_position;
+    uint16_t phase = src->_phase;
+    uint16_t frame_count_out = 0;
+    int16_t *buffer = src->_buffer;
+    const int16_t *coeffs;
+    const int16_t *samples;
+    int32_t acc;
+
+    memcpy(buffer + history_count * channel_count, samples_in, frame_count * channel_count * sizeof(int16_t));
+
+    while (position < end) {
+        coeffs = src->_coeffs + phase * tap_count;
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            samples = buffer + (position - history_count) * channel_count + ch;
+            acc = 0;
+            for (uint16_t k = 0; k < tap_count; k++) {
+                acc += (int32_t)coeffs[k] * samples[k * channel_count];
+            }
+            acc >>= 15;
+            if (acc > INT16_MAX) {
+                acc = INT16_MAX;
+            } else if (acc < INT16_MIN) {
+                acc = INT16_MIN;
+            }
+            *samples_out++ = (int16_t)acc;
+        }
+        frame_count_out++;
+
+        position += src->_step;
+        phase += src->_step_phase;
+        if (phase >= src->_interpolation) {
+            phase -= src->_interpolation;
+            position++;
+        }
+    }
+
+    /* Keep the last samples in as history for the next packet */
+    memmove(buffer, buffer + frame_count * channel_count, history_count * channel_count * sizeof(int16_t));
+    src->_position = position - frame_count;
+    src->_phase = phase;
+
+    return frame_count_out;
+}
+
+/** @brief Convert 20-bit or 24-bit samples.
+ *
+ *  @param[in]  src          SRC rational instance.
+ *  @param[in]  samples_in   Interleaved samples in.
+ *  @param[in]  frame_count  Number of samples in per channel, fitting the buffer.
+ *  @param[out] samples_out  Interleaved samples out.
+ *  @return Number of samples out per channel.
+ */
+static uint16_t src_32bits(audio_src_rational_instance_t *src, int32_t *samples_in, uint16_t frame_count,
+                           int32_t *samples_out)
+{
+    uint8_t channel_count = src->cfg.channel_count;
+    uint16_t tap_count = src->_tap_count;
+    uint16_t history_count = tap_count - 1;
+    uint16_t end = history_count + frame_count;
+    uint16_t position = src->_position;
+    uint16_t phase = src->_phase;
+    uint16_t frame_count_out = 0;
+    int32_t max = (1L << (src->cfg.bit_depth - 1)) - 1;
+    int32_t *buffer = src->_buffer;
+    const int16_t *coeffs;
+    const int32_t *samples;
+    int64_t acc;
+
+    memcpy(buffer + history_count * channel_count, samples_in, frame_count * channel_count * sizeof(int32_t));
+
+    while (position < end) {
+        coeffs = src->_coeffs + phase * tap_count;
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            samples = buffer + (position - history_count) * channel_count + ch;
+            acc = 0;
+            for (uint16_t k = 0; k < tap_count; k++) {
+                acc += (int64_t)coeffs[k] * samples[k * channel_count];
+            }
+            acc >>= 15;
+            if (acc > max) {
+                acc = max;
+            } else if (acc < -max - 1) {
+                acc = -max - 1;
+            }
+            *samples_out++ = (int32_t)acc;
+        }
+        frame_count_out++;
+
+        position += src->_step;
+        phase += src->_step_phase;
+        if (phase >= src->_interpolation) {
+            phase -= src->_interpolation;
+            position++;
+        }
+    }
+
+    memmove(buffer, buffer + frame_count * channel_count, history_count * channel_count * sizeof(int32_t));
+    src->_position = position - frame_count;
+    src->_phase = phase;
+
+    return frame_count_out;
+}
@@ -0,0 +1,118 @@
+/** @file  audio_src_rational.h
+ *  @brief Sampling rate converter processing stage for any rational ratio.
+ *
+ *  The stage converts from input_sample_rate to output_sample_rate by interpolating by L
+ *  and decimating by M, where L / M is the ratio reduced to its lowest terms (160 / 147
+ *  from 44.1 kHz to 48 kHz). The Kaiser windowed-sinc lowpass filter is generated at
+ *  initialization and split in L phases, only the output samples are computed.
+ *
+ *  The filter takes L * taps per phase 16-bit coefficients from the memory pool, where the
+ *  taps per phase are AUDIO_SRC_RATIONAL_TAPS, scaled by M / L when decimating.
+ *
+ *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef AUDIO_SRC_RATIONAL_H_
+#define AUDIO_SRC_RATIONAL_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdint.h>
+#include "sac_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#ifndef AUDIO_SRC_RATIONAL_TAPS
+#define AUDIO_SRC_RATIONAL_TAPS       24  /*!< Taps per phase of the filter when interpolating */
+#endif
+
+#ifndef AUDIO_SRC_RATIONAL_MAX_FACTOR
+#define AUDIO_SRC_RATIONAL_MAX_FACTOR 160 /*!< Largest interpolation or decimation factor supported */
+#endif
+
+/* TYPES **********************************************************************/
+/** @brief SRC Rational Commands.
+ */
+typedef enum audio_src_rational_cmd {
+    AUDIO_SRC_RATIONAL_RESET,                /*!< Clear the filter history, for a discontinuity in the stream */
+    AUDIO_SRC_RATIONAL_GET_INTERPOLATION,    /*!< Get the interpolation factor L, 0 if the ratio is not supported
+                                                  or the memory could not be allocated */
+    AUDIO_SRC_RATIONAL_GET_DECIMATION        /*!< Get the decimation factor M, 0 if the ratio is not supported
+                                                  or the memory could not be allocated */
+} audio_src_rational_cmd_t;
+
+/** @brief SRC Rational Configuration.
+ */
+typedef struct audio_src_rational_cfg {
+    uint32_t input_sample_rate;  /*!< Sampling rate of the samples in, in Hz */
+    uint32_t output_sample_rate; /*!< Sampling rate of the samples out, in Hz */
+    sac_bit_depth_t bit_depth;   /*!< Bit depth selected from the sac_bit_depth_t enum */
+    uint8_t channel_count;       /*!< 1 for mono and 2 for interleaved stereo payloads */
+    uint16_t payload_size;       /*!< Maximum size of the payload in bytes expected at input */
+} audio_src_rational_cfg_t;
+
+/** @brief SRC Rational Instance.
+ */
+typedef struct audio_src_rational_instance {
+    audio_src_rational_cfg_t cfg; /*!< SRC rational user configuration */
+    mem_pool_t *_mem_pool;        /*!< Internal: memory pool the coefficients and buffer come from */
+    int16_t *_coeffs;             /*!< Internal: coefficients in Q15, phase after phase, in reverse order */
+    void *_buffer;                /*!< Internal: filter history followed by the samples in */
+    uint16_t _interpolation;      /*!< Internal: interpolation factor L, 0 if the ratio is not supported */
+    uint16_t _decimation;         /*!< Internal: decimation factor M */
+    uint16_t _tap_count;          /*!< Internal: taps per phase */
+    uint16_t _buffer_frame_count; /*!< Internal: number of samples in per channel the buffer holds */
+    uint16_t _step;               /*!< Internal: samples in to skip between two samples out */
+    uint16_t _step_phase;         /*!< Internal: phases to advance between two samples out */
+    uint16_t _position;           /*!< Internal: index in the buffer of the next sample out */
+    uint16_t _phase;              /*!< Internal: phase of the next sample out */
+} audio_src_rational_instance_t;
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Initialize the SRC rational processing stage.
+ *
+ *  @param[in] instance  SRC rational instance.
+ *  @param[in] mem_pool  Memory pool for memory allocation.
+ */
+void audio_src_rational_init(void *instance, mem_pool_t *mem_pool);
+
+/** @brief Deinitialize the SRC rational processing stage.
+ *
+ *  @param[in] instance  SRC rational instance.
+ */
+void audio_src_rational_deinit(void *instance);
+
+/** @brief Process SRC on an audio packet.
+ *
+ *  The number of samples out varies by one from a packet to the next when the payload
+ *  is not a multiple of M samples per channel. The samples in are copied before any
+ *  sample out is written, so data_out can point to data_in if it can hold the samples out.
+ *
+ *  @param[in]  instance     SRC rational instance.
+ *  @param[in]  header       Audio header.
+ *  @param[in]  data_in      Data in to be processed.
+ *  @param[in]  bytes_count  Number of bytes to process.
+ *  @param[out] data_out     Processed samples out.
+ *  @return Number of bytes out. Return 0 if no samples processed.
+ */
+uint16_t audio_src_rational_process(void *instance, sac_header_t *header, uint8_t *data_in,
+                                    uint16_t bytes_count, uint8_t *data_out);
+
+/** @brief SRC rational control function.
+ *
+ *  @param[in] instance  SRC rational instance.
+ *  @param[in] cmd       Control command.
+ *  @param[in] arg       Control argument.
+ *  @return Value returned dependent on command.
+ */
+uint32_t audio_src_rational_ctrl(void *instance, uint8_t cmd, uint32_t arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIO_SRC_RATIONAL_H_ */
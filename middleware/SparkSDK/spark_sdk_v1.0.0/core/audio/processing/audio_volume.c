@@ -9,18 +9,25 @@
 
 /* INCLUDES *******************************************************************/
 #include <string.h>
+#include "arm_math.h"
 #include "audio_volume.h"
 
+/* CONSTANTS ******************************************************************/
+#define GAIN_FRAC_BITS     30 /* Gains are in Q2.30 format so a unity gain is representable */
+#define GAIN_Q16_FRAC_BITS 16 /* 16-bit samples use a Q15.16 gain so the product fits in 32 bits */
+
 /* PRIVATE FUNCTION PROTOTYPES ************************************************/
 static void audio_volume_increase(audio_volume_instance_t *volume_ctrl);
 static void audio_volume_decrease(audio_volume_instance_t *volume_ctrl);
 static void audio_volume_mute(audio_volume_instance_t *volume_ctrl);
 static float audio_volume_get_level(audio_volume_instance_t *volume_ctrl);
 static void adjust_volume_factor(audio_volume_instance_t *volume);
-static void apply_volume_factor_16bits(int16_t *audio_samples_in, uint16_t samples_count,
-                                       int16_t *audio_samples_out, float volume_factor);
-static void apply_volume_factor_32bits(int32_t *audio_samples_in, uint16_t samples_count,
-                                       int32_t *audio_samples_out, float volume_factor);
+static int32_t volume_factor_to_gain(float volume_factor);
+static void apply_volume_gain_16bits(int16_t *audio_samples_in, uint16_t frame_count, uint8_t channel_count,
+                                     int16_t *audio_samples_out, int32_t gain_start, int32_t gain_end);
+static void apply_volume_gain_32bits(int32_t *audio_samples_in, uint16_t frame_count, uint8_t channel_count,
+                                     int32_t *audio_samples_out, int32_t gain_start, int32_t gain_end,
+                                     uint8_t bit_depth);
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 void audio_volume_init(void *instance, mem_pool_t *mem_pool)
@@ -67,17 +74,24 @@ uint16_t audio_volume_process(void *instance, sac_header_t *header,
 {
     (void)header;
     audio_volume_instance_t *vol_inst = (audio_volume_instance_t *)instance;
+    uint8_t channel_count = (vol_inst->channel_count == 0) ? 1 : vol_inst->channel_count;
+    int32_t gain_start, gain_end;
 
     if ((vol_inst->_volume_threshold != AUDIO_VOLUME_MAX) || (vol_inst->_volume_factor != AUDIO_VOLUME_MAX)) {
+        /* Ramp the gain over the block from the previous factor to the adjusted one */
+        gain_start = volume_factor_to_gain(vol_inst->_volume_factor);
         adjust_volume_factor(vol_inst);
+        gain_end = volume_factor_to_gain(vol_inst->_volume_factor);
 
         switch (vol_inst->bit_depth) {
         case AUDIO_16BITS:
-            apply_volume_factor_16bits((int16_t *)data_in, (size / AUDIO_16BITS_BYTE), (int16_t *)data_out, vol_inst->_volume_factor);
+            apply_volume_gain_16bits((int16_t *)data_in, (size / AUDIO_16BITS_BYTE / channel_count), channel_count,
+                                     (int16_t *)data_out, gain_start, gain_end);
             break;
         case AUDIO_20BITS:
         case AUDIO_24BITS:
-            apply_volume_factor_32bits((int32_t *)data_in, (size / AUDIO_32BITS_BYTE), (int32_t *)data_out, vol_inst->_volume_factor);
+            apply_volume_gain_32bits((int32_t *)data_in, (size / AUDIO_32BITS_BYTE / channel_count), channel_count,
+                                     (int32_t *)data_out, gain_start, gain_end, vol_inst->bit_depth);
             break;
         default:
             return 0;
@@ -155,36 +169,102 @@ static void adjust_volume_factor(audio_volume_instance_t *instance)
     }
 }
 
-/** @brief Process a volume factor on each sample.
+/** @brief Convert a volume factor to a fixed point gain.
+ *
+ *  @param[in] volume_factor  Volume factor between AUDIO_VOLUME_MIN and AUDIO_VOLUME_MAX.
+ *  @return Gain in Q2.30 format.
+ */
+static int32_t volume_factor_to_gain(float volume_factor)
+{
+    return (int32_t)(volume_factor * (1 << GAIN_FRAC_BITS));
+}
+
+/** @brief Apply a linearly ramped gain on each frame.
+ *
+ *  Every sample of a frame gets the same gain. The result is saturated to 16 bits.
+ *  When the DSP extension is available, two samples of a frame are loaded and stored per word.
  *
  *  @param[in]  audio_samples_in   16bits samples pointer of data in.
- *  @param[in]  samples_count      Number of samples to process.
- *  @param[out] audio_samples_out  16bits samples pointer of data out.
- *  @param[in]  volume_factor      Volume factor to apply.
+ *  @param[in]  frame_count        Number of frames to process.
+ *  @param[in]  channel_count      Number of interleaved samples per frame.
+ *  @param[out] audio_samples_out  16bits samples pointer of data out, can be audio_samples_in.
+ *  @param[in]  gain_start         Gain at the start of the block, in Q2.30 format.
+ *  @param[in]  gain_end           Gain at the end of the block, in Q2.30 format.
  */
-static void apply_volume_factor_16bits(int16_t *audio_samples_in, uint16_t samples_count,
-                                       int16_t *audio_samples_out, float volume_factor)
+static void apply_volume_gain_16bits(int16_t *audio_samples_in, uint16_t frame_count, uint8_t channel_count,
+                                     int16_t *audio_samples_out, int32_t gain_start, int32_t gain_end)
 {
-    uint16_t count;
+    uint16_t frame;
+    uint8_t channel;
+    int32_t gain = gain_start;
+    int32_t gain_step = 0;
+    int32_t gain_q16;
 
-    for (count = 0; count < samples_count; count++) {
-        audio_samples_out[count] = audio_samples_in[count] * volume_factor;
+    if (frame_count != 0) {
+        gain_step = (gain_end - gain_start) / frame_count;
+    }
+    for (frame = 0; frame < frame_count; frame++) {
+        gain += gain_step;
+        gain_q16 = gain >> (GAIN_FRAC_BITS - GAIN_Q16_FRAC_BITS);
+        channel = 0;
+#if defined(ARM_MATH_DSP)
+        q31_t samples;
+
+        for (; (channel + 1) < channel_count; channel += 2) {
+            samples = read_q15x2(&audio_samples_in[channel]);
+            write_q15x2(&audio_samples_out[channel],
+                        __PKHBT(__SSAT(((q15_t)samples * gain_q16) >> GAIN_Q16_FRAC_BITS, 16),
+                                __SSAT(((samples >> 16) * gain_q16) >> GAIN_Q16_FRAC_BITS, 16), 16));
+        }
+#endif
+        for (; channel < channel_count; channel++) {
+            audio_samples_out[channel] = clip_q31_to_q15((audio_samples_in[channel] * gain_q16) >> GAIN_Q16_FRAC_BITS);
+        }
+        audio_samples_in += channel_count;
+        audio_samples_out += channel_count;
     }
 }
 
-/** @brief Process a volume factor on each sample.
+/** @brief Apply a linearly ramped gain on each frame.
+ *
+ *  Every sample of a frame gets the same gain. The result is saturated to the bit depth
+ *  of the samples, which are right-justified and sign extended in 32 bits.
  *
  *  @param[in]  audio_samples_in   32bits samples pointer of data in.
- *  @param[in]  samples_count      Number of samples to process.
- *  @param[out] audio_samples_out  32bits samples pointer of data out.
- *  @param[in]  volume_factor      Volume factor to apply.
+ *  @param[in]  frame_count        Number of frames to process.
+ *  @param[in]  channel_count      Number of interleaved samples per frame.
+ *  @param[out] audio_samples_out  32bits samples pointer of data out, can be audio_samples_in.
+ *  @param[in]  gain_start         Gain at the start of the block, in Q2.30 format.
+ *  @param[in]  gain_end           Gain at the end of the block, in Q2.30 format.
+ *  @param[in]  bit_depth          Bit depth of the samples.
  */
-static void apply_volume_factor_32bits(int32_t *audio_samples_in, uint16_t samples_count,
-                                       int32_t *audio_samples_out, float volume_factor)
+static void apply_volume_gain_32bits(int32_t *audio_samples_in, uint16_t frame_count, uint8_t channel_count,
+                                     int32_t *audio_samples_out, int32_t gain_start, int32_t gain_end,
+                                     uint8_t bit_depth)
 {
-    uint16_t count;
+    const q63_t sample_max = (1 << (bit_depth - 1)) - 1;
+    const q63_t sample_min = -(1 << (bit_depth - 1));
+    uint16_t frame;
+    uint8_t channel;
+    int32_t gain = gain_start;
+    int32_t gain_step = 0;
+    q63_t sample;
 
-    for (count = 0; count < samples_count; count++) {
-        audio_samples_out[count] = audio_samples_in[count] * volume_factor;
+    if (frame_count != 0) {
+        gain_step = (gain_end - gain_start) / frame_count;
+    }
+    for (frame = 0; frame < frame_count; frame++) {
+        gain += gain_step;
+        for (channel = 0; channel < channel_count; channel++) {
+            sample = ((q63_t)audio_samples_in[channel] * gain) >> GAIN_FRAC_BITS;
+            if (sample > sample_max) {
+                sample = sample_max;
+            } else if (sample < sample_min) {
+                sample = sample_min;
+            }
+            audio_samples_out[channel] = (int32_t)sample;
+        }
+        audio_samples_in += channel_count;
+        audio_samples_out += channel_count;
     }
 }
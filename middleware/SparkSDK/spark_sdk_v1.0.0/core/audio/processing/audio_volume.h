@@ -39,6 +39,8 @@ typedef enum audio_volume_cmd {
  */
 typedef struct audio_volume_instance {
     sac_bit_depth_t bit_depth;    /*!< Bit depth selected from the sac_bit_depth_t enum */
+    uint8_t channel_count;        /*!< Number of interleaved channels, all samples of a frame get the same gain.
+                                       0 is treated as 1 */
     uint8_t initial_volume_level; /*!< Initial volume level from 0 to 100 */
     float   _volume_factor;       /*!< Internal: factor used for calculation */
     float   _volume_threshold;    /*!< Internal: threshold set by user that _volume_factor will tend towards */
@@ -59,6 +61,8 @@ void audio_volume_init(void *instance, mem_pool_t *mem_pool);
 void audio_volume_deinit(void *instance);
 
 /** @brief Process volume on each audio sample.
+ *
+ *  @note data_out can point to data_in, the stage can run in place.
  *
  *  @param[in]  volume       Volume instance.
  *  @param[in]  header       Audio header.
@@ -12,11 +12,30 @@
 #include <string.h>
 #include "audio_cdc_module.h"
 #include "audio_fallback_module.h"
+#if (SAC_PROFILING_EN > 0U) && !defined(__arm__)
+#include <time.h>
+#endif
 
 /* CONSTANTS ******************************************************************/
 #define CDC_QUEUE_DATA_SIZE_INFLATION      (SAC_MAX_CHANNEL_COUNT * AUDIO_32BITS_BYTE)
 #define PROD_QUEUE_SIZE_MIN_WHEN_ENQUEUING 0
 #define TX_QUEUE_HIGH_LEVEL                2
+#define ZERO_COPY_QUEUE_SIZE_INFLATION     2 /* Nodes used as processing and CDC destination */
+#define DWT_CTRL_CYCCNTENA                 (1UL << 0)  /* DWT_CTRL cycle counter enable */
+#define DEMCR_TRCENA                       (1UL << 24) /* DEMCR trace enable, needed for the DWT */
+
+/* MACROS *********************************************************************/
+#define DWT_CTRL   (*(volatile uint32_t *)0xE0001000) /* Data Watchpoint and Trace control register */
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004) /* Data Watchpoint and Trace cycle counter */
+#define DEMCR      (*(volatile uint32_t *)0xE000EDFC) /* Debug Exception and Monitor Control Register */
+
+#if (SAC_PROFILING_EN > 0U)
+#define PROFILE_BEGIN(start)      uint32_t start = get_cycles()
+#define PROFILE_END(stats, start) update_cycles_stats(&(stats), get_cycles() - (start))
+#else
+#define PROFILE_BEGIN(start)
+#define PROFILE_END(stats, start)
+#endif
 
 /* PRIVATE GLOBALS ************************************************************/
 static mem_pool_t mem_pool;
@@ -24,23 +43,49 @@ static audio_mixer_module_t *audio_mixer_module;
 
 /* PRIVATE FUNCTION PROTOTYPES ************************************************/
 static void init_audio_queues(sac_pipeline_t *pipeline, sac_error_t *err);
+static void init_zero_copy_audio_queues(sac_pipeline_t *pipeline, uint16_t queue_data_size, sac_error_t *err);
 static void init_audio_free_queue(sac_endpoint_t *endpoint, const char *queue_name,
                                   uint16_t queue_data_size, uint8_t queue_size, sac_error_t *err);
+static void init_endpoint_queue(sac_endpoint_t *endpoint, const char *queue_name, uint8_t queue_size, sac_error_t *err);
+static void init_lent_queue(sac_endpoint_t *consumer, sac_error_t *err);
+static void release_queue(queue_t *queue);
+static uint8_t get_lent_queue_size(sac_pipeline_t *pipeline);
 static void move_audio_packet_to_consumer_queue(sac_pipeline_t *pipeline, queue_node_t *node);
+static void link_audio_packet_to_consumer_queue(sac_pipeline_t *pipeline, queue_node_t *node);
+static void enqueue_consumer_node(sac_pipeline_t *pipeline, queue_node_t *node);
+static uint16_t seal_audio_packet(sac_pipeline_t *pipeline, queue_node_t *node, bool queue_level_high);
+static bool get_consumer_queue_level_high(sac_pipeline_t *pipeline);
 static queue_node_t *process_samples(sac_pipeline_t *pipeline, queue_node_t *node);
+static queue_node_t *start_crossfade(sac_pipeline_t *pipeline, queue_node_t *node);
+static void end_crossfade(sac_pipeline_t *pipeline, sac_processing_t *process, queue_node_t *dry_node,
+                          queue_node_t *wet_node, bool fade_in);
 static void enqueue_producer_node(sac_endpoint_t *producer, sac_error_t *err);
 static uint16_t produce(sac_pipeline_t *pipeline, sac_error_t *err);
 static uint16_t consume(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sac_error_t *err);
 static void consume_no_delay(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sac_error_t *err);
 static void consume_delay(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sac_error_t *err);
+static sac_processing_t *get_concealment_stage(sac_pipeline_t *pipeline);
+static queue_node_t *conceal_packet_loss(sac_pipeline_t *pipeline, sac_endpoint_t *consumer);
 static void validate_pipeline_config(sac_pipeline_t *pipeline, sac_error_t *err);
 static queue_node_t *start_mixing_process(sac_pipeline_t *pipeline, queue_node_t *node);
+static uint8_t get_header_crc4(const sac_header_t *header);
+#if (SAC_PROFILING_EN > 0U)
+static inline uint32_t get_cycles(void);
+static void update_cycles_stats(sac_cycles_stats_t *stats, uint32_t cycles);
+static sac_cycles_stats_t *get_consumer_profile(sac_pipeline_t *pipeline, sac_endpoint_t *consumer);
+#endif
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 void sac_init(queue_critical_cfg_t queue_critical, uint8_t *queue_memory, uint32_t queue_memory_size)
 {
     queue_init(queue_critical);
     mem_pool_init(&mem_pool, queue_memory, (size_t)queue_memory_size);
+#if (SAC_PROFILING_EN > 0U) && defined(__arm__)
+    /* Start the cycle counter */
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
 }
 
 void sac_mixer_module_init(audio_mixer_module_cfg_t cfg, sac_error_t *err)
@@ -50,6 +95,11 @@ void sac_mixer_module_init(audio_mixer_module_cfg_t cfg, sac_error_t *err)
     audio_mixer_module = audio_mixer_module_init(cfg, &mem_pool, err);
 }
 
+void sac_mixer_module_set_input_gain(uint8_t input, int16_t gain)
+{
+    audio_mixer_module_set_input_gain(audio_mixer_module, input, gain);
+}
+
 void sac_fallback_module_init(sac_fallback_module_cfg_t cfg, sac_error_t *err)
 {
     *err = SAC_ERR_NONE;
@@ -62,7 +112,8 @@ sac_pipeline_t *sac_pipeline_init(const char *name, sac_endpoint_t *producer,
 {
     *err = SAC_ERR_NONE;
 
-    sac_pipeline_t *pipeline = (sac_pipeline_t *)mem_pool_malloc(&mem_pool, sizeof(sac_pipeline_t));
+    sac_pipeline_t *pipeline = (sac_pipeline_t *)mem_pool_alloc(&mem_pool, sizeof(sac_pipeline_t),
+                                                                 SAC_MEM_POOL_OWNER_PIPELINE, MEM_POOL_FLAG_NONE);
     if (pipeline == NULL) {
         *err = SAC_ERR_NOT_ENOUGH_MEMORY;
         return NULL;
@@ -80,14 +131,17 @@ sac_endpoint_t *sac_endpoint_init(void *instance, const char *name, sac_endpoint
 {
     *err = SAC_ERR_NONE;
 
-    sac_endpoint_t *endpoint = (sac_endpoint_t *)mem_pool_malloc(&mem_pool, sizeof(sac_endpoint_t));
+    sac_endpoint_t *endpoint = (sac_endpoint_t *)mem_pool_alloc(&mem_pool, sizeof(sac_endpoint_t),
+                                                                 SAC_MEM_POOL_OWNER_PIPELINE, MEM_POOL_FLAG_NONE);
     if (endpoint == NULL) {
         *err = SAC_ERR_NOT_ENOUGH_MEMORY;
         return NULL;
     }
 
-    queue_t *queue = (queue_t *)mem_pool_malloc(&mem_pool, sizeof(queue_t));
+    queue_t *queue = (queue_t *)mem_pool_alloc(&mem_pool, sizeof(queue_t), SAC_MEM_POOL_OWNER_PIPELINE,
+                                               MEM_POOL_FLAG_NONE);
     if (queue == NULL) {
+        mem_pool_release(&mem_pool, endpoint);
         *err = SAC_ERR_NOT_ENOUGH_MEMORY;
         return NULL;
     }
@@ -96,15 +150,42 @@ sac_endpoint_t *sac_endpoint_init(void *instance, const char *name, sac_endpoint
     endpoint->name = name;
     endpoint->iface = iface;
     endpoint->cfg = cfg;
+    if (endpoint->cfg.max_audio_payload_size < endpoint->cfg.audio_payload_size) {
+        endpoint->cfg.max_audio_payload_size = endpoint->cfg.audio_payload_size;
+    }
     endpoint->next_endpoint = NULL;
     endpoint->_queue = queue;
     endpoint->_free_queue = NULL;
     endpoint->_current_node = NULL;
     endpoint->_buffering_complete = false;
+    endpoint->_lent_queue = NULL;
+    endpoint->_free_queue_pool = NULL;
+    endpoint->_queue_linked = false;
 
     return endpoint;
 }
 
+void sac_pipeline_deinit(sac_pipeline_t *pipeline)
+{
+    mem_pool_release(&mem_pool, pipeline);
+}
+
+void sac_endpoint_deinit(sac_endpoint_t *endpoint)
+{
+    if (endpoint == NULL) {
+        return;
+    }
+    if (!endpoint->_queue_linked) {
+        release_queue(endpoint->_queue);
+    }
+    release_queue(endpoint->_lent_queue);
+    if (endpoint->_free_queue_pool != NULL) {
+        release_queue(endpoint->_free_queue);
+        mem_pool_release(&mem_pool, endpoint->_free_queue_pool);
+    }
+    mem_pool_release(&mem_pool, endpoint);
+}
+
 void sac_endpoint_link(sac_endpoint_t *consumer, sac_endpoint_t *producer, sac_error_t *err)
 {
     *err = SAC_ERR_NONE;
@@ -112,8 +193,13 @@ void sac_endpoint_link(sac_endpoint_t *consumer, sac_endpoint_t *producer, sac_e
     if (consumer == NULL || producer == NULL) {
         *err = SAC_ERR_NULL_PTR;
     } else {
+        if (!producer->_queue_linked) {
+            /* The producer queue is replaced by the consumer one */
+            release_queue(producer->_queue);
+        }
         producer->_queue = consumer->_queue;
         producer->_free_queue = consumer->_free_queue;
+        producer->_queue_linked = true;
     }
 }
 
@@ -121,7 +207,8 @@ sac_processing_t *sac_processing_stage_init(void *instance, const char *name, sa
 {
     *err = SAC_ERR_NONE;
 
-    sac_processing_t *process = (sac_processing_t *)mem_pool_malloc(&mem_pool, sizeof(sac_processing_t));
+    sac_processing_t *process = (sac_processing_t *)mem_pool_alloc(&mem_pool, sizeof(sac_processing_t),
+                                                                   SAC_MEM_POOL_OWNER_PROCESSING, MEM_POOL_FLAG_NONE);
     if (process == NULL) {
         *err = SAC_ERR_NOT_ENOUGH_MEMORY;
         return NULL;
@@ -134,6 +221,17 @@ sac_processing_t *sac_processing_stage_init(void *instance, const char *name, sa
     return process;
 }
 
+void sac_processing_stage_deinit(sac_processing_t *process)
+{
+    if (process == NULL) {
+        return;
+    }
+    if (process->_initialized && (process->iface.deinit != NULL)) {
+        process->iface.deinit(process->instance);
+    }
+    mem_pool_release(&mem_pool, process);
+}
+
 void sac_pipeline_add_processing(sac_pipeline_t *pipeline, sac_processing_t *process)
 {
     sac_processing_t *current_process = pipeline->process;
@@ -151,6 +249,137 @@ void sac_pipeline_add_processing(sac_pipeline_t *pipeline, sac_processing_t *pro
     current_process->next_process = process;
 }
 
+void sac_pipeline_insert_processing(sac_pipeline_t *pipeline, sac_processing_t *process,
+                                    sac_processing_t *previous, sac_error_t *err)
+{
+    sac_processing_t *next_process;
+
+    *err = SAC_ERR_NONE;
+
+    if (process == NULL) {
+        *err = SAC_ERR_NULL_PTR;
+        return;
+    }
+    next_process = (previous == NULL) ? pipeline->process : previous->next_process;
+    if (((previous != NULL) && (previous->iface.conceal != NULL)) ||
+        ((process->iface.conceal != NULL) && (next_process != NULL))) {
+        /* A concealing stage must stay last, its synthesized payloads skip the stages after it */
+        *err = SAC_ERR_PIPELINE_CFG_INVALID;
+        return;
+    }
+
+    if (!process->_initialized) {
+        if (process->iface.init != NULL) {
+            process->iface.init(process->instance, &mem_pool);
+        }
+        process->_initialized = true;
+    }
+
+    /* Link the stage before publishing it, so the pipeline never sees a partial chain */
+    process->next_process = next_process;
+    if (previous == NULL) {
+        __atomic_store_n(&pipeline->process, process, __ATOMIC_RELEASE);
+    } else {
+        __atomic_store_n(&previous->next_process, process, __ATOMIC_RELEASE);
+    }
+}
+
+void sac_pipeline_remove_processing(sac_pipeline_t *pipeline, sac_processing_t *process, sac_error_t *err)
+{
+    sac_processing_t *current_process = pipeline->process;
+
+    *err = SAC_ERR_NONE;
+
+    if (process == NULL) {
+        *err = SAC_ERR_NULL_PTR;
+        return;
+    }
+    if (current_process == process) {
+        __atomic_store_n(&pipeline->process, process->next_process, __ATOMIC_RELEASE);
+        return;
+    }
+
+    while ((current_process != NULL) && (current_process->next_process != process)) {
+        current_process = current_process->next_process;
+    }
+    if (current_process == NULL) {
+        *err = SAC_ERR_PIPELINE_CFG_INVALID;
+        return;
+    }
+
+    /* The removed stage keeps its next pointer for a concealing stage search that may be going through it */
+    __atomic_store_n(&current_process->next_process, process->next_process, __ATOMIC_RELEASE);
+}
+
+void sac_processing_set_bypass(sac_processing_t *process, bool bypass, bool crossfade)
+{
+    process->_crossfade = crossfade;
+    process->_bypass = bypass;
+}
+
+void sac_processing_set_input_format(sac_processing_t *process, sac_bit_depth_t bit_depth, uint8_t channel_count)
+{
+    process->_input_bit_depth = bit_depth;
+    process->_input_channel_count = channel_count;
+}
+
+void sac_endpoint_set_audio_payload_size(sac_pipeline_t *pipeline, sac_endpoint_t *endpoint,
+                                         uint16_t payload_size, sac_error_t *err)
+{
+    *err = SAC_ERR_NONE;
+
+    if (pipeline->cfg.mixer_option.input_mixer_pipeline || pipeline->cfg.mixer_option.output_mixer_pipeline ||
+        ((endpoint != pipeline->producer) && pipeline->cfg.cdc_enable)) {
+        /* The mixer and the CDC are configured for a fixed payload size */
+        *err = SAC_ERR_PIPELINE_CFG_INVALID;
+        return;
+    }
+    if (payload_size > endpoint->cfg.max_audio_payload_size) {
+        *err = SAC_ERR_PAYLOAD_SIZE_INVALID;
+        return;
+    }
+
+    endpoint->cfg.audio_payload_size = payload_size;
+}
+
+void sac_endpoint_release_packet(sac_endpoint_t *consumer)
+{
+    queue_free_node(queue_dequeue_node(consumer->_lent_queue));
+}
+
+uint8_t *sac_endpoint_lend_packet(sac_endpoint_t *producer)
+{
+    queue_node_t *node;
+
+    if ((producer->_lent_queue == NULL) ||
+        (queue_get_length(producer->_lent_queue) == queue_get_limit(producer->_lent_queue))) {
+        return NULL;
+    }
+    node = queue_get_free_node(producer->_free_queue);
+    if (node == NULL) {
+        return NULL;
+    }
+    /* The node stays lent with its first buffer, it is never returned */
+    queue_enqueue_node(producer->_lent_queue, node);
+
+    return producer->cfg.use_encapsulation ? (uint8_t *)sac_node_get_header(node) : sac_node_get_data(node);
+}
+
+void sac_endpoint_exchange_packet(sac_endpoint_t *producer, uint8_t *packet)
+{
+    queue_node_t *node = producer->_current_node;
+    uint16_t payload_size;
+
+    if (producer->cfg.use_encapsulation) {
+        /* The payload size is read from the received audio header once produced */
+        node->data = packet - SAC_PACKET_HEADER_OFFSET;
+    } else {
+        payload_size = sac_node_get_payload_size(node);
+        node->data = packet - SAC_PACKET_DATA_OFFSET;
+        sac_node_set_payload_size(node, payload_size);
+    }
+}
+
 void sac_pipeline_add_extra_consumer(sac_pipeline_t *pipeline, sac_endpoint_t *next_consumer)
 {
     sac_endpoint_t *current_consumer = pipeline->consumer;
@@ -182,6 +411,13 @@ void sac_pipeline_setup(sac_pipeline_t *pipeline, sac_error_t *err)
     sac_endpoint_t *producer = pipeline->producer;
 
     pipeline->_user_data_size = (pipeline->cfg.user_data_enable) ? 1 : 0;
+    pipeline->_packet_crc_size = (pipeline->cfg.payload_crc_enable) ? SAC_PACKET_CRC_SIZE : 0;
+    pipeline->_consumer_count = 0;
+    do {
+        pipeline->_consumer_count++;
+        consumer = consumer->next_endpoint;
+    } while (consumer != NULL);
+    consumer = pipeline->consumer;
     validate_pipeline_config(pipeline, err);
     if (*err != SAC_ERR_NONE) {
         return;
@@ -189,9 +425,10 @@ void sac_pipeline_setup(sac_pipeline_t *pipeline, sac_error_t *err)
 
     /* Initialize processing stages */
     while (process != NULL) {
-        if (process->iface.init != NULL) {
+        if ((process->iface.init != NULL) && !process->_initialized) {
             process->iface.init(process->instance, &mem_pool);
         }
+        process->_initialized = true;
         process = process->next_process;
     }
 
@@ -275,20 +512,20 @@ void sac_pipeline_consume(sac_pipeline_t *pipeline, sac_error_t *err)
 
 sac_statistics_t *sac_pipeline_get_stats(sac_pipeline_t *pipeline)
 {
-    pipeline->_statistics.producer_buffer_load = pipeline->producer->_queue->length;
-    pipeline->_statistics.consumer_buffer_load = pipeline->consumer->_queue->length;
+    pipeline->_statistics.producer_buffer_load = queue_get_length(pipeline->producer->_queue);
+    pipeline->_statistics.consumer_buffer_load = queue_get_length(pipeline->consumer->_queue);
 
     return &pipeline->_statistics;
 }
 
 uint32_t sac_pipeline_get_producer_buffer_load(sac_pipeline_t *pipeline)
 {
-    return pipeline->producer->_queue->length;
+    return queue_get_length(pipeline->producer->_queue);
 }
 
 uint32_t sac_pipeline_get_consumer_buffer_load(sac_pipeline_t *pipeline)
 {
-    return pipeline->consumer->_queue->length;
+    return queue_get_length(pipeline->consumer->_queue);
 }
 
 uint32_t sac_pipeline_get_consumer_buffer_overflow_count(sac_pipeline_t *pipeline)
@@ -306,6 +543,16 @@ uint32_t sac_pipeline_get_producer_packets_corrupted_count(sac_pipeline_t *pipel
     return pipeline->_statistics.producer_packets_corrupted_count;
 }
 
+uint32_t sac_pipeline_get_producer_payload_corrupted_count(sac_pipeline_t *pipeline)
+{
+    return pipeline->_statistics.producer_payload_corrupted_count;
+}
+
+uint32_t sac_pipeline_get_consumer_packets_concealed_count(sac_pipeline_t *pipeline)
+{
+    return pipeline->_statistics.consumer_packets_concealed_count;
+}
+
 void sac_pipeline_reset_stats(sac_pipeline_t *pipeline)
 {
     uint32_t consume_size;
@@ -320,6 +567,32 @@ void sac_pipeline_reset_stats(sac_pipeline_t *pipeline)
     pipeline->_statistics.consumer_buffer_size = consume_size;
 }
 
+sac_pipeline_profile_t *sac_pipeline_get_profile(sac_pipeline_t *pipeline)
+{
+#if (SAC_PROFILING_EN > 0U)
+    sac_cycles_stats_t *stats = (sac_cycles_stats_t *)&pipeline->_profile;
+
+    for (uint8_t i = 0; i < (sizeof(sac_pipeline_profile_t) / sizeof(sac_cycles_stats_t)); i++) {
+        stats[i].avg = (stats[i].count > 0) ? (uint32_t)(stats[i]._total / stats[i].count) : 0;
+    }
+
+    return &pipeline->_profile;
+#else
+    (void)pipeline;
+
+    return NULL;
+#endif
+}
+
+void sac_pipeline_reset_profile(sac_pipeline_t *pipeline)
+{
+#if (SAC_PROFILING_EN > 0U)
+    memset(&pipeline->_profile, 0, sizeof(sac_pipeline_profile_t));
+#else
+    (void)pipeline;
+#endif
+}
+
 void sac_pipeline_start(sac_pipeline_t *pipeline)
 {
     pipeline->_buffering_threshold = (pipeline->cfg.do_initial_buffering) ?
@@ -335,7 +608,7 @@ void sac_pipeline_stop(sac_pipeline_t *pipeline)
 
     /* Stop endpoints */
     do {
-        pipeline->consumer->iface.stop(consumer->instance);
+        consumer->iface.stop(consumer->instance);
         consumer = consumer->next_endpoint;
     } while (consumer != NULL);
 
@@ -356,10 +629,14 @@ void sac_pipeline_process(sac_pipeline_t *pipeline, sac_error_t *err)
     queue_node_t *node1, *node2, *temp_node;
     sac_endpoint_t *consumer = pipeline->consumer;
     sac_endpoint_t *producer = pipeline->producer;
-    uint8_t crc;
+    sac_header_t *header;
+    uint16_t packet_size;
+    bool payload_valid;
 
     *err = SAC_ERR_NONE;
 
+    PROFILE_BEGIN(process_start);
+
     /* Prevent the mixer to make the buffering before the mixing */
     if ((!pipeline->cfg.mixer_option.input_mixer_pipeline) &&
         (!pipeline->cfg.mixer_option.output_mixer_pipeline)) {
@@ -378,6 +655,7 @@ void sac_pipeline_process(sac_pipeline_t *pipeline, sac_error_t *err)
     /* If it's a Mixing Pipeline get the mixed packet of all Output Producer Endpoints.
      * Otherwise, get the packet from the single producer endpoints.
      */
+    PROFILE_BEGIN(dequeue_start);
     if (pipeline->cfg.mixer_option.output_mixer_pipeline) {
         temp_node = queue_get_free_node(consumer->_free_queue);
         node1 = start_mixing_process(pipeline, temp_node);
@@ -389,6 +667,7 @@ void sac_pipeline_process(sac_pipeline_t *pipeline, sac_error_t *err)
             return;
         }
     }
+    PROFILE_END(pipeline->_profile.dequeue, dequeue_start);
 
     /*
      * Check if payload size in audio header is what is expected. If not, packet may have
@@ -396,16 +675,41 @@ void sac_pipeline_process(sac_pipeline_t *pipeline, sac_error_t *err)
      * when using this packet as data source for memcpy().
      */
     if (producer->cfg.use_encapsulation) {
-        crc = sac_node_get_header(node1)->crc4;
-        sac_node_get_header(node1)->crc4 = 0;
-        sac_node_get_header(node1)->reserved = 0;
-        if (crc4itu(0, (uint8_t *)sac_node_get_header(node1), sizeof(sac_header_t)) != crc) {
+        header = sac_node_get_header(node1);
+        if (get_header_crc4(header) != header->crc4) {
+            pipeline->_statistics.producer_packets_corrupted_count++;
+            if (get_concealment_stage(pipeline) != NULL) {
+                /* Drop the packet, the consumer will conceal it like a lost one */
+                queue_free_node(node1);
+                return;
+            }
             /* Audio packet is corrupted, set it to a known value */
             sac_node_set_payload_size(node1, producer->cfg.audio_payload_size);
-            sac_node_get_header(node1)->fallback = 0;
-            sac_node_get_header(node1)->tx_queue_level_high = 0;
-            sac_node_get_header(node1)->user_data_is_valid = 0;
-            pipeline->_statistics.producer_packets_corrupted_count++;
+            header->fallback = 0;
+            header->tx_queue_level_high = 0;
+            header->user_data_is_valid = 0;
+        } else if (pipeline->_packet_crc_size > 0) {
+            /*
+             * The CRC4 still accepts a corrupted header 1 time in 16, so the payload size must fit
+             * the node before it is used to locate the CRC8 or to mute the payload.
+             */
+            if (sac_node_get_payload_size(node1) > producer->cfg.max_audio_payload_size) {
+                sac_node_set_payload_size(node1, producer->cfg.audio_payload_size);
+                payload_valid = false;
+            } else {
+                packet_size = sizeof(sac_header_t) + sac_node_get_payload_size(node1) + pipeline->_user_data_size;
+                payload_valid = crc8_verify((uint8_t *)header, packet_size, ((uint8_t *)header)[packet_size]);
+            }
+            if (!payload_valid) {
+                pipeline->_statistics.producer_payload_corrupted_count++;
+                if (get_concealment_stage(pipeline) != NULL) {
+                    queue_free_node(node1);
+                    return;
+                }
+                /* Audio payload is corrupted, mute it rather than playing noise */
+                memset(sac_node_get_data(node1), 0, sac_node_get_payload_size(node1));
+                header->user_data_is_valid = 0;
+            }
         }
     }
 
@@ -422,16 +726,26 @@ void sac_pipeline_process(sac_pipeline_t *pipeline, sac_error_t *err)
     } else {
         /* Consumer takes only audio data */
         if (pipeline->cfg.cdc_enable) {
+            PROFILE_BEGIN(cdc_start);
             /* Calculate average queue length */
             audio_cdc_module_update_queue_avg(pipeline);
             /* Apply Clock Drift Compensation */
             node1 = audio_cdc_module_process(pipeline, node2, err);
+            PROFILE_END(pipeline->_profile.cdc, cdc_start);
         } else {
             node1 = node2;
         }
     }
 
-    move_audio_packet_to_consumer_queue(pipeline, node1);
+    PROFILE_BEGIN(enqueue_start);
+    if (pipeline->cfg.zero_copy_enable) {
+        /* The consumers take ownership of the node */
+        link_audio_packet_to_consumer_queue(pipeline, node1);
+    } else {
+        move_audio_packet_to_consumer_queue(pipeline, node1);
+        queue_free_node(node1);
+    }
+    PROFILE_END(pipeline->_profile.enqueue, enqueue_start);
 
     /*
      * Start the Mixer Output Pipeline as soon as the first mixed audio packet is ready.
@@ -444,7 +758,8 @@ void sac_pipeline_process(sac_pipeline_t *pipeline, sac_error_t *err)
             consumer->iface.start(consumer->instance);
         }
     }
-    queue_free_node(node1);
+
+    PROFILE_END(pipeline->_profile.process, process_start);
 }
 
 uint32_t sac_get_allocated_bytes(void)
@@ -462,6 +777,7 @@ static void init_audio_queues(sac_pipeline_t *pipeline, sac_error_t *err)
 {
     sac_endpoint_t *consumer = pipeline->consumer;
     sac_endpoint_t *producer = pipeline->producer;
+    sac_processing_t *process = pipeline->process;
     uint16_t queue_data_inflation_size;
     uint16_t queue_data_size;
     uint8_t queue_size;
@@ -470,29 +786,45 @@ static void init_audio_queues(sac_pipeline_t *pipeline, sac_error_t *err)
     queue_data_inflation_size = SAC_NODE_PAYLOAD_SIZE_VAR_SIZE;
     queue_data_inflation_size += sizeof(sac_header_t);
     queue_data_inflation_size += pipeline->_user_data_size;
+    queue_data_inflation_size += pipeline->_packet_crc_size;
     if (pipeline->cfg.cdc_enable) {
         queue_data_inflation_size += CDC_QUEUE_DATA_SIZE_INFLATION;
     }
+    /* Stages like the multi-rate codec can output more than they get, e.g. a header before raw samples */
+    while (process != NULL) {
+        queue_data_inflation_size += process->iface.output_overhead;
+        process = process->next_process;
+    }
 
     /* Calculate producer initial queue data size  */
-    if (consumer->cfg.audio_payload_size > producer->cfg.audio_payload_size) {
+    if (consumer->cfg.max_audio_payload_size > producer->cfg.max_audio_payload_size) {
         /* If consumer queue is bigger than producer queue,
            then the audio processing will require more space than initial size */
-        queue_data_size = consumer->cfg.audio_payload_size;
+        queue_data_size = consumer->cfg.max_audio_payload_size;
     } else {
-        queue_data_size = producer->cfg.audio_payload_size;
+        queue_data_size = producer->cfg.max_audio_payload_size;
     }
     queue_data_size += queue_data_inflation_size;
     queue_data_size += sac_align_data_size(queue_data_size, uint32_t); /* Align nodes on 32bits */
 
+    if (pipeline->cfg.zero_copy_enable) {
+        init_zero_copy_audio_queues(pipeline, queue_data_size, err);
+        return;
+    }
+
     /* Initialize producer queue.
      * The Mixer Output Pipeline producer queue will be initialized in
      * sac_endpoint_link() as it shares the Mixer Input Pipeline consumer queue.
      */
     if (!pipeline->cfg.mixer_option.output_mixer_pipeline) {
         queue_size = producer->cfg.queue_size;
+        /* Lent audio packets never come back to the free queue */
         init_audio_free_queue(producer, "Processing Free Queue",
-                              queue_data_size, queue_size, err);
+                              queue_data_size, queue_size + producer->cfg.lent_queue_size, err);
+        if (*err != SAC_ERR_NONE) {
+            return;
+        }
+        init_lent_queue(producer, err);
         if (*err != SAC_ERR_NONE) {
             return;
         }
@@ -500,11 +832,14 @@ static void init_audio_queues(sac_pipeline_t *pipeline, sac_error_t *err)
             /* When using delayed action, one of the node will not be available */
             queue_size--;
         }
-        queue_init_queue(producer->_queue, queue_size, "Processing Queue");
+        init_endpoint_queue(producer, "Processing Queue", queue_size, err);
+        if (*err != SAC_ERR_NONE) {
+            return;
+        }
     }
 
     /* Calculate producer initial queue data size  */
-    queue_data_size = consumer->cfg.audio_payload_size;
+    queue_data_size = consumer->cfg.max_audio_payload_size;
     queue_data_size += queue_data_inflation_size;
     queue_data_size += sac_align_data_size(queue_data_size, uint32_t); /* Align nodes on 32bits */
 
@@ -523,6 +858,8 @@ static void init_audio_queues(sac_pipeline_t *pipeline, sac_error_t *err)
     if (pipeline->cfg.mixer_option.input_mixer_pipeline) {
         queue_size += 3;
     }
+    /* Lent audio packets stay out of the free queue until the layer below releases them */
+    queue_size += get_lent_queue_size(pipeline);
 
     init_audio_free_queue(consumer, "Audio Buffer Free Queue",
                           queue_data_size, queue_size, err);
@@ -533,12 +870,83 @@ static void init_audio_queues(sac_pipeline_t *pipeline, sac_error_t *err)
     /* Initialize consumer queues */
     do {
         consumer->_free_queue = pipeline->consumer->_free_queue; /* All consumers use the same memory space */
-        queue_size = consumer->_free_queue->limit;
+        queue_size = consumer->_free_queue->limit - get_lent_queue_size(pipeline);
+        if (consumer->cfg.delayed_action) {
+            /* When using delayed action, one of the node will not be available */
+            queue_size--;
+        }
+        init_endpoint_queue(consumer, "Audio Buffer", queue_size, err);
+        if (*err != SAC_ERR_NONE) {
+            return;
+        }
+        init_lent_queue(consumer, err);
+        if (*err != SAC_ERR_NONE) {
+            return;
+        }
+        consumer = consumer->next_endpoint;
+    } while (consumer != NULL);
+}
+
+/** @brief Initialize audio queues sharing a single free queue.
+ *
+ *  Every node of the pipeline comes from the same pool so a processed
+ *  producer node can be enqueued as is in the consumer queues.
+ *
+ *  @param[in]  pipeline         Pipeline instance.
+ *  @param[in]  queue_data_size  Size in bytes of the data in a node.
+ *  @param[out] err              Error code.
+ */
+static void init_zero_copy_audio_queues(sac_pipeline_t *pipeline, uint16_t queue_data_size, sac_error_t *err)
+{
+    sac_endpoint_t *consumer = pipeline->consumer;
+    sac_endpoint_t *producer = pipeline->producer;
+    uint8_t consumer_queue_size;
+    uint8_t queue_size;
+
+    consumer_queue_size = consumer->cfg.queue_size;
+    if (pipeline->cfg.cdc_enable) {
+        consumer_queue_size += CDC_QUEUE_SIZE_INFLATION;
+    }
+
+    /* Initialize the free queue shared by the producer and every consumer */
+    queue_size = producer->cfg.queue_size + consumer_queue_size + ZERO_COPY_QUEUE_SIZE_INFLATION +
+                 get_lent_queue_size(pipeline) + producer->cfg.lent_queue_size;
+    init_audio_free_queue(producer, "Audio Free Queue", queue_data_size, queue_size, err);
+    if (*err != SAC_ERR_NONE) {
+        return;
+    }
+    init_lent_queue(producer, err);
+    if (*err != SAC_ERR_NONE) {
+        return;
+    }
+
+    /* Initialize producer queue */
+    queue_size = producer->cfg.queue_size;
+    if (producer->cfg.delayed_action) {
+        /* When using delayed action, one of the node will not be available */
+        queue_size--;
+    }
+    init_endpoint_queue(producer, "Processing Queue", queue_size, err);
+    if (*err != SAC_ERR_NONE) {
+        return;
+    }
+
+    /* Initialize consumer queues */
+    do {
+        consumer->_free_queue = producer->_free_queue;
+        queue_size = consumer_queue_size;
         if (consumer->cfg.delayed_action) {
             /* When using delayed action, one of the node will not be available */
             queue_size--;
         }
-        queue_init_queue(consumer->_queue, queue_size, "Audio Buffer");
+        init_endpoint_queue(consumer, "Audio Buffer", queue_size, err);
+        if (*err != SAC_ERR_NONE) {
+            return;
+        }
+        init_lent_queue(consumer, err);
+        if (*err != SAC_ERR_NONE) {
+            return;
+        }
         consumer = consumer->next_endpoint;
     } while (consumer != NULL);
 }
@@ -555,15 +963,26 @@ static void init_audio_free_queue(sac_endpoint_t *endpoint, const char *queue_na
                                   uint16_t queue_data_size, uint8_t queue_size, sac_error_t *err)
 {
     uint8_t *pool_ptr;
+    uint8_t headroom;
+    queue_node_t *node;
 
     *err = SAC_ERR_NONE;
 
-    pool_ptr = mem_pool_malloc(&mem_pool, QUEUE_NB_BYTES_NEEDED(queue_size, queue_data_size));
+    /* Keep the nodes aligned on 32 bits after the headroom */
+    headroom = endpoint->cfg.packet_headroom;
+    if ((headroom % sizeof(uint32_t)) != 0) {
+        headroom += sac_align_data_size(headroom, uint32_t);
+    }
+    queue_data_size += headroom;
+
+    pool_ptr = mem_pool_alloc(&mem_pool, QUEUE_NB_BYTES_NEEDED(queue_size, queue_data_size),
+                              SAC_MEM_POOL_OWNER_PIPELINE, MEM_POOL_FLAG_NONE);
     if (pool_ptr == NULL) {
         *err = SAC_ERR_NOT_ENOUGH_MEMORY;
         return;
     }
-    endpoint->_free_queue = mem_pool_malloc(&mem_pool, sizeof(queue_t));
+    endpoint->_free_queue_pool = pool_ptr;
+    endpoint->_free_queue = mem_pool_alloc(&mem_pool, sizeof(queue_t), SAC_MEM_POOL_OWNER_PIPELINE, MEM_POOL_FLAG_NONE);
     if (endpoint->_free_queue == NULL) {
         *err = SAC_ERR_NOT_ENOUGH_MEMORY;
         return;
@@ -574,6 +993,102 @@ static void init_audio_free_queue(sac_endpoint_t *endpoint, const char *queue_na
                     queue_size,
                     queue_data_size,
                     queue_name);
+
+    /* The headroom stays free in front of the data of every node */
+    for (node = endpoint->_free_queue->head; node != NULL; node = node->next) {
+        node->data += headroom;
+    }
+}
+
+/** @brief Initialize the queue of an endpoint.
+ *
+ *  @param[in]  endpoint    Pointer to the queue's endpoint.
+ *  @param[in]  queue_name  Name of the queue.
+ *  @param[in]  queue_size  Queue length limit.
+ *  @param[out] err         Error code.
+ */
+static void init_endpoint_queue(sac_endpoint_t *endpoint, const char *queue_name, uint8_t queue_size, sac_error_t *err)
+{
+    queue_node_t **ring;
+
+    *err = SAC_ERR_NONE;
+
+    if (!endpoint->cfg.use_spsc_queue) {
+        queue_init_queue(endpoint->_queue, queue_size, queue_name);
+        return;
+    }
+
+    ring = (queue_node_t **)mem_pool_alloc(&mem_pool, QUEUE_SPSC_NB_BYTES_NEEDED(queue_size),
+                                           SAC_MEM_POOL_OWNER_PIPELINE, MEM_POOL_FLAG_NONE);
+    if (ring == NULL) {
+        *err = SAC_ERR_NOT_ENOUGH_MEMORY;
+        return;
+    }
+    queue_init_spsc_queue(endpoint->_queue, ring, queue_size, queue_name);
+}
+
+/** @brief Initialize the queue holding the audio packets an endpoint lends.
+ *
+ *  It is an SPSC queue so the layer below can release packets from its own context.
+ *
+ *  @param[in]  consumer  Pointer to the consumer or producer endpoint.
+ *  @param[out] err       Error code.
+ */
+static void init_lent_queue(sac_endpoint_t *consumer, sac_error_t *err)
+{
+    queue_node_t **ring;
+
+    *err = SAC_ERR_NONE;
+
+    if (consumer->cfg.lent_queue_size == 0) {
+        return;
+    }
+
+    consumer->_lent_queue = (queue_t *)mem_pool_alloc(&mem_pool, sizeof(queue_t), SAC_MEM_POOL_OWNER_PIPELINE,
+                                                      MEM_POOL_FLAG_NONE);
+    if (consumer->_lent_queue == NULL) {
+        *err = SAC_ERR_NOT_ENOUGH_MEMORY;
+        return;
+    }
+    ring = (queue_node_t **)mem_pool_alloc(&mem_pool, QUEUE_SPSC_NB_BYTES_NEEDED(consumer->cfg.lent_queue_size),
+                                           SAC_MEM_POOL_OWNER_PIPELINE, MEM_POOL_FLAG_NONE);
+    if (ring == NULL) {
+        *err = SAC_ERR_NOT_ENOUGH_MEMORY;
+        return;
+    }
+    queue_init_spsc_queue(consumer->_lent_queue, ring, consumer->cfg.lent_queue_size, "Lent Audio Buffer");
+}
+
+/** @brief Unlink a queue and release its memory, with its ring for an SPSC queue.
+ *
+ *  @param[in] queue  Queue allocated with SAC_MEM_POOL_OWNER_PIPELINE, NULL to do nothing.
+ */
+static void release_queue(queue_t *queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+    queue_unlink(queue);
+    mem_pool_release(&mem_pool, queue->ring);
+    mem_pool_release(&mem_pool, queue);
+}
+
+/** @brief Get the number of audio packets the consumers of a pipeline can lend at once.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @return Sum of the consumers lent queue size.
+ */
+static uint8_t get_lent_queue_size(sac_pipeline_t *pipeline)
+{
+    sac_endpoint_t *consumer = pipeline->consumer;
+    uint8_t lent_queue_size = 0;
+
+    do {
+        lent_queue_size += consumer->cfg.lent_queue_size;
+        consumer = consumer->next_endpoint;
+    } while (consumer != NULL);
+
+    return lent_queue_size;
 }
 
 /** @brief Copy data from a node of the producer queue to a node of the consumer queue.
@@ -584,34 +1099,131 @@ static void init_audio_free_queue(sac_endpoint_t *endpoint, const char *queue_na
 static void move_audio_packet_to_consumer_queue(sac_pipeline_t *pipeline, queue_node_t *node1)
 {
     queue_node_t *node2;
+    sac_endpoint_t *consumer;
+
+    /* Move audio packet into a consumer node, the single copy shared by all consumers */
+    node2 = queue_get_free_node(pipeline->consumer->_free_queue);
+    if (node2 == NULL) {
+        /* Every node is queued, drop the oldest packet of the full queues to recover one.
+         * SPSC queues can only be dequeued by their consumer.
+         */
+        consumer = pipeline->consumer;
+        do {
+            if ((queue_get_length(consumer->_queue) == queue_get_limit(consumer->_queue)) &&
+                !consumer->cfg.use_spsc_queue) {
+                pipeline->_statistics.consumer_buffer_overflow_count++;
+                queue_free_node(queue_dequeue_node(consumer->_queue));
+            }
+            consumer = consumer->next_endpoint;
+        } while (consumer != NULL);
+
+        node2 = queue_get_free_node(pipeline->consumer->_free_queue);
+        if (node2 == NULL) {
+            pipeline->_statistics.consumer_buffer_overflow_count++;
+            return;
+        }
+    }
+    memcpy(node2->data, node1->data, SAC_PACKET_HEADER_OFFSET + sizeof(sac_header_t) +
+           sac_node_get_payload_size(node1) + pipeline->_user_data_size);
+
+    enqueue_consumer_node(pipeline, node2);
+}
+
+/** @brief Enqueue a producer queue node in the consumer queues without copying it.
+ *
+ *  @note Only used when the pipeline is configured with zero_copy_enable.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @param[in] node      Node from the producer free queue containing the processed data.
+ */
+static void link_audio_packet_to_consumer_queue(sac_pipeline_t *pipeline, queue_node_t *node)
+{
+    enqueue_consumer_node(pipeline, node);
+}
+
+/** @brief Enqueue a node for all consumers.
+ *
+ *  The node is shared by reference: it holds one reference per consumer and returns
+ *  to its free queue once the last consumer frees it. When a consumer queue is full,
+ *  its oldest packet is dropped, except for SPSC queues which drop the new one.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @param[in] node      Node containing the audio packet.
+ */
+static void enqueue_consumer_node(sac_pipeline_t *pipeline, queue_node_t *node)
+{
     sac_endpoint_t *consumer = pipeline->consumer;
 
-    /* Detect overflow */
+    if (pipeline->_consumer_count > 1) {
+        /* Take a reference on the node for every extra consumer before it becomes visible */
+        queue_add_copy_count(node, pipeline->_consumer_count - 1);
+        if (consumer->cfg.use_encapsulation) {
+            /* Consumers must not write into a shared packet, so seal it once for all of them */
+            seal_audio_packet(pipeline, node, get_consumer_queue_level_high(pipeline));
+        }
+    }
+
     do {
         if ((queue_get_length(consumer->_queue) == queue_get_limit(consumer->_queue)) &&
-            (queue_get_length(consumer->_free_queue) == 0)) {
+            !consumer->cfg.use_spsc_queue) {
             pipeline->_statistics.consumer_buffer_overflow_count++;
             queue_free_node(queue_dequeue_node(consumer->_queue));
         }
+        if (!queue_enqueue_node(consumer->_queue, node)) {
+            /* Release this consumer's reference */
+            pipeline->_statistics.consumer_buffer_overflow_count++;
+            queue_free_node(node);
+        }
         consumer = consumer->next_endpoint;
     } while (consumer != NULL);
+}
 
-    /* Move audio packet into a consumer node */
-    node2 = queue_get_free_node(pipeline->consumer->_free_queue);
-    memcpy(node2->data, node1->data, SAC_PACKET_HEADER_OFFSET + sizeof(sac_header_t) +
-           sac_node_get_payload_size(node1) + pipeline->_user_data_size);
+/** @brief Fill the audio header and the CRCs of an encapsulated audio packet.
+ *
+ *  @param[in] pipeline          Pipeline instance.
+ *  @param[in] node              Node containing the audio packet.
+ *  @param[in] queue_level_high  Whether the consumer queue is filling up.
+ *  @return Size of the audio packet, in bytes.
+ */
+static uint16_t seal_audio_packet(sac_pipeline_t *pipeline, queue_node_t *node, bool queue_level_high)
+{
+    uint8_t *packet = (uint8_t *)sac_node_get_header(node);
+    uint16_t packet_size = sac_node_get_payload_size(node);
+
+    /* Update audio header's payload size before sending the packet */
+    sac_node_get_header(node)->payload_size = (uint8_t)packet_size;
+    packet_size += (sizeof(sac_header_t) + pipeline->_user_data_size);
+    ((sac_header_t *)packet)->tx_queue_level_high = queue_level_high ? 1 : 0;
+
+    /* Update CRC */
+    ((sac_header_t *)packet)->reserved = 0;
+    ((sac_header_t *)packet)->crc4 = get_header_crc4((sac_header_t *)packet);
+    if (pipeline->_packet_crc_size > 0) {
+        /* The CRC8 covers the header, so it must be computed last */
+        packet[packet_size] = crc8(CRC8_INIT, packet, packet_size);
+        packet_size += pipeline->_packet_crc_size;
+    }
 
-    /* Enqueue node for all consumers */
-    consumer = pipeline->consumer;
-    while (1) {
-        queue_enqueue_node(consumer->_queue, node2);
-        consumer = consumer->next_endpoint;
-        if (consumer != NULL) {
-            queue_inc_copy_count(node2);
-        } else {
-            break;
+    return packet_size;
+}
+
+/** @brief Check if any consumer queue of the pipeline is filling up.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @return True if a consumer queue holds TX_QUEUE_HIGH_LEVEL packets or more.
+ */
+static bool get_consumer_queue_level_high(sac_pipeline_t *pipeline)
+{
+    sac_endpoint_t *consumer = pipeline->consumer;
+
+    do {
+        if (queue_get_length(consumer->_queue) >= TX_QUEUE_HIGH_LEVEL) {
+            return true;
         }
-    }
+        consumer = consumer->next_endpoint;
+    } while (consumer != NULL);
+
+    return false;
 }
 
 /** @brief Apply all processing stages to a producer queue node.
@@ -623,33 +1235,87 @@ static void move_audio_packet_to_consumer_queue(sac_pipeline_t *pipeline, queue_
 static queue_node_t *process_samples(sac_pipeline_t *pipeline, queue_node_t *node1)
 {
     uint16_t rv;
-    queue_node_t *node2, *node_tmp;
+    queue_node_t *node2 = NULL;
+    queue_node_t *node_tmp;
+    queue_node_t *dry_node;
     sac_processing_t *process = pipeline->process;
+    bool bypass;
+#if (SAC_PROFILING_EN > 0U)
+    uint8_t stage_index = 0;
+#endif
+
+    if (process == NULL) {
+        /* The last stage has been removed since the pipeline was checked */
+        return node1;
+    }
 
-    /* Get a process destination node */
-    node2 = queue_get_free_node(pipeline->producer->_free_queue);
     do {
+        PROFILE_BEGIN(stage_start);
+        /* Apply a bypass change requested since the last packet */
+        dry_node = NULL;
+        bypass = process->_bypass;
+        if (bypass != process->_bypass_applied) {
+            process->_bypass_applied = bypass;
+            if (process->_crossfade) {
+                dry_node = start_crossfade(pipeline, node1);
+                if (dry_node == NULL) {
+                    pipeline->_statistics.processing_crossfade_skipped_count++;
+                }
+            }
+        }
         /* Execute gate function if present */
-        if ((process->iface.gate == NULL) || process->iface.gate(process->instance, sac_node_get_header(node1),
-                                                                 sac_node_get_data(node1),
-                                                                 sac_node_get_payload_size(node1))) {
-        /* node1 is the source node */
-            rv = process->iface.process(process->instance,
-                                        sac_node_get_header(node1),
-                                        sac_node_get_data(node1),
-                                        sac_node_get_payload_size(node1),
-                                        sac_node_get_data(node2));
-            if (rv != 0) { /* != 0 means processing happened */
-                /* Copy the header from the old source */
-                memcpy(sac_node_get_header(node2), sac_node_get_header(node1), sizeof(sac_header_t));
-                /* Update the size */
-                sac_node_set_payload_size(node2, rv);
-                /* Swap node1 and node2 */
-                node_tmp = node1;
-                node1 = node2;
-                node2 = node_tmp;
+        if ((!bypass || (dry_node != NULL)) &&
+            ((process->iface.gate == NULL) || process->iface.gate(process->instance, sac_node_get_header(node1),
+                                                                  sac_node_get_data(node1),
+                                                                  sac_node_get_payload_size(node1)))) {
+            if (process->iface.in_place) {
+                /* node1 is both the source and the destination node */
+                rv = process->iface.process(process->instance,
+                                            sac_node_get_header(node1),
+                                            sac_node_get_data(node1),
+                                            sac_node_get_payload_size(node1),
+                                            sac_node_get_data(node1));
+                if (rv != 0) { /* != 0 means processing happened */
+                    sac_node_set_payload_size(node1, rv);
+                }
+            } else {
+                if (node2 == NULL) {
+                    /* Get a process destination node only when a stage requires one */
+                    node2 = queue_get_free_node(pipeline->producer->_free_queue);
+                }
+                if (node2 == NULL) {
+                    /* No destination node, the packet goes on unprocessed by this stage */
+                    rv = 0;
+                    pipeline->_statistics.processing_stage_skipped_count++;
+                } else {
+                    /* node1 is the source node */
+                    rv = process->iface.process(process->instance,
+                                                sac_node_get_header(node1),
+                                                sac_node_get_data(node1),
+                                                sac_node_get_payload_size(node1),
+                                                sac_node_get_data(node2));
+                }
+                if (rv != 0) { /* != 0 means processing happened */
+                    /* Copy the header from the old source */
+                    memcpy(sac_node_get_header(node2), sac_node_get_header(node1), sizeof(sac_header_t));
+                    /* Update the size */
+                    sac_node_set_payload_size(node2, rv);
+                    /* Swap node1 and node2 */
+                    node_tmp = node1;
+                    node1 = node2;
+                    node2 = node_tmp;
+                }
             }
         }
+        if (dry_node != NULL) {
+            end_crossfade(pipeline, process, dry_node, node1, !bypass);
+        }
+#if (SAC_PROFILING_EN > 0U)
+        if (stage_index < SAC_PROFILING_STAGE_COUNT) {
+            PROFILE_END(pipeline->_profile.stage[stage_index], stage_start);
+        }
+        stage_index++;
+#endif
         process = process->next_process;
     } while (process != NULL);
     queue_free_node(node2);
@@ -657,6 +1323,86 @@ static queue_node_t *process_samples(sac_pipeline_t *pipeline, queue_node_t *nod
     return node1;
 }
 
+/** @brief Keep a copy of a processing stage input for a crossfade.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @param[in] node      Node about to be processed.
+ *  @return Node holding the copy, NULL if no free node is available.
+ */
+static queue_node_t *start_crossfade(sac_pipeline_t *pipeline, queue_node_t *node)
+{
+    queue_node_t *dry_node = queue_get_free_node(pipeline->producer->_free_queue);
+
+    if (dry_node != NULL) {
+        memcpy(sac_node_get_data(dry_node), sac_node_get_data(node), sac_node_get_payload_size(node));
+        sac_node_set_payload_size(dry_node, sac_node_get_payload_size(node));
+    }
+
+    return dry_node;
+}
+
+/** @brief Crossfade a processing stage output with its input and free the input copy.
+ *
+ *  The gain ramps linearly over the packet frames. Nothing is mixed if the stage changed
+ *  the payload size, since its output is then not in the same format as its input.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @param[in] process   Processing stage, which gives the format of its input.
+ *  @param[in] dry_node  Copy of the stage input.
+ *  @param[in] wet_node  Stage output, which receives the crossfaded samples.
+ *  @param[in] fade_in   True to fade from the input to the output, false for the opposite.
+ */
+static void end_crossfade(sac_pipeline_t *pipeline, sac_processing_t *process, queue_node_t *dry_node,
+                          queue_node_t *wet_node, bool fade_in)
+{
+    uint16_t size = sac_node_get_payload_size(wet_node);
+    sac_bit_depth_t bit_depth = (process->_input_bit_depth != 0) ? process->_input_bit_depth :
+                                                                  pipeline->producer->cfg.bit_depth;
+    uint8_t channel_count = (process->_input_channel_count != 0) ? process->_input_channel_count :
+                                                                  pipeline->producer->cfg.channel_count;
+    uint16_t frame_count, frame, channel;
+    int32_t gain;
+
+    if ((size == sac_node_get_payload_size(dry_node)) && (channel_count > 0)) {
+        if (bit_depth == AUDIO_16BITS) {
+            int16_t *dry = (int16_t *)sac_node_get_data(dry_node);
+            int16_t *wet = (int16_t *)sac_node_get_data(wet_node);
+
+            frame_count = size / (sizeof(int16_t) * channel_count);
+            for (frame = 0; frame < frame_count; frame++) {
+                /* Q15 gain of the stage output */
+                gain = ((int32_t)frame << 15) / frame_count;
+                if (!fade_in) {
+                    gain = (1 << 15) - gain;
+                }
+                for (channel = 0; channel < channel_count; channel++) {
+                    *wet = (int16_t)(*dry + ((((int32_t)*wet - *dry) * gain) >> 15));
+                    dry++;
+                    wet++;
+                }
+            }
+        } else {
+            int32_t *dry = (int32_t *)sac_node_get_data(dry_node);
+            int32_t *wet = (int32_t *)sac_node_get_data(wet_node);
+
+            frame_count = size / (sizeof(int32_t) * channel_count);
+            for (frame = 0; frame < frame_count; frame++) {
+                gain = ((int32_t)frame << 15) / frame_count;
+                if (!fade_in) {
+                    gain = (1 << 15) - gain;
+                }
+                for (channel = 0; channel < channel_count; channel++) {
+                    *wet = (int32_t)(*dry + ((((int64_t)*wet - *dry) * gain) >> 15));
+                    dry++;
+                    wet++;
+                }
+            }
+        }
+    }
+
+    queue_free_node(dry_node);
+}
+
 /** @brief Enqueue the current producer queue node.
  *
  *  @param[in]  producer  Pointer to the producer endpoint.
@@ -674,9 +1420,9 @@ static void enqueue_producer_node(sac_endpoint_t *producer, sac_error_t *err)
     /*
      * Before enqueuing a node, make sure that the producer queue is empty.
      * If it's not, the processing hasn't started, so dequeue the node in queue
-     * before enqueuing the new one.
+     * before enqueuing the new one. SPSC queues can only be dequeued by their consumer.
      */
-    if (queue_get_length(producer->_queue) > PROD_QUEUE_SIZE_MIN_WHEN_ENQUEUING) {
+    if ((queue_get_length(producer->_queue) > PROD_QUEUE_SIZE_MIN_WHEN_ENQUEUING) && !producer->cfg.use_spsc_queue) {
         queue_free_node(queue_dequeue_node(producer->_queue));
     }
     if (!queue_enqueue_node(producer->_queue, producer->_current_node)) {
@@ -710,13 +1456,17 @@ static uint16_t produce(sac_pipeline_t *pipeline, sac_error_t *err)
     payload_size = producer->cfg.audio_payload_size;
     if (producer->cfg.use_encapsulation) {
         payload = (uint8_t *)sac_node_get_header(producer->_current_node);
-        payload_size += (sizeof(sac_header_t) + pipeline->_user_data_size);
+        payload_size += (sizeof(sac_header_t) + pipeline->_user_data_size + pipeline->_packet_crc_size);
     } else {
         payload = (uint8_t *)sac_node_get_data(producer->_current_node);
         sac_node_set_payload_size(producer->_current_node, payload_size);
     }
 
-    return producer->iface.action(producer->instance, payload, payload_size);
+    PROFILE_BEGIN(action_start);
+    payload_size = producer->iface.action(producer->instance, payload, payload_size);
+    PROFILE_END(pipeline->_profile.producer_action, action_start);
+
+    return payload_size;
 }
 
 /** @brief Apply the consumer endpoint action on the current node.
@@ -729,7 +1479,10 @@ static uint16_t produce(sac_pipeline_t *pipeline, sac_error_t *err)
 static uint16_t consume(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sac_error_t *err)
 {
     uint8_t *payload;
-    uint16_t payload_size, crc;
+    uint16_t payload_size;
+#if (SAC_PROFILING_EN > 0U)
+    sac_cycles_stats_t *action_stats = get_consumer_profile(pipeline, consumer);
+#endif
 
     *err = SAC_ERR_NONE;
 
@@ -742,22 +1495,27 @@ static uint16_t consume(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sac_
         payload_size = sac_node_get_payload_size(consumer->_current_node);
         if (consumer->cfg.use_encapsulation) {
             payload = (uint8_t *)sac_node_get_header(consumer->_current_node);
-            /* Update audio header's payload size before sending the packet */
-            sac_node_get_header(consumer->_current_node)->payload_size = (uint8_t)payload_size;
-            payload_size += (sizeof(sac_header_t) + pipeline->_user_data_size);
-            ((sac_header_t *)payload)->tx_queue_level_high = (queue_get_length(consumer->_queue) < TX_QUEUE_HIGH_LEVEL) ? 0 : 1;
-
-            /* Update CRC */
-            ((sac_header_t *)payload)->crc4 = 0;
-            ((sac_header_t *)payload)->reserved = 0;
-            crc = crc4itu(0, payload, sizeof(sac_header_t));
-            ((sac_header_t *)payload)->crc4 = crc;
+            if (pipeline->_consumer_count > 1) {
+                /* Shared packet, already sealed when enqueued */
+                payload_size += (sizeof(sac_header_t) + pipeline->_user_data_size + pipeline->_packet_crc_size);
+            } else {
+                payload_size = seal_audio_packet(pipeline, consumer->_current_node,
+                                                 queue_get_length(consumer->_queue) >= TX_QUEUE_HIGH_LEVEL);
+            }
         } else {
             payload = sac_node_get_data(consumer->_current_node);
         }
     }
 
-    return consumer->iface.action(consumer->instance, payload, payload_size);
+    PROFILE_BEGIN(action_start);
+    payload_size = consumer->iface.action(consumer->instance, payload, payload_size);
+#if (SAC_PROFILING_EN > 0U)
+    if (action_stats != NULL) {
+        PROFILE_END(*action_stats, action_start);
+    }
+#endif
+
+    return payload_size;
 }
 
 /** @brief Execute the specified not delayed action consumer endpoint.
@@ -773,13 +1531,23 @@ static void consume_no_delay(sac_pipeline_t *pipeline, sac_endpoint_t *consumer,
     *err = SAC_ERR_NONE;
 
     if (consumer->_buffering_complete) {
+        if ((consumer->_lent_queue != NULL) &&
+            (queue_get_length(consumer->_lent_queue) == queue_get_limit(consumer->_lent_queue))) {
+            /* Every lendable packet is still held by the layer below */
+            return;
+        }
         /* Get the next node, if available, without dequeuing */
         consumer->_current_node = queue_get_node(consumer->_queue);
         /* Start consumption of the node */
         size = consume(pipeline, consumer, err);
         if (size > 0) {
-            /* Consumed successfully, so dequeue and free */
-            queue_free_node(queue_dequeue_node(consumer->_queue));
+            if (consumer->_lent_queue != NULL) {
+                /* Consumed successfully, hold the node until the layer below releases it */
+                queue_enqueue_node(consumer->_lent_queue, queue_dequeue_node(consumer->_queue));
+            } else {
+                /* Consumed successfully, so dequeue and free */
+                queue_free_node(queue_dequeue_node(consumer->_queue));
+            }
         }
         consumer->_current_node = NULL;
     }
@@ -800,11 +1568,88 @@ static void consume_delay(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sa
         queue_free_node(consumer->_current_node);
         /* Get new node */
         consumer->_current_node = queue_dequeue_node(consumer->_queue);
+        if ((consumer->_current_node == NULL) && !consumer->cfg.use_encapsulation) {
+            /* The packet is late or lost, play a synthesized one if a stage can conceal it */
+            consumer->_current_node = conceal_packet_loss(pipeline, consumer);
+        }
         /* Start consumption of new node */
         consume(pipeline, consumer, err);
     }
 }
 
+/** @brief Get the first processing stage able to conceal a packet loss.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @return Pointer to the processing stage, NULL if none is present or all are bypassed.
+ */
+static sac_processing_t *get_concealment_stage(sac_pipeline_t *pipeline)
+{
+    /* Called from the consumer interrupt, pair with the stage insertion and removal release stores */
+    sac_processing_t *process = __atomic_load_n(&pipeline->process, __ATOMIC_ACQUIRE);
+
+    while (process != NULL) {
+        if ((process->iface.conceal != NULL) && !process->_bypass_applied) {
+            return process;
+        }
+        process = __atomic_load_n(&process->next_process, __ATOMIC_ACQUIRE);
+    }
+
+    return NULL;
+}
+
+/** @brief Synthesize an audio packet replacing the one the consumer is missing.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @param[in] consumer  Pointer to the consumer endpoint.
+ *  @return Node holding the synthesized packet, NULL if it could not be synthesized.
+ */
+static queue_node_t *conceal_packet_loss(sac_pipeline_t *pipeline, sac_endpoint_t *consumer)
+{
+    sac_processing_t *process;
+    queue_node_t *node;
+    uint16_t size;
+
+    process = get_concealment_stage(pipeline);
+    if (process == NULL) {
+        return NULL;
+    }
+    node = queue_get_free_node(consumer->_free_queue);
+    if (node == NULL) {
+        return NULL;
+    }
+
+    size = process->iface.conceal(process->instance, sac_node_get_data(node), consumer->cfg.audio_payload_size);
+    if (size == 0) {
+        /* Nothing left to play, let the consumer underflow */
+        queue_free_node(node);
+        return NULL;
+    }
+
+    memset(sac_node_get_header(node), 0, sizeof(sac_header_t));
+    sac_node_set_payload_size(node, size);
+    pipeline->_statistics.consumer_packets_concealed_count++;
+
+    return node;
+}
+
+/** @brief Calculate the CRC4 of an audio header.
+ *
+ *  The header is copied so the CRC can be checked on a received
+ *  packet without clearing its CRC field.
+ *
+ *  @param[in] header  Audio header.
+ *  @return CRC4 of the header, computed with the crc4 and reserved fields set to 0.
+ */
+static uint8_t get_header_crc4(const sac_header_t *header)
+{
+    sac_header_t header_copy = *header;
+
+    header_copy.crc4 = 0;
+    header_copy.reserved = 0;
+
+    return crc4itu(CRC4_ITU_INIT, (uint8_t *)&header_copy, sizeof(sac_header_t));
+}
+
 /** @brief Validate the user configuration for the pipeline.
  *
  *  @param[in]  pipeline  Pipeline instance.
@@ -812,9 +1657,31 @@ static void consume_delay(sac_pipeline_t *pipeline, sac_endpoint_t *consumer, sa
  */
 static void validate_pipeline_config(sac_pipeline_t *pipeline, sac_error_t *err)
 {
+    sac_endpoint_t *consumer = pipeline->consumer;
+    sac_processing_t *process = pipeline->process;
+
     if (pipeline->cfg.cdc_enable && pipeline->consumer->cfg.use_encapsulation) {
         *err = SAC_ERR_PIPELINE_CFG_INVALID;
     }
+    if (pipeline->cfg.zero_copy_enable && (pipeline->cfg.mixer_option.input_mixer_pipeline ||
+                                           pipeline->cfg.mixer_option.output_mixer_pipeline)) {
+        /* Mixer pipelines share their queues with another pipeline */
+        *err = SAC_ERR_PIPELINE_CFG_INVALID;
+    }
+    do {
+        if ((consumer->cfg.lent_queue_size > 0) && consumer->cfg.delayed_action) {
+            /* A delayed action consumer frees its node on the next cycle */
+            *err = SAC_ERR_PIPELINE_CFG_INVALID;
+        }
+        consumer = consumer->next_endpoint;
+    } while (consumer != NULL);
+    while (process != NULL) {
+        if ((process->iface.conceal != NULL) && (process->next_process != NULL)) {
+            /* Synthesized payloads would skip the stages after the concealing one */
+            *err = SAC_ERR_PIPELINE_CFG_INVALID;
+        }
+        process = process->next_process;
+    }
 }
 
 /** @brief Mix the producers' audio packet.
@@ -864,3 +1731,61 @@ static queue_node_t *start_mixing_process(sac_pipeline_t *pipeline, queue_node_t
 
     return node;
 }
+
+#if (SAC_PROFILING_EN > 0U)
+/** @brief Get the current cycle count.
+ *
+ *  @return DWT cycle counter on target, nanoseconds of a monotonic clock on host.
+ */
+static inline uint32_t get_cycles(void)
+{
+#if defined(__arm__)
+    return DWT_CYCCNT;
+#else
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint32_t)((uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec);
+#endif
+}
+
+/** @brief Add an execution to cycles statistics.
+ *
+ *  @param[in] stats   Cycles statistics.
+ *  @param[in] cycles  Cycles of the execution.
+ */
+static void update_cycles_stats(sac_cycles_stats_t *stats, uint32_t cycles)
+{
+    if ((stats->count == 0) || (cycles < stats->min)) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    stats->_total += cycles;
+    stats->count++;
+}
+
+/** @brief Get the cycles statistics of a consumer endpoint action.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @param[in] consumer  Consumer endpoint of the pipeline.
+ *  @return Cycles statistics, NULL if the consumer is past the profiled ones.
+ */
+static sac_cycles_stats_t *get_consumer_profile(sac_pipeline_t *pipeline, sac_endpoint_t *consumer)
+{
+    sac_endpoint_t *current_consumer = pipeline->consumer;
+    uint8_t consumer_index = 0;
+
+    while ((current_consumer != consumer) && (current_consumer != NULL)) {
+        current_consumer = current_consumer->next_endpoint;
+        consumer_index++;
+    }
+    if ((current_consumer == NULL) || (consumer_index >= SAC_PROFILING_CONSUMER_COUNT)) {
+        return NULL;
+    }
+
+    return &pipeline->_profile.consumer_action[consumer_index];
+}
+#endif
@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include "audio_mixer_module.h"
 #include "crc4_itu.h"
+#include "crc8.h"
 #include "mem_pool.h"
 #include "queue.h"
 #include "resampling.h"
@@ -30,8 +31,20 @@ extern "C" {
 #define SAC_NODE_PAYLOAD_SIZE_VAR_SIZE sizeof(uint16_t) /*!< Size of the audio payload variable. */
 #define SAC_PACKET_HEADER_OFFSET       (SAC_NODE_PAYLOAD_SIZE_OFFSET + SAC_NODE_PAYLOAD_SIZE_VAR_SIZE) /*!< Position of the audio header in the audio packet */
 #define SAC_PACKET_DATA_OFFSET         (SAC_PACKET_HEADER_OFFSET + sizeof(sac_header_t)) /*!< Position of the packet data in the audio packet */
+#define SAC_PACKET_CRC_SIZE            sizeof(uint8_t) /*!< Size of the CRC8 trailing an audio packet when payload CRC is enabled */
 #define SAC_PRODUCER_QUEUE_SIZE        3 /*!< Queue size to use when initializing a producer audio endpoint */
 #define SAC_TXQ_ARR_LEN                3 /*!< Array size holding tx queue len values to determine a rolling average */
+#define SAC_PROFILING_STAGE_COUNT      8 /*!< Number of processing stages profiled per pipeline, the following ones are not */
+#define SAC_PROFILING_CONSUMER_COUNT   4 /*!< Number of consumer endpoints profiled per pipeline, the following ones are not */
+#define SAC_MEM_POOL_OWNER_PROCESSING  1 /*!< Owner of the processing stage blocks in the audio core memory pool, released
+                                              by sac_processing_stage_deinit() */
+#define SAC_MEM_POOL_OWNER_PIPELINE    2 /*!< Owner of the pipeline, endpoint and audio queue blocks in the audio core memory
+                                              pool, released by sac_pipeline_deinit() and sac_endpoint_deinit() */
+
+/* PROFILING ******************************************************************/
+#ifndef SAC_PROFILING_EN
+#define SAC_PROFILING_EN 0 /*!< Set to 1 to record the cycles spent by each part of the pipelines */
+#endif
 
 /* MACROS *********************************************************************/
 #define sac_node_get_payload_size(node) (*((uint16_t *)(queue_get_data_ptr(node, SAC_NODE_PAYLOAD_SIZE_OFFSET)))) /*!< Get the audio payload size in the audio packet */
@@ -92,9 +105,11 @@ typedef struct sac_header {
  */
 typedef struct sac_processing_interface {
     void (*init)(void *instance, mem_pool_t *mem_pool); /*!< Function the audio core uses to execute any processing
-                                                             stage initialization sequence */
+                                                             stage initialization sequence. Its memory is allocated
+                                                             with mem_pool_alloc() and SAC_MEM_POOL_OWNER_PROCESSING */
     void (*deinit)(void *instance); /*!< Function the audio core uses to execute any processing
-                                         stage de-initialization sequence */
+                                         stage de-initialization sequence, which releases the blocks
+                                         init allocated with mem_pool_alloc() */
     uint32_t (*ctrl)(void *instance, uint8_t cmd, uint32_t args); /*!< Function the audio application uses to interact with the
                                                                        processing stage */
     uint16_t (*process)(void *instance, sac_header_t *header,
@@ -103,6 +118,18 @@ typedef struct sac_processing_interface {
     bool (*gate)(void *instance,  sac_header_t *header,
                         uint8_t *data_in, uint16_t size); /*!< Function called by process_samples prior to process to
                                                                to determine if process will be executed or not */
+    uint16_t (*conceal)(void *instance, uint8_t *data_out, uint16_t size); /*!< Function the audio core uses to synthesize
+                                                                                a payload when a delayed action consumer
+                                                                                runs out of audio packets, NULL if the stage
+                                                                                does not conceal packet losses. The payload
+                                                                                goes straight to the consumer without clock
+                                                                                drift compensation, so such a stage must be
+                                                                                the last of the pipeline */
+    bool in_place; /*!< True if process can be called with data_out pointing to data_in. The stage is then
+                        executed on the source node and no destination node is needed */
+    uint16_t output_overhead; /*!< Largest number of bytes process can output beyond its input size, 0 if the
+                                   output is never larger. The audio queue nodes are inflated by the sum over
+                                   the pipeline stages */
 } sac_processing_interface_t;
 
 /** @brief Audio Processing.
@@ -112,6 +139,12 @@ typedef struct sac_processing {
     const char *name;                    /*!< Character string describing the processing stage */
     sac_processing_interface_t iface;    /*!< Interface the processing stage must comply to */
     struct sac_processing *next_process; /*!< Pointer to the next processing state */
+    volatile bool _bypass;               /*!< Internal: Bypass requested with sac_processing_set_bypass() */
+    bool _bypass_applied;                /*!< Internal: Bypass state of the last processed audio packet */
+    bool _crossfade;                     /*!< Internal: Crossfade over one audio packet when the bypass state changes */
+    bool _initialized;                   /*!< Internal: The init function of the processing stage has been called */
+    sac_bit_depth_t _input_bit_depth;    /*!< Internal: Bit depth of the stage input, 0 for the producer's */
+    uint8_t _input_channel_count;        /*!< Internal: Channel count of the stage input, 0 for the producer's */
 } sac_processing_t;
 
 /** @brief Endpoint Interface.
@@ -140,7 +173,19 @@ typedef struct audio_endpoint_cfg {
     uint8_t channel_count;       /*!< 1 if the endpoint produces or consumes mono audio payloads and 2 for interleaved stereo */
     sac_bit_depth_t bit_depth;   /*!< Bit depth of samples the endpoint produces or consumes */
     uint16_t audio_payload_size; /*!< Size in bytes of the audio payload */
+    uint16_t max_audio_payload_size; /*!< Largest audio payload size sac_endpoint_set_audio_payload_size() can set.
+                                          Queues are sized for it. 0 to keep audio_payload_size */
     uint8_t queue_size;          /*!< Size in number of audio packets the endpoint's queue can contain */
+    bool use_spsc_queue;         /*!< True to use a lock-free single-producer single-consumer queue for the endpoint's queue.
+                                      The queue is then written and read without masking interrupts, but on overflow the
+                                      newest audio packet is dropped instead of the oldest */
+    uint8_t lent_queue_size;     /*!< Number of audio packets an endpoint without delayed action can lend at once to the layer
+                                      below it (e.g. the size of a wireless connection queue). A consumed packet is then held
+                                      until sac_endpoint_release_packet() is called instead of being copied by the endpoint.
+                                      A producer lends with sac_endpoint_lend_packet() the packets the layer below receives in,
+                                      and exchanges them with sac_endpoint_exchange_packet(). 0 if the endpoint copies them */
+    uint8_t packet_headroom;     /*!< Bytes kept free in front of the audio packets given to a producer endpoint action, so the
+                                      layer below can receive a packet in place along with its own header. 0 if none */
 } audio_endpoint_cfg_t;
 
 /** @brief Audio Endpoint.
@@ -155,6 +200,10 @@ typedef struct sac_endpoint {
     queue_t *_free_queue;               /*!< Internal: Pointer to the free queue the endpoint will retrieve free nodes from */
     queue_node_t *_current_node;        /*!< Internal: pointer to the queue node the endpoint is working with at the moment */
     bool _buffering_complete;           /*!< Internal: Whether or not the initial audio buffering has been completed */
+    queue_t *_lent_queue;               /*!< Internal: queue of the audio packets lent by the endpoint, NULL if it copies them */
+    uint8_t *_free_queue_pool;          /*!< Internal: Nodes of the free queue allocated by the endpoint, NULL if it uses
+                                                       the free queue of another endpoint */
+    bool _queue_linked;                 /*!< Internal: The queue is the one of the consumer linked with sac_endpoint_link() */
 } sac_endpoint_t;
 
 /** @brief Audio Pipeline Configuration.
@@ -164,10 +213,18 @@ typedef struct sac_pipeline_cfg {
     uint16_t cdc_resampling_length;  /*!< Amount of samples used when resampling. Can be ignored if CDC is not enabled. */
     uint16_t cdc_queue_avg_size;     /*!< Amount of measurements used when averaging the consumer queue size.
                                           Can be ignored if CDC is not enabled. */
+    resampling_mode_t cdc_resampling_mode; /*!< Resampling algorithm used by the CDC. Linear adds or removes one sample
+                                                over cdc_resampling_length samples, polyphase continuously adjusts the
+                                                resampling ratio to the consumer queue level. */
     bool do_initial_buffering;       /*!< Wait for the consumer queue (TX audio buffer) to be
                                           full before starting to consume */
     bool user_data_enable;           /*!< Set to true if using User Data processing, false otherwise */
     sac_mixer_option_t mixer_option; /*!< Configure the pipeline with mixer's specific options */
+    bool zero_copy_enable;           /*!< Producer and consumers share the same free queue and processed audio
+                                          packets are handed over to the consumer queue without being copied.
+                                          Cannot be used with mixer pipelines. */
+    bool payload_crc_enable;         /*!< Append a CRC8 of the header, payload and user data to encapsulated audio
+                                          packets and check it on reception. Must match on both ends of the link. */
 } sac_pipeline_cfg_t;
 
 /** @brief Audio Statistics.
@@ -180,8 +237,38 @@ typedef struct sac_statistics {
     uint32_t consumer_buffer_overflow_count;   /*!< Number of times the consumer queue has overflowed */
     uint32_t consumer_buffer_underflow_count;  /*!< Number of times the consumer queue has underflowed */
     uint32_t producer_packets_corrupted_count; /*!< Number of corrupted packets received from the coord */
+    uint32_t producer_payload_corrupted_count; /*!< Number of packets received with a valid header but a corrupted payload */
+    uint32_t consumer_packets_concealed_count; /*!< Number of packets a processing stage synthesized in place of missing ones */
+    uint32_t processing_crossfade_skipped_count; /*!< Number of bypass changes applied without crossfade for lack of a free node */
+    uint32_t processing_stage_skipped_count;     /*!< Number of times a processing stage did not process a packet for lack of a free node */
 } sac_statistics_t;
 
+/** @brief Audio Cycles Statistics.
+ *
+ *  Cycles are DWT cycle counts on target and nanoseconds of a monotonic clock on host.
+ */
+typedef struct sac_cycles_stats {
+    uint32_t min;    /*!< Minimum cycles of a single execution */
+    uint32_t avg;    /*!< Average cycles, updated by sac_pipeline_get_profile() */
+    uint32_t max;    /*!< Maximum cycles of a single execution */
+    uint32_t count;  /*!< Number of executions */
+    uint64_t _total; /*!< Internal: Sum of the cycles of all executions */
+} sac_cycles_stats_t;
+
+/** @brief Audio Pipeline Profile.
+ */
+typedef struct sac_pipeline_profile {
+    sac_cycles_stats_t process;         /*!< Whole sac_pipeline_process() */
+    sac_cycles_stats_t dequeue;         /*!< Getting the packet to process from the producer queue or the mixer */
+    sac_cycles_stats_t stage[SAC_PROFILING_STAGE_COUNT]; /*!< Processing stages, gate included, in the order of the
+                                                               pipeline's processing list */
+    sac_cycles_stats_t cdc;             /*!< Clock drift compensation */
+    sac_cycles_stats_t enqueue;         /*!< Handing the processed packet to the consumer queues */
+    sac_cycles_stats_t producer_action; /*!< Action of the pipeline's producer endpoint */
+    sac_cycles_stats_t consumer_action[SAC_PROFILING_CONSUMER_COUNT]; /*!< Action of each consumer endpoint, in the order
+                                                                           of the pipeline's consumer list */
+} sac_pipeline_profile_t;
+
 /** @brief Audio Pipeline.
  */
 typedef struct sac_pipeline {
@@ -197,7 +284,12 @@ typedef struct sac_pipeline {
     uint8_t _buffering_threshold;      /*!< Internal: The number of audio packets to buffer before considering
                                             the initial buffering complete */
     uint8_t _user_data_size;           /*!< Internal: Set to 0 or 1 depending on cfg->enable_user_data */
+    uint8_t _packet_crc_size;          /*!< Internal: Set to 0 or SAC_PACKET_CRC_SIZE depending on cfg->payload_crc_enable */
+    uint8_t _consumer_count;           /*!< Internal: Number of consumers sharing each processed audio packet */
     sac_cdc_instance_t *_cdc_instance; /*!< Internal: CDC instance for this pipeline */
+#if (SAC_PROFILING_EN > 0U)
+    sac_pipeline_profile_t _profile;   /*!< Internal: Cycles spent by each part of the pipeline */
+#endif
 } sac_pipeline_t;
 
 /** @brief Audio Fallback Module Configuration.
@@ -274,6 +366,13 @@ void sac_init(queue_critical_cfg_t queue_critical, uint8_t *queue_memory, uint32
  */
 void sac_mixer_module_init(audio_mixer_module_cfg_t cfg, sac_error_t *err);
 
+/** @brief Set the gain of an Audio Mixer Module input.
+ *
+ *  @param[in] input  Input index, in the order of the mixer input pipelines producers.
+ *  @param[in] gain   Q2.14 gain, AUDIO_MIXER_GAIN_UNITY for 1.0.
+ */
+void sac_mixer_module_set_input_gain(uint8_t input, int16_t gain);
+
 /** @brief Initialize the Audio Fallback Module.
  *
  *  @note Only call this initialization when the Fallback Module is needed.
@@ -306,6 +405,25 @@ sac_pipeline_t *sac_pipeline_init(const char *name, sac_endpoint_t *producer,
  */
 sac_endpoint_t *sac_endpoint_init(void *instance, const char *name, sac_endpoint_interface_t iface, audio_endpoint_cfg_t cfg, sac_error_t *err);
 
+/** @brief Deinitialize an audio pipeline and release its memory.
+ *
+ *  The pipeline must be stopped. Its endpoints and processing stages are left as is,
+ *  release them with sac_endpoint_deinit() and sac_processing_stage_deinit().
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ */
+void sac_pipeline_deinit(sac_pipeline_t *pipeline);
+
+/** @brief Deinitialize an audio endpoint and release its memory.
+ *
+ *  The audio queues the endpoint allocated are released with it. Since the consumers of a
+ *  pipeline share the free queue of the first one, and a linked producer the queues of its
+ *  consumer, deinitialize together every endpoint of the pipelines using them, once stopped.
+ *
+ *  @param[in] endpoint  Endpoint instance.
+ */
+void sac_endpoint_deinit(sac_endpoint_t *endpoint);
+
 /** @brief Link the queue of a consumer endpoint with a producer endpoint.
  *
  *  @note This feature is used for audio mixing.
@@ -326,6 +444,15 @@ void sac_endpoint_link(sac_endpoint_t *consumer, sac_endpoint_t *producer, sac_e
  */
 sac_processing_t *sac_processing_stage_init(void *instance, const char *name, sac_processing_interface_t iface, sac_error_t *err);
 
+/** @brief Deinitialize an audio processing stage and release its memory.
+ *
+ *  The stage must not be part of a pipeline, remove it first if needed. Its memory
+ *  goes back to the audio core memory pool, for the next stages to be initialized.
+ *
+ *  @param[in] process  Processing stage.
+ */
+void sac_processing_stage_deinit(sac_processing_t *process);
+
 /** @brief Add a processing stage to the pipeline.
  *
  *  @param[in] pipeline  Pipeline instance.
@@ -333,6 +460,112 @@ sac_processing_t *sac_processing_stage_init(void *instance, const char *name, sa
  */
 void sac_pipeline_add_processing(sac_pipeline_t *pipeline, sac_processing_t *process);
 
+/** @brief Insert a processing stage in a pipeline, which may be running.
+ *
+ *  @note Must be called from the context calling sac_pipeline_process().
+ *
+ *  The stage is linked with a single release store, so it applies from one audio packet
+ *  to the next and the consumer interrupt looking for a concealing stage always sees a
+ *  complete chain. It is initialized if this is the first time it is used. Nothing can
+ *  be inserted after a stage concealing packet losses.
+ *
+ *  @param[in]  pipeline  Pipeline instance.
+ *  @param[in]  process   Processing stage to insert.
+ *  @param[in]  previous  Processing stage after which to insert, NULL to insert first.
+ *  @param[out] err       Error code.
+ */
+void sac_pipeline_insert_processing(sac_pipeline_t *pipeline, sac_processing_t *process,
+                                    sac_processing_t *previous, sac_error_t *err);
+
+/** @brief Remove a processing stage from a pipeline, which may be running.
+ *
+ *  @note Must be called from the context calling sac_pipeline_process().
+ *
+ *  The stage keeps its state and can be inserted again. Since no audio packet goes through
+ *  the pipeline while this runs, and the consumer interrupt completes its search for a
+ *  concealing stage before this resumes, the stage is unused once this returns. It can then
+ *  be reused right away or released with sac_processing_stage_deinit().
+ *
+ *  The pipeline is left unchanged and SAC_ERR_PIPELINE_CFG_INVALID is returned when the
+ *  stage is not part of it.
+ *
+ *  @param[in]  pipeline  Pipeline instance.
+ *  @param[in]  process   Processing stage to remove.
+ *  @param[out] err       Error code.
+ */
+void sac_pipeline_remove_processing(sac_pipeline_t *pipeline, sac_processing_t *process, sac_error_t *err);
+
+/** @brief Bypass or restore a processing stage.
+ *
+ *  The change applies to the next audio packet. With crossfade, the stage still processes that packet
+ *  and its output is faded against its input over the packet. This requires the stage input to be
+ *  PCM samples, in the producer format unless set by sac_processing_set_input_format(), and the
+ *  stage to keep the payload size. Otherwise the stage processes that packet and the switch is made
+ *  on the next one. If no free node is left to hold the stage input, the switch is made without
+ *  crossfade and counted in the processing_crossfade_skipped_count statistic.
+ *
+ *  @param[in] process    Processing stage.
+ *  @param[in] bypass     True to skip the stage, false to execute it.
+ *  @param[in] crossfade  True to crossfade between the processed and bypassed audio.
+ */
+void sac_processing_set_bypass(sac_processing_t *process, bool bypass, bool crossfade);
+
+/** @brief Set the format of the samples a processing stage receives.
+ *
+ *  Only needed to crossfade the bypass of a stage placed after one changing the bit
+ *  depth or the channel count, since the producer format is assumed otherwise.
+ *
+ *  @param[in] process        Processing stage.
+ *  @param[in] bit_depth      Bit depth of the stage input.
+ *  @param[in] channel_count  Channel count of the stage input.
+ */
+void sac_processing_set_input_format(sac_processing_t *process, sac_bit_depth_t bit_depth, uint8_t channel_count);
+
+/** @brief Change the audio payload size of an endpoint while the pipeline runs.
+ *
+ *  The new size applies to the next audio packet the endpoint produces. It must not
+ *  exceed the endpoint max_audio_payload_size. Consumer sizes can not be changed on
+ *  pipelines using CDC, and neither can endpoint sizes of mixer pipelines.
+ *
+ *  @param[in]  pipeline      Pipeline instance.
+ *  @param[in]  endpoint      Producer or consumer endpoint of the pipeline.
+ *  @param[in]  payload_size  New audio payload size, in bytes.
+ *  @param[out] err           Error code.
+ */
+void sac_endpoint_set_audio_payload_size(sac_pipeline_t *pipeline, sac_endpoint_t *endpoint,
+                                         uint16_t payload_size, sac_error_t *err);
+
+/** @brief Release the oldest audio packet lent by a consumer endpoint.
+ *
+ *  @note Lent audio packets must be released in the order they were consumed. Can be called
+ *        from an interrupt context: the lent queue is lock-free, but returning the packet to
+ *        its free queue enters the Audio Core critical section for a few instructions.
+ *
+ *  @param[in] consumer  Consumer endpoint configured with a lent_queue_size.
+ */
+void sac_endpoint_release_packet(sac_endpoint_t *consumer);
+
+/** @brief Lend an audio packet of a producer endpoint to the layer below it.
+ *
+ *  The layer below keeps the packet to receive audio packets in, with packet_headroom bytes
+ *  free in front of it. Must be called after sac_pipeline_setup(), at most lent_queue_size times.
+ *
+ *  @param[in] producer  Producer endpoint configured with a lent_queue_size.
+ *  @return Lent audio packet, laid out as the packets given to the producer action. NULL if none is left.
+ */
+uint8_t *sac_endpoint_lend_packet(sac_endpoint_t *producer);
+
+/** @brief Exchange the audio packet a producer endpoint is producing for one received in place.
+ *
+ *  Must be called from the producer endpoint action. The packet given to the action is then
+ *  owned by the layer below to receive in, and the received packet is produced instead of
+ *  being copied.
+ *
+ *  @param[in] producer  Producer endpoint configured with a lent_queue_size.
+ *  @param[in] packet    Received audio packet, in a packet lent by the producer or exchanged before.
+ */
+void sac_endpoint_exchange_packet(sac_endpoint_t *producer, uint8_t *packet);
+
 /** @brief Add an extra consumer endpoint to the pipeline.
  *
  *  @param[in] pipeline       Pipeline instance.
@@ -450,12 +683,42 @@ uint32_t sac_pipeline_get_consumer_buffer_underflow_count(sac_pipeline_t *pipeli
  */
 uint32_t sac_pipeline_get_producer_packets_corrupted_count(sac_pipeline_t *pipeline);
 
+/** @brief Get producer packets received with a corrupted payload.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @return Producer packets with a corrupted payload.
+ */
+uint32_t sac_pipeline_get_producer_payload_corrupted_count(sac_pipeline_t *pipeline);
+
+/** @brief Get the number of audio packets concealed for the consumer.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @return Consumer packets synthesized by a concealment processing stage.
+ */
+uint32_t sac_pipeline_get_consumer_packets_concealed_count(sac_pipeline_t *pipeline);
+
 /** @brief Reset the audio stats.
  *
  *  @param[in] pipeline  Pipeline instance.
  */
 void sac_pipeline_reset_stats(sac_pipeline_t *pipeline);
 
+/** @brief Get the cycles spent by each part of the pipeline.
+ *
+ *  @note Only available when SAC_PROFILING_EN is set, on target the DWT cycle counter
+ *        is enabled by sac_init().
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ *  @return Pipeline profile, NULL if profiling is compiled out.
+ */
+sac_pipeline_profile_t *sac_pipeline_get_profile(sac_pipeline_t *pipeline);
+
+/** @brief Reset the cycles statistics of the pipeline.
+ *
+ *  @param[in] pipeline  Pipeline instance.
+ */
+void sac_pipeline_reset_profile(sac_pipeline_t *pipeline);
+
 /** @brief Get the number of bytes allocated in the memory pool.
  *
  *  @return Number of bytes allocated in the memory pool.
@@ -26,7 +26,8 @@ typedef enum sac_error {
                                             module initialization */
     SAC_ERR_PIPELINE_CFG_INVALID,      /*!< Pipeline configuration is invalid */
     SAC_ERR_NULL_PTR,                  /*!< A pointer is NULL while it should have been initialized */
-    SAC_ERR_MIXER_INIT_FAILURE         /*!< An error occurred during the mixer module initialization */
+    SAC_ERR_MIXER_INIT_FAILURE,        /*!< An error occurred during the mixer module initialization */
+    SAC_ERR_PAYLOAD_SIZE_INVALID       /*!< Audio payload size exceeds the size the queues were allocated for */
 } sac_error_t;
 
 
@@ -28,20 +28,24 @@
 #define WPS_INTEGGAIN_ONE_PULSE_VAL      1
 #define WPS_INTEGGAIN_MANY_PULSES_VAL    0
 
+#define SWC_MEM_POOL_OWNER_WPS           1 /* Callback, request and timeslot blocks allocated by swc_init() */
+#define SWC_MEM_POOL_OWNER_NODE          2 /* Node and radio blocks */
+#define SWC_MEM_POOL_OWNER_CONNECTION    3 /* Connection and channel blocks */
+
 /* MACROS *********************************************************************/
 #define HW_ADDR(net_id, node_id) ((net_id << 8) | node_id)
 #define NET_ID_FROM_PAN_ID(pan_id) (pan_id & 0x0ff)
 #define SYNCWORD_ID_FROM_PAN_ID(pan_id) ((pan_id & 0xf00) >> 8)
 
-#define MEM_ALLOC_CHECK_RETURN_NULL(ptr, size, err) { \
-    ptr = mem_pool_malloc(&mem_pool, size); \
+#define MEM_ALLOC_CHECK_RETURN_NULL(ptr, size, owner, err) { \
+    ptr = mem_pool_alloc(&mem_pool, size, owner, MEM_POOL_FLAG_NONE); \
     if (ptr == NULL) { \
         *err = SWC_ERR_NOT_ENOUGH_MEMORY; \
         return NULL; \
     } \
 }
-#define MEM_ALLOC_CHECK_RETURN_VOID(ptr, size, err) { \
-    ptr = mem_pool_malloc(&mem_pool, size); \
+#define MEM_ALLOC_CHECK_RETURN_VOID(ptr, size, owner, err) { \
+    ptr = mem_pool_alloc(&mem_pool, size, owner, MEM_POOL_FLAG_NONE); \
     if (ptr == NULL) { \
         *err = SWC_ERR_NOT_ENOUGH_MEMORY; \
         return; \
@@ -69,9 +73,9 @@ void swc_init(swc_cfg_t cfg, swc_hal_t *hal, swc_error_t *err)
 
     mem_pool_init(&mem_pool, cfg.memory_pool, (size_t)cfg.memory_pool_size);
 
-    MEM_ALLOC_CHECK_RETURN_VOID(timeslots, sizeof(timeslot_t) * cfg.timeslot_sequence_length, err);
-    MEM_ALLOC_CHECK_RETURN_VOID(callback_queue, sizeof(wps_callback_inst_t) * WPS_DEFAULT_CALLBACK_QUEUE_SIZE, err);
-    MEM_ALLOC_CHECK_RETURN_VOID(request, sizeof(wps_request_info_t) * WPS_REQUEST_MEMORY_SIZE, err);
+    MEM_ALLOC_CHECK_RETURN_VOID(timeslots, sizeof(timeslot_t) * cfg.timeslot_sequence_length, SWC_MEM_POOL_OWNER_WPS, err);
+    MEM_ALLOC_CHECK_RETURN_VOID(callback_queue, sizeof(wps_callback_inst_t) * WPS_DEFAULT_CALLBACK_QUEUE_SIZE, SWC_MEM_POOL_OWNER_WPS, err);
+    MEM_ALLOC_CHECK_RETURN_VOID(request, sizeof(wps_request_info_t) * WPS_REQUEST_MEMORY_SIZE, SWC_MEM_POOL_OWNER_WPS, err);
 
     /* Initialize the callback queue which will be used to accumulate and run the WPS callbacks asynchronously */
     wps_init_callback_queue(&wps, callback_queue, WPS_DEFAULT_CALLBACK_QUEUE_SIZE, hal->context_switch);
@@ -119,9 +123,9 @@ swc_node_t *swc_node_init(swc_node_cfg_t cfg, swc_error_t *err)
 
     *err = SWC_ERR_NONE;
 
-    MEM_ALLOC_CHECK_RETURN_NULL(node, sizeof(swc_node_t), err);
-    MEM_ALLOC_CHECK_RETURN_NULL(node->wps_node_handle, sizeof(wps_node_t), err);
-    MEM_ALLOC_CHECK_RETURN_NULL(node->wps_radio_handle, sizeof(wps_radio_t) * WPS_RADIO_COUNT, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(node, sizeof(swc_node_t), SWC_MEM_POOL_OWNER_NODE, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(node->wps_node_handle, sizeof(wps_node_t), SWC_MEM_POOL_OWNER_NODE, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(node->wps_radio_handle, sizeof(wps_radio_t) * WPS_RADIO_COUNT, SWC_MEM_POOL_OWNER_NODE, err);
 
     node->radio_count = 0;
     node->cfg = cfg;
@@ -152,8 +156,8 @@ void swc_node_add_radio(swc_node_t *node, swc_radio_cfg_t cfg, swc_hal_t *hal, s
     node->wps_radio_handle[radio_id].radio.irq_polarity = cfg.irq_polarity;
     node->wps_radio_handle[radio_id].radio.std_spi      = cfg.std_spi;
 
-    MEM_ALLOC_CHECK_RETURN_VOID(node->wps_radio_handle[radio_id].nvm, sizeof(nvm_t), err);
-    MEM_ALLOC_CHECK_RETURN_VOID(node->wps_radio_handle[radio_id].spectral_calib_vars, sizeof(calib_vars_t), err);
+    MEM_ALLOC_CHECK_RETURN_VOID(node->wps_radio_handle[radio_id].nvm, sizeof(nvm_t), SWC_MEM_POOL_OWNER_NODE, err);
+    MEM_ALLOC_CHECK_RETURN_VOID(node->wps_radio_handle[radio_id].spectral_calib_vars, sizeof(calib_vars_t), SWC_MEM_POOL_OWNER_NODE, err);
 
     /* Disable MCU external interrupt servicing the radio IRQ before initializing the WPS.
      * It will be later re-activated with a call to the swc_connect() function.
@@ -195,19 +199,19 @@ swc_connection_t *swc_connection_init(swc_node_t *node, swc_connection_cfg_t cfg
                                                       header_size + WPS_PAYLOAD_SIZE_BYTE_SIZE;
 
     /* Allocate memory */
-    MEM_ALLOC_CHECK_RETURN_NULL(conn, sizeof(swc_connection_t), err);
-    MEM_ALLOC_CHECK_RETURN_NULL(conn->wps_conn_handle, sizeof(wps_connection_t), err);
-    MEM_ALLOC_CHECK_RETURN_NULL(xlayer_queue, sizeof(xlayer_t) * cfg.queue_size, err);
-    MEM_ALLOC_CHECK_RETURN_NULL(frame_queue, sizeof(uint8_t) * cfg.queue_size * conn_frame_length, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(conn, sizeof(swc_connection_t), SWC_MEM_POOL_OWNER_CONNECTION, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(conn->wps_conn_handle, sizeof(wps_connection_t), SWC_MEM_POOL_OWNER_CONNECTION, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(xlayer_queue, sizeof(xlayer_t) * cfg.queue_size, SWC_MEM_POOL_OWNER_CONNECTION, err);
+    MEM_ALLOC_CHECK_RETURN_NULL(frame_queue, sizeof(uint8_t) * cfg.queue_size * conn_frame_length, SWC_MEM_POOL_OWNER_CONNECTION, err);
     if (cfg.fallback_enabled) {
         threshold_count = 1;
-        MEM_ALLOC_CHECK_RETURN_NULL(fallback_threshold, sizeof(uint8_t) * threshold_count, err);
+        MEM_ALLOC_CHECK_RETURN_NULL(fallback_threshold, sizeof(uint8_t) * threshold_count, SWC_MEM_POOL_OWNER_CONNECTION, err);
         memcpy(fallback_threshold, &cfg.fallback_settings.threshold, threshold_count);
     }
     if (cfg.throttling_enabled) {
-        MEM_ALLOC_CHECK_RETURN_NULL(conn->wps_conn_handle->pattern, sizeof(bool) * WPS_CONNECTION_THROTTLE_GRANULARITY, err);
+        MEM_ALLOC_CHECK_RETURN_NULL(conn->wps_conn_handle->pattern, sizeof(bool) * WPS_CONNECTION_THROTTLE_GRANULARITY, SWC_MEM_POOL_OWNER_CONNECTION, err);
     }
-    MEM_ALLOC_CHECK_RETURN_NULL(channel_buffer, sizeof(rf_channel_t[WPS_NB_RF_CHANNEL][WPS_RADIO_COUNT]) * (threshold_count + 1), err);
+    MEM_ALLOC_CHECK_RETURN_NULL(channel_buffer, sizeof(rf_channel_t[WPS_NB_RF_CHANNEL][WPS_RADIO_COUNT]) * (threshold_count + 1), SWC_MEM_POOL_OWNER_CONNECTION, err);
 
     conn->channel_count = 0;
     conn->cfg = cfg;
@@ -272,7 +276,7 @@ void swc_connection_add_channel(swc_connection_t *conn, swc_node_t *node, swc_ch
 
     *err = SWC_ERR_NONE;
 
-    MEM_ALLOC_CHECK_RETURN_VOID(wps_chann_cfg.power, sizeof(tx_power_settings_t), err);
+    MEM_ALLOC_CHECK_RETURN_VOID(wps_chann_cfg.power, sizeof(tx_power_settings_t), SWC_MEM_POOL_OWNER_CONNECTION, err);
 
     /* Configure RF channels the connection will use */
     wps_chann_cfg.frequency          = cfg.frequency;
@@ -321,6 +325,12 @@ void swc_connection_set_rx_success_callback(swc_connection_t *conn, void (*cb)(v
     conn->wps_conn_handle->rx_success_parg_callback_t = conn;
 }
 
+void swc_connection_set_tx_release_callback(swc_connection_t *conn, void (*cb)(void *parg, uint8_t *payload_buffer),
+                                            void *parg)
+{
+    wps_set_tx_release_callback(conn->wps_conn_handle, cb, parg);
+}
+
 void swc_connection_set_throttling_active_ratio(swc_connection_t *conn, uint8_t active_ratio, swc_error_t *err)
 {
     wps_error_t wps_err;
@@ -349,6 +359,9 @@ void swc_connection_send(swc_connection_t *conn, uint8_t *payload_buffer, uint8_
     *err = SWC_ERR_NONE;
 
     wps_send(conn->wps_conn_handle, payload_buffer, size, &wps_err);
+    if (wps_err != WPS_NO_ERROR) {
+        *err = SWC_ERR_SEND_FAILED;
+    }
 }
 
 uint8_t swc_connection_receive(swc_connection_t *conn, uint8_t **payload, swc_error_t *err)
@@ -373,6 +386,34 @@ void swc_connection_receive_complete(swc_connection_t *conn, swc_error_t *err)
     wps_read_done(conn->wps_conn_handle, &wps_err);
 }
 
+uint8_t swc_connection_receive_exchange(swc_connection_t *conn, uint8_t **payload_buffer, uint8_t *rx_buffer,
+                                        swc_error_t *err)
+{
+    wps_error_t wps_err;
+    wps_rx_frame frame;
+
+    *err = SWC_ERR_NONE;
+
+    frame = wps_read(conn->wps_conn_handle, &wps_err);
+    *payload_buffer = wps_read_exchange(conn->wps_conn_handle, rx_buffer, &wps_err);
+
+    return frame.size;
+}
+
+void swc_connection_set_rx_payload_buffer(swc_connection_t *conn, uint8_t index, uint8_t *rx_buffer, swc_error_t *err)
+{
+    wps_error_t wps_err;
+
+    *err = SWC_ERR_NONE;
+
+    wps_set_rx_payload_memory(conn->wps_conn_handle, index, rx_buffer, &wps_err);
+}
+
+uint8_t swc_connection_get_rx_headroom(swc_connection_t *conn)
+{
+    return wps_get_rx_headroom(conn->wps_conn_handle);
+}
+
 void swc_setup(swc_node_t *node)
 {
     wps_error_t wps_err;
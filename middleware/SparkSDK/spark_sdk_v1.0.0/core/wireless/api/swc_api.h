@@ -245,6 +245,21 @@ void swc_connection_set_tx_dropped_callback(swc_connection_t *conn, void (*cb)(v
  */
 void swc_connection_set_rx_success_callback(swc_connection_t *conn, void (*cb)(void *conn));
 
+/** @brief Set the callback function to execute when the connection returns a payload buffer.
+ *
+ *  @note Once a frame leaves the transmission queue, either transmitted or dropped, the buffer
+ *        given to swc_connection_send() is handed back to the callback. This lets the application
+ *        lend its own buffers to the connection instead of copying payloads in the buffers of
+ *        swc_connection_get_payload_buffer(). A lent buffer must not be modified until it is
+ *        returned. Buffers are returned in the order they were sent.
+ *
+ *  @param[in] conn  Connection handle.
+ *  @param[in] cb    Callback function.
+ *  @param[in] parg  Void pointer argument for the callback.
+ */
+void swc_connection_set_tx_release_callback(swc_connection_t *conn, void (*cb)(void *parg, uint8_t *payload_buffer),
+                                            void *parg);
+
 /** @brief Set the percentage of allocated timeslots to use.
  *
  *  The throttling feature reduces the usable bandwidth in order to reduce power consumption.
@@ -271,7 +286,7 @@ void swc_connection_get_payload_buffer(swc_connection_t *conn, uint8_t **payload
  *  @param[in]  conn            Connection handle.
  *  @param[in]  payload_buffer  Buffer containing the payload to transmit.
  *  @param[in]  size            Size of the payload.
- *  @param[out] err             Wireless Core error code.
+ *  @param[out] err             Wireless Core error code, SWC_ERR_SEND_FAILED if the payload was not enqueued.
  */
 void swc_connection_send(swc_connection_t *conn, uint8_t *payload_buffer, uint8_t size, swc_error_t *err);
 
@@ -291,6 +306,43 @@ uint8_t swc_connection_receive(swc_connection_t *conn, uint8_t **payload_buffer,
  */
 void swc_connection_receive_complete(swc_connection_t *conn, swc_error_t *err);
 
+/** @brief Exchange the last received payload buffer for another buffer.
+ *
+ *  @note The received payload is handed to the application instead of being copied out of
+ *        the connection reception queue, and the queue receives its next frame in the given
+ *        buffer instead. Every buffer given must hold swc_connection_get_rx_headroom() bytes
+ *        in front of the payload and max_payload_size bytes from it. The payload must still
+ *        be removed with swc_connection_receive_complete().
+ *
+ *  @param[in]  conn            Connection handle.
+ *  @param[out] payload_buffer  Received payload, now owned by the application. NULL if none.
+ *  @param[in]  rx_buffer       Buffer where the next payload is received.
+ *  @param[out] err             Wireless Core error code.
+ *  @return Size of the payload.
+ */
+uint8_t swc_connection_receive_exchange(swc_connection_t *conn, uint8_t **payload_buffer, uint8_t *rx_buffer,
+                                        swc_error_t *err);
+
+/** @brief Set a buffer the connection reception queue receives in.
+ *
+ *  @note Must be called before swc_connect() for each of the queue_size entries of the
+ *        queue, so every payload received is in a buffer of the application to exchange
+ *        with swc_connection_receive_exchange().
+ *
+ *  @param[in]  conn       Connection handle.
+ *  @param[in]  index      Entry of the reception queue, below the connection queue_size.
+ *  @param[in]  rx_buffer  Buffer where the payloads of the entry are received.
+ *  @param[out] err        Wireless Core error code.
+ */
+void swc_connection_set_rx_payload_buffer(swc_connection_t *conn, uint8_t index, uint8_t *rx_buffer, swc_error_t *err);
+
+/** @brief Get the number of bytes the connection writes in front of a received payload.
+ *
+ *  @param[in] conn  Connection handle.
+ *  @return Headroom required in front of the buffers given to the reception queue.
+ */
+uint8_t swc_connection_get_rx_headroom(swc_connection_t *conn);
+
 /** @brief Wireless Core setup.
  *
  *  This is the last API call that needs to be made when initializing and
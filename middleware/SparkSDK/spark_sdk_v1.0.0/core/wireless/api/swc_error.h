@@ -14,8 +14,9 @@
  */
 typedef enum swc_error {
     SWC_ERR_NONE = 0,         /*!< No error occurred */
-    SWC_ERR_NOT_ENOUGH_MEMORY /*!< Not enough memory is allocated by the application
-                                   for a full wireless core initialization */
+    SWC_ERR_NOT_ENOUGH_MEMORY, /*!< Not enough memory is allocated by the application
+                                    for a full wireless core initialization */
+    SWC_ERR_SEND_FAILED        /*!< The payload could not be enqueued in the connection transmission queue */
 } swc_error_t;
 
 
@@ -9,6 +9,7 @@
 
 /* INCLUDES *******************************************************************/
 #include "swc_stats.h"
+#include <inttypes.h>
 #include <stdio.h>
 #include "swc_api.h"
 #include "wps_stats.h"
@@ -79,11 +80,11 @@ int swc_connection_format_stats(swc_connection_t *conn, swc_node_t *node, char *
 
         string_length = snprintf(buffer, size,
                                  "<<< %s >>>\r\n"
-                                 "%s:\t\t%10lu\r\n"
-                                 "  %s:\t%10lu (%05.2f%%)\r\n"
-                                 "  %s:\t%10lu (%05.2f%%)\r\n"
-                                 "  %s:\t%10lu (%05.2f%%)\r\n"
-                                 "%s: %lu\r\n"
+                                 "%s:\t\t%10" PRIu32 "\r\n"
+                                 "  %s:\t%10" PRIu32 " (%05.2f%%)\r\n"
+                                 "  %s:\t%10" PRIu32 " (%05.2f%%)\r\n"
+                                 "  %s:\t%10" PRIu32 " (%05.2f%%)\r\n"
+                                 "%s: %" PRIu32 "\r\n"
                                  "%s: %.2f%%\r\n",
                                  conn->cfg.name,
                                  tx_timeslot_occurrence_str, conn->stats.tx_timeslot_occurrence,
@@ -108,11 +109,11 @@ int swc_connection_format_stats(swc_connection_t *conn, swc_node_t *node, char *
 
         string_length = snprintf(buffer, size,
                                  "<<< %s >>>\r\n"
-                                 "%s:\t\t%10lu\r\n"
-                                 "  %s:\t%10lu (%05.2f%%)\r\n"
-                                 "  %s:\t\t%10lu (%05.2f%%)\r\n"
-                                 "%s: %lu\r\n"
-                                 "%s: %lu\r\n",
+                                 "%s:\t\t%10" PRIu32 "\r\n"
+                                 "  %s:\t%10" PRIu32 " (%05.2f%%)\r\n"
+                                 "  %s:\t\t%10" PRIu32 " (%05.2f%%)\r\n"
+                                 "%s: %" PRIu32 "\r\n"
+                                 "%s: %" PRIu32 "\r\n",
                                  conn->cfg.name,
                                  rx_timeslot_occurrence_str, conn->stats.rx_timeslot_occurrence,
                                  packet_successfully_received_count_str, conn->stats.packet_successfully_received_count,
@@ -14,6 +14,7 @@
 
 /* PRIVATE FUNCTION PROTOTYPES ************************************************/
 static inline bool time_slot_is_empty(scheduler_t *scheduler, timeslot_t *time_slot);
+static void update_next_time_slots(scheduler_t *scheduler);
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 void link_scheduler_init(scheduler_t *scheduler,
@@ -24,12 +25,15 @@ void link_scheduler_init(scheduler_t *scheduler,
     scheduler->total_time_slot_count = schedule->size;
     scheduler->schedule = schedule;
     scheduler->local_addr = local_addr;
+
+    update_next_time_slots(scheduler);
 }
 
 void link_scheduler_reset(scheduler_t *scheduler)
 {
-    scheduler->current_time_slot_num = 0;
+    /* No time slot is incremented past this, before the time slots are cleared */
     scheduler->total_time_slot_count = 0;
+    scheduler->current_time_slot_num = 0;
     scheduler->sleep_cycles = 0;
     scheduler->tx_disabled = false;
 
@@ -40,32 +44,19 @@ void link_scheduler_reset(scheduler_t *scheduler)
 
 uint8_t link_scheduler_increment_time_slot(scheduler_t *scheduler)
 {
-    uint8_t i = scheduler->current_time_slot_num;
-    uint8_t inc_count = 0;
+    timeslot_t *time_slot;
 
     scheduler->timeslot_mismatch = false;
 
-    if (scheduler->total_time_slot_count != 0) {
-        timeslot_t *next_time_slot = &scheduler->schedule->timeslot[(i + 1) % scheduler->total_time_slot_count];
+    if (scheduler->total_time_slot_count == 0) {
+        return 0;
+    }
 
-        if (time_slot_is_empty(scheduler, next_time_slot)) {
-            scheduler->sleep_cycles += scheduler->schedule->timeslot[i].duration_pll_cycles;
-            i = (i + 1) % scheduler->total_time_slot_count;
-            inc_count++;
-            while (time_slot_is_empty(scheduler, &scheduler->schedule->timeslot[i])) {
-                scheduler->sleep_cycles += scheduler->schedule->timeslot[i].duration_pll_cycles;
-                i = (i + 1) % scheduler->total_time_slot_count;
-                inc_count++;
-            };
-        } else {
-            scheduler->sleep_cycles += scheduler->schedule->timeslot[i].duration_pll_cycles;
-            i = (i + 1) % scheduler->total_time_slot_count;
-            inc_count++;
-        }
+    time_slot = &scheduler->schedule->timeslot[scheduler->current_time_slot_num];
+    scheduler->sleep_cycles += time_slot->next_sleep_cycles;
+    scheduler->current_time_slot_num = time_slot->next_time_slot_num;
 
-        scheduler->current_time_slot_num = i;
-    }
-    return inc_count;
+    return time_slot->next_inc_count;
 }
 
 void link_scheduler_set_time_slot_i(scheduler_t *scheduler, uint8_t time_slot_i)
@@ -75,12 +66,18 @@ void link_scheduler_set_time_slot_i(scheduler_t *scheduler, uint8_t time_slot_i)
 
 void link_scheduler_enable_tx(scheduler_t *scheduler)
 {
-    scheduler->tx_disabled = false;
+    if (scheduler->tx_disabled) {
+        scheduler->tx_disabled = false;
+        update_next_time_slots(scheduler);
+    }
 }
 
 void link_scheduler_disable_tx(scheduler_t *scheduler)
 {
-    scheduler->tx_disabled = true;
+    if (!scheduler->tx_disabled) {
+        scheduler->tx_disabled = true;
+        update_next_time_slots(scheduler);
+    }
 }
 
 timeslot_t *link_scheduler_get_current_timeslot(scheduler_t *scheduler)
@@ -142,3 +139,45 @@ static inline bool time_slot_is_empty(scheduler_t *scheduler, timeslot_t *time_s
         return false;
     }
 }
+
+/** @brief Compute the next non-empty time slot of every time slot.
+ *
+ *  The time slots are walked once here, outside the radio interrupt, so
+ *  incrementing the time slot only has to read the result. Without any
+ *  non-empty time slot, every time slot moves to the following one.
+ *
+ *  @note The results are built in locals and each field is stored once,
+ *        so the radio interrupt never reads a partial sum.
+ *
+ *  @param[in]  scheduler  Scheduler object.
+ */
+static void update_next_time_slots(scheduler_t *scheduler)
+{
+    timeslot_t *time_slot;
+    uint8_t count = scheduler->total_time_slot_count;
+    uint32_t sleep_cycles;
+    uint8_t inc_count;
+    uint8_t i;
+
+    for (uint8_t start = 0; start < count; start++) {
+        time_slot = &scheduler->schedule->timeslot[start];
+        sleep_cycles = 0;
+        inc_count = 0;
+        i = start;
+        do {
+            sleep_cycles += scheduler->schedule->timeslot[i].duration_pll_cycles;
+            inc_count++;
+            i = (i + 1) % count;
+        } while ((i != start) && time_slot_is_empty(scheduler, &scheduler->schedule->timeslot[i]));
+
+        /* Back to the start, which is the only non-empty time slot or no time slot is */
+        if ((i == start) && time_slot_is_empty(scheduler, time_slot)) {
+            sleep_cycles = time_slot->duration_pll_cycles;
+            inc_count = 1;
+            i = (start + 1) % count;
+        }
+        time_slot->next_sleep_cycles = sleep_cycles;
+        time_slot->next_inc_count = inc_count;
+        time_slot->next_time_slot_num = i;
+    }
+}
@@ -25,6 +25,9 @@ typedef struct timeslot {
     wps_connection_t* connection_main;       /**< Main connection instance. */
     wps_connection_t* connection_auto_reply; /**< Auto-reply connection instance. */
     uint32_t          duration_pll_cycles;   /**< Timeslot duration, in PLL cycles. */
+    uint32_t          next_sleep_cycles;     /**< Time until the next non-empty timeslot, in PLL cycles. */
+    uint8_t           next_time_slot_num;    /**< Index of the next non-empty timeslot. */
+    uint8_t           next_inc_count;        /**< Number of timeslots up to the next non-empty timeslot. */
 } timeslot_t;
 
 /** @brief Schedule instance.
@@ -53,6 +56,10 @@ typedef struct scheduler {
 
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
 /** @brief Initialize scheduler object.
+ *
+ *  @note The connections must be assigned to their time slots
+ *        beforehand, since the next non-empty time slot of
+ *        every time slot is computed here.
  *
  *  @param[in] scheduler  Scheduler object.
  *  @param[in] schedule   Schedule.
@@ -92,11 +99,17 @@ void link_scheduler_set_time_slot_i(scheduler_t *scheduler,
 
 /** @brief Enable transmissions.
  *
- *  @return The current time slot.
+ *  @note The next non-empty time slots are computed again
+ *        if transmissions were disabled.
+ *
+ *  @param[in]  scheduler  Scheduler object.
  */
 void link_scheduler_enable_tx(scheduler_t *scheduler);
 
 /** @brief Disable transmissions.
+ *
+ *  @note The next non-empty time slots are computed again
+ *        if transmissions were enabled.
  *
  *  @param[in]  scheduler  Scheduler object.
  */
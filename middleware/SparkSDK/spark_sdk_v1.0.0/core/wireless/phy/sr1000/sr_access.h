@@ -527,6 +527,39 @@ static inline void sr_access_spi_transfer_non_blocking(radio_hal_t *radio_hal,
     radio_hal->transfer_full_duplex_non_blocking(tx_buffer, rx_buffer, size);
 }
 
+/** @brief Check if the radio HAL can chain SPI transfers in non blocking mode.
+ *
+ *  @param[in] radio_hal  Radio HAL instance.
+ *  @retval True   Chained transfers are supported.
+ *  @retval False  Chained transfers are not supported.
+ */
+static inline bool sr_access_is_chain_supported(radio_hal_t *radio_hal)
+{
+    return (radio_hal->transfer_chain_non_blocking != NULL);
+}
+
+/** @brief Initiate a chain of SPI transfers in non blocking mode
+ *
+ *  @note CS is left LOW after the last transfer, like for a single transfer.
+ *
+ *  @param[in]  radio_hal  Radio HAL instance.
+ *  @param[in]  tx_buffer  Buffers to send to the radio, one per transfer.
+ *  @param[out] rx_buffer  Buffers containing the radio response, one per transfer.
+ *  @param[in]  size       Sizes of the transfers.
+ *  @param[in]  release_cs CS is pulsed HIGH after a transfer when its entry is set.
+ *  @param[in]  count      Number of transfers.
+ */
+static inline void sr_access_spi_transfer_chain_non_blocking(radio_hal_t *radio_hal,
+                                                             uint8_t **tx_buffer,
+                                                             uint8_t **rx_buffer,
+                                                             uint16_t *size,
+                                                             bool *release_cs,
+                                                             uint8_t count)
+{
+    radio_hal->reset_cs();
+    radio_hal->transfer_chain_non_blocking(tx_buffer, rx_buffer, size, release_cs, count);
+}
+
 /** @brief Initiate an SPI transfer in blocking mode
  *
  *  @param[in]  radio_adv  Radio HAL instance.
@@ -21,10 +21,10 @@ void wps_phy_connect(wps_phy_t *wps_phy)
     uwb_set_radio_actions(wps_phy->radio, SET_RADIO_ACTIONS(RADIO_ACTIONS_CLEAR));
     uwb_transfer_blocking(wps_phy->radio);
 
-    while (!(*wps_phy->pwr_status_cmd & BIT_AWAKE)) {
+    do {
         wps_phy->pwr_status_cmd = uwb_read_register_8(wps_phy->radio, REG_PWRSTATUS);
         uwb_transfer_blocking(wps_phy->radio);
-    }
+    } while (!(*wps_phy->pwr_status_cmd & BIT_AWAKE));
 
     uwb_set_timer_config(wps_phy->radio, SET_TIMER_CFG(TIMER_CFG_CLEAR,
                                                        AUTOWAKE_UP_ENABLE,
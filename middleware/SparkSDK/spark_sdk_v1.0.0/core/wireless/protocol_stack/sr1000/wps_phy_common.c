@@ -26,6 +26,7 @@ static void prepare_phy(wps_phy_t *phy);
 static void prepare_radio(wps_phy_t *phy);
 static void set_config(wps_phy_t *phy);
 static void set_channel_config(wps_phy_t *phy);
+static void set_config_chain(wps_phy_t *phy);
 static void enable_radio_irq(wps_phy_t *phy);
 static void check_radio_irq(wps_phy_t *phy);
 static void set_header(wps_phy_t *phy);
@@ -70,10 +71,14 @@ static int_flag_cfg_t set_events_for_rx_with_ack(void);
 static int_flag_cfg_t set_events_for_rx_without_ack(void);
 static int_flag_cfg_t set_events_for_rx_with_auto_payload(void);
 static void enqueue_states(wps_phy_t *wps_phy, wps_phy_state_t *state);
+static void enqueue_set_config_states(wps_phy_t *wps_phy);
+static void append_channel_config(wps_phy_t *phy);
+static void append_spi_chain_transfer(wps_phy_t *phy, uint8_t *transfer_begin);
 
 /* TYPES **********************************************************************/
 static wps_phy_state_t prepare_phy_states[]               = {prepare_phy, end};
 static wps_phy_state_t set_config_states[]                = {set_config, close_spi, set_channel_config, end};
+static wps_phy_state_t set_config_chain_states[]          = {set_config_chain, end};
 static wps_phy_state_t prepare_radio_cut_through_states[] = {set_header, set_payload_cut_through, prepare_radio, signal_yield,
                                                              close_spi, set_config, close_spi, enable_radio_irq, end};
 static wps_phy_state_t set_header_states[]                = {close_spi, set_header, end};
@@ -314,6 +319,13 @@ static void enqueue_states(wps_phy_t *wps_phy, wps_phy_state_t *state)
  */
 static void enqueue_tx_prepare_frame_states(wps_phy_t *wps_phy, uint8_t header_size, uint8_t payload_size)
 {
+    if (sr_access_is_chain_supported(wps_phy->radio->radio_hal)) {
+        /* The frame is chained to the radio configuration by set_config_chain */
+        wps_phy->spi_chain.fill_header  = (header_size + payload_size != 0);
+        wps_phy->spi_chain.fill_payload = (payload_size != 0);
+        return;
+    }
+
     if (header_size + payload_size != 0) {
         enqueue_states(wps_phy, set_header_states);
     }
@@ -323,6 +335,22 @@ static void enqueue_tx_prepare_frame_states(wps_phy_t *wps_phy, uint8_t header_s
     }
 }
 
+/** @brief Setup the state machine to send the radio configuration.
+ *
+ *  When the radio HAL supports chained transfers, the configuration and the
+ *  frame are sent with a single DMA interrupt instead of one per SPI transfer.
+ *
+ *  @param[in] wps_phy  PHY instance struct.
+ */
+static void enqueue_set_config_states(wps_phy_t *wps_phy)
+{
+    if (sr_access_is_chain_supported(wps_phy->radio->radio_hal)) {
+        enqueue_states(wps_phy, set_config_chain_states);
+    } else {
+        enqueue_states(wps_phy, set_config_states);
+    }
+}
+
 /** @brief Setup the state machine to receive payload from the radio.
  *
  *  @param[in] wps_phy        PHY instance struct.
@@ -358,11 +386,11 @@ static void prepare_phy(wps_phy_t *phy)
                     phy->signal_main = PHY_SIGNAL_YIELD;
                 }
             } else {
-                enqueue_states(phy, set_config_states);
+                enqueue_set_config_states(phy);
                 prepare_radio(phy);
             }
         } else {
-            enqueue_states(phy, set_config_states);
+            enqueue_set_config_states(phy);
             prepare_radio(phy);
         }
     }
@@ -569,6 +597,8 @@ static void prepare_radio(wps_phy_t *phy)
 
     phy->signal_auto = PHY_SIGNAL_NONE;
     phy->cfg.radio_actions = RADIO_ACTIONS_CLEAR;
+    phy->spi_chain.fill_header  = false;
+    phy->spi_chain.fill_payload = false;
 
     if (main_is_tx(phy)) {
         prepare_radio_tx(phy, &radio_events);
@@ -624,6 +654,65 @@ static void set_config(wps_phy_t *phy)
 static void set_channel_config(wps_phy_t *phy)
 {
     phy->signal_main = PHY_SIGNAL_YIELD;
+    append_channel_config(phy);
+    uwb_transfer_non_blocking(phy->radio);
+}
+
+/** @brief State : Send the radio config, the channel config and the frame with a single chain of SPI transfers.
+ *
+ *  The radio configuration has already been appended to the access sequence by
+ *  prepare_radio. The channel configuration and the TX FIFO header are appended
+ *  after it so that every transfer keeps its own part of the SPI buffers, while
+ *  the payload is sent straight from the frame in the same SPI command as the
+ *  header.
+ *
+ *  @param[in] signal_data  Data required to process the state. The type shall be wps_phy_t.
+ */
+static void set_config_chain(wps_phy_t *phy)
+{
+    phy_spi_chain_t *spi_chain      = &phy->spi_chain;
+    xlayer_frame_t  *frame          = phy->tx.frame;
+    uint8_t          transfer_begin = 0;
+
+    spi_chain->count = 0;
+    append_spi_chain_transfer(phy, &transfer_begin);
+
+    append_channel_config(phy);
+    append_spi_chain_transfer(phy, &transfer_begin);
+
+    if (spi_chain->fill_header) {
+        sr_access_disable_radio_irq(phy->radio->radio_hal);
+        uwb_fill_tx_fifo(phy->radio, frame->header_begin_it, (frame->header_end_it - frame->header_begin_it));
+        append_spi_chain_transfer(phy, &transfer_begin);
+    }
+
+    if (spi_chain->fill_payload) {
+        /* Payload continues the TX FIFO burst of the header */
+        spi_chain->release_cs[spi_chain->count - 1] = false;
+        spi_chain->tx_data[spi_chain->count]        = frame->payload_begin_it;
+        spi_chain->rx_data[spi_chain->count]        = phy->radio->access_sequence.rx_buffer;
+        spi_chain->size[spi_chain->count]           = frame->payload_end_it - frame->payload_begin_it;
+        spi_chain->release_cs[spi_chain->count]     = true;
+        spi_chain->count++;
+    }
+
+    phy->radio->access_sequence.index = 0;
+    phy->signal_main = PHY_SIGNAL_PREPARE_DONE;
+
+    sr_access_spi_transfer_chain_non_blocking(phy->radio->radio_hal,
+                                              spi_chain->tx_data,
+                                              spi_chain->rx_data,
+                                              spi_chain->size,
+                                              spi_chain->release_cs,
+                                              spi_chain->count);
+}
+
+/** @brief Append the channel configuration to the access sequence.
+ *
+ *  @param[in] phy  PHY instance struct.
+ */
+static void append_channel_config(wps_phy_t *phy)
+{
     if ((phy->cfg.sleep_level == SLEEP_IDLE) && (phy->radio->phy_version == PHY_VERSION_8_3)) {
         /* #1: Bit INTEGLEN of register DLLTUNING (0x1D) needs to be set then reset every time the radio is put to sleep,
          *     after the sleep time compare value is configured, to ensure proper operation.
@@ -637,7 +726,27 @@ static void set_channel_config(wps_phy_t *phy)
     uwb_select_channel(phy->radio,
                        (uint8_t *)phy->xlayer_main->config.channel->channel.tx_pattern,
                        phy->xlayer_main->config.channel->pulse_size);
-    uwb_transfer_non_blocking(phy->radio);
+}
+
+/** @brief Add the commands appended to the access sequence since the last transfer to the SPI chain.
+ *
+ *  @param[in]     phy             PHY instance struct.
+ *  @param[in,out] transfer_begin  Access sequence index where the transfer begins, updated to the next one.
+ */
+static void append_spi_chain_transfer(wps_phy_t *phy, uint8_t *transfer_begin)
+{
+    access_sequence_instance_t *access_sequence = &phy->radio->access_sequence;
+    phy_spi_chain_t            *spi_chain       = &phy->spi_chain;
+
+    spi_chain->tx_data[spi_chain->count]    = &access_sequence->tx_buffer[*transfer_begin];
+    spi_chain->rx_data[spi_chain->count]    = &access_sequence->rx_buffer[*transfer_begin];
+    spi_chain->size[spi_chain->count]       = access_sequence->index - *transfer_begin;
+    spi_chain->release_cs[spi_chain->count] = true;
+    spi_chain->count++;
+
+    /* A burst write ends with the transfer, the next one starts a new SPI command */
+    access_sequence->burst_mode = false;
+    *transfer_begin             = access_sequence->index;
 }
 
 /** @brief State : Fill the header of the frame in the radio tx fifo.
@@ -1258,7 +1367,8 @@ static void end_flush(wps_phy_t *phy)
         return;
     }
 
-    *phy->tx.signal = auto_is_tx(phy) ? PHY_SIGNAL_FRAME_NOT_SENT : PHY_SIGNAL_FRAME_SENT_NACK;
+    *phy->tx.signal = ((phy->xlayer_auto != NULL) && auto_is_tx(phy)) ? PHY_SIGNAL_FRAME_NOT_SENT :
+                                                                          PHY_SIGNAL_FRAME_SENT_NACK;
     *phy->rx.signal = PHY_SIGNAL_FRAME_MISSED;
 }
 
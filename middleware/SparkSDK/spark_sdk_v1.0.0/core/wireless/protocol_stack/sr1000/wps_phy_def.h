@@ -22,7 +22,8 @@ extern "C" {
 #include "xlayer.h"
 
 /* CONSTANTS ******************************************************************/
-#define PHY_STATE_Q_SIZE 10 /*!< Queue size for PHY layer state machine. */
+#define PHY_STATE_Q_SIZE      10 /*!< Queue size for PHY layer state machine. */
+#define PHY_SPI_CHAIN_SIZE    4  /*!< Maximum number of SPI transfers chained for a frame. */
 
 /* TYPES **********************************************************************/
 /** @brief Wireless protocol stack PHY Layer input signal.
@@ -114,6 +115,22 @@ typedef struct phy_frame_cfg {
     phase_info_t *phase_info;       /*!< Phases informations */
 } phy_frame_cfg_t;
 
+/** @brief SPI transfers chained to prepare a frame.
+ *
+ *  The radio configuration, the channel configuration, the frame header and
+ *  the frame payload are sent to the radio with a single DMA interrupt when the
+ *  radio HAL supports chained transfers.
+ */
+typedef struct phy_spi_chain {
+    uint8_t *tx_data[PHY_SPI_CHAIN_SIZE]; /*!< TX buffer of each transfer */
+    uint8_t *rx_data[PHY_SPI_CHAIN_SIZE]; /*!< RX buffer of each transfer */
+    uint16_t size[PHY_SPI_CHAIN_SIZE];    /*!< Size of each transfer */
+    bool release_cs[PHY_SPI_CHAIN_SIZE];  /*!< CS is released after the transfer */
+    uint8_t count;                        /*!< Number of chained transfers */
+    bool fill_header;                     /*!< Frame header must be written in the TX FIFO */
+    bool fill_payload;                    /*!< Frame payload must be written in the TX FIFO */
+} phy_spi_chain_t;
+
 /** @brief WPS PHY instance.
  */
 struct wps_phy {
@@ -139,6 +156,7 @@ struct wps_phy {
     phy_frame_cfg_t cfg; /*!< General configuration settings for the phy Layer*/
     phy_tx_frame_t tx;   /*!< TX configuration settings for the phy Layer*/
     phyl1_rx_frame_t rx; /*!< RX configuration settings for the phy Layer*/
+    phy_spi_chain_t spi_chain; /*!< SPI transfers chained to prepare a frame */
 
     rx_wait_time_t rx_wait;  /*!< RX wait time */
     uint8_t *rssi;           /*!< RSSI in 1/10 dB */
@@ -41,6 +41,7 @@ static void set_rx_conn_queue_memory(uint8_t *buffer,
                                      uint32_t queue_size,
                                      uint32_t hdr_len,
                                      uint32_t max_frame_len);
+static void set_rx_frame_memory(xlayer_t *frame, uint8_t *memory);
 static uint8_t generate_active_pattern(bool *pattern, uint8_t active_ratio);
 static void initialize_request_queues(wps_t *wps);
 
@@ -322,6 +323,7 @@ void wps_create_connection(wps_connection_t *connection,
     connection->tx_drop_callback_t          = NULL;
     connection->rx_success_callback_t       = NULL;
     connection->evt_callback_t              = NULL;
+    connection->tx_release_callback_t       = NULL;
     connection->get_tick_quarter_ms  = config->get_tick_quarter_ms;
     connection->packet_cfg           = DEFAULT_PACKET_CONFIGURATION;
     connection->channel              = config->channel_buffer;
@@ -573,6 +575,14 @@ void wps_set_event_callback(wps_connection_t *connection, void (*callback)(void
     }
 }
 
+void wps_set_tx_release_callback(wps_connection_t *connection, void (*callback)(void *parg, uint8_t *payload), void *parg)
+{
+    if (connection != NULL) {
+        connection->tx_release_callback_t = callback;
+        connection->tx_release_parg_callback_t = parg;
+    }
+}
+
 void wps_connect(wps_t *wps, wps_error_t *err)
 {
     wps_phy_cfg_t phy_cfg = {0};
@@ -757,6 +767,44 @@ void wps_read_done(wps_connection_t *connection, wps_error_t *err)
     *err = circular_queue_dequeue(&connection->xlayer_queue) ? WPS_NO_ERROR : WPS_QUEUE_EMPTY_ERROR;
 }
 
+uint8_t *wps_read_exchange(wps_connection_t *connection, uint8_t *payload, wps_error_t *err)
+{
+    xlayer_t *frame;
+    uint8_t *received;
+
+    *err = WPS_NO_ERROR;
+
+    frame = circular_queue_front(&connection->xlayer_queue);
+    if (frame == NULL) {
+        *err = WPS_QUEUE_EMPTY_ERROR;
+        return NULL;
+    }
+
+    received = frame->frame.payload_begin_it;
+    set_rx_frame_memory(frame, payload - wps_get_rx_headroom(connection));
+
+    return received;
+}
+
+void wps_set_rx_payload_memory(wps_connection_t *connection, uint32_t index, uint8_t *payload, wps_error_t *err)
+{
+    xlayer_t *buffer_begin = (xlayer_t *)connection->xlayer_queue.buffer_begin;
+
+    *err = WPS_NO_ERROR;
+
+    if (index >= connection->xlayer_queue.capacity) {
+        *err = WPS_QUEUE_FULL_ERROR;
+        return;
+    }
+
+    set_rx_frame_memory(&buffer_begin[index], payload - wps_get_rx_headroom(connection));
+}
+
+uint8_t wps_get_rx_headroom(wps_connection_t *connection)
+{
+    return connection->header_size + WPS_PAYLOAD_SIZE_BYTE_SIZE;
+}
+
 uint32_t wps_get_fifo_size(wps_connection_t *connection)
 {
     return circular_queue_size(&connection->xlayer_queue);
@@ -923,16 +971,26 @@ static void set_rx_conn_queue_memory(uint8_t *buffer,
     xlayer_t *buffer_begin = (xlayer_t *)queue->buffer_begin;
 
     for (uint32_t i = 0; i < queue_size; ++i) {
-        buffer_begin[i].frame.payload_memory      = (buffer + i * max_frame_len);
         buffer_begin[i].frame.payload_memory_size = max_frame_len;
-        buffer_begin[i].frame.payload_begin_it    = buffer_begin[i].frame.payload_memory;
+        buffer_begin[i].frame.header_memory_size  = hdr_len;
+        set_rx_frame_memory(&buffer_begin[i], buffer + i * max_frame_len);
+    }
+}
 
-        buffer_begin[i].frame.header_memory      = buffer_begin[i].frame.payload_memory;
-        buffer_begin[i].frame.header_memory_size = hdr_len;
+/** @brief Point a reception frame at the memory it receives header and payload in.
+ *
+ *  @param[in] frame   Reception cross layer.
+ *  @param[in] memory  Frame memory, as large as the frame payload memory size.
+ */
+static void set_rx_frame_memory(xlayer_t *frame, uint8_t *memory)
+{
+    frame->frame.payload_memory   = memory;
+    frame->frame.payload_begin_it = memory;
+    frame->frame.payload_end_it   = memory;
 
-        buffer_begin[i].frame.header_begin_it = buffer_begin[i].frame.payload_memory;
-        buffer_begin[i].frame.header_end_it   = buffer_begin[i].frame.payload_memory;
-    }
+    frame->frame.header_memory   = memory;
+    frame->frame.header_begin_it = memory;
+    frame->frame.header_end_it   = memory;
 }
 
 /** @brief Generate active pattern based on given ratio.
@@ -701,6 +701,20 @@ void wps_set_rx_success_callback(wps_connection_t *connection, void (*callback)(
  */
 void wps_set_event_callback(wps_connection_t *connection, void (*callback)(void *parg), void *parg);
 
+/** @brief Set the callback function to execute when a payload buffer is returned by the WPS.
+ *
+ *  @note The callback is called from the WPS context once a frame leaves the TX queue, either
+ *        successfully transmitted or dropped. It lets a buffer given to wps_send() be lent
+ *        to the WPS instead of being copied into the connection queue: the buffer must not
+ *        be modified nor reused until the callback returns it. Frames leave the TX queue in
+ *        the order they were sent.
+ *
+ *  @param[in] connection  Pointer to the connection.
+ *  @param[in] callback    Function pointer to the callback.
+ *  @param[in] parg        Void pointer argument for the callback.
+ */
+void wps_set_tx_release_callback(wps_connection_t *connection, void (*callback)(void *parg, uint8_t *payload), void *parg);
+
 /** @brief Connect node to network.
  *
  *  Setup the radio internal timer and reset every layer in the WPS.
@@ -784,6 +798,41 @@ wps_rx_frame wps_read(wps_connection_t *connection, wps_error_t *err);
  */
 void wps_read_done(wps_connection_t *connection, wps_error_t *err);
 
+/** @brief Exchange the memory of the last received frame for another buffer.
+ *
+ *  The received payload is handed over instead of being copied out of the receiver FIFO,
+ *  and the next frame received in this FIFO slot lands in the given buffer. The frame
+ *  must still be removed with wps_read_done().
+ *
+ *  @param[in]  connection  Connection instance.
+ *  @param[in]  payload     Location of the next payload received in the slot. The header
+ *                          and the radio status byte of the frame are written in the
+ *                          wps_get_rx_headroom() bytes in front of it.
+ *  @param[out] err         Pointer to the error code.
+ *  @return Payload of the received frame, now owned by the caller, NULL if the FIFO is empty.
+ */
+uint8_t *wps_read_exchange(wps_connection_t *connection, uint8_t *payload, wps_error_t *err);
+
+/** @brief Set the memory a slot of the receiver FIFO receives its frames in.
+ *
+ *  Must be called before connecting. Lets the receiver FIFO receive in buffers
+ *  exchanged with wps_read_exchange() from the first frame on.
+ *
+ *  @param[in]  connection  Connection instance.
+ *  @param[in]  index       Index of the slot, below the FIFO size.
+ *  @param[in]  payload     Location of the payload received in the slot, with
+ *                          wps_get_rx_headroom() bytes free in front of it.
+ *  @param[out] err         Pointer to the error code.
+ */
+void wps_set_rx_payload_memory(wps_connection_t *connection, uint32_t index, uint8_t *payload, wps_error_t *err);
+
+/** @brief Get the number of bytes written in front of a received payload.
+ *
+ *  @param[in] connection  Connection instance.
+ *  @return Size of the frame header and of the radio status byte.
+ */
+uint8_t wps_get_rx_headroom(wps_connection_t *connection);
+
 /** @brief Return the used space of the connection Xlayer queue.
  *
  *  @param[in] connection  Connection instance.
@@ -110,12 +110,15 @@ struct wps_connection {
     void (*tx_drop_callback_t)(void *parg);    /*!< Function called by the wps to indicate a frame is dropped */
     void (*rx_success_callback_t)(void *parg); /*!< Function called by the wps to indicate the frame has been received */
     void (*evt_callback_t)(void *parg);        /*!< Function called by the wps to indicate that a WPS event appened */
+    void (*tx_release_callback_t)(void *parg, uint8_t *payload); /*!< Function called by the wps when a frame leaves the TX queue
+                                                                      and its payload buffer is no longer used */
 
     void *tx_success_parg_callback_t; /*!< TX success callback void pointer argument. */
     void *tx_fail_parg_callback_t;    /*!< TX fail callback void pointer argument. */
     void *tx_drop_parg_callback_t;    /*!< TX drop callback void pointer argument. */
     void *rx_success_parg_callback_t; /*!< RX success callback void pointer argument. */
     void *evt_parg_callback_t;        /*!< Event callback void pointer argument. */
+    void *tx_release_parg_callback_t; /*!< TX release callback void pointer argument. */
     uint64_t (*get_tick_quarter_ms)(void); /*!< Get free running timer tick in quarter ms */
 };
 
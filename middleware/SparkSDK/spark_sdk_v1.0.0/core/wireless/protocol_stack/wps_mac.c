@@ -1251,6 +1251,16 @@ static bool no_space_available_for_rx(wps_mac_t *wps_mac)
  */
 static bool send_done(wps_connection_t *connection)
 {
+    xlayer_t *frame;
+
+    if (connection->tx_release_callback_t != NULL) {
+        frame = circular_queue_front(&connection->xlayer_queue);
+        if (frame != NULL) {
+            /* Give the payload buffer back to its owner */
+            connection->tx_release_callback_t(connection->tx_release_parg_callback_t, frame->frame.payload_memory);
+        }
+    }
+
     return circular_queue_dequeue(&connection->xlayer_queue);
 }
 
@@ -1390,6 +1400,10 @@ static void handle_link_throttle(wps_mac_t *wps_mac, uint8_t *inc_count)
             do {
                 *inc_count += link_scheduler_increment_time_slot(&wps_mac->scheduler);
                 candidate_timeslot = link_scheduler_get_current_timeslot(&wps_mac->scheduler);
+                /* Timeslots of connections without throttling are always active */
+                if (candidate_timeslot->connection_main->pattern == NULL) {
+                    break;
+                }
                 total_pattern_count = candidate_timeslot->connection_main->pattern_total_count;
                 current_pattern_count = (candidate_timeslot->connection_main->pattern_count + 1) % total_pattern_count;
                 candidate_timeslot->connection_main->pattern_count = current_pattern_count;
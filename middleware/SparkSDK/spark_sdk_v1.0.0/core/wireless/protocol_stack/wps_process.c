@@ -366,6 +366,16 @@ static void set_signal_mac_to_phy(wps_mac_t *mac, wps_phy_t *phy)
  */
 static bool send_done(wps_connection_t *connection)
 {
+    xlayer_t *frame;
+
+    if (connection->tx_release_callback_t != NULL) {
+        frame = circular_queue_front(&connection->xlayer_queue);
+        if (frame != NULL) {
+            /* Give the payload buffer back to its owner */
+            connection->tx_release_callback_t(connection->tx_release_parg_callback_t, frame->frame.payload_memory);
+        }
+    }
+
     return circular_queue_dequeue(&connection->xlayer_queue);
 }
 
@@ -24,7 +24,9 @@ extern "C" {
  *  microcontroller's peripherals.
  *
  *  Every functions must be implemented. If a function is not needed, the user
- *  must implement an empty function.
+ *  must implement an empty function. The only exception is
+ *  transfer_chain_non_blocking which can be left NULL, the PHY then issues one
+ *  non blocking transfer per SPI transaction.
  *
  *  For example, if the shutdown pin is not used, simply create :
  *  void no_shutdown_pin(void) {} and pass it to both
@@ -49,6 +51,14 @@ typedef struct {
                                                                   actual read and write are always in half-duplex mode.
                                                                   FYI : CS Pin need to be externally controlled when
                                                                   using this mode. */
+    void (*transfer_chain_non_blocking)
+        (uint8_t **tx_data, uint8_t **rx_data, uint16_t *size, bool *release_cs, uint8_t count); /*!< Chain of SPI
+                                             transfers in non blocking mode, completed by a single DMA interrupt.
+                                             CS is pulsed HIGH after a transfer when its release_cs entry is set,
+                                             otherwise the next transfer continues the same SPI command. Like for a
+                                             single transfer, CS is externally controlled before the first and
+                                             after the last transfer. The arrays must remain valid until completion.
+                                             Optional, can be NULL. */
     bool (*is_spi_busy)(void);           /*!< Check if the status of the busy flag in the SPI Status Register */
     void (*context_switch)(void);        /*!< Trigger the Spark radio IRQ context */
     void (*disable_radio_irq)(void);     /*!< Disable radio IRQ interrupt source */
@@ -40,6 +40,112 @@ const int8_t index_table[] = {
     -1, -1, -1, -1, 2, 4, 6, 8
 };
 
+/* Table of index changes of the 3-bit and 2-bit codecs, indexed by the code magnitude */
+static const int8_t index_table_3bits[] = {-1, -1, 1, 2};
+static const int8_t index_table_2bits[] = {-1, 2};
+
+/* (new_sample[2:0] + ½) * step_size/4 computed by repetitive addition, indexed by step_size index */
+static const uint16_t difference_table[STEP_SIZE_TABLE_LENGTH][8] = {
+    {    0,     1,     3,     4,     7,     8,    10,    11},
+    {    1,     3,     5,     7,     9,    11,    13,    15},
+    {    1,     3,     5,     7,    10,    12,    14,    16},
+    {    1,     3,     6,     8,    11,    13,    16,    18},
+    {    1,     3,     6,     8,    12,    14,    17,    19},
+    {    1,     4,     7,    10,    13,    16,    19,    22},
+    {    1,     4,     7,    10,    14,    17,    20,    23},
+    {    1,     4,     8,    11,    15,    18,    22,    25},
+    {    2,     6,    10,    14,    18,    22,    26,    30},
+    {    2,     6,    10,    14,    19,    23,    27,    31},
+    {    2,     6,    11,    15,    21,    25,    30,    34},
+    {    2,     7,    12,    17,    23,    28,    33,    38},
+    {    2,     7,    13,    18,    25,    30,    36,    41},
+    {    3,     9,    15,    21,    28,    34,    40,    46},
+    {    3,    10,    17,    24,    31,    38,    45,    52},
+    {    3,    10,    18,    25,    34,    41,    49,    56},
+    {    4,    12,    21,    29,    38,    46,    55,    63},
+    {    4,    13,    22,    31,    41,    50,    59,    68},
+    {    5,    15,    25,    35,    46,    56,    66,    76},
+    {    5,    16,    27,    38,    50,    61,    72,    83},
+    {    6,    18,    31,    43,    56,    68,    81,    93},
+    {    6,    19,    33,    46,    61,    74,    88,   101},
+    {    7,    22,    37,    52,    67,    82,    97,   112},
+    {    8,    24,    41,    57,    74,    90,   107,   123},
+    {    9,    27,    45,    63,    82,   100,   118,   136},
+    {   10,    30,    50,    70,    90,   110,   130,   150},
+    {   11,    33,    55,    77,    99,   121,   143,   165},
+    {   12,    36,    60,    84,   109,   133,   157,   181},
+    {   13,    39,    66,    92,   120,   146,   173,   199},
+    {   14,    43,    73,   102,   132,   161,   191,   220},
+    {   16,    48,    81,   113,   146,   178,   211,   243},
+    {   17,    52,    88,   123,   160,   195,   231,   266},
+    {   19,    58,    97,   136,   176,   215,   254,   293},
+    {   21,    64,   107,   150,   194,   237,   280,   323},
+    {   23,    70,   118,   165,   213,   260,   308,   355},
+    {   26,    78,   130,   182,   235,   287,   339,   391},
+    {   28,    85,   143,   200,   258,   315,   373,   430},
+    {   31,    94,   157,   220,   284,   347,   410,   473},
+    {   34,   103,   173,   242,   313,   382,   452,   521},
+    {   38,   114,   191,   267,   345,   421,   498,   574},
+    {   42,   126,   210,   294,   379,   463,   547,   631},
+    {   46,   138,   231,   323,   417,   509,   602,   694},
+    {   51,   153,   255,   357,   459,   561,   663,   765},
+    {   56,   168,   280,   392,   505,   617,   729,   841},
+    {   61,   184,   308,   431,   555,   678,   802,   925},
+    {   68,   204,   340,   476,   612,   748,   884,  1020},
+    {   74,   223,   373,   522,   672,   821,   971,  1120},
+    {   82,   246,   411,   575,   740,   904,  1069,  1233},
+    {   90,   271,   452,   633,   814,   995,  1176,  1357},
+    {   99,   298,   497,   696,   895,  1094,  1293,  1492},
+    {  109,   328,   547,   766,   985,  1204,  1423,  1642},
+    {  120,   360,   601,   841,  1083,  1323,  1564,  1804},
+    {  132,   397,   662,   927,  1192,  1457,  1722,  1987},
+    {  145,   436,   728,  1019,  1311,  1602,  1894,  2185},
+    {  160,   480,   801,  1121,  1442,  1762,  2083,  2403},
+    {  176,   528,   881,  1233,  1587,  1939,  2292,  2644},
+    {  194,   582,   970,  1358,  1746,  2134,  2522,  2910},
+    {  213,   639,  1066,  1492,  1920,  2346,  2773,  3199},
+    {  234,   703,  1173,  1642,  2112,  2581,  3051,  3520},
+    {  258,   774,  1291,  1807,  2324,  2840,  3357,  3873},
+    {  284,   852,  1420,  1988,  2556,  3124,  3692,  4260},
+    {  312,   936,  1561,  2185,  2811,  3435,  4060,  4684},
+    {  343,  1030,  1717,  2404,  3092,  3779,  4466,  5153},
+    {  378,  1134,  1890,  2646,  3402,  4158,  4914,  5670},
+    {  415,  1246,  2078,  2909,  3742,  4573,  5405,  6236},
+    {  457,  1372,  2287,  3202,  4117,  5032,  5947,  6862},
+    {  503,  1509,  2516,  3522,  4529,  5535,  6542,  7548},
+    {  553,  1660,  2767,  3874,  4981,  6088,  7195,  8302},
+    {  608,  1825,  3043,  4260,  5479,  6696,  7914,  9131},
+    {  669,  2008,  3348,  4687,  6027,  7366,  8706, 10045},
+    {  736,  2209,  3683,  5156,  6630,  8103,  9577, 11050},
+    {  810,  2431,  4052,  5673,  7294,  8915, 10536, 12157},
+    {  891,  2674,  4457,  6240,  8023,  9806, 11589, 13372},
+    {  980,  2941,  4902,  6863,  8825, 10786, 12747, 14708},
+    { 1078,  3235,  5393,  7550,  9708, 11865, 14023, 16180},
+    { 1186,  3559,  5932,  8305, 10679, 13052, 15425, 17798},
+    { 1305,  3915,  6526,  9136, 11747, 14357, 16968, 19578},
+    { 1435,  4306,  7178, 10049, 12922, 15793, 18665, 21536},
+    { 1579,  4737,  7896, 11054, 14214, 17372, 20531, 23689},
+    { 1737,  5211,  8686, 12160, 15636, 19110, 22585, 26059},
+    { 1911,  5733,  9555, 13377, 17200, 21022, 24844, 28666},
+    { 2102,  6306, 10511, 14715, 18920, 23124, 27329, 31533},
+    { 2312,  6937, 11562, 16187, 20812, 25437, 30062, 34687},
+    { 2543,  7630, 12718, 17805, 22893, 27980, 33068, 38155},
+    { 2798,  8394, 13990, 19586, 25183, 30779, 36375, 41971},
+    { 3077,  9232, 15388, 21543, 27700, 33855, 40011, 46166},
+    { 3385, 10156, 16928, 23699, 30471, 37242, 44014, 50785},
+    { 3724, 11172, 18621, 26069, 33518, 40966, 48415, 55863},
+    { 4095, 12286, 20478, 28669, 36862, 45053, 53245, 61436}
+};
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static inline uint8_t encode_sample(int32_t original_sample, int32_t *predicted_sample, int32_t *index);
+static inline int16_t decode_sample(uint8_t original_sample, int32_t *predicted_sample, int32_t *index);
+static inline uint8_t encode_sample_nbits(int32_t original_sample, int32_t *predicted_sample, int32_t *index,
+                                          uint8_t code_size, const int8_t *index_changes);
+static inline int16_t decode_sample_nbits(uint8_t original_sample, int32_t *predicted_sample, int32_t *index,
+                                          uint8_t code_size, const int8_t *index_changes);
+static const int8_t *get_index_changes(uint8_t code_size);
+
 /* PUBLIC FUNCTIONS ***********************************************************/
 void adpcm_init_state(adpcm_state_t *state)
 {
@@ -165,3 +271,330 @@ int16_t adpcm_decode(uint8_t original_sample, adpcm_state_t *state)
 
     return (int16_t)new_sample;
 }
+
+void adpcm_encode_block(const int16_t *pcm, uint8_t *codes, uint16_t sample_count, adpcm_state_t *state)
+{
+    int32_t predicted_sample = state->state.predicted_sample;
+    int32_t index = state->state.index;
+    uint8_t code;
+
+    for (uint16_t i = 0; i < sample_count / 2; i++) {
+        code = encode_sample(*pcm++, &predicted_sample, &index);
+        *codes++ = code | (encode_sample(*pcm++, &predicted_sample, &index) << 4);
+    }
+    if (sample_count & 0x01) {
+        *codes = encode_sample(*pcm, &predicted_sample, &index);
+    }
+
+    state->state.index = (uint8_t)index;
+    state->state.predicted_sample = (int16_t)predicted_sample;
+}
+
+void adpcm_decode_block(const uint8_t *codes, int16_t *pcm, uint16_t sample_count, adpcm_state_t *state)
+{
+    int32_t predicted_sample = state->state.predicted_sample;
+    int32_t index = state->state.index;
+
+    for (uint16_t i = 0; i < sample_count / 2; i++) {
+        *pcm++ = decode_sample(*codes & 0x0F, &predicted_sample, &index);
+        *pcm++ = decode_sample(*codes++ >> 4, &predicted_sample, &index);
+    }
+    if (sample_count & 0x01) {
+        *pcm = decode_sample(*codes & 0x0F, &predicted_sample, &index);
+    }
+
+    state->state.index = (uint8_t)index;
+    state->state.predicted_sample = (int16_t)predicted_sample;
+}
+
+void adpcm_encode_block_stereo(const int16_t *pcm, uint8_t *codes, uint16_t frame_count,
+                               adpcm_state_t *left_state, adpcm_state_t *right_state)
+{
+    int32_t left_predicted_sample = left_state->state.predicted_sample;
+    int32_t left_index = left_state->state.index;
+    int32_t right_predicted_sample = right_state->state.predicted_sample;
+    int32_t right_index = right_state->state.index;
+    uint8_t code;
+
+    for (uint16_t i = 0; i < frame_count; i++) {
+        code = encode_sample(*pcm++, &left_predicted_sample, &left_index);
+        *codes++ = code | (encode_sample(*pcm++, &right_predicted_sample, &right_index) << 4);
+    }
+
+    left_state->state.index = (uint8_t)left_index;
+    left_state->state.predicted_sample = (int16_t)left_predicted_sample;
+    right_state->state.index = (uint8_t)right_index;
+    right_state->state.predicted_sample = (int16_t)right_predicted_sample;
+}
+
+void adpcm_decode_block_stereo(const uint8_t *codes, int16_t *pcm, uint16_t frame_count,
+                               adpcm_state_t *left_state, adpcm_state_t *right_state)
+{
+    int32_t left_predicted_sample = left_state->state.predicted_sample;
+    int32_t left_index = left_state->state.index;
+    int32_t right_predicted_sample = right_state->state.predicted_sample;
+    int32_t right_index = right_state->state.index;
+
+    for (uint16_t i = 0; i < frame_count; i++) {
+        *pcm++ = decode_sample(*codes & 0x0F, &left_predicted_sample, &left_index);
+        *pcm++ = decode_sample(*codes++ >> 4, &right_predicted_sample, &right_index);
+    }
+
+    left_state->state.index = (uint8_t)left_index;
+    left_state->state.predicted_sample = (int16_t)left_predicted_sample;
+    right_state->state.index = (uint8_t)right_index;
+    right_state->state.predicted_sample = (int16_t)right_predicted_sample;
+}
+
+void adpcm_encode_block_packed(const int16_t *pcm, uint8_t *codes, uint16_t frame_count, uint8_t channel_count,
+                               uint8_t code_size, adpcm_state_t *state)
+{
+    int32_t predicted_sample[ADPCM_PACKED_CHANNEL_MAX];
+    int32_t index[ADPCM_PACKED_CHANNEL_MAX];
+    const int8_t *index_changes = get_index_changes(code_size);
+    uint32_t bit_buffer = 0;
+    uint8_t bit_count = 0;
+    uint8_t code;
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        predicted_sample[ch] = state[ch].state.predicted_sample;
+        index[ch] = state[ch].state.index;
+    }
+
+    for (uint16_t i = 0; i < frame_count; i++) {
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            if (code_size == ADPCM_CODE_SIZE_MAX) {
+                code = encode_sample(*pcm++, &predicted_sample[ch], &index[ch]);
+            } else {
+                code = encode_sample_nbits(*pcm++, &predicted_sample[ch], &index[ch], code_size, index_changes);
+            }
+            bit_buffer |= (uint32_t)code << bit_count;
+            bit_count += code_size;
+            if (bit_count >= 8) {
+                *codes++ = (uint8_t)bit_buffer;
+                bit_buffer >>= 8;
+                bit_count -= 8;
+            }
+        }
+    }
+    if (bit_count > 0) {
+        *codes = (uint8_t)bit_buffer;
+    }
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        state[ch].state.index = (uint8_t)index[ch];
+        state[ch].state.predicted_sample = (int16_t)predicted_sample[ch];
+    }
+}
+
+void adpcm_decode_block_packed(const uint8_t *codes, int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                               uint8_t code_size, adpcm_state_t *state)
+{
+    int32_t predicted_sample[ADPCM_PACKED_CHANNEL_MAX];
+    int32_t index[ADPCM_PACKED_CHANNEL_MAX];
+    const int8_t *index_changes = get_index_changes(code_size);
+    uint8_t code_mask = (1 << code_size) - 1;
+    uint32_t bit_buffer = 0;
+    uint8_t bit_count = 0;
+    uint8_t code;
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        predicted_sample[ch] = state[ch].state.predicted_sample;
+        index[ch] = state[ch].state.index;
+    }
+
+    for (uint16_t i = 0; i < frame_count; i++) {
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            if (bit_count < code_size) {
+                bit_buffer |= (uint32_t)(*codes++) << bit_count;
+                bit_count += 8;
+            }
+            code = bit_buffer & code_mask;
+            bit_buffer >>= code_size;
+            bit_count -= code_size;
+            if (code_size == ADPCM_CODE_SIZE_MAX) {
+                *pcm++ = decode_sample(code, &predicted_sample[ch], &index[ch]);
+            } else {
+                *pcm++ = decode_sample_nbits(code, &predicted_sample[ch], &index[ch], code_size, index_changes);
+            }
+        }
+    }
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        state[ch].state.index = (uint8_t)index[ch];
+        state[ch].state.predicted_sample = (int16_t)predicted_sample[ch];
+    }
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Encode a 16-bit PCM sample with the state held in local variables.
+ *
+ *  Bit-exact with adpcm_encode(), the difference is read from difference_table.
+ *
+ *  @param[in]     original_sample   16-bit PCM sample.
+ *  @param[in,out] predicted_sample  Output of the ADPCM predictor.
+ *  @param[in,out] index             Index into step_size_table.
+ *  @return 4-bit ADPCM sample.
+ */
+static inline uint8_t encode_sample(int32_t original_sample, int32_t *predicted_sample, int32_t *index)
+{
+    int32_t difference = original_sample - *predicted_sample;
+    int32_t step_size = step_size_table[*index];
+    uint8_t new_sample = 0;
+
+    if (difference < 0) {
+        new_sample = 8;
+        difference = -difference;
+    }
+    /* quantize difference down to four bits */
+    if (difference >= step_size) {
+        new_sample |= 4;
+        difference -= step_size;
+    }
+    if (difference >= (step_size >> 1)) {
+        new_sample |= 2;
+        difference -= (step_size >> 1);
+    }
+    if (difference >= (step_size >> 2)) {
+        new_sample |= 1;
+    }
+
+    decode_sample(new_sample, predicted_sample, index);
+
+    return new_sample;
+}
+
+/** @brief Decode a 4-bit ADPCM sample with the state held in local variables.
+ *
+ *  Bit-exact with adpcm_decode(), the difference is read from difference_table.
+ *
+ *  @param[in]     original_sample   4-bit ADPCM sample.
+ *  @param[in,out] predicted_sample  Output of the ADPCM predictor.
+ *  @param[in,out] index             Index into step_size_table.
+ *  @return 16-bit PCM sample.
+ */
+static inline int16_t decode_sample(uint8_t original_sample, int32_t *predicted_sample, int32_t *index)
+{
+    int32_t difference = difference_table[*index][original_sample & 0x07];
+    int32_t new_sample;
+
+    if (original_sample & 8) {  /* account for sign bit */
+        difference = -difference;
+    }
+    new_sample = *predicted_sample + difference;
+    if (new_sample > INT16_MAX) {  /* check for overflow */
+        new_sample = INT16_MAX;
+    } else if (new_sample < INT16_MIN) {
+        new_sample = INT16_MIN;
+    }
+    *predicted_sample = new_sample;
+
+    *index += index_table[original_sample];
+    if (*index < 0) {  /* check for index underflow */
+        *index = 0;
+    } else if (*index > (STEP_SIZE_TABLE_LENGTH - 1)) {  /* check for index overflow */
+        *index = (STEP_SIZE_TABLE_LENGTH - 1);
+    }
+
+    return (int16_t)new_sample;
+}
+
+/** @brief Encode a 16-bit PCM sample into a 2 or 3-bit ADPCM code.
+ *
+ *  Same quantizer as the 4-bit codec, with code_size - 1 magnitude bits
+ *  found by repeated subtraction of the halved step_size.
+ *
+ *  @param[in]     original_sample   16-bit PCM sample.
+ *  @param[in,out] predicted_sample  Output of the ADPCM predictor.
+ *  @param[in,out] index             Index into step_size_table.
+ *  @param[in]     code_size         Code size in bits.
+ *  @param[in]     index_changes     Table of index changes of this code size.
+ *  @return ADPCM code, sign bit in the msb.
+ */
+static inline uint8_t encode_sample_nbits(int32_t original_sample, int32_t *predicted_sample, int32_t *index,
+                                          uint8_t code_size, const int8_t *index_changes)
+{
+    int32_t difference = original_sample - *predicted_sample;
+    int32_t step_size = step_size_table[*index];
+    uint8_t sign_bit = 1 << (code_size - 1);
+    uint8_t new_sample = 0;
+
+    if (difference < 0) {
+        new_sample = sign_bit;
+        difference = -difference;
+    }
+    for (uint8_t mask = sign_bit >> 1; mask != 0; mask >>= 1) {
+        if (difference >= step_size) {
+            new_sample |= mask;
+            difference -= step_size;
+        }
+        step_size >>= 1;
+    }
+
+    decode_sample_nbits(new_sample, predicted_sample, index, code_size, index_changes);
+
+    return new_sample;
+}
+
+/** @brief Decode a 2 or 3-bit ADPCM code.
+ *
+ *  @param[in]     original_sample   ADPCM code, sign bit in the msb.
+ *  @param[in,out] predicted_sample  Output of the ADPCM predictor.
+ *  @param[in,out] index             Index into step_size_table.
+ *  @param[in]     code_size         Code size in bits.
+ *  @param[in]     index_changes     Table of index changes of this code size.
+ *  @return 16-bit PCM sample.
+ */
+static inline int16_t decode_sample_nbits(uint8_t original_sample, int32_t *predicted_sample, int32_t *index,
+                                          uint8_t code_size, const int8_t *index_changes)
+{
+    int32_t step_size = step_size_table[*index];
+    uint8_t sign_bit = 1 << (code_size - 1);
+    int32_t difference = 0;
+    int32_t new_sample;
+
+    /* difference = (magnitude + ½) * step_size / 2^(code_size - 2) */
+    for (uint8_t mask = sign_bit >> 1; mask != 0; mask >>= 1) {
+        if (original_sample & mask) {
+            difference += step_size;
+        }
+        step_size >>= 1;
+    }
+    difference += step_size;
+    if (original_sample & sign_bit) {  /* account for sign bit */
+        difference = -difference;
+    }
+    new_sample = *predicted_sample + difference;
+    if (new_sample > INT16_MAX) {  /* check for overflow */
+        new_sample = INT16_MAX;
+    } else if (new_sample < INT16_MIN) {
+        new_sample = INT16_MIN;
+    }
+    *predicted_sample = new_sample;
+
+    *index += index_changes[original_sample & (sign_bit - 1)];
+    if (*index < 0) {  /* check for index underflow */
+        *index = 0;
+    } else if (*index > (STEP_SIZE_TABLE_LENGTH - 1)) {  /* check for index overflow */
+        *index = (STEP_SIZE_TABLE_LENGTH - 1);
+    }
+
+    return (int16_t)new_sample;
+}
+
+/** @brief Get the table of index changes of a code size.
+ *
+ *  @param[in] code_size  Code size in bits.
+ *  @return Table of index changes, indexed by the code magnitude.
+ */
+static const int8_t *get_index_changes(uint8_t code_size)
+{
+    switch (code_size) {
+    case 2:
+        return index_table_2bits;
+    case 3:
+        return index_table_3bits;
+    default:
+        return index_table;
+    }
+}
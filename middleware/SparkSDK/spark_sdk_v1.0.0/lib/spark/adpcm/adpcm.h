@@ -26,6 +26,16 @@ extern "C" {
 /* INCLUDES *******************************************************************/
 #include <stdint.h>
 
+/* CONSTANTS ******************************************************************/
+#define ADPCM_CODE_SIZE_MIN      2 /*!< Smallest supported ADPCM code size, in bits */
+#define ADPCM_CODE_SIZE_MAX      4 /*!< Largest supported ADPCM code size, in bits */
+#define ADPCM_PACKED_CHANNEL_MAX 2 /*!< Maximum number of interleaved channels of the packed block functions */
+
+/* MACROS *********************************************************************/
+/** @brief Number of bytes needed to hold sample_count codes of code_size bits.
+ */
+#define ADPCM_PACKED_NB_BYTES(sample_count, code_size) ((((uint32_t)(sample_count) * (code_size)) + 7) / 8)
+
 /* TYPES **********************************************************************/
 typedef struct state_variable {
         int16_t predicted_sample;
@@ -92,6 +102,81 @@ uint8_t adpcm_encode(int32_t original_sample, adpcm_state_t *state);
  */
 int16_t adpcm_decode(uint8_t original_sample, adpcm_state_t *state);
 
+/** @brief Encode a block of 16-bit PCM samples using ADPCM compression.
+ *
+ *  Produces the same codes as calling adpcm_encode() on each sample. Two codes are
+ *  packed per byte, the first sample in the 4 lsb. With an odd sample count, the
+ *  last code is written in the 4 lsb of the last byte.
+ *
+ *  @param[in]  pcm           16-bit PCM samples.
+ *  @param[out] codes         Packed 4-bit ADPCM samples, (sample_count + 1) / 2 bytes.
+ *  @param[in]  sample_count  Number of samples to encode.
+ *  @param[out] state         Internal ADPCM encoder state.
+ */
+void adpcm_encode_block(const int16_t *pcm, uint8_t *codes, uint16_t sample_count, adpcm_state_t *state);
+
+/** @brief Decode a block of packed 4-bit ADPCM samples into 16-bit PCM samples.
+ *
+ *  @param[in]  codes         Packed 4-bit ADPCM samples, as written by adpcm_encode_block().
+ *  @param[out] pcm           16-bit PCM samples.
+ *  @param[in]  sample_count  Number of samples to decode.
+ *  @param[out] state         Internal ADPCM decoder state.
+ */
+void adpcm_decode_block(const uint8_t *codes, int16_t *pcm, uint16_t sample_count, adpcm_state_t *state);
+
+/** @brief Encode a block of interleaved stereo 16-bit PCM samples using ADPCM compression.
+ *
+ *  Each output byte holds the left code in the 4 lsb and the right code in the 4 msb.
+ *
+ *  @param[in]  pcm          Interleaved stereo 16-bit PCM samples.
+ *  @param[out] codes        Packed 4-bit ADPCM samples, one byte per frame.
+ *  @param[in]  frame_count  Number of stereo frames to encode.
+ *  @param[out] left_state   Internal ADPCM encoder state of the left channel.
+ *  @param[out] right_state  Internal ADPCM encoder state of the right channel.
+ */
+void adpcm_encode_block_stereo(const int16_t *pcm, uint8_t *codes, uint16_t frame_count,
+                               adpcm_state_t *left_state, adpcm_state_t *right_state);
+
+/** @brief Decode a block of packed stereo ADPCM samples into interleaved 16-bit PCM samples.
+ *
+ *  @param[in]  codes        Packed 4-bit ADPCM samples, as written by adpcm_encode_block_stereo().
+ *  @param[out] pcm          Interleaved stereo 16-bit PCM samples.
+ *  @param[in]  frame_count  Number of stereo frames to decode.
+ *  @param[out] left_state   Internal ADPCM decoder state of the left channel.
+ *  @param[out] right_state  Internal ADPCM decoder state of the right channel.
+ */
+void adpcm_decode_block_stereo(const uint8_t *codes, int16_t *pcm, uint16_t frame_count,
+                               adpcm_state_t *left_state, adpcm_state_t *right_state);
+
+/** @brief Encode a block of interleaved 16-bit PCM samples into bit-packed 2, 3 or 4-bit ADPCM codes.
+ *
+ *  Codes are written LSB first and interleaved like the input samples. The 2 and 3-bit variants
+ *  use the same step size table as the 4-bit codec with a coarser quantizer and their own index
+ *  adaptation, so a state can be carried over when the code size changes between blocks. With a
+ *  code size of 4, the output is identical to adpcm_encode_block() for a single channel and to
+ *  adpcm_encode_block_stereo() for two channels.
+ *
+ *  @param[in]  pcm            Interleaved 16-bit PCM samples.
+ *  @param[out] codes          Packed ADPCM codes, ADPCM_PACKED_NB_BYTES(frame_count * channel_count, code_size) bytes.
+ *  @param[in]  frame_count    Number of frames to encode.
+ *  @param[in]  channel_count  Number of interleaved channels, 1 up to ADPCM_PACKED_CHANNEL_MAX.
+ *  @param[in]  code_size      Code size in bits, ADPCM_CODE_SIZE_MIN up to ADPCM_CODE_SIZE_MAX.
+ *  @param[out] state          Array of channel_count internal ADPCM encoder states.
+ */
+void adpcm_encode_block_packed(const int16_t *pcm, uint8_t *codes, uint16_t frame_count, uint8_t channel_count,
+                               uint8_t code_size, adpcm_state_t *state);
+
+/** @brief Decode a block of bit-packed 2, 3 or 4-bit ADPCM codes into interleaved 16-bit PCM samples.
+ *
+ *  @param[in]  codes          Packed ADPCM codes, as written by adpcm_encode_block_packed().
+ *  @param[out] pcm            Interleaved 16-bit PCM samples.
+ *  @param[in]  frame_count    Number of frames to decode.
+ *  @param[in]  channel_count  Number of interleaved channels, 1 up to ADPCM_PACKED_CHANNEL_MAX.
+ *  @param[in]  code_size      Code size in bits, ADPCM_CODE_SIZE_MIN up to ADPCM_CODE_SIZE_MAX.
+ *  @param[out] state          Array of channel_count internal ADPCM decoder states.
+ */
+void adpcm_decode_block_packed(const uint8_t *codes, int16_t *pcm, uint16_t frame_count, uint8_t channel_count,
+                               uint8_t code_size, adpcm_state_t *state);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,52 @@
+/** @file crc16.h
+ *  @brief 16-bit CRC implementation (CCITT polynomial 0x1021).
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef CRC16_H_
+#define CRC16_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define CRC16_INIT 0xFFFF /*!< Initial value of the CRC16 */
+
+#ifndef CRC_SLICE_BY_4_EN
+#define CRC_SLICE_BY_4_EN 1 /*!< Set to 1 to process 4 bytes per iteration at the cost of 3 more lookup tables */
+#endif
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Calculate CRC16 of input data.
+ *
+ *  @param[in] crc   Existing CRC value before process a new one.
+ *  @param[in] data  Pointer to data to be hashed with CRC.
+ *  @param[in] len   Size of data.
+ *  @return CRC value.
+ */
+uint16_t crc16(uint16_t crc, const uint8_t *data, uint16_t len);
+
+/** @brief Verify the CRC16 of input data without modifying it.
+ *
+ *  @param[in] data      Pointer to data to be checked.
+ *  @param[in] len       Size of data.
+ *  @param[in] expected  CRC16 value the data is expected to have.
+ *  @retval true   Data matches the expected CRC.
+ *  @retval false  Data is corrupted.
+ */
+bool crc16_verify(const uint8_t *data, uint16_t len, uint16_t expected);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC16_H_ */
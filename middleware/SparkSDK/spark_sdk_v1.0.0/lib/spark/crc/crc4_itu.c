@@ -32,15 +32,88 @@ static uint8_t const table_byte[256] = {
     0x4, 0x3, 0xa, 0xd, 0x1, 0x6, 0xf, 0x8, 0xe, 0x9, 0x0, 0x7, 0xb, 0xc, 0x5, 0x2
 };
 
+#if (CRC_SLICE_BY_4_EN > 0U)
+/* Lookup tables of the CRC of a byte followed by 1, 2 and 3 zero bytes */
+static uint8_t const table_slice[3][256] = {
+    {
+        0x0, 0xc, 0x1, 0xd, 0x2, 0xe, 0x3, 0xf, 0x4, 0x8, 0x5, 0x9, 0x6, 0xa, 0x7, 0xb,
+        0x8, 0x4, 0x9, 0x5, 0xa, 0x6, 0xb, 0x7, 0xc, 0x0, 0xd, 0x1, 0xe, 0x2, 0xf, 0x3,
+        0x9, 0x5, 0x8, 0x4, 0xb, 0x7, 0xa, 0x6, 0xd, 0x1, 0xc, 0x0, 0xf, 0x3, 0xe, 0x2,
+        0x1, 0xd, 0x0, 0xc, 0x3, 0xf, 0x2, 0xe, 0x5, 0x9, 0x4, 0x8, 0x7, 0xb, 0x6, 0xa,
+        0xb, 0x7, 0xa, 0x6, 0x9, 0x5, 0x8, 0x4, 0xf, 0x3, 0xe, 0x2, 0xd, 0x1, 0xc, 0x0,
+        0x3, 0xf, 0x2, 0xe, 0x1, 0xd, 0x0, 0xc, 0x7, 0xb, 0x6, 0xa, 0x5, 0x9, 0x4, 0x8,
+        0x2, 0xe, 0x3, 0xf, 0x0, 0xc, 0x1, 0xd, 0x6, 0xa, 0x7, 0xb, 0x4, 0x8, 0x5, 0x9,
+        0xa, 0x6, 0xb, 0x7, 0x8, 0x4, 0x9, 0x5, 0xe, 0x2, 0xf, 0x3, 0xc, 0x0, 0xd, 0x1,
+        0xf, 0x3, 0xe, 0x2, 0xd, 0x1, 0xc, 0x0, 0xb, 0x7, 0xa, 0x6, 0x9, 0x5, 0x8, 0x4,
+        0x7, 0xb, 0x6, 0xa, 0x5, 0x9, 0x4, 0x8, 0x3, 0xf, 0x2, 0xe, 0x1, 0xd, 0x0, 0xc,
+        0x6, 0xa, 0x7, 0xb, 0x4, 0x8, 0x5, 0x9, 0x2, 0xe, 0x3, 0xf, 0x0, 0xc, 0x1, 0xd,
+        0xe, 0x2, 0xf, 0x3, 0xc, 0x0, 0xd, 0x1, 0xa, 0x6, 0xb, 0x7, 0x8, 0x4, 0x9, 0x5,
+        0x4, 0x8, 0x5, 0x9, 0x6, 0xa, 0x7, 0xb, 0x0, 0xc, 0x1, 0xd, 0x2, 0xe, 0x3, 0xf,
+        0xc, 0x0, 0xd, 0x1, 0xe, 0x2, 0xf, 0x3, 0x8, 0x4, 0x9, 0x5, 0xa, 0x6, 0xb, 0x7,
+        0xd, 0x1, 0xc, 0x0, 0xf, 0x3, 0xe, 0x2, 0x9, 0x5, 0x8, 0x4, 0xb, 0x7, 0xa, 0x6,
+        0x5, 0x9, 0x4, 0x8, 0x7, 0xb, 0x6, 0xa, 0x1, 0xd, 0x0, 0xc, 0x3, 0xf, 0x2, 0xe
+    },
+    {
+        0x0, 0xf, 0x7, 0x8, 0xe, 0x1, 0x9, 0x6, 0x5, 0xa, 0x2, 0xd, 0xb, 0x4, 0xc, 0x3,
+        0xa, 0x5, 0xd, 0x2, 0x4, 0xb, 0x3, 0xc, 0xf, 0x0, 0x8, 0x7, 0x1, 0xe, 0x6, 0x9,
+        0xd, 0x2, 0xa, 0x5, 0x3, 0xc, 0x4, 0xb, 0x8, 0x7, 0xf, 0x0, 0x6, 0x9, 0x1, 0xe,
+        0x7, 0x8, 0x0, 0xf, 0x9, 0x6, 0xe, 0x1, 0x2, 0xd, 0x5, 0xa, 0xc, 0x3, 0xb, 0x4,
+        0x3, 0xc, 0x4, 0xb, 0xd, 0x2, 0xa, 0x5, 0x6, 0x9, 0x1, 0xe, 0x8, 0x7, 0xf, 0x0,
+        0x9, 0x6, 0xe, 0x1, 0x7, 0x8, 0x0, 0xf, 0xc, 0x3, 0xb, 0x4, 0x2, 0xd, 0x5, 0xa,
+        0xe, 0x1, 0x9, 0x6, 0x0, 0xf, 0x7, 0x8, 0xb, 0x4, 0xc, 0x3, 0x5, 0xa, 0x2, 0xd,
+        0x4, 0xb, 0x3, 0xc, 0xa, 0x5, 0xd, 0x2, 0x1, 0xe, 0x6, 0x9, 0xf, 0x0, 0x8, 0x7,
+        0x6, 0x9, 0x1, 0xe, 0x8, 0x7, 0xf, 0x0, 0x3, 0xc, 0x4, 0xb, 0xd, 0x2, 0xa, 0x5,
+        0xc, 0x3, 0xb, 0x4, 0x2, 0xd, 0x5, 0xa, 0x9, 0x6, 0xe, 0x1, 0x7, 0x8, 0x0, 0xf,
+        0xb, 0x4, 0xc, 0x3, 0x5, 0xa, 0x2, 0xd, 0xe, 0x1, 0x9, 0x6, 0x0, 0xf, 0x7, 0x8,
+        0x1, 0xe, 0x6, 0x9, 0xf, 0x0, 0x8, 0x7, 0x4, 0xb, 0x3, 0xc, 0xa, 0x5, 0xd, 0x2,
+        0x5, 0xa, 0x2, 0xd, 0xb, 0x4, 0xc, 0x3, 0x0, 0xf, 0x7, 0x8, 0xe, 0x1, 0x9, 0x6,
+        0xf, 0x0, 0x8, 0x7, 0x1, 0xe, 0x6, 0x9, 0xa, 0x5, 0xd, 0x2, 0x4, 0xb, 0x3, 0xc,
+        0x8, 0x7, 0xf, 0x0, 0x6, 0x9, 0x1, 0xe, 0xd, 0x2, 0xa, 0x5, 0x3, 0xc, 0x4, 0xb,
+        0x2, 0xd, 0x5, 0xa, 0xc, 0x3, 0xb, 0x4, 0x7, 0x8, 0x0, 0xf, 0x9, 0x6, 0xe, 0x1
+    },
+    {
+        0x0, 0x6, 0xc, 0xa, 0x1, 0x7, 0xd, 0xb, 0x2, 0x4, 0xe, 0x8, 0x3, 0x5, 0xf, 0x9,
+        0x4, 0x2, 0x8, 0xe, 0x5, 0x3, 0x9, 0xf, 0x6, 0x0, 0xa, 0xc, 0x7, 0x1, 0xb, 0xd,
+        0x8, 0xe, 0x4, 0x2, 0x9, 0xf, 0x5, 0x3, 0xa, 0xc, 0x6, 0x0, 0xb, 0xd, 0x7, 0x1,
+        0xc, 0xa, 0x0, 0x6, 0xd, 0xb, 0x1, 0x7, 0xe, 0x8, 0x2, 0x4, 0xf, 0x9, 0x3, 0x5,
+        0x9, 0xf, 0x5, 0x3, 0x8, 0xe, 0x4, 0x2, 0xb, 0xd, 0x7, 0x1, 0xa, 0xc, 0x6, 0x0,
+        0xd, 0xb, 0x1, 0x7, 0xc, 0xa, 0x0, 0x6, 0xf, 0x9, 0x3, 0x5, 0xe, 0x8, 0x2, 0x4,
+        0x1, 0x7, 0xd, 0xb, 0x0, 0x6, 0xc, 0xa, 0x3, 0x5, 0xf, 0x9, 0x2, 0x4, 0xe, 0x8,
+        0x5, 0x3, 0x9, 0xf, 0x4, 0x2, 0x8, 0xe, 0x7, 0x1, 0xb, 0xd, 0x6, 0x0, 0xa, 0xc,
+        0xb, 0xd, 0x7, 0x1, 0xa, 0xc, 0x6, 0x0, 0x9, 0xf, 0x5, 0x3, 0x8, 0xe, 0x4, 0x2,
+        0xf, 0x9, 0x3, 0x5, 0xe, 0x8, 0x2, 0x4, 0xd, 0xb, 0x1, 0x7, 0xc, 0xa, 0x0, 0x6,
+        0x3, 0x5, 0xf, 0x9, 0x2, 0x4, 0xe, 0x8, 0x1, 0x7, 0xd, 0xb, 0x0, 0x6, 0xc, 0xa,
+        0x7, 0x1, 0xb, 0xd, 0x6, 0x0, 0xa, 0xc, 0x5, 0x3, 0x9, 0xf, 0x4, 0x2, 0x8, 0xe,
+        0x2, 0x4, 0xe, 0x8, 0x3, 0x5, 0xf, 0x9, 0x0, 0x6, 0xc, 0xa, 0x1, 0x7, 0xd, 0xb,
+        0x6, 0x0, 0xa, 0xc, 0x7, 0x1, 0xb, 0xd, 0x4, 0x2, 0x8, 0xe, 0x5, 0x3, 0x9, 0xf,
+        0xa, 0xc, 0x6, 0x0, 0xb, 0xd, 0x7, 0x1, 0x8, 0xe, 0x4, 0x2, 0x9, 0xf, 0x5, 0x3,
+        0xe, 0x8, 0x2, 0x4, 0xf, 0x9, 0x3, 0x5, 0xc, 0xa, 0x0, 0x6, 0xd, 0xb, 0x1, 0x7
+    }
+};
+#endif
+
 /* PUBLIC FUNCTIONS ***********************************************************/
-uint8_t crc4itu(uint8_t crc, uint8_t *data, uint8_t len)
+uint8_t crc4itu(uint8_t crc, const uint8_t *data, uint16_t len)
 {
     if (data == NULL) {
         return 0;
     }
     crc &= 0xf;
+#if (CRC_SLICE_BY_4_EN > 0U)
+    while (len >= 4) {
+        crc = table_slice[2][crc ^ data[0]] ^ table_slice[1][data[1]] ^
+              table_slice[0][data[2]] ^ table_byte[data[3]];
+        data += 4;
+        len -= 4;
+    }
+#endif
     while (len--) {
         crc = table_byte[crc ^ *data++];
     }
     return crc;
 }
+
+bool crc4itu_verify(const uint8_t *data, uint16_t len, uint8_t expected)
+{
+    return (crc4itu(CRC4_ITU_INIT, data, len) == expected);
+}
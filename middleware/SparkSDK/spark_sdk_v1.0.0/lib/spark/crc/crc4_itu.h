@@ -10,12 +10,20 @@
 #define CRC4_ITU_H_
 
 /* INCLUDES *******************************************************************/
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* CONSTANTS ******************************************************************/
+#define CRC4_ITU_INIT 0x0 /*!< Initial value of the CRC4 */
+
+#ifndef CRC_SLICE_BY_4_EN
+#define CRC_SLICE_BY_4_EN 1 /*!< Set to 1 to process 4 bytes per iteration at the cost of 3 more lookup tables */
+#endif
+
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
 /** @brief Calculate CRC4 of input data.
  *
@@ -24,7 +32,17 @@ extern "C" {
  *  @param[in] len   Size of data.
  *  @return CRC value.
  */
-uint8_t crc4itu(uint8_t crc, uint8_t *data, uint8_t len);
+uint8_t crc4itu(uint8_t crc, const uint8_t *data, uint16_t len);
+
+/** @brief Verify the CRC4 of input data without modifying it.
+ *
+ *  @param[in] data      Pointer to data to be checked.
+ *  @param[in] len       Size of data.
+ *  @param[in] expected  CRC4 value the data is expected to have.
+ *  @retval true   Data matches the expected CRC.
+ *  @retval false  Data is corrupted.
+ */
+bool crc4itu_verify(const uint8_t *data, uint16_t len, uint8_t expected);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,52 @@
+/** @file crc8.h
+ *  @brief 8-bit CRC implementation (polynomial 0x07).
+ *
+ *  @copyright Copyright (C) 2022 SPARK Microsystems International Inc. All rights reserved.
+ *  @license   This source code is proprietary and subject to the SPARK Microsystems
+ *             Software EULA found in this package in file EULA.txt.
+ *  @author    SPARK FW Team.
+ */
+#ifndef CRC8_H_
+#define CRC8_H_
+
+/* INCLUDES *******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CONSTANTS ******************************************************************/
+#define CRC8_INIT 0x00 /*!< Initial value of the CRC8 */
+
+#ifndef CRC_SLICE_BY_4_EN
+#define CRC_SLICE_BY_4_EN 1 /*!< Set to 1 to process 4 bytes per iteration at the cost of 3 more lookup tables */
+#endif
+
+/* PUBLIC FUNCTION PROTOTYPES *************************************************/
+/** @brief Calculate CRC8 of input data.
+ *
+ *  @param[in] crc   Existing CRC value before process a new one.
+ *  @param[in] data  Pointer to data to be hashed with CRC.
+ *  @param[in] len   Size of data.
+ *  @return CRC value.
+ */
+uint8_t crc8(uint8_t crc, const uint8_t *data, uint16_t len);
+
+/** @brief Verify the CRC8 of input data without modifying it.
+ *
+ *  @param[in] data      Pointer to data to be checked.
+ *  @param[in] len       Size of data.
+ *  @param[in] expected  CRC8 value the data is expected to have.
+ *  @retval true   Data matches the expected CRC.
+ *  @retval false  Data is corrupted.
+ */
+bool crc8_verify(const uint8_t *data, uint16_t len, uint8_t expected);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC8_H_ */
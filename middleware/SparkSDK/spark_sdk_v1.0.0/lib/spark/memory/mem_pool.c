@@ -10,42 +10,435 @@
 /* INCLUDES *******************************************************************/
 #include "mem_pool.h"
 
+/* CONSTANTS ******************************************************************/
+#define BLOCK_MAGIC_USED  0x5AC1 /* Block allocated by mem_pool_alloc() */
+#define BLOCK_MAGIC_FREE  0xF7EE /* Block in a free list */
+#define BLOCK_FLAG_LAST   0x01   /* No mem_pool_alloc() block follows this one in memory */
+#define SMALL_CLASS_COUNT 4      /* Classes of 0, 8, 16 and 24 bytes, below the first power of two class */
+#define SMALL_CLASS_SHIFT 3      /* Log2 of the small classes size step */
+#define CLASS_FL_MIN      5      /* Log2 of the first power of two class */
+#define CLASS_SL_BITS     2      /* Each power of two is split in 4 classes */
+
+/* MACROS *********************************************************************/
+#define ALIGN_SIZE(size) (((size) + (MEM_POOL_ALIGNMENT - 1)) & ~(MEM_POOL_ALIGNMENT - 1))
+
+/* TYPES **********************************************************************/
+/** @brief Header placed in front of each mem_pool_alloc() block.
+ */
+typedef struct mem_pool_block {
+    uint32_t size;      /*!< Usable size of the block, which may exceed the wanted size */
+    uint32_t prev_size; /*!< Usable size of the mem_pool_alloc() block right before this one, 0 if there is none */
+    uint16_t magic;     /*!< BLOCK_MAGIC_USED or BLOCK_MAGIC_FREE */
+    uint8_t  owner;     /*!< Owner the block is accounted to */
+    uint8_t  flags;     /*!< BLOCK_FLAG_LAST or 0 */
+} mem_pool_block_t;
+
+/** @brief Links stored in the payload of a released block.
+ */
+typedef struct mem_pool_free_links {
+    mem_pool_block_t *next; /*!< Next block of the free list */
+    mem_pool_block_t *prev; /*!< Previous block of the free list, NULL for the first one */
+} mem_pool_free_links_t;
+
+#define BLOCK_HEADER_SIZE ALIGN_SIZE(sizeof(mem_pool_block_t))
+#define BLOCK_MIN_SIZE    ALIGN_SIZE(sizeof(mem_pool_free_links_t))
+
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static inline uint8_t get_floor_class(uint32_t size);
+static inline uint32_t get_class_size(uint8_t size_class);
+static inline mem_pool_free_links_t *get_links(mem_pool_block_t *block);
+static inline mem_pool_block_t *get_next_block(mem_pool_block_t *block);
+static inline mem_pool_block_t *get_prev_block(mem_pool_block_t *block);
+static mem_pool_block_t *find_free_block(mem_pool_t *mem_pool, uint32_t size);
+static mem_pool_block_t *take_fresh_block(mem_pool_t *mem_pool, uint32_t size);
+static void split_block(mem_pool_t *mem_pool, mem_pool_block_t *block, uint32_t size);
+static void insert_free_block(mem_pool_t *mem_pool, mem_pool_block_t *block);
+static void remove_free_block(mem_pool_t *mem_pool, mem_pool_block_t *block);
+static void update_usage(mem_pool_t *mem_pool, uint8_t owner, uint32_t size);
+
 /* PUBLIC FUNCTIONS ***********************************************************/
 void mem_pool_init(mem_pool_t *mem_pool, uint8_t * pool, size_t meme_pool_size)
 {
+    memset(mem_pool, 0, sizeof(mem_pool_t));
+
     mem_pool->mem_pool_begin = pool;
     mem_pool->capacity = meme_pool_size;
-    mem_pool->free_bytes = mem_pool->capacity;
-    mem_pool->mem_pool_it = mem_pool->mem_pool_begin;
-    mem_pool->mem_pool_end = mem_pool->mem_pool_begin + mem_pool->capacity;
+    mem_pool_free(mem_pool);
 }
 
 void *mem_pool_malloc(mem_pool_t *mem_pool, size_t wanted_size)
 {
     void* ptr_ret = NULL;
 
-    if (wanted_size & (sizeof(void *) - 1)) {
-        wanted_size += (sizeof(uint32_t) - (wanted_size & (sizeof(void *) - 1)));
-    }
+    wanted_size = ALIGN_SIZE(wanted_size);
 
     if (wanted_size <= mem_pool->free_bytes) {
         ptr_ret = mem_pool->mem_pool_it;
         memset(mem_pool->mem_pool_it, 0, wanted_size);
         mem_pool->mem_pool_it += wanted_size;
         mem_pool->free_bytes -= wanted_size;
+        /* The last mem_pool_alloc() block keeps BLOCK_FLAG_LAST, it is now followed by this one */
+        mem_pool->last_block = NULL;
+        update_usage(mem_pool, MEM_POOL_OWNER_DEFAULT, wanted_size);
     }
 
     return ptr_ret;
 }
 
+void *mem_pool_alloc(mem_pool_t *mem_pool, size_t wanted_size, uint8_t owner, uint8_t flags)
+{
+    mem_pool_block_t *block;
+
+    if ((owner >= MEM_POOL_OWNER_COUNT) || (wanted_size > mem_pool->capacity)) {
+        return NULL;
+    }
+
+    /* A released block holds the free list links */
+    if (wanted_size < BLOCK_MIN_SIZE) {
+        wanted_size = BLOCK_MIN_SIZE;
+    }
+    wanted_size = ALIGN_SIZE(wanted_size);
+
+    block = find_free_block(mem_pool, wanted_size);
+    if (block != NULL) {
+        remove_free_block(mem_pool, block);
+        split_block(mem_pool, block, wanted_size);
+    } else {
+        block = take_fresh_block(mem_pool, wanted_size);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    block->owner = owner;
+    block->magic = BLOCK_MAGIC_USED;
+    update_usage(mem_pool, owner, BLOCK_HEADER_SIZE + block->size);
+
+    if (!(flags & MEM_POOL_FLAG_NO_ZERO)) {
+        memset((uint8_t *)block + BLOCK_HEADER_SIZE, 0, block->size);
+    }
+
+    return (uint8_t *)block + BLOCK_HEADER_SIZE;
+}
+
+void mem_pool_release(mem_pool_t *mem_pool, void *ptr)
+{
+    mem_pool_block_t *block, *neighbour;
+
+    if ((ptr == NULL) || ((uint8_t *)ptr < (mem_pool->mem_pool_begin + BLOCK_HEADER_SIZE)) ||
+        ((uint8_t *)ptr >= mem_pool->mem_pool_it)) {
+        return;
+    }
+
+    block = (mem_pool_block_t *)((uint8_t *)ptr - BLOCK_HEADER_SIZE);
+    if (block->magic != BLOCK_MAGIC_USED) {
+        return;
+    }
+
+    block->magic = BLOCK_MAGIC_FREE;
+    mem_pool->used_bytes -= BLOCK_HEADER_SIZE + block->size;
+    mem_pool->owner_bytes[block->owner] -= BLOCK_HEADER_SIZE + block->size;
+
+    /* Merge with the following block */
+    neighbour = get_next_block(block);
+    if ((neighbour != NULL) && (neighbour->magic == BLOCK_MAGIC_FREE)) {
+        remove_free_block(mem_pool, neighbour);
+        block->size += BLOCK_HEADER_SIZE + neighbour->size;
+        block->flags = neighbour->flags;
+    }
+    /* Merge with the preceding block */
+    neighbour = get_prev_block(block);
+    if ((neighbour != NULL) && (neighbour->magic == BLOCK_MAGIC_FREE)) {
+        remove_free_block(mem_pool, neighbour);
+        neighbour->size += BLOCK_HEADER_SIZE + block->size;
+        neighbour->flags = block->flags;
+        if (mem_pool->last_block == block) {
+            mem_pool->last_block = neighbour;
+        }
+        block = neighbour;
+    }
+
+    if (mem_pool->last_block == block) {
+        /* The block ends at the top of the used pool, give it back */
+        mem_pool->last_block = get_prev_block(block);
+        if (mem_pool->last_block != NULL) {
+            ((mem_pool_block_t *)mem_pool->last_block)->flags |= BLOCK_FLAG_LAST;
+        }
+        mem_pool->mem_pool_it = (uint8_t *)block;
+        mem_pool->free_bytes += BLOCK_HEADER_SIZE + block->size;
+        return;
+    }
+
+    neighbour = get_next_block(block);
+    if (neighbour != NULL) {
+        neighbour->prev_size = block->size;
+    }
+    insert_free_block(mem_pool, block);
+}
+
 void mem_pool_free(mem_pool_t *mem_pool)
 {
     mem_pool->free_bytes = mem_pool->capacity;
     mem_pool->mem_pool_it = mem_pool->mem_pool_begin;
     mem_pool->mem_pool_end = mem_pool->mem_pool_begin + mem_pool->capacity;
+    mem_pool->used_bytes = 0;
+    mem_pool->free_list_map = 0;
+    mem_pool->last_block = NULL;
+    memset(mem_pool->free_list, 0, sizeof(mem_pool->free_list));
+    memset(mem_pool->owner_bytes, 0, sizeof(mem_pool->owner_bytes));
 }
 
 uint32_t mem_pool_get_allocated_bytes(mem_pool_t *mem_pool)
 {
-    return (mem_pool->capacity - mem_pool->free_bytes);
+    return mem_pool->used_bytes;
+}
+
+uint32_t mem_pool_get_high_water_mark(mem_pool_t *mem_pool)
+{
+    return mem_pool->high_water_mark;
+}
+
+uint32_t mem_pool_get_owner_bytes(mem_pool_t *mem_pool, uint8_t owner)
+{
+    if (owner >= MEM_POOL_OWNER_COUNT) {
+        return 0;
+    }
+
+    return mem_pool->owner_bytes[owner];
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Get the largest size class whose size does not exceed a block size.
+ *
+ *  Classes are 8 bytes apart below 32 bytes, then each power of two is split in 4.
+ *
+ *  @param[in] size  Block size, in bytes.
+ *  @return Size class.
+ */
+static inline uint8_t get_floor_class(uint32_t size)
+{
+    uint8_t fl;
+
+    if (size < (1UL << CLASS_FL_MIN)) {
+        return (uint8_t)(size >> SMALL_CLASS_SHIFT);
+    }
+
+    fl = (uint8_t)(31 - __builtin_clz(size));
+    if (fl > MEM_POOL_CLASS_FL_MAX) {
+        return MEM_POOL_CLASS_COUNT - 1;
+    }
+
+    return (uint8_t)(SMALL_CLASS_COUNT + ((fl - CLASS_FL_MIN) << CLASS_SL_BITS) +
+                     ((size >> (fl - CLASS_SL_BITS)) & ((1 << CLASS_SL_BITS) - 1)));
+}
+
+/** @brief Get the smallest block size of a size class.
+ *
+ *  @param[in] size_class  Size class.
+ *  @return Size, in bytes.
+ */
+static inline uint32_t get_class_size(uint8_t size_class)
+{
+    uint8_t fl, sl;
+
+    if (size_class < SMALL_CLASS_COUNT) {
+        return (uint32_t)size_class << SMALL_CLASS_SHIFT;
+    }
+
+    fl = ((size_class - SMALL_CLASS_COUNT) >> CLASS_SL_BITS) + CLASS_FL_MIN;
+    sl = (size_class - SMALL_CLASS_COUNT) & ((1 << CLASS_SL_BITS) - 1);
+
+    return ((uint32_t)((1 << CLASS_SL_BITS) + sl)) << (fl - CLASS_SL_BITS);
+}
+
+/** @brief Get the free list links of a released block.
+ *
+ *  @param[in] block  Block header.
+ *  @return Links.
+ */
+static inline mem_pool_free_links_t *get_links(mem_pool_block_t *block)
+{
+    return (mem_pool_free_links_t *)((uint8_t *)block + BLOCK_HEADER_SIZE);
+}
+
+/** @brief Get the mem_pool_alloc() block right after another in memory.
+ *
+ *  @param[in] block  Block header.
+ *  @return Block header, NULL if the memory that follows is not a mem_pool_alloc() block.
+ */
+static inline mem_pool_block_t *get_next_block(mem_pool_block_t *block)
+{
+    if (block->flags & BLOCK_FLAG_LAST) {
+        return NULL;
+    }
+
+    return (mem_pool_block_t *)((uint8_t *)block + BLOCK_HEADER_SIZE + block->size);
+}
+
+/** @brief Get the mem_pool_alloc() block right before another in memory.
+ *
+ *  @param[in] block  Block header.
+ *  @return Block header, NULL if the memory that precedes is not a mem_pool_alloc() block.
+ */
+static inline mem_pool_block_t *get_prev_block(mem_pool_block_t *block)
+{
+    if (block->prev_size == 0) {
+        return NULL;
+    }
+
+    return (mem_pool_block_t *)((uint8_t *)block - BLOCK_HEADER_SIZE - block->prev_size);
+}
+
+/** @brief Find a released block able to hold a size.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] size      Wanted size, aligned.
+ *  @return Block header, NULL if none fits.
+ */
+static mem_pool_block_t *find_free_block(mem_pool_t *mem_pool, uint32_t size)
+{
+    mem_pool_block_t *block;
+    uint64_t map;
+    uint8_t size_class;
+
+    /* Smallest class whose blocks are all at least size bytes */
+    size_class = get_floor_class(size);
+    if (get_class_size(size_class) < size) {
+        size_class++;
+    }
+
+    if (size_class < MEM_POOL_CLASS_COUNT) {
+        map = mem_pool->free_list_map >> size_class;
+        if (map != 0) {
+            return mem_pool->free_list[(uint8_t)__builtin_ctzll(map) + size_class];
+        }
+        return NULL;
+    }
+
+    /* The last class holds blocks of any size above its own */
+    block = mem_pool->free_list[MEM_POOL_CLASS_COUNT - 1];
+    while ((block != NULL) && (block->size < size)) {
+        block = get_links(block)->next;
+    }
+
+    return block;
+}
+
+/** @brief Take a block from the end of the pool.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] size      Wanted size, aligned.
+ *  @return Block header, NULL if the pool is exhausted.
+ */
+static mem_pool_block_t *take_fresh_block(mem_pool_t *mem_pool, uint32_t size)
+{
+    mem_pool_block_t *block;
+    mem_pool_block_t *last_block = mem_pool->last_block;
+
+    if ((BLOCK_HEADER_SIZE + size) > mem_pool->free_bytes) {
+        return NULL;
+    }
+
+    block = (mem_pool_block_t *)mem_pool->mem_pool_it;
+    block->size = size;
+    block->prev_size = 0;
+    block->flags = BLOCK_FLAG_LAST;
+    if (last_block != NULL) {
+        block->prev_size = last_block->size;
+        last_block->flags &= ~BLOCK_FLAG_LAST;
+    }
+    mem_pool->last_block = block;
+    mem_pool->mem_pool_it += BLOCK_HEADER_SIZE + size;
+    mem_pool->free_bytes -= BLOCK_HEADER_SIZE + size;
+
+    return block;
+}
+
+/** @brief Split the end of a block into a released block, if it can hold one.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] block     Block header, not in a free list.
+ *  @param[in] size      Size the block keeps, aligned.
+ */
+static void split_block(mem_pool_t *mem_pool, mem_pool_block_t *block, uint32_t size)
+{
+    mem_pool_block_t *remainder, *next;
+
+    if (block->size < (size + BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE)) {
+        return;
+    }
+
+    remainder = (mem_pool_block_t *)((uint8_t *)block + BLOCK_HEADER_SIZE + size);
+    remainder->size = block->size - size - BLOCK_HEADER_SIZE;
+    remainder->prev_size = size;
+    remainder->flags = block->flags;
+    remainder->magic = BLOCK_MAGIC_FREE;
+    remainder->owner = MEM_POOL_OWNER_DEFAULT;
+    block->size = size;
+    block->flags &= ~BLOCK_FLAG_LAST;
+
+    /* Released neighbours are always merged, so the block after the remainder is in use */
+    next = get_next_block(remainder);
+    if (next != NULL) {
+        next->prev_size = remainder->size;
+    }
+    insert_free_block(mem_pool, remainder);
+}
+
+/** @brief Add a released block to the free list of its class.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] block     Block header.
+ */
+static void insert_free_block(mem_pool_t *mem_pool, mem_pool_block_t *block)
+{
+    uint8_t size_class = get_floor_class(block->size);
+    mem_pool_block_t *head = mem_pool->free_list[size_class];
+
+    block->magic = BLOCK_MAGIC_FREE;
+    get_links(block)->next = head;
+    get_links(block)->prev = NULL;
+    if (head != NULL) {
+        get_links(head)->prev = block;
+    }
+    mem_pool->free_list[size_class] = block;
+    mem_pool->free_list_map |= (1ULL << size_class);
+}
+
+/** @brief Remove a released block from the free list of its class.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] block     Block header.
+ */
+static void remove_free_block(mem_pool_t *mem_pool, mem_pool_block_t *block)
+{
+    uint8_t size_class = get_floor_class(block->size);
+    mem_pool_free_links_t *links = get_links(block);
+
+    if (links->prev != NULL) {
+        get_links(links->prev)->next = links->next;
+    } else {
+        mem_pool->free_list[size_class] = links->next;
+        if (links->next == NULL) {
+            mem_pool->free_list_map &= ~(1ULL << size_class);
+        }
+    }
+    if (links->next != NULL) {
+        get_links(links->next)->prev = links->prev;
+    }
+}
+
+/** @brief Account for a new allocation.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] owner     Owner of the allocation.
+ *  @param[in] size      Bytes taken from the pool.
+ */
+static void update_usage(mem_pool_t *mem_pool, uint8_t owner, uint32_t size)
+{
+    mem_pool->used_bytes += size;
+    mem_pool->owner_bytes[owner] += size;
+    if (mem_pool->used_bytes > mem_pool->high_water_mark) {
+        mem_pool->high_water_mark = mem_pool->used_bytes;
+    }
 }
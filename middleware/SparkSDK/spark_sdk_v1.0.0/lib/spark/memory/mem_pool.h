@@ -1,6 +1,16 @@
 /** @file  mem_pool.h
  *  @brief Memory management for the SDK.
  *
+ *  Two kinds of allocations share the same pool:
+ *  - mem_pool_malloc() carves permanent, zeroed blocks out of the pool. They are only
+ *    given back all at once by mem_pool_free().
+ *  - mem_pool_alloc() returns blocks that can be given back individually with
+ *    mem_pool_release(). Released blocks are merged with their released neighbours
+ *    and kept in free lists segregated by size class. A larger block is split to
+ *    serve a smaller allocation, and a released block ending at the top of the used
+ *    pool goes back to it. Both calls run in constant time, except for blocks of
+ *    the last size class which are searched first fit.
+ *
  *  @copyright Copyright (C) 2021 SPARK Microsystems International Inc.
  *  @license   This source code is proprietary and subject to the SPARK Microsystems
  *             Software EULA found in this package in file EULA.txt.
@@ -18,13 +28,34 @@
 extern "C" {
 #endif
 
+/* CONSTANTS ******************************************************************/
+#define MEM_POOL_ALIGNMENT      sizeof(void *) /*!< Alignment of every block returned by the pool */
+#define MEM_POOL_CLASS_FL_MAX   13 /*!< Log2 of the largest size class, bigger blocks share the last class */
+#define MEM_POOL_CLASS_COUNT    (4 + ((MEM_POOL_CLASS_FL_MAX - 4) * 4)) /*!< Number of segregated free lists */
+#define MEM_POOL_OWNER_DEFAULT  0 /*!< Owner of the blocks allocated with mem_pool_malloc() */
+
+#ifndef MEM_POOL_OWNER_COUNT
+#define MEM_POOL_OWNER_COUNT    8 /*!< Number of owners the pool keeps separate accounting for */
+#endif
+
+/** @brief mem_pool_alloc() flags.
+ */
+#define MEM_POOL_FLAG_NONE      0x00 /*!< Zero the block before returning it */
+#define MEM_POOL_FLAG_NO_ZERO   0x01 /*!< Return the block without zeroing it, for buffers that are written before being read */
+
 /* TYPES **********************************************************************/
 typedef struct {
     uint8_t  *mem_pool_begin;
     uint32_t capacity;
-    uint32_t free_bytes;
+    uint32_t free_bytes;      /*!< Bytes never allocated yet, at the end of the pool */
     uint8_t  *mem_pool_end;
     uint8_t  *mem_pool_it;
+    uint32_t used_bytes;      /*!< Bytes currently allocated, including block headers */
+    uint32_t high_water_mark; /*!< Highest value used_bytes has reached since mem_pool_init() */
+    uint64_t free_list_map;   /*!< Bit n is set when free_list[n] is not empty */
+    void     *free_list[MEM_POOL_CLASS_COUNT];        /*!< Released blocks, by size class */
+    void     *last_block;                             /*!< mem_pool_alloc() block ending at mem_pool_it, NULL if none */
+    uint32_t owner_bytes[MEM_POOL_OWNER_COUNT];       /*!< Bytes currently allocated by each owner */
 } mem_pool_t;
 
 /* PUBLIC FUNCTIONS ***********************************************************/
@@ -37,6 +68,8 @@ typedef struct {
 void mem_pool_init(mem_pool_t *mem_pool, uint8_t * pool, size_t meme_pool_size);
 
 /** @brief Memory pool allocation.
+ *
+ *  The block is zeroed and can only be given back with mem_pool_free().
  *
  *  @param[in] mem_pool     Memory pool handler.
  *  @param[in] wanted_size  User wanted size.
@@ -44,6 +77,29 @@ void mem_pool_init(mem_pool_t *mem_pool, uint8_t * pool, size_t meme_pool_size);
  */
 void *mem_pool_malloc(mem_pool_t *mem_pool, size_t wanted_size);
 
+/** @brief Allocate a block that can be released individually.
+ *
+ *  The smallest released block class that fits is used first, splitting the block when
+ *  the remainder can hold another one. The block is taken from the end of the pool otherwise.
+ *
+ *  @param[in] mem_pool     Memory pool handler.
+ *  @param[in] wanted_size  User wanted size.
+ *  @param[in] owner        Owner the block is accounted to, below MEM_POOL_OWNER_COUNT.
+ *  @param[in] flags        MEM_POOL_FLAG_NONE or MEM_POOL_FLAG_NO_ZERO.
+ *  @return Pointer to first element of asked memory, NULL if the pool is exhausted.
+ */
+void *mem_pool_alloc(mem_pool_t *mem_pool, size_t wanted_size, uint8_t owner, uint8_t flags);
+
+/** @brief Release a block allocated with mem_pool_alloc().
+ *
+ *  Releasing NULL or a block already released does nothing. Blocks from
+ *  mem_pool_malloc() must not be released.
+ *
+ *  @param[in] mem_pool  Memory pool handler.
+ *  @param[in] ptr       Block to release.
+ */
+void mem_pool_release(mem_pool_t *mem_pool, void *ptr);
+
 /** @brief Free every bloc of memory previously allocated.
  *
  *  @param[in] mem_pool  Memory pool handler.
@@ -57,6 +113,24 @@ void mem_pool_free(mem_pool_t *mem_mang);
  */
 uint32_t mem_pool_get_allocated_bytes(mem_pool_t *mem_pool);
 
+/** @brief Get the highest number of bytes allocated at once from the pool.
+ *
+ *  The mark is kept across mem_pool_free() so the pool can be sized for
+ *  applications that tear down and rebuild their allocations.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @return High-water mark, in bytes.
+ */
+uint32_t mem_pool_get_high_water_mark(mem_pool_t *mem_pool);
+
+/** @brief Get the number of bytes currently allocated by an owner.
+ *
+ *  @param[in] mem_pool  Memory pool handle.
+ *  @param[in] owner     Owner, below MEM_POOL_OWNER_COUNT.
+ *  @return Number of bytes allocated, including block headers.
+ */
+uint32_t mem_pool_get_owner_bytes(mem_pool_t *mem_pool, uint8_t owner);
+
 
 #ifdef __cplusplus
 }
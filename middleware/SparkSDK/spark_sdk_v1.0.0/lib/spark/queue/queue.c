@@ -10,6 +10,12 @@
 #include "queue.h"
 #include <string.h>
 
+/* CONSTANTS ******************************************************************/
+#define FREE_INDEX_MASK  0x0000ffff /* Top node index of a free queue */
+#define FREE_INDEX_EMPTY 0x0000ffff /* Top node index of an empty free queue */
+#define FREE_TAG_MASK    0xffff0000 /* Count of the free queue top updates */
+#define FREE_TAG_INC     0x00010000
+
 /* TYPES **********************************************************************/
 typedef void (*queue_enter_critical_t)(void);
 typedef void (*queue_exit_critical_t)(void);
@@ -20,6 +26,15 @@ static queue_t *last_queue;
 static queue_enter_critical_t enter_critical;
 static queue_exit_critical_t exit_critical;
 
+/* PRIVATE FUNCTION PROTOTYPES ************************************************/
+static void link_queue(queue_t *queue);
+static uint16_t spsc_next_index(queue_t *queue, uint16_t index);
+static queue_node_t *spsc_dequeue_node(queue_t *queue);
+static bool spsc_enqueue_node(queue_t *queue, queue_node_t *node);
+static uint16_t spsc_get_length(queue_t *queue);
+static queue_node_t *free_pop_node(queue_t *queue);
+static bool free_push_node(queue_t *queue, queue_node_t *node);
+
 /* PUBLIC FUNCTIONS ***********************************************************/
 void queue_init(queue_critical_cfg_t critical)
 {
@@ -52,6 +67,9 @@ uint32_t queue_init_pool(uint8_t *pool, queue_t *new_free_queue, uint16_t num_no
     new_free_queue->limit = num_nodes;
     new_free_queue->q_name = queue_name;
     new_free_queue->free_queue_type = true;
+    new_free_queue->spsc_queue_type = false;
+    /* The head stays the first node of the pool, the top is found by index from it */
+    new_free_queue->free_top = (num_nodes == 0) ? FREE_INDEX_EMPTY : 0;
     /* Add queue to queue list */
     new_free_queue->prev_queue = last_queue;
     last_queue = new_free_queue;
@@ -71,9 +89,27 @@ void queue_init_queue(queue_t *queue, uint16_t limit, const char *q_name)
     queue->limit  = limit;
     queue->q_name = q_name;
     queue->free_queue_type = false;
-    /* Add queue to queue list */
-    queue->prev_queue = last_queue;
-    last_queue = queue;
+    queue->spsc_queue_type = false;
+    queue->ring   = NULL;
+    link_queue(queue);
+    exit_critical();
+}
+
+void queue_init_spsc_queue(queue_t *queue, queue_node_t **ring, uint16_t limit, const char *q_name)
+{
+    /* Initialize new queue */
+    enter_critical();
+    queue->head   = NULL;
+    queue->tail   = NULL;
+    queue->length = 0;
+    queue->limit  = limit;
+    queue->q_name = q_name;
+    queue->free_queue_type = false;
+    queue->spsc_queue_type = true;
+    queue->ring   = ring;
+    queue->enqueue_idx = 0;
+    queue->dequeue_idx = 0;
+    link_queue(queue);
     exit_critical();
 }
 
@@ -85,13 +121,10 @@ queue_node_t *queue_get_free_node(queue_t *queue)
 void queue_free_node(queue_node_t *node)
 {
     if (node != NULL) {
-        enter_critical();
-        if (node->copy_count == 1) {
-            exit_critical();
+        /* The last copy returns the node, ready for a single copy again */
+        if (__atomic_sub_fetch(&node->copy_count, 1, __ATOMIC_ACQ_REL) == 0) {
+            __atomic_store_n(&node->copy_count, 1, __ATOMIC_RELAXED);
             queue_enqueue_node(node->home_queue, node);
-        } else {
-            node->copy_count--;
-            exit_critical();
         }
     }
 }
@@ -100,6 +133,13 @@ queue_node_t *queue_dequeue_node(queue_t *queue)
 {
     queue_node_t *head = NULL;
 
+    if (queue->spsc_queue_type) {
+        return spsc_dequeue_node(queue);
+    }
+    if (queue->free_queue_type) {
+        return free_pop_node(queue);
+    }
+
     enter_critical();
     if (queue->length == 0) {
         /* The queue is empty */
@@ -122,6 +162,13 @@ bool queue_enqueue_node(queue_t *queue, queue_node_t *node)
 {
     bool ret = false;
 
+    if (queue->spsc_queue_type) {
+        return (node == NULL) ? false : spsc_enqueue_node(queue, node);
+    }
+    if (queue->free_queue_type) {
+        return (node == NULL) ? false : free_push_node(queue, node);
+    }
+
     if (node != NULL) { /* Prevent NULL node from being enqueued */
         enter_critical();
         if (queue->length < queue->limit) {
@@ -145,7 +192,11 @@ bool queue_enqueue_at_head(queue_t *queue, queue_node_t *node)
 {
     bool ret = false;
 
-    if (node != NULL) { /* Prevent NULL node from being enqueued */
+    if (queue->free_queue_type) {
+        /* Free nodes have no order */
+        return (node == NULL) ? false : free_push_node(queue, node);
+    }
+    if ((node != NULL) && !queue->spsc_queue_type) { /* Prevent NULL node from being enqueued */
         enter_critical();
         if (queue->length < queue->limit) {
             if (queue->length == 0) {
@@ -166,12 +217,18 @@ bool queue_enqueue_at_head(queue_t *queue, queue_node_t *node)
 
 queue_node_t *queue_get_node(queue_t *queue)
 {
+    if (queue->spsc_queue_type) {
+        return (spsc_get_length(queue) == 0) ? NULL : queue->ring[queue->dequeue_idx];
+    }
     return (queue->free_queue_type || (queue->length == 0)) ? NULL : queue->head;
 }
 
 uint16_t queue_get_length(queue_t *queue)
 {
-    return (queue == NULL) ? 0 : queue->length;
+    if (queue == NULL) {
+        return 0;
+    }
+    return (queue->spsc_queue_type) ? spsc_get_length(queue) : __atomic_load_n(&queue->length, __ATOMIC_RELAXED);
 }
 
 uint16_t queue_get_limit(queue_t *queue)
@@ -186,7 +243,7 @@ void queue_flush(queue_t *queue_to_flush)
     /* Cannot flush free queues */
     if (!queue_to_flush->free_queue_type) {
         enter_critical();
-        if ((queue_to_flush == NULL) || (queue_to_flush->length == 0)) {
+        if ((queue_to_flush == NULL) || (queue_get_length(queue_to_flush) == 0)) {
             /* Ignore if queue_to_flush invalid or empty */
         } else {
             /* free each node */
@@ -205,26 +262,23 @@ void queue_unlink(queue_t *queue_to_unlink)
     queue_t *q_ptr = last_queue;
     queue_t *prev_qptr = last_queue;
 
-    /* Cannot unlink free queues */
-    if (!queue_to_unlink->free_queue_type) {
-        enter_critical();
-        /* Starting at last_queue, look for the queue in the chain */
-        while ((q_ptr != queue_to_unlink) && (q_ptr != NULL)) {
-            prev_qptr = q_ptr;
-            q_ptr = q_ptr->prev_queue;
-        }
-        /* Make sure queue was found */
-        if (q_ptr != NULL) {
-            if (q_ptr == last_queue) {
-                /* If it's the last queue, just update last_queue */
-                last_queue = q_ptr->prev_queue;
-            } else {
-                /* Otherwise, remove this queue from the chain */
-                prev_qptr->prev_queue = q_ptr->prev_queue;
-            }
+    enter_critical();
+    /* Starting at last_queue, look for the queue in the chain */
+    while ((q_ptr != queue_to_unlink) && (q_ptr != NULL)) {
+        prev_qptr = q_ptr;
+        q_ptr = q_ptr->prev_queue;
+    }
+    /* Make sure queue was found */
+    if (q_ptr != NULL) {
+        if (q_ptr == last_queue) {
+            /* If it's the last queue, just update last_queue */
+            last_queue = q_ptr->prev_queue;
+        } else {
+            /* Otherwise, remove this queue from the chain */
+            prev_qptr->prev_queue = q_ptr->prev_queue;
         }
-        exit_critical();
     }
+    exit_critical();
 }
 
 bool queue_get_stats(bool first, queue_stats_t *queue_stats)
@@ -243,7 +297,7 @@ bool queue_get_stats(bool first, queue_stats_t *queue_stats)
     }
     if (q_ptr != NULL) {
         queue_stats->queue_name      = (char *)q_ptr->q_name;
-        queue_stats->queue_length    = q_ptr->length;
+        queue_stats->queue_length    = queue_get_length(q_ptr);
         queue_stats->queue_limit     = q_ptr->limit;
         queue_stats->queue_free_type = q_ptr->free_queue_type;
         ret = true;
@@ -253,7 +307,157 @@ bool queue_get_stats(bool first, queue_stats_t *queue_stats)
 
 void queue_inc_copy_count(queue_node_t *node)
 {
-    enter_critical();
-    node->copy_count++;
-    exit_critical();
+    __atomic_add_fetch(&node->copy_count, 1, __ATOMIC_RELAXED);
+}
+
+void queue_add_copy_count(queue_node_t *node, uint8_t count)
+{
+    __atomic_add_fetch(&node->copy_count, count, __ATOMIC_RELAXED);
+}
+
+/* PRIVATE FUNCTIONS **********************************************************/
+/** @brief Add a queue to the linked list of queues.
+ *
+ *  @param[in] queue  Queue to add.
+ */
+static void link_queue(queue_t *queue)
+{
+    queue->prev_queue = last_queue;
+    last_queue = queue;
+}
+
+/** @brief Get the ring index following the specified one.
+ *
+ *  The ring holds limit + 1 entries so a full queue can be told apart from an empty one.
+ *
+ *  @param[in] queue  SPSC queue.
+ *  @param[in] index  Current ring index.
+ *  @return Next ring index.
+ */
+static uint16_t spsc_next_index(queue_t *queue, uint16_t index)
+{
+    return (index == queue->limit) ? 0 : (index + 1);
+}
+
+/** @brief Get a node from an SPSC queue.
+ *
+ *  @note Must only be called from the consumer context.
+ *
+ *  @param[in] queue  SPSC queue.
+ *  @return Address of the node, or NULL if queue is empty.
+ */
+static queue_node_t *spsc_dequeue_node(queue_t *queue)
+{
+    queue_node_t *node;
+    uint16_t dequeue_idx = queue->dequeue_idx;
+
+    /* Acquire ensures the ring entry is read after the producer published it */
+    if (dequeue_idx == __atomic_load_n(&queue->enqueue_idx, __ATOMIC_ACQUIRE)) {
+        /* The queue is empty */
+        return NULL;
+    }
+    node = queue->ring[dequeue_idx];
+    /* Release ensures the ring entry is read before the slot is given back */
+    __atomic_store_n(&queue->dequeue_idx, spsc_next_index(queue, dequeue_idx), __ATOMIC_RELEASE);
+
+    return node;
+}
+
+/** @brief Add a node to an SPSC queue.
+ *
+ *  @note Must only be called from the producer context.
+ *
+ *  @param[in] queue  SPSC queue.
+ *  @param[in] node   Address of the node.
+ *  @return true if the node was successfully enqueued, false if the queue is full.
+ */
+static bool spsc_enqueue_node(queue_t *queue, queue_node_t *node)
+{
+    uint16_t enqueue_idx = queue->enqueue_idx;
+    uint16_t next_idx = spsc_next_index(queue, enqueue_idx);
+
+    if (next_idx == __atomic_load_n(&queue->dequeue_idx, __ATOMIC_ACQUIRE)) {
+        /* The queue is full */
+        return false;
+    }
+    queue->ring[enqueue_idx] = node;
+    /* Release ensures the ring entry is written before it is published */
+    __atomic_store_n(&queue->enqueue_idx, next_idx, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/** @brief Get the length of an SPSC queue.
+ *
+ *  @param[in] queue  SPSC queue.
+ *  @return Length of the queue.
+ */
+static uint16_t spsc_get_length(queue_t *queue)
+{
+    uint16_t enqueue_idx = __atomic_load_n(&queue->enqueue_idx, __ATOMIC_ACQUIRE);
+    uint16_t dequeue_idx = __atomic_load_n(&queue->dequeue_idx, __ATOMIC_ACQUIRE);
+
+    if (enqueue_idx >= dequeue_idx) {
+        return enqueue_idx - dequeue_idx;
+    }
+    return (queue->limit + 1) - (dequeue_idx - enqueue_idx);
+}
+
+/** @brief Get a node from a free queue.
+ *
+ *  The top is replaced with compare-and-swap. Its tag changes on every update,
+ *  so a top taken and given back meanwhile fails the swap instead of linking a
+ *  stale next node.
+ *
+ *  @param[in] queue  Free queue.
+ *  @return Address of the node, or NULL if queue is empty.
+ */
+static queue_node_t *free_pop_node(queue_t *queue)
+{
+    uint32_t top = __atomic_load_n(&queue->free_top, __ATOMIC_ACQUIRE);
+    uint32_t new_top;
+    queue_node_t *node;
+    queue_node_t *next;
+
+    do {
+        if ((top & FREE_INDEX_MASK) == FREE_INDEX_EMPTY) {
+            /* The queue is empty */
+            return NULL;
+        }
+        node = &queue->head[top & FREE_INDEX_MASK];
+        /* Stale if the node is taken meanwhile, the swap then fails */
+        next = __atomic_load_n(&node->next, __ATOMIC_RELAXED);
+        new_top = ((top & FREE_TAG_MASK) + FREE_TAG_INC) |
+                  ((next == NULL) ? FREE_INDEX_EMPTY : (uint32_t)(next - queue->head));
+    } while (!__atomic_compare_exchange_n(&queue->free_top, &top, new_top, true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+    __atomic_sub_fetch(&queue->length, 1, __ATOMIC_RELAXED);
+
+    return node;
+}
+
+/** @brief Add a node to a free queue.
+ *
+ *  A free queue only holds the nodes of its pool, so it can not be full. Its
+ *  length is updated after the top and can be off by the updates in progress.
+ *
+ *  @param[in] queue  Free queue.
+ *  @param[in] node   Address of the node, from the pool of the queue.
+ *  @return Always true.
+ */
+static bool free_push_node(queue_t *queue, queue_node_t *node)
+{
+    uint32_t top = __atomic_load_n(&queue->free_top, __ATOMIC_RELAXED);
+    uint32_t new_top;
+
+    do {
+        __atomic_store_n(&node->next,
+                         ((top & FREE_INDEX_MASK) == FREE_INDEX_EMPTY) ? NULL : &queue->head[top & FREE_INDEX_MASK],
+                         __ATOMIC_RELAXED);
+        new_top = ((top & FREE_TAG_MASK) + FREE_TAG_INC) | (uint32_t)(node - queue->head);
+    } while (!__atomic_compare_exchange_n(&queue->free_top, &top, new_top, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    __atomic_add_fetch(&queue->length, 1, __ATOMIC_RELAXED);
+
+    return true;
 }
@@ -21,6 +21,7 @@ extern "C" {
 /* CONSTANTS ******************************************************************/
 #define QUEUE_LIMIT_UNLIMITED  0xffff
 #define QUEUE_NB_BYTES_NEEDED(num_nodes, data_size) ((num_nodes) * ((sizeof(queue_node_t) + (data_size))))
+#define QUEUE_SPSC_NB_BYTES_NEEDED(limit) (((limit) + 1) * sizeof(queue_node_t *))
 
 /* TYPES **********************************************************************/
 typedef struct queue_node {
@@ -36,6 +37,11 @@ typedef struct queue {
     uint16_t     length;
     uint16_t     limit;
     bool         free_queue_type;
+    bool         spsc_queue_type;
+    queue_node_t **ring;
+    uint16_t     enqueue_idx;
+    uint16_t     dequeue_idx;
+    uint32_t     free_top; /* Free queue top node index in the low half, ABA tag in the high half */
     const char   *q_name;
     struct queue *prev_queue;
 } queue_t;
@@ -68,6 +74,10 @@ typedef struct queue_critical_cfg {
 void queue_init(queue_critical_cfg_t critical);
 
 /** @brief Initialize a new node pool.
+ *
+ *  The free queue is a lock-free stack of the pool nodes: getting and freeing
+ *  a node only uses atomic compare-and-swap, so it never enters the critical
+ *  section and is safe from any context.
  *
  *  @param[in] pool            Pool containing nodes and data.
  *  @param[in] new_free_queue  Queue where new nodes will be stored.
@@ -87,6 +97,21 @@ uint32_t queue_init_pool(uint8_t *pool, queue_t *new_free_queue, uint16_t num_no
  */
 void queue_init_queue(queue_t *queue, uint16_t limit, const char *q_name);
 
+/** @brief Initialize a new single-producer single-consumer queue.
+ *
+ *  Nodes are stored in a ring of node pointers and only atomic index updates
+ *  are used, so no critical section is entered when enqueuing or dequeuing.
+ *  The queue is safe between one producer context and one consumer context
+ *  (e.g. one ISR and one task). Only the consumer context may dequeue, flush
+ *  or read the head node, and queue_enqueue_at_head() is not supported.
+ *
+ *  @param[in] queue   Queue to be initialized.
+ *  @param[in] ring    Ring of QUEUE_SPSC_NB_BYTES_NEEDED(limit) bytes.
+ *  @param[in] limit   Queue length limit.
+ *  @param[in] q_name  Queue name.
+ */
+void queue_init_spsc_queue(queue_t *queue, queue_node_t **ring, uint16_t limit, const char *q_name);
+
 /** @brief Get a free buffer from the queue.
  *
  *  @param[in] queue  Queue containing free nodes.
@@ -152,7 +177,9 @@ void queue_flush(queue_t *queue_to_flush);
 
 /** @brief Unlink the queue from the linked list of queues.
  *
- *  @param[in] queue_to_flush  Desired queue.
+ *  A queue, free queues included, must be unlinked before its memory is reused.
+ *
+ *  @param[in] queue  Desired queue.
  */
 void queue_unlink(queue_t *queue);
 
@@ -174,6 +201,16 @@ bool queue_get_stats(bool first, queue_stats_t *queue_stats);
  */
 void queue_inc_copy_count(queue_node_t *node);
 
+/** @brief Add to the copy count value of a node.
+ *
+ *  Same as calling queue_inc_copy_count() count times, in a
+ *  single critical section.
+ *
+ *  @param[in] node   Address of the node.
+ *  @param[in] count  Number of extra users of the node.
+ */
+void queue_add_copy_count(queue_node_t *node, uint8_t count);
+
 
 #ifdef __cplusplus
 }
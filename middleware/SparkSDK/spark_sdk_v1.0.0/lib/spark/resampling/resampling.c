@@ -14,6 +14,143 @@
 
 /* CONSTANTS ******************************************************************/
 #define ADD_REM_DIFF       2
+#define NB_BUFFER_TYPE     5
+
+#define POLYPHASE_PHASES_BITS  5                                          /* 32 filter phases */
+#define POLYPHASE_SUBPHASE_BITS 15                                        /* Interpolation between two phases */
+#define POLYPHASE_COEF_BITS    14                                         /* Coefficients are in Q1.14 format */
+#define POLYPHASE_HISTORY      (RESAMPLING_POLYPHASE_TAPS - 1)           /* Frames kept between two calls */
+#define POLYPHASE_START_POS    (RESAMPLING_POLYPHASE_TAPS / 2 - 1)       /* Window newest frame is the first input frame */
+#define PPM_TO_Q32             4295                                       /* 2^32 / 1000000 */
+
+/* MACROS *********************************************************************/
+/** @brief Define a linear interpolation kernel.
+ *
+ *  The sample type, shift and channel count are compile-time constants so the
+ *  inner channel loop is unrolled and no per-sample type dispatch remains.
+ *
+ *  @param[in] _name     Kernel name.
+ *  @param[in] _type     Sample storage type.
+ *  @param[in] _shift    Sample bit depth shift (resampling_buffer_type_t value).
+ *  @param[in] _nb_ch    Number of interleaved channels.
+ *  @param[in] _advance  Function moving the interpolation point to the next frame.
+ */
+#define INTERP_LINEAR_KERNEL(_name, _type, _shift, _nb_ch, _advance)                          \
+    static uint32_t _name(resampling_instance_t *instance, int32_t *y, int32_t *y1,          \
+                          int32_t *out, uint16_t size)                                        \
+    {                                                                                         \
+        _type *y_in = (_type *)y;                                                             \
+        _type *y1_in = (_type *)y1;                                                           \
+        _type *out_ptr = (_type *)out;                                                        \
+        int64_t y1_value;                                                                     \
+        uint16_t idx = 0;                                                                     \
+                                                                                              \
+        while (idx < size) {                                                                  \
+            for (uint8_t ch = 0; ch < (_nb_ch); ch++) {                                       \
+                y1_value = y1_in[idx + ch];                                                   \
+                out_ptr[idx + ch] = (_type)(y1_value + ((instance->x_axis *                   \
+                                            (y_in[idx + ch] - y1_value)) >> (_shift)));       \
+            }                                                                                 \
+            idx += (_nb_ch);                                                                  \
+            if (_advance(instance)) {                                                         \
+                /* Resampling done */                                                         \
+                break;                                                                        \
+            }                                                                                 \
+        }                                                                                     \
+        return idx;                                                                           \
+    }
+
+/** @brief Define the add and remove sample kernels of a bit depth for 1 and 2 channels.
+ *
+ *  @param[in] _bits   Bit depth.
+ *  @param[in] _type   Sample storage type.
+ */
+#define INTERP_LINEAR_KERNELS(_bits, _type)                                                              \
+    INTERP_LINEAR_KERNEL(interp_linear_add_##_bits##bits_1ch, _type, BUFFER_##_bits##BITS, 1, advance_add) \
+    INTERP_LINEAR_KERNEL(interp_linear_add_##_bits##bits_2ch, _type, BUFFER_##_bits##BITS, 2, advance_add) \
+    INTERP_LINEAR_KERNEL(interp_linear_rem_##_bits##bits_1ch, _type, BUFFER_##_bits##BITS, 1, advance_rem) \
+    INTERP_LINEAR_KERNEL(interp_linear_rem_##_bits##bits_2ch, _type, BUFFER_##_bits##BITS, 2, advance_rem)
+
+/** @brief Define a polyphase filter kernel.
+ *
+ *  The sample type and channel count are compile-time constants so each tap is a typed
+ *  load from the history or the input and no per-tap type dispatch remains.
+ *
+ *  @param[in] _name   Kernel name.
+ *  @param[in] _type   Sample storage type.
+ *  @param[in] _nb_ch  Number of interleaved channels.
+ */
+#define POLYPHASE_KERNEL(_name, _type, _nb_ch)                                                      \
+    static uint16_t _name(resampling_instance_t *instance, void *ptr_input, void *ptr_output,       \
+                          uint16_t sample_count)                                                    \
+    {                                                                                               \
+        int32_t coef[RESAMPLING_POLYPHASE_TAPS];                                                    \
+        const _type *in = (const _type *)ptr_input;                                                 \
+        _type *out = (_type *)ptr_output;                                                           \
+        const _type *in_ptr;                                                                        \
+        uint16_t frame_in_count = sample_count / (_nb_ch);                                          \
+        uint16_t frame_out_count = 0;                                                               \
+        uint16_t first_frame;                                                                       \
+        uint8_t hist_taps, tap;                                                                     \
+        int64_t acc;                                                                                \
+        int64_t max_value = (int64_t)instance->buffer_type_max - 1;                                 \
+        int64_t min_value = -(int64_t)instance->buffer_type_max;                                    \
+        uint64_t position_frac;                                                                     \
+                                                                                                    \
+        /* Stop when the window newest frame is not available yet */                                \
+        while (((instance->position + RESAMPLING_POLYPHASE_TAPS / 2) <                              \
+                (POLYPHASE_HISTORY + frame_in_count)) && (frame_out_count <= frame_in_count)) {     \
+            polyphase_get_coef(instance->position_frac, coef);                                      \
+            first_frame = instance->position - POLYPHASE_START_POS;                                 \
+            /* Taps before the input frames are in the history */                                   \
+            hist_taps = (first_frame < POLYPHASE_HISTORY) ? (POLYPHASE_HISTORY - first_frame) : 0;  \
+                                                                                                    \
+            for (uint8_t ch = 0; ch < (_nb_ch); ch++) {                                             \
+                acc = 0;                                                                            \
+                for (tap = 0; tap < hist_taps; tap++) {                                             \
+                    acc += (int64_t)instance->history[(first_frame + tap) * (_nb_ch) + ch] *        \
+                           coef[tap];                                                               \
+                }                                                                                   \
+                in_ptr = &in[(first_frame + hist_taps - POLYPHASE_HISTORY) * (_nb_ch) + ch];        \
+                for (; tap < RESAMPLING_POLYPHASE_TAPS; tap++) {                                    \
+                    acc += (int64_t)*in_ptr * coef[tap];                                            \
+                    in_ptr += (_nb_ch);                                                             \
+                }                                                                                   \
+                /* Round and saturate to the sample bit depth */                                    \
+                acc = (acc + (1 << (POLYPHASE_COEF_BITS - 1))) >> POLYPHASE_COEF_BITS;              \
+                if (acc > max_value) {                                                              \
+                    acc = max_value;                                                                \
+                } else if (acc < min_value) {                                                       \
+                    acc = min_value;                                                                \
+                }                                                                                   \
+                out[frame_out_count * (_nb_ch) + ch] = (_type)acc;                                  \
+            }                                                                                       \
+            frame_out_count++;                                                                      \
+                                                                                                    \
+            /* Move the position by 1 + step offset frame */                                        \
+            position_frac = (uint64_t)instance->position_frac +                                     \
+                            (uint64_t)((1LL << 32) + instance->step_offset);                        \
+            instance->position += (uint16_t)(position_frac >> 32);                                  \
+            instance->position_frac = (uint32_t)position_frac;                                      \
+        }                                                                                           \
+                                                                                                    \
+        /* Rebase the position on the next input and keep the last frames of the window */          \
+        instance->position -= frame_in_count;                                                       \
+        if (frame_in_count < POLYPHASE_HISTORY) {                                                   \
+            memmove(instance->history, &instance->history[frame_in_count * (_nb_ch)],               \
+                    (POLYPHASE_HISTORY - frame_in_count) * (_nb_ch) * sizeof(int32_t));             \
+            for (uint16_t idx = 0; idx < frame_in_count * (_nb_ch); idx++) {                        \
+                instance->history[(POLYPHASE_HISTORY - frame_in_count) * (_nb_ch) + idx] = in[idx]; \
+            }                                                                                       \
+        } else {                                                                                    \
+            in_ptr = &in[(frame_in_count - POLYPHASE_HISTORY) * (_nb_ch)];                          \
+            for (uint16_t idx = 0; idx < POLYPHASE_HISTORY * (_nb_ch); idx++) {                     \
+                instance->history[idx] = in_ptr[idx];                                               \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        return frame_out_count * (_nb_ch);                                                          \
+    }
 
 /* PRIVATE FUNCTION PROTOTYPES ************************************************/
 static uint16_t resample_add_sample(resampling_instance_t *instance, uint32_t *ptr_input, uint32_t *ptr_output, uint16_t sample_count);
@@ -21,11 +158,95 @@ static uint16_t resample_remove_sample(resampling_instance_t *instance, uint32_t
 static uint16_t resample_bypass(resampling_instance_t *instance, uint32_t *ptr_input, uint32_t *ptr_output, uint16_t sample_count);
 static void resampling_stop(resampling_instance_t *instance);
 static uint32_t interp_linear(resampling_instance_t *instance, int32_t *y, int32_t *y1, int32_t *out, uint16_t size);
+static inline bool advance_add(resampling_instance_t *instance);
+static inline bool advance_rem(resampling_instance_t *instance);
 static void update_last_sample(resampling_instance_t *instance, int32_t *ptr_input, uint16_t sample_count);
 static int32_t cast_type_read(resampling_instance_t *instance, int32_t *in, uint16_t index);
 static void cast_type_write(resampling_instance_t *instance, int32_t *out, uint16_t index, int32_t value);
 static int32_t *get_ptr_addr(resampling_instance_t *instance, int32_t *sample_array, uint16_t idx);
 static uint8_t sizeof_buffer_type(resampling_instance_t *instance);
+static void polyphase_get_coef(uint32_t position_frac, int32_t *coef);
+
+/* PRIVATE GLOBALS ************************************************************/
+/* Kaiser windowed-sinc (beta 6, cutoff 0.9 * Nyquist) polyphase filter, one row per fractional delay.
+ * Each row is normalized to unity gain. The last row is the first one delayed by one frame and is
+ * used to interpolate the last phase.
+ */
+static const int16_t polyphase_coef[(1 << POLYPHASE_PHASES_BITS) + 1][RESAMPLING_POLYPHASE_TAPS] = {
+    {    41,   -135,    319,   -599,    944,  -1288,   1543,  14740,   1543,  -1288,    944,   -599,    319,   -135,     41,     -6},
+    {    41,   -135,    310,   -568,    864,  -1103,   1081,  14721,   2025,  -1470,   1020,   -626,    325,   -135,     39,     -5},
+    {    42,   -133,    300,   -533,    779,   -917,    640,  14661,   2524,  -1648,   1091,   -649,    328,   -133,     37,     -5},
+    {    42,   -130,    287,   -496,    691,   -731,    222,  14560,   3040,  -1820,   1155,   -667,    329,   -129,     35,     -4},
+    {    41,   -127,    273,   -456,    601,   -547,   -172,  14425,   3569,  -1985,   1212,   -681,    327,   -125,     32,     -3},
+    {    40,   -122,    257,   -414,    510,   -366,   -542,  14249,   4111,  -2141,   1261,   -689,    323,   -119,     29,     -3},
+    {    39,   -117,    239,   -370,    417,   -190,   -885,  14037,   4662,  -2286,   1302,   -692,    315,   -111,     25,     -1},
+    {    38,   -111,    221,   -326,    325,    -19,  -1202,  13790,   5221,  -2419,   1334,   -690,    304,   -103,     21,      0},
+    {    36,   -104,    201,   -280,    234,    146,  -1492,  13506,   5785,  -2537,   1355,   -681,    290,    -92,     16,      1},
+    {    34,    -97,    181,   -234,    144,    303,  -1754,  13191,   6352,  -2641,   1366,   -666,    273,    -81,     10,      3},
+    {    32,    -89,    160,   -187,     57,    451,  -1988,  12839,   6920,  -2727,   1367,   -645,    253,    -68,      4,      5},
+    {    30,    -81,    139,   -141,    -28,    590,  -2194,  12460,   7485,  -2795,   1356,   -618,    230,    -54,     -2,      7},
+    {    28,    -73,    117,    -96,   -109,    718,  -2372,  12056,   8045,  -2843,   1333,   -585,    203,    -38,     -9,      9},
+    {    25,    -65,     96,    -52,   -187,    836,  -2523,  11624,   8598,  -2869,   1299,   -545,    174,    -22,    -16,     11},
+    {    23,    -57,     75,     -9,   -260,    943,  -2645,  11167,   9142,  -2874,   1252,   -500,    142,     -4,    -24,     13},
+    {    20,    -48,     54,     32,   -328,   1038,  -2741,  10687,   9673,  -2854,   1193,   -448,    108,     15,    -32,     15},
+    {    18,    -40,     34,     71,   -391,   1122,  -2810,  10187,  10189,  -2810,   1122,   -391,     71,     34,    -40,     18},
+    {    15,    -32,     15,    108,   -448,   1193,  -2854,   9673,  10687,  -2741,   1038,   -328,     32,     54,    -48,     20},
+    {    13,    -24,     -4,    142,   -500,   1252,  -2874,   9142,  11167,  -2645,    943,   -260,     -9,     75,    -57,     23},
+    {    11,    -16,    -22,    174,   -545,   1299,  -2869,   8598,  11624,  -2523,    836,   -187,    -52,     96,    -65,     25},
+    {     9,     -9,    -38,    203,   -585,   1333,  -2843,   8045,  12056,  -2372,    718,   -109,    -96,    117,    -73,     28},
+    {     7,     -2,    -54,    230,   -618,   1356,  -2795,   7485,  12460,  -2194,    590,    -28,   -141,    139,    -81,     30},
+    {     5,      4,    -68,    253,   -645,   1367,  -2727,   6920,  12839,  -1988,    451,     57,   -187,    160,    -89,     32},
+    {     3,     10,    -81,    273,   -666,   1366,  -2641,   6352,  13191,  -1754,    303,    144,   -234,    181,    -97,     34},
+    {     1,     16,    -92,    290,   -681,   1355,  -2537,   5785,  13506,  -1492,    146,    234,   -280,    201,   -104,     36},
+    {     0,     21,   -103,    304,   -690,   1334,  -2419,   5221,  13790,  -1202,    -19,    325,   -326,    221,   -111,     38},
+    {    -1,     25,   -111,    315,   -692,   1302,  -2286,   4662,  14037,   -885,   -190,    417,   -370,    239,   -117,     39},
+    {    -3,     29,   -119,    323,   -689,   1261,  -2141,   4111,  14249,   -542,   -366,    510,   -414,    257,   -122,     40},
+    {    -3,     32,   -125,    327,   -681,   1212,  -1985,   3569,  14425,   -172,   -547,    601,   -456,    273,   -127,     41},
+    {    -4,     35,   -129,    329,   -667,   1155,  -1820,   3040,  14560,    222,   -731,    691,   -496,    287,   -130,     42},
+    {    -5,     37,   -133,    328,   -649,   1091,  -1648,   2524,  14661,    640,   -917,    779,   -533,    300,   -133,     42},
+    {    -5,     39,   -135,    325,   -626,   1020,  -1470,   2025,  14721,   1081,  -1103,    864,   -568,    310,   -135,     41},
+    {    -6,     41,   -135,    319,   -599,    944,  -1288,   1543,  14740,   1543,  -1288,    944,   -599,    319,   -135,     41}
+};
+
+INTERP_LINEAR_KERNELS(8, int8_t)
+INTERP_LINEAR_KERNELS(16, int16_t)
+INTERP_LINEAR_KERNELS(20, int32_t)
+INTERP_LINEAR_KERNELS(24, int32_t)
+INTERP_LINEAR_KERNELS(32, int32_t)
+
+/* Add sample kernels indexed by buffer type then by channel count - 1 */
+static const resampling_interp_t interp_add_kernels[NB_BUFFER_TYPE][RESAMPLING_CFG_MAX_NB_CHANNEL] = {
+    {interp_linear_add_8bits_1ch,  interp_linear_add_8bits_2ch},
+    {interp_linear_add_16bits_1ch, interp_linear_add_16bits_2ch},
+    {interp_linear_add_20bits_1ch, interp_linear_add_20bits_2ch},
+    {interp_linear_add_24bits_1ch, interp_linear_add_24bits_2ch},
+    {interp_linear_add_32bits_1ch, interp_linear_add_32bits_2ch},
+};
+
+/* Remove sample kernels indexed by buffer type then by channel count - 1 */
+static const resampling_interp_t interp_rem_kernels[NB_BUFFER_TYPE][RESAMPLING_CFG_MAX_NB_CHANNEL] = {
+    {interp_linear_rem_8bits_1ch,  interp_linear_rem_8bits_2ch},
+    {interp_linear_rem_16bits_1ch, interp_linear_rem_16bits_2ch},
+    {interp_linear_rem_20bits_1ch, interp_linear_rem_20bits_2ch},
+    {interp_linear_rem_24bits_1ch, interp_linear_rem_24bits_2ch},
+    {interp_linear_rem_32bits_1ch, interp_linear_rem_32bits_2ch},
+};
+
+POLYPHASE_KERNEL(polyphase_8bits_1ch, int8_t, 1)
+POLYPHASE_KERNEL(polyphase_8bits_2ch, int8_t, 2)
+POLYPHASE_KERNEL(polyphase_16bits_1ch, int16_t, 1)
+POLYPHASE_KERNEL(polyphase_16bits_2ch, int16_t, 2)
+POLYPHASE_KERNEL(polyphase_32bits_1ch, int32_t, 1)
+POLYPHASE_KERNEL(polyphase_32bits_2ch, int32_t, 2)
+
+/* Polyphase kernels indexed by buffer type then by channel count - 1, 20 to 32-bit samples are in 32-bit words */
+static const resampling_polyphase_t polyphase_kernels[NB_BUFFER_TYPE][RESAMPLING_CFG_MAX_NB_CHANNEL] = {
+    {polyphase_8bits_1ch,  polyphase_8bits_2ch},
+    {polyphase_16bits_1ch, polyphase_16bits_2ch},
+    {polyphase_32bits_1ch, polyphase_32bits_2ch},
+    {polyphase_32bits_1ch, polyphase_32bits_2ch},
+    {polyphase_32bits_1ch, polyphase_32bits_2ch},
+};
 
 /* PUBLIC FUNCTIONS ***********************************************************/
 resampling_errors_t resampling_init(resampling_instance_t *instance, resampling_config_t *resampling_config)
@@ -33,6 +254,8 @@ resampling_errors_t resampling_init(resampling_instance_t *instance, resampling_
     /* WARNING this initialisation works only in audio 16 bits sample bit depth */
     uint32_t resampling_size;
     uint16_t nb_sample_ch;
+    uint8_t type_index;
+    uint8_t channel_index;
 
     /* Config verification */
     if (resampling_config->nb_channel > RESAMPLING_CFG_MAX_NB_CHANNEL) {
@@ -40,16 +263,45 @@ resampling_errors_t resampling_init(resampling_instance_t *instance, resampling_
     }
     switch (resampling_config->buffer_type) {
     case BUFFER_8BITS:
+        type_index = 0;
+        break;
     case BUFFER_16BITS:
+        type_index = 1;
+        break;
     case BUFFER_20BITS:
+        type_index = 2;
+        break;
     case BUFFER_24BITS:
+        type_index = 3;
+        break;
     case BUFFER_32BITS:
+        type_index = 4;
         break;
     default:
         return RESAMPLING_INVALID_TYPE;
     }
 
+    /* Select the interpolation kernels once */
+    channel_index = (resampling_config->nb_channel == 0) ? 0 : (resampling_config->nb_channel - 1);
+    instance->interp_add = interp_add_kernels[type_index][channel_index];
+    instance->interp_rem = interp_rem_kernels[type_index][channel_index];
+    instance->polyphase  = polyphase_kernels[type_index][channel_index];
+
     /* Struct initialization */
+    instance->mode          = resampling_config->mode;
+    instance->position      = POLYPHASE_START_POS;
+    instance->position_frac = 0;
+    instance->step_offset   = 0;
+    memset(instance->history, 0, sizeof(instance->history));
+    if (instance->mode == RESAMPLING_MODE_POLYPHASE) {
+        /* Polyphase resampling always runs, its ratio is adjusted with resampling_set_ratio_ppm() */
+        instance->status      = RESAMPLING_RUNNING;
+        instance->correction  = RESAMPLING_NO_CORRECTION;
+        instance->buffer_type = resampling_config->buffer_type;
+        instance->nb_channel  = resampling_config->nb_channel;
+        instance->buffer_type_max = (1 << instance->buffer_type);
+        return RESAMPLING_NO_ERROR;
+    }
     instance->status      = RESAMPLING_WAIT_QUEUE_FULL;
     instance->correction  = RESAMPLING_NO_CORRECTION;
     instance->buffer_type = resampling_config->buffer_type;
@@ -77,8 +329,21 @@ void resampling_start(resampling_instance_t *instance, resampling_correction_t c
     instance->correction = correction;
 }
 
+void resampling_set_ratio_ppm(resampling_instance_t *instance, int32_t ratio_ppm)
+{
+    if (ratio_ppm > RESAMPLING_RATIO_MAX_PPM) {
+        ratio_ppm = RESAMPLING_RATIO_MAX_PPM;
+    } else if (ratio_ppm < -RESAMPLING_RATIO_MAX_PPM) {
+        ratio_ppm = -RESAMPLING_RATIO_MAX_PPM;
+    }
+    instance->step_offset = ratio_ppm * PPM_TO_Q32;
+}
+
 uint16_t resample(resampling_instance_t *instance, void *ptr_input, void *ptr_output, uint16_t sample_count)
 {
+    if (instance->mode == RESAMPLING_MODE_POLYPHASE) {
+        return instance->polyphase(instance, ptr_input, ptr_output, sample_count);
+    }
     if (instance->status != RESAMPLING_IDLE) {
         switch (instance->correction) {
         case RESAMPLING_ADD_SAMPLE:
@@ -276,6 +541,8 @@ static void resampling_stop(resampling_instance_t *instance)
 }
 
 /** @brief Linear interpolation
+ *
+ *  @note size must be a multiple of the channel count.
  *
  *  @param[in]  instance  Structure instance pointer.
  *  @param[in]  y         First data.
@@ -286,58 +553,47 @@ static void resampling_stop(resampling_instance_t *instance)
  */
 static uint32_t interp_linear(resampling_instance_t *instance, int32_t *y, int32_t *y1, int32_t *out, uint16_t size)
 {
-    uint16_t idx;
-    uint8_t nb_ch;
-    int64_t y1_value;
-    int64_t y_value;
-    int32_t interp;
-    int8_t bias_comp;
-
-    idx = 0;
-    nb_ch = instance->nb_channel;
-
-    while (idx < size) {
-        y1_value = cast_type_read(instance, y1, idx);
-        y_value  = cast_type_read(instance, y, idx);
-
-        interp = (int32_t)(y1_value + ((instance->x_axis * (y_value - y1_value)) >> instance->buffer_type));
-
-        cast_type_write(instance, out, idx, interp);
-
-        idx++;
-        /* If all channel have been calculated of the current lookup table index, increment the index */
-        if ((idx % nb_ch) == 0) {
-            if (instance->correction == RESAMPLING_ADD_SAMPLE) {
-                instance->bias += instance->bias_step_add;
-                if (instance->bias >= instance->buffer_type_max) {
-                    bias_comp = 1;
-                    instance->bias -= instance->buffer_type_max;
-                } else {
-                    bias_comp = 0;
-                }
-                if(instance->x_axis > (instance->step_add + bias_comp)) {
-                    instance->x_axis -= (instance->step_add + bias_comp);
-                } else {
-                    /* Resampling done */
-                    break;
-                }
-            } else {
-                instance->bias += instance->bias_step_rem;
-                if (instance->bias >= instance->buffer_type_max) {
-                    bias_comp = 1;
-                    instance->bias -= instance->buffer_type_max;
-                } else {
-                    bias_comp = 0;
-                }
-                instance->x_axis += instance->step_rem + bias_comp;
-                if(instance->x_axis > instance->max_x_axis) {
-                    /* Resampling done */
-                    break;
-                }
-            }
-        }
+    if (instance->correction == RESAMPLING_ADD_SAMPLE) {
+        return instance->interp_add(instance, y, y1, out, size);
+    } else {
+        return instance->interp_rem(instance, y, y1, out, size);
     }
-    return idx;
+}
+
+/** @brief Move the interpolation point to the next frame when adding a sample.
+ *
+ *  @param[in] instance  Structure instance pointer.
+ *  @return True if the resampling is done.
+ */
+static inline bool advance_add(resampling_instance_t *instance)
+{
+    uint32_t bias_comp;
+
+    instance->bias += instance->bias_step_add;
+    bias_comp = (instance->bias >= instance->buffer_type_max);
+    instance->bias -= bias_comp * instance->buffer_type_max;
+    if (instance->x_axis > (instance->step_add + bias_comp)) {
+        instance->x_axis -= (instance->step_add + bias_comp);
+        return false;
+    }
+    return true;
+}
+
+/** @brief Move the interpolation point to the next frame when removing a sample.
+ *
+ *  @param[in] instance  Structure instance pointer.
+ *  @return True if the resampling is done.
+ */
+static inline bool advance_rem(resampling_instance_t *instance)
+{
+    uint32_t bias_comp;
+
+    instance->bias += instance->bias_step_rem;
+    bias_comp = (instance->bias >= instance->buffer_type_max);
+    instance->bias -= bias_comp * instance->buffer_type_max;
+    instance->x_axis += instance->step_rem + bias_comp;
+
+    return (instance->x_axis > instance->max_x_axis);
 }
 
 /** @brief Move last samples of input to last_sample array of instance.
@@ -457,3 +713,23 @@ static uint8_t sizeof_buffer_type(resampling_instance_t *instance)
         return sizeof(int16_t);
     }
 }
+
+/** @brief Get the filter coefficients for a fractional position.
+ *
+ *  Coefficients are linearly interpolated between the two closest phases.
+ *
+ *  @param[in]  position_frac  Fractional position, in Q0.32 format.
+ *  @param[out] coef           Coefficients, in Q1.14 format.
+ */
+static void polyphase_get_coef(uint32_t position_frac, int32_t *coef)
+{
+    uint32_t phase = position_frac >> (32 - POLYPHASE_PHASES_BITS);
+    int32_t subphase = (position_frac >> (32 - POLYPHASE_PHASES_BITS - POLYPHASE_SUBPHASE_BITS)) &
+                       ((1 << POLYPHASE_SUBPHASE_BITS) - 1);
+    const int16_t *coef0 = polyphase_coef[phase];
+    const int16_t *coef1 = polyphase_coef[phase + 1];
+
+    for (uint8_t tap = 0; tap < RESAMPLING_POLYPHASE_TAPS; tap++) {
+        coef[tap] = coef0[tap] + (((coef1[tap] - coef0[tap]) * subphase) >> POLYPHASE_SUBPHASE_BITS);
+    }
+}
@@ -28,6 +28,9 @@ extern "C" {
 #define RESAMPLING_CFG_MAX_NB_CHANNEL 2
 #define LAST_SAMPLE_AMT               2
 #define LAST_SAMPLE_ARRAY_SIZE        LAST_SAMPLE_AMT*RESAMPLING_CFG_MAX_NB_CHANNEL /* [Samp-2][Samp-1] */
+#define RESAMPLING_POLYPHASE_TAPS     16
+#define POLYPHASE_HISTORY_ARRAY_SIZE  ((RESAMPLING_POLYPHASE_TAPS - 1) * RESAMPLING_CFG_MAX_NB_CHANNEL)
+#define RESAMPLING_RATIO_MAX_PPM      1000 /* Maximum ratio deviation of the polyphase mode */
 
 /* TYPES **********************************************************************/
 /** @brief Resampling Errors Codes.
@@ -62,6 +65,16 @@ typedef enum resampling_correction {
     RESAMPLING_REMOVE_SAMPLE,
 } resampling_correction_t;
 
+/** @brief Resampling Modes.
+ *
+ *  This enum contains all the resampling algorithms of this library.
+ */
+typedef enum resampling_mode {
+    RESAMPLING_MODE_LINEAR,    /*!< Add or remove one sample over resampling_length samples by linear interpolation */
+    RESAMPLING_MODE_POLYPHASE, /*!< Continuously resample at a ratio set with resampling_set_ratio_ppm() using a
+                                    polyphase windowed-sinc filter */
+} resampling_mode_t;
+
 /** @brief Resampling Instance Status.
  *
  *  This enum contains all states for this library.
@@ -82,8 +95,25 @@ typedef struct resampling_config {
     resampling_buffer_type_t buffer_type;
     uint16_t resampling_length;
     uint8_t nb_channel;
+    resampling_mode_t mode;
 } resampling_config_t;
 
+struct resampling_instance;
+
+/** @brief Resampling interpolation kernel.
+ *
+ *  Kernels are specialized per sample bit depth, channel count and correction mode.
+ */
+typedef uint32_t (*resampling_interp_t)(struct resampling_instance *instance, int32_t *y, int32_t *y1,
+                                        int32_t *out, uint16_t size);
+
+/** @brief Resampling polyphase filter kernel.
+ *
+ *  Kernels are specialized per sample storage type and channel count.
+ */
+typedef uint16_t (*resampling_polyphase_t)(struct resampling_instance *instance, void *ptr_input, void *ptr_output,
+                                           uint16_t sample_count);
+
 /** @brief Resampling library instance structure.
  *
  *  Variables within this structure will be set by the library in the init function.
@@ -102,6 +132,14 @@ typedef struct resampling_instance {
     int64_t x_axis;
     uint8_t nb_channel;
     uint32_t max_x_axis;
+    resampling_interp_t interp_add;
+    resampling_interp_t interp_rem;
+    resampling_polyphase_t polyphase;
+    resampling_mode_t mode;
+    int32_t history[POLYPHASE_HISTORY_ARRAY_SIZE];
+    uint16_t position;
+    uint32_t position_frac;
+    int32_t step_offset;
 } resampling_instance_t;
 
 /* PUBLIC FUNCTION PROTOTYPES *************************************************/
@@ -120,7 +158,17 @@ resampling_errors_t resampling_init(resampling_instance_t *instance, resampling_
  */
 void resampling_start(resampling_instance_t *instance, resampling_correction_t correction);
 
+/** @brief Set the resampling ratio of the polyphase mode.
+ *
+ *  @param[in] instance   Structure instance pointer.
+ *  @param[in] ratio_ppm  Deviation from a 1:1 ratio in parts per million, clamped to +/-RESAMPLING_RATIO_MAX_PPM.
+ *                        A positive value consumes the input faster, producing fewer samples.
+ */
+void resampling_set_ratio_ppm(resampling_instance_t *instance, int32_t ratio_ppm);
+
 /** @brief resample the signal if STARTED.
+ *
+ *  In polyphase mode, the signal is always resampled and the output holds up to one more frame than the input.
  *
  *  @param[in] instance       Structure instance pointer.
  *  @param[in] ptr_input      Pointer to input data.